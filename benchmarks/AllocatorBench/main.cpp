@@ -0,0 +1,208 @@
+// Compares one vkAllocateMemory per buffer (the original path in the steps) with VgtAllocator.
+//
+// Usage: AllocatorBench [--count N] [--rounds N] [--device-local]
+//
+// Both paths create, bind, fill (host-visible only) and destroy the same sequence of buffers.
+// A churn pass then frees/reallocates random buffers and prints allocator statistics.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include <VgtAllocator.h>
+#include <VgtBenchDevice.h>
+
+using Clock = std::chrono::steady_clock;
+
+static uint32_t FindMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties& memProps, uint32_t typeBits, VkMemoryPropertyFlags properties)
+{
+    for (uint32_t i = 0; i < memProps.memoryTypeCount; ++i)
+    {
+        if ((typeBits & (1u << i)) && (memProps.memoryTypes[i].propertyFlags & properties) == properties)
+            return i;
+    }
+    return UINT32_MAX;
+}
+
+static VkBufferCreateInfo MakeBufferCI(VkDeviceSize size)
+{
+    VkBufferCreateInfo ci{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    ci.size = size;
+    ci.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    ci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    return ci;
+}
+
+// Original path: create, query, allocate, bind, map/fill/unmap per resource.
+static double RunPerResource(const VgtBenchDevice& dev, const std::vector<VkDeviceSize>& sizes, VkMemoryPropertyFlags props)
+{
+    const bool hostVisible = (props & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+    std::vector<VkBuffer> buffers(sizes.size(), VK_NULL_HANDLE);
+    std::vector<VkDeviceMemory> memories(sizes.size(), VK_NULL_HANDLE);
+
+    const auto t0 = Clock::now();
+    for (size_t i = 0; i < sizes.size(); ++i)
+    {
+        const VkBufferCreateInfo ci = MakeBufferCI(sizes[i]);
+        vkCreateBuffer(dev.device, &ci, nullptr, &buffers[i]);
+
+        VkMemoryRequirements req{};
+        vkGetBufferMemoryRequirements(dev.device, buffers[i], &req);
+
+        VkMemoryAllocateInfo ai{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+        ai.allocationSize = req.size;
+        ai.memoryTypeIndex = FindMemoryTypeIndex(dev.memProps, req.memoryTypeBits, props);
+        if (vkAllocateMemory(dev.device, &ai, nullptr, &memories[i]) != VK_SUCCESS)
+        {
+            std::fprintf(stderr, "vkAllocateMemory failed after %zu allocations\n", i);
+            break;
+        }
+        vkBindBufferMemory(dev.device, buffers[i], memories[i], 0);
+
+        if (hostVisible)
+        {
+            void* mapped = nullptr;
+            vkMapMemory(dev.device, memories[i], 0, sizes[i], 0, &mapped);
+            std::memset(mapped, 0, 64);
+            vkUnmapMemory(dev.device, memories[i]);
+        }
+    }
+    for (size_t i = 0; i < sizes.size(); ++i)
+    {
+        vkDestroyBuffer(dev.device, buffers[i], nullptr);
+        if (memories[i])
+            vkFreeMemory(dev.device, memories[i], nullptr);
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+static double RunSubAllocated(VgtAllocator& allocator, const std::vector<VkDeviceSize>& sizes, VkMemoryPropertyFlags props)
+{
+    std::vector<VkBuffer> buffers(sizes.size(), VK_NULL_HANDLE);
+    std::vector<VgtAllocation> allocs(sizes.size());
+
+    const auto t0 = Clock::now();
+    for (size_t i = 0; i < sizes.size(); ++i)
+    {
+        const VkBufferCreateInfo ci = MakeBufferCI(sizes[i]);
+        if (VgtCreateBuffer(allocator, ci, props, buffers[i], allocs[i]) != VK_SUCCESS)
+        {
+            std::fprintf(stderr, "VgtCreateBuffer failed after %zu allocations\n", i);
+            break;
+        }
+        if (allocs[i].mapped)
+            std::memset(allocs[i].mapped, 0, 64);
+    }
+    for (size_t i = 0; i < sizes.size(); ++i)
+        VgtDestroyBuffer(allocator, buffers[i], allocs[i]);
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+// Random free/realloc to exercise buddy merging; prints the resulting fragmentation.
+static void RunChurn(VgtAllocator& allocator, const std::vector<VkDeviceSize>& sizes, VkMemoryPropertyFlags props, std::mt19937& rng)
+{
+    std::vector<VkBuffer> buffers(sizes.size(), VK_NULL_HANDLE);
+    std::vector<VgtAllocation> allocs(sizes.size());
+    for (size_t i = 0; i < sizes.size(); ++i)
+        VgtCreateBuffer(allocator, MakeBufferCI(sizes[i]), props, buffers[i], allocs[i]);
+
+    std::uniform_int_distribution<size_t> pick(0, sizes.size() - 1);
+    for (size_t n = 0; n < sizes.size() * 4; ++n)
+    {
+        const size_t i = pick(rng);
+        VgtDestroyBuffer(allocator, buffers[i], allocs[i]);
+        buffers[i] = VK_NULL_HANDLE;
+        if (n % 3 != 0)
+            VgtCreateBuffer(allocator, MakeBufferCI(sizes[pick(rng)]), props, buffers[i], allocs[i]);
+    }
+
+    VgtPrintAllocatorStats("churn", VgtGetAllocatorStats(allocator));
+
+    for (size_t i = 0; i < sizes.size(); ++i)
+        VgtDestroyBuffer(allocator, buffers[i], allocs[i]);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t count = 2000;
+    uint32_t rounds = 5;
+    bool deviceLocal = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+            count = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+            rounds = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--device-local") == 0)
+            deviceLocal = true;
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--count N] [--rounds N] [--device-local]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    VgtBenchDeviceCreateInfo deviceCI{};
+    deviceCI.appName = "AllocatorBench";
+    deviceCI.queueFlags = 0; // memory only: any queue will do
+    VgtBenchDevice dev;
+    if (!VgtCreateBenchDevice(deviceCI, dev))
+    {
+        std::fprintf(stderr, "Failed to create a Vulkan device\n");
+        VgtDestroyBenchDevice(dev);
+        return 1;
+    }
+
+    // The per-resource path cannot exceed maxMemoryAllocationCount (often 4096).
+    const uint32_t limit = dev.props.limits.maxMemoryAllocationCount;
+    if (count + 16 > limit)
+    {
+        count = limit - 16;
+        std::fprintf(stderr, "Clamping --count to %u (maxMemoryAllocationCount=%u)\n", count, limit);
+    }
+
+    const VkMemoryPropertyFlags props = deviceLocal
+        ? VkMemoryPropertyFlags(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+        : VkMemoryPropertyFlags(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    // Mix of small (uniform/vertex) and medium (mesh/staging) sizes.
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> shift(8, 18);
+    std::vector<VkDeviceSize> sizes(count);
+    for (auto& s : sizes)
+        s = (VkDeviceSize(1) << shift(rng)) + VkDeviceSize(rng() % 256);
+
+    VgtAllocatorCreateInfo allocatorCI{};
+    allocatorCI.physicalDevice = dev.physicalDevice;
+    allocatorCI.device = dev.device;
+    VgtAllocator allocator;
+    VgtCreateAllocator(allocatorCI, allocator);
+
+    std::printf("device: %s\n", dev.props.deviceName);
+    std::printf("buffers: %u per round, %u round(s), %s memory\n", count, rounds, deviceLocal ? "device-local" : "host-visible");
+
+    double bestPerResource = 1e30;
+    double bestSubAllocated = 1e30;
+    for (uint32_t r = 0; r < rounds; ++r)
+    {
+        bestPerResource = std::min(bestPerResource, RunPerResource(dev, sizes, props));
+        bestSubAllocated = std::min(bestSubAllocated, RunSubAllocated(allocator, sizes, props));
+    }
+
+    std::printf("per-resource vkAllocateMemory: %8.3f ms (%.3f us/buffer)\n", bestPerResource, bestPerResource * 1000.0 / count);
+    std::printf("VgtAllocator                 : %8.3f ms (%.3f us/buffer)\n", bestSubAllocated, bestSubAllocated * 1000.0 / count);
+    if (bestSubAllocated > 0.0)
+        std::printf("speedup: %.2fx\n", bestPerResource / bestSubAllocated);
+
+    RunChurn(allocator, sizes, props, rng);
+
+    VgtDestroyAllocator(allocator);
+    VgtDestroyBenchDevice(dev);
+    return 0;
+}
@@ -0,0 +1,667 @@
+// Measures how clustered forward lighting scales with the number of lights.
+//
+// Usage: ClusterBench [--lights N[,N...]] [--size N] [--rounds N] [--range R] [--naive-max N]
+//
+// The scene is a large floor seen at a grazing angle from above (so the clusters span many depth
+// slices), shaded with the Step05_LightingBasic --lights shaders into an offscreen size x size
+// image. The lights are scattered in a slab just above the floor, every fourth one a spot light.
+// For each light count the best of --rounds submissions is reported for
+//   - clustered: the binning pass (cluster_lights.comp) plus the shading pass, which evaluates only
+//     the lights of each fragment's cluster (at most maxLightsPerCluster of them),
+//   - brute force: the same shader with every light evaluated for every pixel (lighting_clustered.frag
+//     with kAllLights), skipped above --naive-max lights because its cost grows without bound.
+// The light lists are read back after the clustered run: the average and maximum lights per
+// cluster and the number of clusters that overflowed their fixed slot show where the bound bites.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include <VgtAllocator.h>
+#include <VgtBenchDevice.h>
+#include <VgtClusteredLights.h>
+#include <VgtDepth.h>
+#include <VgtMath.h>
+#include <VgtOptions.h>
+#include <VgtSpirv.h>
+#include <VgtUniformRing.h>
+
+constexpr VkFormat kColorFormat = VK_FORMAT_R8G8B8A8_UNORM;
+
+constexpr float kFovY = 0.785398f;
+constexpr float kZNear = 0.1f;
+constexpr float kZFar = 20.0f;
+
+struct Vertex
+{
+    float pos[3];
+    float normal[3];
+};
+
+// Same layout as the UBO of lighting_clustered.vert / lighting_clustered.frag.
+struct UniformBufferObject
+{
+    VgtMat4 mvp;
+    VgtMat4 modelView;
+    VgtMat4 normalMatrix;
+    float lightDir[4];
+};
+
+// Offscreen color + depth target, the floor and its UBO, and the Step05 clustered shaders.
+struct BenchScene
+{
+    VkExtent2D extent{};
+    VgtMat4 view{};
+
+    VgtBenchColorTarget color;
+    VgtDepthBuffer depth;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+
+    VkBuffer vertexBuffer = VK_NULL_HANDLE;
+    VgtAllocation vertexAlloc;
+    VgtUniformRing uniformRing;
+    uint32_t uboOffset = 0;
+
+    VkDescriptorSetLayout descLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descPool = VK_NULL_HANDLE;
+    VkDescriptorSet descSet = VK_NULL_HANDLE;
+
+    VkShaderModule vertModule = VK_NULL_HANDLE;
+    VkShaderModule fragModule = VK_NULL_HANDLE;
+};
+
+// Everything that depends on the light count: the lights, their clusters and the pipelines
+// (whose layout includes the cluster descriptor set).
+struct LightSetup
+{
+    uint32_t lightCount = 0;
+    VkBuffer lightBuffer = VK_NULL_HANDLE;
+    VgtAllocation lightAlloc;
+    VgtClusteredLights clusters;
+    VkBuffer readbackBuffer = VK_NULL_HANDLE; // copy of the per-cluster counts
+    VgtAllocation readbackAlloc;
+
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline clusteredPipeline = VK_NULL_HANDLE;
+    VkPipeline naivePipeline = VK_NULL_HANDLE; // kAllLights = true
+};
+
+static bool CreateBenchScene(const VgtBenchDevice& dev, VgtAllocator& allocator, BenchScene& scene)
+{
+    if (VgtCreateBenchColorTarget(allocator, dev.device, kColorFormat, scene.extent, scene.color) != VK_SUCCESS)
+        return false;
+
+    const VkFormat depthFormat = VgtPickDepthFormat(dev.physicalDevice);
+    if (VgtCreateDepthBuffer(allocator, dev.device, depthFormat, scene.extent, scene.depth) != VK_SUCCESS)
+        return false;
+
+    VkAttachmentDescription attachmentDescs[2]{};
+    attachmentDescs[0].format = kColorFormat;
+    attachmentDescs[0].samples = VK_SAMPLE_COUNT_1_BIT;
+    attachmentDescs[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachmentDescs[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachmentDescs[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachmentDescs[0].finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    attachmentDescs[1].format = depthFormat;
+    attachmentDescs[1].samples = VK_SAMPLE_COUNT_1_BIT;
+    attachmentDescs[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachmentDescs[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachmentDescs[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachmentDescs[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachmentDescs[1].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachmentDescs[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference colorRef{};
+    colorRef.attachment = 0;
+    colorRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference depthRef{};
+    depthRef.attachment = 1;
+    depthRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorRef;
+    subpass.pDepthStencilAttachment = &depthRef;
+
+    VkRenderPassCreateInfo rpCI{ VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
+    rpCI.attachmentCount = 2;
+    rpCI.pAttachments = attachmentDescs;
+    rpCI.subpassCount = 1;
+    rpCI.pSubpasses = &subpass;
+    vkCreateRenderPass(dev.device, &rpCI, nullptr, &scene.renderPass);
+
+    const VkImageView fbViews[2] = { scene.color.view, scene.depth.view };
+    VkFramebufferCreateInfo fbCI{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
+    fbCI.renderPass = scene.renderPass;
+    fbCI.attachmentCount = 2;
+    fbCI.pAttachments = fbViews;
+    fbCI.width = scene.extent.width;
+    fbCI.height = scene.extent.height;
+    fbCI.layers = 1;
+    vkCreateFramebuffer(dev.device, &fbCI, nullptr, &scene.framebuffer);
+
+    // The floor: y = 0, x in [-6, 6], z in [-8, 2], facing up.
+    const Vertex vertices[6] = {
+        { { -6.0f, 0.0f,  2.0f }, { 0.0f, 1.0f, 0.0f } },
+        { {  6.0f, 0.0f,  2.0f }, { 0.0f, 1.0f, 0.0f } },
+        { {  6.0f, 0.0f, -8.0f }, { 0.0f, 1.0f, 0.0f } },
+        { { -6.0f, 0.0f,  2.0f }, { 0.0f, 1.0f, 0.0f } },
+        { {  6.0f, 0.0f, -8.0f }, { 0.0f, 1.0f, 0.0f } },
+        { { -6.0f, 0.0f, -8.0f }, { 0.0f, 1.0f, 0.0f } },
+    };
+    VkBufferCreateInfo vbCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    vbCI.size = sizeof(vertices);
+    vbCI.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    vbCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (VgtCreateBuffer(allocator, vbCI, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, scene.vertexBuffer,
+            scene.vertexAlloc) != VK_SUCCESS)
+        return false;
+    std::memcpy(scene.vertexAlloc.mapped, vertices, sizeof(vertices));
+
+    // One static UBO: the floor's model matrix is the identity.
+    if (VgtCreateUniformRing(allocator, sizeof(UniformBufferObject), 1, 1, scene.uniformRing) != VK_SUCCESS)
+        return false;
+
+    scene.view = VgtMat4LookAt(0.0f, 1.0f, 2.0f, 0.0f, 0.0f, -2.0f, 0.0f, 1.0f, 0.0f);
+    const float aspect = static_cast<float>(scene.extent.width) / scene.extent.height;
+    UniformBufferObject ubo{};
+    ubo.modelView = scene.view;
+    ubo.mvp = VgtMat4Mul(scene.view, VgtMat4Perspective(kFovY, aspect, kZNear, kZFar));
+    ubo.normalMatrix = VgtMat4NormalMatrix(scene.view);
+    ubo.lightDir[0] = 0.5f;
+    ubo.lightDir[1] = -0.5f;
+    ubo.lightDir[2] = -1.0f;
+    VgtUniformRingBeginFrame(scene.uniformRing, 0);
+    scene.uboOffset = VgtUniformRingPush(scene.uniformRing, &ubo, sizeof(ubo));
+    if (scene.uboOffset == UINT32_MAX)
+        return false;
+
+    VkDescriptorSetLayoutBinding uboBinding{};
+    uboBinding.binding = 0;
+    uboBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    uboBinding.descriptorCount = 1;
+    uboBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo descLayoutCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    descLayoutCI.bindingCount = 1;
+    descLayoutCI.pBindings = &uboBinding;
+    vkCreateDescriptorSetLayout(dev.device, &descLayoutCI, nullptr, &scene.descLayout);
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSize.descriptorCount = 1;
+
+    VkDescriptorPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolCI.poolSizeCount = 1;
+    poolCI.pPoolSizes = &poolSize;
+    poolCI.maxSets = 1;
+    vkCreateDescriptorPool(dev.device, &poolCI, nullptr, &scene.descPool);
+
+    VkDescriptorSetAllocateInfo descAI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    descAI.descriptorPool = scene.descPool;
+    descAI.descriptorSetCount = 1;
+    descAI.pSetLayouts = &scene.descLayout;
+    vkAllocateDescriptorSets(dev.device, &descAI, &scene.descSet);
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = scene.uniformRing.buffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = sizeof(UniformBufferObject);
+
+    VkWriteDescriptorSet descWrite{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    descWrite.dstSet = scene.descSet;
+    descWrite.dstBinding = 0;
+    descWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    descWrite.descriptorCount = 1;
+    descWrite.pBufferInfo = &bufferInfo;
+    vkUpdateDescriptorSets(dev.device, 1, &descWrite, 0, nullptr);
+
+    const auto vertSpv = VgtLoadSpirv("lighting_clustered.vert.spv", false);
+    const auto fragSpv = VgtLoadSpirv("lighting_clustered.frag.spv", false);
+    if (vertSpv.empty() || fragSpv.empty())
+    {
+        std::fprintf(stderr, "Failed to load lighting_clustered.vert.spv / lighting_clustered.frag.spv\n");
+        return false;
+    }
+
+    VkShaderModuleCreateInfo smVertCI{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    smVertCI.codeSize = vertSpv.size() * sizeof(uint32_t);
+    smVertCI.pCode = vertSpv.data();
+    vkCreateShaderModule(dev.device, &smVertCI, nullptr, &scene.vertModule);
+
+    VkShaderModuleCreateInfo smFragCI{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    smFragCI.codeSize = fragSpv.size() * sizeof(uint32_t);
+    smFragCI.pCode = fragSpv.data();
+    vkCreateShaderModule(dev.device, &smFragCI, nullptr, &scene.fragModule);
+    return true;
+}
+
+static void DestroyBenchScene(const VgtBenchDevice& dev, VgtAllocator& allocator, BenchScene& scene)
+{
+    vkDestroyShaderModule(dev.device, scene.fragModule, nullptr);
+    vkDestroyShaderModule(dev.device, scene.vertModule, nullptr);
+    vkDestroyDescriptorPool(dev.device, scene.descPool, nullptr);
+    vkDestroyDescriptorSetLayout(dev.device, scene.descLayout, nullptr);
+    if (scene.uniformRing.buffer)
+        VgtDestroyUniformRing(allocator, scene.uniformRing);
+    if (scene.vertexBuffer)
+        VgtDestroyBuffer(allocator, scene.vertexBuffer, scene.vertexAlloc);
+    vkDestroyFramebuffer(dev.device, scene.framebuffer, nullptr);
+    vkDestroyRenderPass(dev.device, scene.renderPass, nullptr);
+    VgtDestroyDepthBuffer(allocator, dev.device, scene.depth);
+    VgtDestroyBenchColorTarget(allocator, dev.device, scene.color);
+    scene = BenchScene{};
+}
+
+static bool CreatePipelines(const VgtBenchDevice& dev, const BenchScene& scene, LightSetup& setup)
+{
+    const VkDescriptorSetLayout setLayouts[2] = { scene.descLayout, setup.clusters.setLayout };
+    VkPipelineLayoutCreateInfo plCI{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    plCI.setLayoutCount = 2;
+    plCI.pSetLayouts = setLayouts;
+    if (vkCreatePipelineLayout(dev.device, &plCI, nullptr, &setup.pipelineLayout) != VK_SUCCESS)
+        return false;
+
+    // kAllLights (constant_id 0): false for the clustered pipeline, true for brute force.
+    const VkSpecializationMapEntry specEntry{ 0, 0, sizeof(VkBool32) };
+    const VkBool32 allLights[2] = { VK_FALSE, VK_TRUE };
+    VkSpecializationInfo specInfos[2]{};
+    VkPipelineShaderStageCreateInfo stages[2][2]{};
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        specInfos[i].mapEntryCount = 1;
+        specInfos[i].pMapEntries = &specEntry;
+        specInfos[i].dataSize = sizeof(VkBool32);
+        specInfos[i].pData = &allLights[i];
+
+        stages[i][0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[i][0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        stages[i][0].module = scene.vertModule;
+        stages[i][0].pName = "main";
+        stages[i][1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[i][1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        stages[i][1].module = scene.fragModule;
+        stages[i][1].pName = "main";
+        stages[i][1].pSpecializationInfo = &specInfos[i];
+    }
+
+    VkVertexInputBindingDescription binding{};
+    binding.binding = 0;
+    binding.stride = sizeof(Vertex);
+    binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    VkVertexInputAttributeDescription attrs[2]{};
+    attrs[0].location = 0;
+    attrs[0].binding = 0;
+    attrs[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attrs[0].offset = offsetof(Vertex, pos);
+    attrs[1].location = 1;
+    attrs[1].binding = 0;
+    attrs[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attrs[1].offset = offsetof(Vertex, normal);
+
+    VkPipelineVertexInputStateCreateInfo vi{ VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
+    vi.vertexBindingDescriptionCount = 1;
+    vi.pVertexBindingDescriptions = &binding;
+    vi.vertexAttributeDescriptionCount = 2;
+    vi.pVertexAttributeDescriptions = attrs;
+
+    VkPipelineInputAssemblyStateCreateInfo ia{ VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO };
+    ia.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkPipelineViewportStateCreateInfo vp{ VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO };
+    vp.viewportCount = 1;
+    vp.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rs{ VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO };
+    rs.polygonMode = VK_POLYGON_MODE_FILL;
+    rs.cullMode = VK_CULL_MODE_NONE;
+    rs.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rs.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo ms{ VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
+    ms.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineDepthStencilStateCreateInfo ds{ VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO };
+    ds.depthTestEnable = VK_TRUE;
+    ds.depthWriteEnable = VK_TRUE;
+    ds.depthCompareOp = VgtDepthCompareOp(false);
+
+    VkPipelineColorBlendAttachmentState cbAttach{};
+    cbAttach.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    VkPipelineColorBlendStateCreateInfo cb{ VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
+    cb.attachmentCount = 1;
+    cb.pAttachments = &cbAttach;
+
+    VkDynamicState dynStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dyn{ VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
+    dyn.dynamicStateCount = 2;
+    dyn.pDynamicStates = dynStates;
+
+    VkGraphicsPipelineCreateInfo gpCIs[2]{};
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        VkGraphicsPipelineCreateInfo& gpCI = gpCIs[i];
+        gpCI.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        gpCI.stageCount = 2;
+        gpCI.pStages = stages[i];
+        gpCI.pVertexInputState = &vi;
+        gpCI.pInputAssemblyState = &ia;
+        gpCI.pViewportState = &vp;
+        gpCI.pRasterizationState = &rs;
+        gpCI.pMultisampleState = &ms;
+        gpCI.pDepthStencilState = &ds;
+        gpCI.pColorBlendState = &cb;
+        gpCI.pDynamicState = &dyn;
+        gpCI.layout = setup.pipelineLayout;
+        gpCI.renderPass = scene.renderPass;
+    }
+
+    VkPipeline pipelines[2] = {};
+    const VkResult res = vkCreateGraphicsPipelines(dev.device, VK_NULL_HANDLE, 2, gpCIs, nullptr, pipelines);
+    setup.clusteredPipeline = pipelines[0];
+    setup.naivePipeline = pipelines[1];
+    return res == VK_SUCCESS;
+}
+
+static bool CreateLightSetup(const VgtBenchDevice& dev, VgtAllocator& allocator, const BenchScene& scene, uint32_t lightCount, float range,
+    LightSetup& setup)
+{
+    setup.lightCount = lightCount;
+
+    // A slab just above the floor; the spots aim at its middle.
+    const float boundsMin[3] = { -6.0f, 0.05f, -8.0f };
+    const float boundsMax[3] = { 6.0f, 0.6f, 2.0f };
+    const float target[3] = { 0.0f, 0.0f, -3.0f };
+    const std::vector<VgtLight> lights = VgtScatterLights(lightCount, boundsMin, boundsMax, range, target);
+
+    VkBufferCreateInfo lightCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    lightCI.size = lights.size() * sizeof(VgtLight);
+    lightCI.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    lightCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (VgtCreateBuffer(allocator, lightCI, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, setup.lightBuffer,
+            setup.lightAlloc) != VK_SUCCESS)
+        return false;
+    std::memcpy(setup.lightAlloc.mapped, lights.data(), lightCI.size);
+
+    VgtClusteredLightsCreateInfo clustersCI{};
+    clustersCI.device = dev.device;
+    clustersCI.allocator = &allocator;
+    clustersCI.lightBuffer = setup.lightBuffer;
+    clustersCI.lightCount = lightCount;
+    if (VgtCreateClusteredLights(clustersCI, setup.clusters) != VK_SUCCESS)
+        return false;
+
+    VkBufferCreateInfo readbackCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    readbackCI.size = VgtClusterCount(setup.clusters) * sizeof(uint32_t);
+    readbackCI.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    readbackCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (VgtCreateBuffer(allocator, readbackCI, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            setup.readbackBuffer, setup.readbackAlloc) != VK_SUCCESS)
+        return false;
+
+    return CreatePipelines(dev, scene, setup);
+}
+
+static void DestroyLightSetup(const VgtBenchDevice& dev, VgtAllocator& allocator, LightSetup& setup)
+{
+    vkDestroyPipeline(dev.device, setup.naivePipeline, nullptr);
+    vkDestroyPipeline(dev.device, setup.clusteredPipeline, nullptr);
+    vkDestroyPipelineLayout(dev.device, setup.pipelineLayout, nullptr);
+    if (setup.readbackBuffer)
+        VgtDestroyBuffer(allocator, setup.readbackBuffer, setup.readbackAlloc);
+    VgtDestroyClusteredLights(setup.clusters);
+    if (setup.lightBuffer)
+        VgtDestroyBuffer(allocator, setup.lightBuffer, setup.lightAlloc);
+    setup = LightSetup{};
+}
+
+// Query layout: 0 before the binning pass, 1 after it, 2 after the render pass. The brute-force
+// run bins too, because the shader reads the view-space lights the binning pass writes; only its
+// shading time (1 -> 2) is compared.
+static void RecordFrame(const BenchScene& scene, const LightSetup& setup, VkCommandBuffer cmd, VkQueryPool timestampPool, bool naive)
+{
+    vkResetCommandBuffer(cmd, 0);
+
+    VkCommandBufferBeginInfo begin{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    vkBeginCommandBuffer(cmd, &begin);
+    vkCmdResetQueryPool(cmd, timestampPool, 0, 3);
+
+    const float aspect = static_cast<float>(scene.extent.width) / scene.extent.height;
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestampPool, 0);
+    VgtCmdClusterLights(cmd, setup.clusters, scene.view, kFovY, aspect, kZNear, kZFar, scene.extent);
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampPool, 1);
+
+    VkClearValue clears[2]{};
+    clears[1].depthStencil.depth = VgtDepthClearValue(false);
+
+    VkRenderPassBeginInfo rpBegin{ VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
+    rpBegin.renderPass = scene.renderPass;
+    rpBegin.framebuffer = scene.framebuffer;
+    rpBegin.renderArea.extent = scene.extent;
+    rpBegin.clearValueCount = 2;
+    rpBegin.pClearValues = clears;
+    vkCmdBeginRenderPass(cmd, &rpBegin, VK_SUBPASS_CONTENTS_INLINE);
+
+    VkViewport viewport{};
+    viewport.width = static_cast<float>(scene.extent.width);
+    viewport.height = static_cast<float>(scene.extent.height);
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.extent = scene.extent;
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(cmd, 0, 1, &scene.vertexBuffer, &offset);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, naive ? setup.naivePipeline : setup.clusteredPipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, setup.pipelineLayout, 0, 1, &scene.descSet, 1, &scene.uboOffset);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, setup.pipelineLayout, 1, 1, &setup.clusters.descSet, 0, nullptr);
+    vkCmdDraw(cmd, 6, 1, 0, 0);
+
+    vkCmdEndRenderPass(cmd);
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampPool, 2);
+
+    // The binning pass already made its writes visible to transfers.
+    VkBufferCopy region{};
+    region.size = VgtClusterCount(setup.clusters) * sizeof(uint32_t);
+    vkCmdCopyBuffer(cmd, setup.clusters.countBuffer, setup.readbackBuffer, 1, &region);
+
+    VkMemoryBarrier hostBarrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &hostBarrier, 0, nullptr, 0, nullptr);
+    vkEndCommandBuffer(cmd);
+}
+
+struct Timing
+{
+    double clusterMs = 1e30;
+    double shadeMs = 1e30;
+};
+
+static VkResult Measure(const VgtBenchDevice& dev, VkCommandBuffer cmd, VkFence fence, VkQueryPool timestampPool, uint32_t rounds,
+    Timing& timing)
+{
+    VkResult res = VK_SUCCESS;
+    for (uint32_t r = 0; r < rounds && res == VK_SUCCESS; ++r)
+    {
+        res = VgtBenchSubmitAndWait(dev, cmd, fence);
+        uint64_t ticks[3] = {};
+        if (res == VK_SUCCESS)
+            res = vkGetQueryPoolResults(dev.device, timestampPool, 0, 3, sizeof(ticks), ticks, sizeof(uint64_t),
+                VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+        if (res == VK_SUCCESS)
+        {
+            const double period = dev.props.limits.timestampPeriod * 1e-6;
+            timing.clusterMs = std::min(timing.clusterMs, static_cast<double>(ticks[1] - ticks[0]) * period);
+            timing.shadeMs = std::min(timing.shadeMs, static_cast<double>(ticks[2] - ticks[1]) * period);
+        }
+    }
+    return res;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<uint32_t> lightCounts = { 1, 100, 1000, 10000 };
+    uint32_t size = 1024;
+    uint32_t rounds = 20;
+    float range = 0.5f;
+    uint32_t naiveMax = 1000;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--lights") == 0 && i + 1 < argc && VgtParseBenchCounts(argv[i + 1], lightCounts, kVgtMaxLights))
+            ++i;
+        else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+            size = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+            rounds = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--range") == 0 && i + 1 < argc)
+            range = std::strtof(argv[++i], nullptr);
+        else if (std::strcmp(argv[i], "--naive-max") == 0 && i + 1 < argc)
+            naiveMax = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--lights N[,N...]] [--size N] [--rounds N] [--range R] [--naive-max N]\n", argv[0]);
+            return 1;
+        }
+    }
+    size = std::clamp(size, 16u, 8192u);
+    rounds = std::max(rounds, 1u);
+    range = std::clamp(range, 0.01f, 10.0f);
+
+    VgtBenchDeviceCreateInfo deviceCI{};
+    deviceCI.appName = "ClusterBench";
+    // The binning pass is recorded on the graphics queue, so it needs compute too.
+    deviceCI.queueFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT;
+    VgtBenchDevice dev;
+    if (!VgtCreateBenchDevice(deviceCI, dev))
+    {
+        std::fprintf(stderr, "Failed to create a Vulkan device with a graphics + compute queue\n");
+        VgtDestroyBenchDevice(dev);
+        return 1;
+    }
+    if (!dev.timestamps)
+    {
+        std::fprintf(stderr, "The graphics queue does not support timestamps; nothing to measure\n");
+        VgtDestroyBenchDevice(dev);
+        return 1;
+    }
+
+    VgtAllocatorCreateInfo allocatorCI{};
+    allocatorCI.physicalDevice = dev.physicalDevice;
+    allocatorCI.device = dev.device;
+    VgtAllocator allocator;
+    VgtCreateAllocator(allocatorCI, allocator);
+
+    BenchScene scene;
+    scene.extent = { size, size };
+    if (!CreateBenchScene(dev, allocator, scene))
+    {
+        std::fprintf(stderr, "Failed to create the Step05 clustered lighting resources\n");
+        DestroyBenchScene(dev, allocator, scene);
+        VgtDestroyAllocator(allocator);
+        VgtDestroyBenchDevice(dev);
+        return 1;
+    }
+
+    VkQueryPoolCreateInfo timestampCI{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+    timestampCI.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    timestampCI.queryCount = 3;
+    VkQueryPool timestampPool = VK_NULL_HANDLE;
+    vkCreateQueryPool(dev.device, &timestampCI, nullptr, &timestampPool);
+
+    VkCommandPoolCreateInfo cmdPoolCI{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    cmdPoolCI.queueFamilyIndex = dev.queueFamily;
+    cmdPoolCI.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    VkCommandPool cmdPool = VK_NULL_HANDLE;
+    vkCreateCommandPool(dev.device, &cmdPoolCI, nullptr, &cmdPool);
+
+    VkCommandBufferAllocateInfo cmdAI{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    cmdAI.commandPool = cmdPool;
+    cmdAI.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cmdAI.commandBufferCount = 1;
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+    vkAllocateCommandBuffers(dev.device, &cmdAI, &cmd);
+
+    VkFenceCreateInfo fenceCI{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    VkFence fence = VK_NULL_HANDLE;
+    vkCreateFence(dev.device, &fenceCI, nullptr, &fence);
+
+    std::printf("device: %s\n", dev.props.deviceName);
+    std::printf("target: %ux%u, light range %.2f, %u round(s), best round reported\n", size, size, range, rounds);
+    std::printf("%8s  %12s  %10s  %10s  %10s  %9s  %9s  %9s\n", "lights", "mode", "bin ms", "shade ms", "total ms", "avg/clu", "max/clu",
+        "overflow");
+
+    bool ok = true;
+    for (uint32_t lightCount : lightCounts)
+    {
+        LightSetup setup;
+        if (!CreateLightSetup(dev, allocator, scene, lightCount, range, setup))
+        {
+            std::fprintf(stderr, "lights=%u: failed to create the lights, clusters or pipelines\n", lightCount);
+            DestroyLightSetup(dev, allocator, setup);
+            ok = false;
+            break;
+        }
+
+        Timing clustered;
+        RecordFrame(scene, setup, cmd, timestampPool, false);
+        VkResult res = Measure(dev, cmd, fence, timestampPool, rounds, clustered);
+
+        // Light list occupancy from the last clustered round (the counts are stored unclamped).
+        const uint32_t clusterCount = VgtClusterCount(setup.clusters);
+        const auto* counts = static_cast<const uint32_t*>(setup.readbackAlloc.mapped);
+        uint64_t total = 0;
+        uint32_t maxCount = 0;
+        uint32_t overflow = 0;
+        for (uint32_t c = 0; c < clusterCount && res == VK_SUCCESS; ++c)
+        {
+            total += counts[c];
+            maxCount = std::max(maxCount, counts[c]);
+            if (counts[c] > setup.clusters.maxLightsPerCluster)
+                ++overflow;
+        }
+
+        Timing naive;
+        const bool runNaive = lightCount <= naiveMax;
+        if (res == VK_SUCCESS && runNaive)
+        {
+            RecordFrame(scene, setup, cmd, timestampPool, true);
+            res = Measure(dev, cmd, fence, timestampPool, rounds, naive);
+        }
+        DestroyLightSetup(dev, allocator, setup);
+
+        if (res != VK_SUCCESS)
+        {
+            std::fprintf(stderr, "lights=%u failed: VkResult=%d\n", lightCount, static_cast<int>(res));
+            ok = false;
+            break;
+        }
+
+        std::printf("%8u  %12s  %10.3f  %10.3f  %10.3f  %9.2f  %9u  %9u\n", lightCount, "clustered", clustered.clusterMs,
+            clustered.shadeMs, clustered.clusterMs + clustered.shadeMs, static_cast<double>(total) / clusterCount, maxCount, overflow);
+        if (runNaive)
+            std::printf("%8u  %12s  %10s  %10.3f  %10.3f\n", lightCount, "brute force", "-", naive.shadeMs, naive.shadeMs);
+        else
+            std::printf("%8u  %12s  %10s  %10s  %10s  (skipped, --naive-max %u)\n", lightCount, "brute force", "-", "-", "-", naiveMax);
+    }
+
+    vkDestroyFence(dev.device, fence, nullptr);
+    vkDestroyCommandPool(dev.device, cmdPool, nullptr);
+    vkDestroyQueryPool(dev.device, timestampPool, nullptr);
+    DestroyBenchScene(dev, allocator, scene);
+    VgtDestroyAllocator(allocator);
+    VgtDestroyBenchDevice(dev);
+    return ok ? 0 : 1;
+}
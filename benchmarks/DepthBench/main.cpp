@@ -0,0 +1,637 @@
+// Measures what the depth buffer and a depth pre-pass save on a high-overdraw scene.
+//
+// Usage: DepthBench [--layers N[,N...]] [--size N] [--rounds N] [--reverse-z]
+//
+// The scene is N screen-filling quads at decreasing depth, shaded with the Step05_LightingBasic
+// shaders into an offscreen size x size image. Each layer count is rendered
+//   - without a depth test, back to front (every layer is shaded: the baseline),
+//   - with depth, back to front (every layer still passes the test: early-Z cannot help),
+//   - with depth, front to back (the best case: everything but the front layer is rejected),
+//   - with a depth-only pre-pass, back to front, then an EQUAL shading pass (Step05 --depth-prepass),
+// and the best GPU time of --rounds submissions (timestamp queries around the render pass) is
+// reported. When the device supports pipeline statistics, the fragment shader invocations per
+// pixel are printed too, which shows directly how many layers were actually shaded.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include <VgtAllocator.h>
+#include <VgtBenchDevice.h>
+#include <VgtDepth.h>
+#include <VgtMath.h>
+#include <VgtSpirv.h>
+#include <VgtUniformRing.h>
+
+constexpr VkFormat kColorFormat = VK_FORMAT_R8G8B8A8_UNORM;
+
+struct Vertex
+{
+    float pos[3];
+    float normal[3];
+};
+
+// Same layout as the UBO of lighting.vert / lighting.frag.
+struct UniformBufferObject
+{
+    VgtMat4 mvp;
+    VgtMat4 modelView;
+    VgtMat4 normalMatrix;
+    float lightDir[4];
+};
+
+enum class DepthMode : uint32_t
+{
+    None,        // no depth test, back to front
+    BackToFront, // depth test, back to front
+    FrontToBack, // depth test, front to back
+    Prepass,     // depth-only pass + EQUAL shading pass, back to front
+};
+
+static const char* DepthModeName(DepthMode mode)
+{
+    switch (mode)
+    {
+    case DepthMode::None:
+        return "no depth";
+    case DepthMode::BackToFront:
+        return "back-to-front";
+    case DepthMode::FrontToBack:
+        return "front-to-back";
+    case DepthMode::Prepass:
+        return "pre-pass";
+    }
+    return "?";
+}
+
+// Offscreen color + depth target and the Step05 pipelines in every depth configuration.
+struct BenchScene
+{
+    VkExtent2D extent{};
+    bool reverseZ = false;
+
+    VgtBenchColorTarget color;
+    VgtDepthBuffer depth;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+
+    VkBuffer vertexBuffer = VK_NULL_HANDLE;
+    VgtAllocation vertexAlloc;
+    VgtUniformRing uniformRing;
+
+    VkDescriptorSetLayout descLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descPool = VK_NULL_HANDLE;
+    VkDescriptorSet descSet = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+
+    VkPipeline noDepthPipeline = VK_NULL_HANDLE; // depth test off
+    VkPipeline depthPipeline = VK_NULL_HANDLE;   // test + write
+    VkPipeline prepassPipeline = VK_NULL_HANDLE; // vertex shader only, depth write
+    VkPipeline equalPipeline = VK_NULL_HANDLE;   // EQUAL test, no write
+};
+
+static bool CreatePipelines(const VgtBenchDevice& dev, BenchScene& scene)
+{
+    const auto vertSpv = VgtLoadSpirv("lighting.vert.spv", false);
+    const auto fragSpv = VgtLoadSpirv("lighting.frag.spv", false);
+    if (vertSpv.empty() || fragSpv.empty())
+    {
+        std::fprintf(stderr, "Failed to load lighting.vert.spv / lighting.frag.spv\n");
+        return false;
+    }
+
+    VkShaderModuleCreateInfo smVertCI{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    smVertCI.codeSize = vertSpv.size() * sizeof(uint32_t);
+    smVertCI.pCode = vertSpv.data();
+    VkShaderModule vertModule = VK_NULL_HANDLE;
+    vkCreateShaderModule(dev.device, &smVertCI, nullptr, &vertModule);
+
+    VkShaderModuleCreateInfo smFragCI{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    smFragCI.codeSize = fragSpv.size() * sizeof(uint32_t);
+    smFragCI.pCode = fragSpv.data();
+    VkShaderModule fragModule = VK_NULL_HANDLE;
+    vkCreateShaderModule(dev.device, &smFragCI, nullptr, &fragModule);
+
+    VkPipelineShaderStageCreateInfo stages[2]{};
+    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stages[0].module = vertModule;
+    stages[0].pName = "main";
+    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    stages[1].module = fragModule;
+    stages[1].pName = "main";
+
+    VkVertexInputBindingDescription binding{};
+    binding.binding = 0;
+    binding.stride = sizeof(Vertex);
+    binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    VkVertexInputAttributeDescription attrs[2]{};
+    attrs[0].location = 0;
+    attrs[0].binding = 0;
+    attrs[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attrs[0].offset = offsetof(Vertex, pos);
+    attrs[1].location = 1;
+    attrs[1].binding = 0;
+    attrs[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attrs[1].offset = offsetof(Vertex, normal);
+
+    VkPipelineVertexInputStateCreateInfo vi{ VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
+    vi.vertexBindingDescriptionCount = 1;
+    vi.pVertexBindingDescriptions = &binding;
+    vi.vertexAttributeDescriptionCount = 2;
+    vi.pVertexAttributeDescriptions = attrs;
+
+    VkPipelineInputAssemblyStateCreateInfo ia{ VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO };
+    ia.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkPipelineViewportStateCreateInfo vp{ VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO };
+    vp.viewportCount = 1;
+    vp.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rs{ VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO };
+    rs.polygonMode = VK_POLYGON_MODE_FILL;
+    rs.cullMode = VK_CULL_MODE_NONE;
+    rs.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rs.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo ms{ VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
+    ms.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineColorBlendAttachmentState cbAttach{};
+    cbAttach.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    VkPipelineColorBlendStateCreateInfo cb{ VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
+    cb.attachmentCount = 1;
+    cb.pAttachments = &cbAttach;
+
+    VkPipelineColorBlendAttachmentState prepassCbAttach{}; // colorWriteMask 0
+    VkPipelineColorBlendStateCreateInfo prepassCb = cb;
+    prepassCb.pAttachments = &prepassCbAttach;
+
+    VkDynamicState dynStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dyn{ VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
+    dyn.dynamicStateCount = 2;
+    dyn.pDynamicStates = dynStates;
+
+    VkPipelineDepthStencilStateCreateInfo dsStates[4]{};
+    for (VkPipelineDepthStencilStateCreateInfo& ds : dsStates)
+        ds.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    dsStates[1].depthTestEnable = VK_TRUE;
+    dsStates[1].depthWriteEnable = VK_TRUE;
+    dsStates[1].depthCompareOp = VgtDepthCompareOp(scene.reverseZ);
+    dsStates[2] = dsStates[1];
+    dsStates[3].depthTestEnable = VK_TRUE;
+    dsStates[3].depthCompareOp = VK_COMPARE_OP_EQUAL;
+
+    VkGraphicsPipelineCreateInfo gpCIs[4]{};
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        VkGraphicsPipelineCreateInfo& gpCI = gpCIs[i];
+        gpCI.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        gpCI.stageCount = i == 2 ? 1 : 2;
+        gpCI.pStages = stages;
+        gpCI.pVertexInputState = &vi;
+        gpCI.pInputAssemblyState = &ia;
+        gpCI.pViewportState = &vp;
+        gpCI.pRasterizationState = &rs;
+        gpCI.pMultisampleState = &ms;
+        gpCI.pDepthStencilState = &dsStates[i];
+        gpCI.pColorBlendState = i == 2 ? &prepassCb : &cb;
+        gpCI.pDynamicState = &dyn;
+        gpCI.layout = scene.pipelineLayout;
+        gpCI.renderPass = scene.renderPass;
+    }
+
+    VkPipeline pipelines[4] = {};
+    const VkResult res = vkCreateGraphicsPipelines(dev.device, VK_NULL_HANDLE, 4, gpCIs, nullptr, pipelines);
+    scene.noDepthPipeline = pipelines[0];
+    scene.depthPipeline = pipelines[1];
+    scene.prepassPipeline = pipelines[2];
+    scene.equalPipeline = pipelines[3];
+    vkDestroyShaderModule(dev.device, fragModule, nullptr);
+    vkDestroyShaderModule(dev.device, vertModule, nullptr);
+    return res == VK_SUCCESS;
+}
+
+static bool CreateBenchScene(const VgtBenchDevice& dev, VgtAllocator& allocator, uint32_t maxLayers, BenchScene& scene)
+{
+    if (VgtCreateBenchColorTarget(allocator, dev.device, kColorFormat, scene.extent, scene.color) != VK_SUCCESS)
+        return false;
+
+    const VkFormat depthFormat = VgtPickDepthFormat(dev.physicalDevice);
+    if (VgtCreateDepthBuffer(allocator, dev.device, depthFormat, scene.extent, scene.depth) != VK_SUCCESS)
+        return false;
+
+    VkAttachmentDescription attachmentDescs[2]{};
+    attachmentDescs[0].format = kColorFormat;
+    attachmentDescs[0].samples = VK_SAMPLE_COUNT_1_BIT;
+    attachmentDescs[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachmentDescs[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachmentDescs[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachmentDescs[0].finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    attachmentDescs[1].format = depthFormat;
+    attachmentDescs[1].samples = VK_SAMPLE_COUNT_1_BIT;
+    attachmentDescs[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachmentDescs[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachmentDescs[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachmentDescs[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachmentDescs[1].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachmentDescs[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference colorRef{};
+    colorRef.attachment = 0;
+    colorRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference depthRef{};
+    depthRef.attachment = 1;
+    depthRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorRef;
+    subpass.pDepthStencilAttachment = &depthRef;
+
+    VkRenderPassCreateInfo rpCI{ VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
+    rpCI.attachmentCount = 2;
+    rpCI.pAttachments = attachmentDescs;
+    rpCI.subpassCount = 1;
+    rpCI.pSubpasses = &subpass;
+    vkCreateRenderPass(dev.device, &rpCI, nullptr, &scene.renderPass);
+
+    const VkImageView fbViews[2] = { scene.color.view, scene.depth.view };
+    VkFramebufferCreateInfo fbCI{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
+    fbCI.renderPass = scene.renderPass;
+    fbCI.attachmentCount = 2;
+    fbCI.pAttachments = fbViews;
+    fbCI.width = scene.extent.width;
+    fbCI.height = scene.extent.height;
+    fbCI.layers = 1;
+    vkCreateFramebuffer(dev.device, &fbCI, nullptr, &scene.framebuffer);
+
+    // A quad covering the whole viewport (the layer's mvp only sets its depth), facing the light.
+    const Vertex vertices[6] = {
+        { { -1.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+        { {  1.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+        { {  1.0f,  1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+        { { -1.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+        { {  1.0f,  1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+        { { -1.0f,  1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+    };
+    VkBufferCreateInfo vbCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    vbCI.size = sizeof(vertices);
+    vbCI.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    vbCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (VgtCreateBuffer(allocator, vbCI, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, scene.vertexBuffer,
+            scene.vertexAlloc) != VK_SUCCESS)
+        return false;
+    std::memcpy(scene.vertexAlloc.mapped, vertices, sizeof(vertices));
+
+    if (VgtCreateUniformRing(allocator, sizeof(UniformBufferObject), maxLayers, 1, scene.uniformRing) != VK_SUCCESS)
+        return false;
+
+    VkDescriptorSetLayoutBinding uboBinding{};
+    uboBinding.binding = 0;
+    uboBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    uboBinding.descriptorCount = 1;
+    uboBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo descLayoutCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    descLayoutCI.bindingCount = 1;
+    descLayoutCI.pBindings = &uboBinding;
+    vkCreateDescriptorSetLayout(dev.device, &descLayoutCI, nullptr, &scene.descLayout);
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSize.descriptorCount = 1;
+
+    VkDescriptorPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolCI.poolSizeCount = 1;
+    poolCI.pPoolSizes = &poolSize;
+    poolCI.maxSets = 1;
+    vkCreateDescriptorPool(dev.device, &poolCI, nullptr, &scene.descPool);
+
+    VkDescriptorSetAllocateInfo descAI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    descAI.descriptorPool = scene.descPool;
+    descAI.descriptorSetCount = 1;
+    descAI.pSetLayouts = &scene.descLayout;
+    vkAllocateDescriptorSets(dev.device, &descAI, &scene.descSet);
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = scene.uniformRing.buffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = sizeof(UniformBufferObject);
+
+    VkWriteDescriptorSet descWrite{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    descWrite.dstSet = scene.descSet;
+    descWrite.dstBinding = 0;
+    descWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    descWrite.descriptorCount = 1;
+    descWrite.pBufferInfo = &bufferInfo;
+    vkUpdateDescriptorSets(dev.device, 1, &descWrite, 0, nullptr);
+
+    VkPipelineLayoutCreateInfo plCI{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    plCI.setLayoutCount = 1;
+    plCI.pSetLayouts = &scene.descLayout;
+    vkCreatePipelineLayout(dev.device, &plCI, nullptr, &scene.pipelineLayout);
+
+    return CreatePipelines(dev, scene);
+}
+
+static void DestroyBenchScene(const VgtBenchDevice& dev, VgtAllocator& allocator, BenchScene& scene)
+{
+    vkDestroyPipeline(dev.device, scene.equalPipeline, nullptr);
+    vkDestroyPipeline(dev.device, scene.prepassPipeline, nullptr);
+    vkDestroyPipeline(dev.device, scene.depthPipeline, nullptr);
+    vkDestroyPipeline(dev.device, scene.noDepthPipeline, nullptr);
+    vkDestroyPipelineLayout(dev.device, scene.pipelineLayout, nullptr);
+    vkDestroyDescriptorPool(dev.device, scene.descPool, nullptr);
+    vkDestroyDescriptorSetLayout(dev.device, scene.descLayout, nullptr);
+    if (scene.uniformRing.buffer)
+        VgtDestroyUniformRing(allocator, scene.uniformRing);
+    if (scene.vertexBuffer)
+        VgtDestroyBuffer(allocator, scene.vertexBuffer, scene.vertexAlloc);
+    vkDestroyFramebuffer(dev.device, scene.framebuffer, nullptr);
+    vkDestroyRenderPass(dev.device, scene.renderPass, nullptr);
+    VgtDestroyDepthBuffer(allocator, dev.device, scene.depth);
+    VgtDestroyBenchColorTarget(allocator, dev.device, scene.color);
+    scene = BenchScene{};
+}
+
+// Writes one UBO per layer. Layer 0 is the farthest: depth 0.9 down to 0.1 for the front layer
+// (mirrored with reverse-Z), set directly as clip-space z of the full-screen quad.
+static bool WriteLayerUniforms(BenchScene& scene, uint32_t layerCount, uint32_t& uboBase, VkDeviceSize& uboStride)
+{
+    uboStride = VgtUniformRingAlign(scene.uniformRing, sizeof(UniformBufferObject));
+    VgtUniformRingBeginFrame(scene.uniformRing, 0);
+    auto* uboData = static_cast<uint8_t*>(VgtUniformRingAllocate(scene.uniformRing, uboStride * layerCount, uboBase));
+    if (uboData == nullptr)
+        return false;
+    for (uint32_t layer = 0; layer < layerCount; ++layer)
+    {
+        const float t = layerCount > 1 ? static_cast<float>(layer) / static_cast<float>(layerCount - 1) : 0.0f;
+        const float depth = 0.9f - 0.8f * t;
+
+        UniformBufferObject ubo{};
+        ubo.mvp = VgtMat4Identity();
+        ubo.mvp.m[14] = scene.reverseZ ? 1.0f - depth : depth; // row vectors: z' = z + m[14], and the quad has z = 0
+        ubo.modelView = VgtMat4Identity();
+        ubo.normalMatrix = VgtMat4Identity();
+        ubo.lightDir[0] = 0.5f;
+        ubo.lightDir[1] = -0.5f;
+        ubo.lightDir[2] = -1.0f;
+        std::memcpy(uboData + layer * uboStride, &ubo, sizeof(ubo));
+    }
+    return true;
+}
+
+static void DrawLayers(const BenchScene& scene, VkCommandBuffer cmd, VkPipeline pipeline, uint32_t layerCount, bool frontToBack,
+    uint32_t uboBase, VkDeviceSize uboStride)
+{
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    for (uint32_t i = 0; i < layerCount; ++i)
+    {
+        const uint32_t layer = frontToBack ? layerCount - 1 - i : i;
+        const uint32_t uboOffset = uboBase + static_cast<uint32_t>(layer * uboStride);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, scene.pipelineLayout, 0, 1, &scene.descSet, 1, &uboOffset);
+        vkCmdDraw(cmd, 6, 1, 0, 0);
+    }
+}
+
+// Query pool layout: timestamps 0/1 around the render pass; the statistics pool holds one query.
+static void RecordFrame(const BenchScene& scene, VkCommandBuffer cmd, VkQueryPool timestampPool, VkQueryPool statsPool, DepthMode mode,
+    uint32_t layerCount, uint32_t uboBase, VkDeviceSize uboStride)
+{
+    vkResetCommandBuffer(cmd, 0);
+
+    VkCommandBufferBeginInfo begin{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    vkBeginCommandBuffer(cmd, &begin);
+    if (timestampPool)
+        vkCmdResetQueryPool(cmd, timestampPool, 0, 2);
+    if (statsPool)
+        vkCmdResetQueryPool(cmd, statsPool, 0, 1);
+
+    VkClearValue clears[2]{};
+    clears[1].depthStencil.depth = VgtDepthClearValue(scene.reverseZ);
+
+    VkRenderPassBeginInfo rpBegin{ VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
+    rpBegin.renderPass = scene.renderPass;
+    rpBegin.framebuffer = scene.framebuffer;
+    rpBegin.renderArea.extent = scene.extent;
+    rpBegin.clearValueCount = 2;
+    rpBegin.pClearValues = clears;
+
+    if (timestampPool)
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestampPool, 0);
+    if (statsPool)
+        vkCmdBeginQuery(cmd, statsPool, 0, 0);
+    vkCmdBeginRenderPass(cmd, &rpBegin, VK_SUBPASS_CONTENTS_INLINE);
+
+    VkViewport viewport{};
+    viewport.width = static_cast<float>(scene.extent.width);
+    viewport.height = static_cast<float>(scene.extent.height);
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.extent = scene.extent;
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(cmd, 0, 1, &scene.vertexBuffer, &offset);
+
+    switch (mode)
+    {
+    case DepthMode::None:
+        DrawLayers(scene, cmd, scene.noDepthPipeline, layerCount, false, uboBase, uboStride);
+        break;
+    case DepthMode::BackToFront:
+        DrawLayers(scene, cmd, scene.depthPipeline, layerCount, false, uboBase, uboStride);
+        break;
+    case DepthMode::FrontToBack:
+        DrawLayers(scene, cmd, scene.depthPipeline, layerCount, true, uboBase, uboStride);
+        break;
+    case DepthMode::Prepass:
+        DrawLayers(scene, cmd, scene.prepassPipeline, layerCount, false, uboBase, uboStride);
+        DrawLayers(scene, cmd, scene.equalPipeline, layerCount, false, uboBase, uboStride);
+        break;
+    }
+
+    vkCmdEndRenderPass(cmd);
+    if (statsPool)
+        vkCmdEndQuery(cmd, statsPool, 0);
+    if (timestampPool)
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampPool, 1);
+    vkEndCommandBuffer(cmd);
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<uint32_t> layerCounts = { 1, 4, 16, 64 };
+    uint32_t size = 1024;
+    uint32_t rounds = 20;
+    bool reverseZ = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--layers") == 0 && i + 1 < argc && VgtParseBenchCounts(argv[i + 1], layerCounts))
+            ++i;
+        else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+            size = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+            rounds = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--reverse-z") == 0)
+            reverseZ = true;
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--layers N[,N...]] [--size N] [--rounds N] [--reverse-z]\n", argv[0]);
+            return 1;
+        }
+    }
+    size = std::clamp(size, 16u, 8192u);
+    rounds = std::max(rounds, 1u);
+
+    VgtBenchDeviceCreateInfo deviceCI{};
+    deviceCI.appName = "DepthBench";
+    deviceCI.pipelineStatistics = true; // fragment invocations per pixel, when supported
+    VgtBenchDevice dev;
+    if (!VgtCreateBenchDevice(deviceCI, dev))
+    {
+        std::fprintf(stderr, "Failed to create a Vulkan device\n");
+        VgtDestroyBenchDevice(dev);
+        return 1;
+    }
+    if (!dev.timestamps)
+    {
+        std::fprintf(stderr, "The graphics queue does not support timestamps; nothing to measure\n");
+        VgtDestroyBenchDevice(dev);
+        return 1;
+    }
+
+    VgtAllocatorCreateInfo allocatorCI{};
+    allocatorCI.physicalDevice = dev.physicalDevice;
+    allocatorCI.device = dev.device;
+    VgtAllocator allocator;
+    VgtCreateAllocator(allocatorCI, allocator);
+
+    const uint32_t maxLayers = *std::max_element(layerCounts.begin(), layerCounts.end());
+    BenchScene scene;
+    scene.extent = { size, size };
+    scene.reverseZ = reverseZ;
+    if (!CreateBenchScene(dev, allocator, maxLayers, scene))
+    {
+        std::fprintf(stderr, "Failed to create the Step05 pipelines and resources\n");
+        DestroyBenchScene(dev, allocator, scene);
+        VgtDestroyAllocator(allocator);
+        VgtDestroyBenchDevice(dev);
+        return 1;
+    }
+
+    VkQueryPoolCreateInfo timestampCI{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+    timestampCI.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    timestampCI.queryCount = 2;
+    VkQueryPool timestampPool = VK_NULL_HANDLE;
+    vkCreateQueryPool(dev.device, &timestampCI, nullptr, &timestampPool);
+
+    VkQueryPool statsPool = VK_NULL_HANDLE;
+    if (dev.pipelineStatistics)
+    {
+        VkQueryPoolCreateInfo statsCI{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+        statsCI.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        statsCI.queryCount = 1;
+        statsCI.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+        vkCreateQueryPool(dev.device, &statsCI, nullptr, &statsPool);
+    }
+
+    VkCommandPoolCreateInfo cmdPoolCI{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    cmdPoolCI.queueFamilyIndex = dev.queueFamily;
+    cmdPoolCI.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    VkCommandPool cmdPool = VK_NULL_HANDLE;
+    vkCreateCommandPool(dev.device, &cmdPoolCI, nullptr, &cmdPool);
+
+    VkCommandBufferAllocateInfo cmdAI{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    cmdAI.commandPool = cmdPool;
+    cmdAI.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cmdAI.commandBufferCount = 1;
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+    vkAllocateCommandBuffers(dev.device, &cmdAI, &cmd);
+
+    VkFenceCreateInfo fenceCI{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    VkFence fence = VK_NULL_HANDLE;
+    vkCreateFence(dev.device, &fenceCI, nullptr, &fence);
+
+    const double pixels = static_cast<double>(size) * size;
+    std::printf("device: %s\n", dev.props.deviceName);
+    std::printf("target: %ux%u, depth format %d%s, %u round(s), best round reported\n", size, size, static_cast<int>(scene.depth.format),
+        reverseZ ? " (reverse-Z)" : "", rounds);
+    std::printf("%8s  %14s  %9s  %9s  %9s\n", "layers", "mode", "gpu ms", "speedup", "frag/px");
+
+    const DepthMode modes[] = { DepthMode::None, DepthMode::BackToFront, DepthMode::FrontToBack, DepthMode::Prepass };
+    bool ok = true;
+    for (uint32_t layerCount : layerCounts)
+    {
+        uint32_t uboBase = 0;
+        VkDeviceSize uboStride = 0;
+        if (!WriteLayerUniforms(scene, layerCount, uboBase, uboStride))
+        {
+            std::fprintf(stderr, "layers=%u: uniform ring too small\n", layerCount);
+            ok = false;
+            break;
+        }
+
+        double baselineMs = 0.0;
+        for (DepthMode mode : modes)
+        {
+            RecordFrame(scene, cmd, timestampPool, statsPool, mode, layerCount, uboBase, uboStride);
+
+            double best = 1e30;
+            uint64_t fragInvocations = 0;
+            VkResult res = VK_SUCCESS;
+            for (uint32_t r = 0; r < rounds && res == VK_SUCCESS; ++r)
+            {
+                res = VgtBenchSubmitAndWait(dev, cmd, fence);
+                uint64_t ticks[2] = {};
+                if (res == VK_SUCCESS)
+                    res = vkGetQueryPoolResults(dev.device, timestampPool, 0, 2, sizeof(ticks), ticks, sizeof(uint64_t),
+                        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+                if (res == VK_SUCCESS && statsPool)
+                    res = vkGetQueryPoolResults(dev.device, statsPool, 0, 1, sizeof(fragInvocations), &fragInvocations, sizeof(uint64_t),
+                        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+                if (res == VK_SUCCESS)
+                    best = std::min(best, static_cast<double>(ticks[1] - ticks[0]) * dev.props.limits.timestampPeriod * 1e-6);
+            }
+            if (res != VK_SUCCESS)
+            {
+                std::fprintf(stderr, "layers=%u mode=%s failed: VkResult=%d\n", layerCount, DepthModeName(mode), static_cast<int>(res));
+                ok = false;
+                break;
+            }
+
+            if (mode == DepthMode::None)
+                baselineMs = best;
+            char fragPerPixel[16] = "n/a";
+            if (statsPool)
+                std::snprintf(fragPerPixel, sizeof(fragPerPixel), "%.2f", static_cast<double>(fragInvocations) / pixels);
+            std::printf("%8u  %14s  %9.3f  %8.2fx  %9s\n", layerCount, DepthModeName(mode), best, best > 0.0 ? baselineMs / best : 0.0,
+                fragPerPixel);
+        }
+        if (!ok)
+            break;
+    }
+
+    vkDestroyFence(dev.device, fence, nullptr);
+    vkDestroyCommandPool(dev.device, cmdPool, nullptr);
+    if (statsPool)
+        vkDestroyQueryPool(dev.device, statsPool, nullptr);
+    vkDestroyQueryPool(dev.device, timestampPool, nullptr);
+    DestroyBenchScene(dev, allocator, scene);
+    VgtDestroyAllocator(allocator);
+    VgtDestroyBenchDevice(dev);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+// Times VgtMath's 4x4 multiplies against the scalar Mat4Multiply the steps used before.
+//
+// Usage: MathBench [--count N] [--rounds N]
+//
+// Times single multiplies over N random matrices, then N matrices times one shared matrix (the
+// per-object model * view-projection case) as a loop over VgtMat4Mul and as VgtMat4MulBatch.
+// That the results match the old helpers is checked by tests/VgtMathTest (CTest), not here.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <VgtMath.h>
+
+using Clock = std::chrono::steady_clock;
+
+// --- former per-step helper (Step05_LightingBasic), kept verbatim as the scalar baseline ----
+
+static void Mat4Multiply(float* out, const float* a, const float* b)
+{
+    float temp[16];
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int col = 0; col < 4; ++col)
+        {
+            temp[row * 4 + col] = 0.0f;
+            for (int k = 0; k < 4; ++k)
+            {
+                temp[row * 4 + col] += a[row * 4 + k] * b[k * 4 + col];
+            }
+        }
+    }
+    std::memcpy(out, temp, sizeof(temp));
+}
+
+// --- timing ------------------------------------------------------------------------------
+
+static float Checksum(const std::vector<VgtMat4>& v)
+{
+    float sum = 0.0f;
+    for (const auto& m : v)
+        sum += m.m[0] + m.m[15];
+    return sum;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t count = 4096;
+    uint32_t rounds = 200;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+            count = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+            rounds = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--count N] [--rounds N]\n", argv[0]);
+            return 1;
+        }
+    }
+    count = std::max(count, 1u);
+    rounds = std::max(rounds, 1u);
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+    std::vector<VgtMat4> a(count), b(count), out(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        for (int k = 0; k < 16; ++k)
+        {
+            a[i].m[k] = value(rng);
+            b[i].m[k] = value(rng);
+        }
+    }
+
+    std::printf("kernel: %s\n", VGT_MATH_KERNEL);
+    std::printf("matrices: %u per round, %u round(s)\n", count, rounds);
+
+    double bestLegacy = 1e30;
+    double bestSingle = 1e30;
+    double bestSharedLoop = 1e30;
+    double bestBatch = 1e30;
+    float sink = 0.0f;
+    for (uint32_t r = 0; r < rounds; ++r)
+    {
+        auto t0 = Clock::now();
+        for (uint32_t i = 0; i < count; ++i)
+            Mat4Multiply(out[i].m, a[i].m, b[i].m);
+        bestLegacy = std::min(bestLegacy, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+        sink += Checksum(out);
+
+        t0 = Clock::now();
+        for (uint32_t i = 0; i < count; ++i)
+            out[i] = VgtMat4Mul(a[i], b[i]);
+        bestSingle = std::min(bestSingle, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+        sink += Checksum(out);
+
+        // Shared right-hand side: b[0] stands in for a view-projection read through a reference.
+        const VgtMat4& shared = b[0];
+        t0 = Clock::now();
+        for (uint32_t i = 0; i < count; ++i)
+            out[i] = VgtMat4Mul(a[i], shared);
+        bestSharedLoop = std::min(bestSharedLoop, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+        sink += Checksum(out);
+
+        t0 = Clock::now();
+        VgtMat4MulBatch(out.data(), a.data(), shared, count);
+        bestBatch = std::min(bestBatch, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+        sink += Checksum(out);
+    }
+
+    const double toNs = 1e6 / count;
+    std::printf("scalar Mat4Multiply : %8.3f ms (%.2f ns/matrix)\n", bestLegacy, bestLegacy * toNs);
+    std::printf("VgtMat4Mul          : %8.3f ms (%.2f ns/matrix)\n", bestSingle, bestSingle * toNs);
+    if (bestSingle > 0.0)
+        std::printf("speedup (VgtMat4Mul vs scalar): %.2fx\n", bestLegacy / bestSingle);
+    std::printf("shared b, VgtMat4Mul loop : %8.3f ms (%.2f ns/matrix)\n", bestSharedLoop, bestSharedLoop * toNs);
+    std::printf("shared b, VgtMat4MulBatch : %8.3f ms (%.2f ns/matrix)\n", bestBatch, bestBatch * toNs);
+    if (bestBatch > 0.0)
+        std::printf("speedup (batch vs loop): %.2fx\n", bestSharedLoop / bestBatch);
+    std::printf("(checksum %g)\n", static_cast<double>(sink));
+    return 0;
+}
@@ -0,0 +1,490 @@
+// Measures how command buffer recording scales with threads on the Step04_Transform pipeline.
+//
+// Usage: RecordBench [--draws N[,N...]] [--threads N] [--rounds N]
+//
+// Every draw binds its own UBO slice with a dynamic offset and draws the Step04 triangle, like
+// `Step04_Transform --draws N`. For each draw count one frame is recorded
+//   - inline into the primary command buffer (the single-threaded baseline), then
+//   - into secondary command buffers on 1..N threads (VgtParallelRecorder),
+// and the best of --rounds is reported. The last recording of each configuration is submitted
+// once (untimed) to a small offscreen image, so a broken command buffer fails loudly instead of
+// producing a fast number.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include <VgtAllocator.h>
+#include <VgtBenchDevice.h>
+#include <VgtMath.h>
+#include <VgtParallelRecorder.h>
+#include <VgtSpirv.h>
+#include <VgtUniformRing.h>
+
+using Clock = std::chrono::steady_clock;
+
+constexpr VkFormat kColorFormat = VK_FORMAT_R8G8B8A8_UNORM;
+constexpr VkExtent2D kExtent = { 256, 256 };
+
+struct Vertex
+{
+    float pos[3];
+    float color[3];
+};
+
+// Everything Step04_Transform needs to draw, rendering into one offscreen image.
+struct BenchScene
+{
+    VgtBenchColorTarget color;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+
+    VkBuffer vertexBuffer = VK_NULL_HANDLE;
+    VgtAllocation vertexAlloc;
+    VgtUniformRing uniformRing;
+
+    VkDescriptorSetLayout descLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descPool = VK_NULL_HANDLE;
+    VkDescriptorSet descSet = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+};
+
+static bool CreatePipeline(const VgtBenchDevice& dev, BenchScene& scene)
+{
+    const auto vertSpv = VgtLoadSpirv("transform.vert.spv", false);
+    const auto fragSpv = VgtLoadSpirv("transform.frag.spv", false);
+    if (vertSpv.empty() || fragSpv.empty())
+    {
+        std::fprintf(stderr, "Failed to load transform.vert.spv / transform.frag.spv\n");
+        return false;
+    }
+
+    VkShaderModuleCreateInfo smVertCI{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    smVertCI.codeSize = vertSpv.size() * sizeof(uint32_t);
+    smVertCI.pCode = vertSpv.data();
+    VkShaderModule vertModule = VK_NULL_HANDLE;
+    vkCreateShaderModule(dev.device, &smVertCI, nullptr, &vertModule);
+
+    VkShaderModuleCreateInfo smFragCI{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    smFragCI.codeSize = fragSpv.size() * sizeof(uint32_t);
+    smFragCI.pCode = fragSpv.data();
+    VkShaderModule fragModule = VK_NULL_HANDLE;
+    vkCreateShaderModule(dev.device, &smFragCI, nullptr, &fragModule);
+
+    VkPipelineShaderStageCreateInfo stages[2]{};
+    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stages[0].module = vertModule;
+    stages[0].pName = "main";
+    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    stages[1].module = fragModule;
+    stages[1].pName = "main";
+
+    VkVertexInputBindingDescription binding{};
+    binding.binding = 0;
+    binding.stride = sizeof(Vertex);
+    binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    VkVertexInputAttributeDescription attrs[2]{};
+    attrs[0].location = 0;
+    attrs[0].binding = 0;
+    attrs[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attrs[0].offset = offsetof(Vertex, pos);
+    attrs[1].location = 1;
+    attrs[1].binding = 0;
+    attrs[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attrs[1].offset = offsetof(Vertex, color);
+
+    VkPipelineVertexInputStateCreateInfo vi{ VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
+    vi.vertexBindingDescriptionCount = 1;
+    vi.pVertexBindingDescriptions = &binding;
+    vi.vertexAttributeDescriptionCount = 2;
+    vi.pVertexAttributeDescriptions = attrs;
+
+    VkPipelineInputAssemblyStateCreateInfo ia{ VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO };
+    ia.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkPipelineViewportStateCreateInfo vp{ VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO };
+    vp.viewportCount = 1;
+    vp.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rs{ VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO };
+    rs.polygonMode = VK_POLYGON_MODE_FILL;
+    rs.cullMode = VK_CULL_MODE_NONE;
+    rs.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rs.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo ms{ VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
+    ms.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineColorBlendAttachmentState cbAttach{};
+    cbAttach.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    VkPipelineColorBlendStateCreateInfo cb{ VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
+    cb.attachmentCount = 1;
+    cb.pAttachments = &cbAttach;
+
+    VkDynamicState dynStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dyn{ VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
+    dyn.dynamicStateCount = 2;
+    dyn.pDynamicStates = dynStates;
+
+    VkGraphicsPipelineCreateInfo gpCI{ VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
+    gpCI.stageCount = 2;
+    gpCI.pStages = stages;
+    gpCI.pVertexInputState = &vi;
+    gpCI.pInputAssemblyState = &ia;
+    gpCI.pViewportState = &vp;
+    gpCI.pRasterizationState = &rs;
+    gpCI.pMultisampleState = &ms;
+    gpCI.pColorBlendState = &cb;
+    gpCI.pDynamicState = &dyn;
+    gpCI.layout = scene.pipelineLayout;
+    gpCI.renderPass = scene.renderPass;
+
+    const VkResult res = vkCreateGraphicsPipelines(dev.device, VK_NULL_HANDLE, 1, &gpCI, nullptr, &scene.pipeline);
+    vkDestroyShaderModule(dev.device, fragModule, nullptr);
+    vkDestroyShaderModule(dev.device, vertModule, nullptr);
+    return res == VK_SUCCESS;
+}
+
+static bool CreateBenchScene(const VgtBenchDevice& dev, VgtAllocator& allocator, uint32_t maxDraws, BenchScene& scene)
+{
+    if (VgtCreateBenchColorTarget(allocator, dev.device, kColorFormat, kExtent, scene.color) != VK_SUCCESS)
+        return false;
+
+    VkAttachmentDescription colorAttachment{};
+    colorAttachment.format = kColorFormat;
+    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference colorRef{};
+    colorRef.attachment = 0;
+    colorRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorRef;
+
+    VkRenderPassCreateInfo rpCI{ VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
+    rpCI.attachmentCount = 1;
+    rpCI.pAttachments = &colorAttachment;
+    rpCI.subpassCount = 1;
+    rpCI.pSubpasses = &subpass;
+    vkCreateRenderPass(dev.device, &rpCI, nullptr, &scene.renderPass);
+
+    VkFramebufferCreateInfo fbCI{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
+    fbCI.renderPass = scene.renderPass;
+    fbCI.attachmentCount = 1;
+    fbCI.pAttachments = &scene.color.view;
+    fbCI.width = kExtent.width;
+    fbCI.height = kExtent.height;
+    fbCI.layers = 1;
+    vkCreateFramebuffer(dev.device, &fbCI, nullptr, &scene.framebuffer);
+
+    // The Step04 triangle, in host-visible memory (upload speed is not what is measured here).
+    const Vertex vertices[3] = {
+        { {  0.0f, -0.5f, 0.0f }, { 1.0f, 0.0f, 0.0f } },
+        { {  0.5f,  0.5f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+        { { -0.5f,  0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+    };
+    VkBufferCreateInfo vbCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    vbCI.size = sizeof(vertices);
+    vbCI.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    vbCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (VgtCreateBuffer(allocator, vbCI, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, scene.vertexBuffer,
+            scene.vertexAlloc) != VK_SUCCESS)
+        return false;
+    std::memcpy(scene.vertexAlloc.mapped, vertices, sizeof(vertices));
+
+    if (VgtCreateUniformRing(allocator, sizeof(VgtMat4), maxDraws, 1, scene.uniformRing) != VK_SUCCESS)
+        return false;
+
+    VkDescriptorSetLayoutBinding uboBinding{};
+    uboBinding.binding = 0;
+    uboBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    uboBinding.descriptorCount = 1;
+    uboBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutCreateInfo descLayoutCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    descLayoutCI.bindingCount = 1;
+    descLayoutCI.pBindings = &uboBinding;
+    vkCreateDescriptorSetLayout(dev.device, &descLayoutCI, nullptr, &scene.descLayout);
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSize.descriptorCount = 1;
+
+    VkDescriptorPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolCI.poolSizeCount = 1;
+    poolCI.pPoolSizes = &poolSize;
+    poolCI.maxSets = 1;
+    vkCreateDescriptorPool(dev.device, &poolCI, nullptr, &scene.descPool);
+
+    VkDescriptorSetAllocateInfo descAI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    descAI.descriptorPool = scene.descPool;
+    descAI.descriptorSetCount = 1;
+    descAI.pSetLayouts = &scene.descLayout;
+    vkAllocateDescriptorSets(dev.device, &descAI, &scene.descSet);
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = scene.uniformRing.buffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = sizeof(VgtMat4);
+
+    VkWriteDescriptorSet descWrite{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    descWrite.dstSet = scene.descSet;
+    descWrite.dstBinding = 0;
+    descWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    descWrite.descriptorCount = 1;
+    descWrite.pBufferInfo = &bufferInfo;
+    vkUpdateDescriptorSets(dev.device, 1, &descWrite, 0, nullptr);
+
+    VkPipelineLayoutCreateInfo plCI{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    plCI.setLayoutCount = 1;
+    plCI.pSetLayouts = &scene.descLayout;
+    vkCreatePipelineLayout(dev.device, &plCI, nullptr, &scene.pipelineLayout);
+
+    return CreatePipeline(dev, scene);
+}
+
+static void DestroyBenchScene(const VgtBenchDevice& dev, VgtAllocator& allocator, BenchScene& scene)
+{
+    vkDestroyPipeline(dev.device, scene.pipeline, nullptr);
+    vkDestroyPipelineLayout(dev.device, scene.pipelineLayout, nullptr);
+    vkDestroyDescriptorPool(dev.device, scene.descPool, nullptr);
+    vkDestroyDescriptorSetLayout(dev.device, scene.descLayout, nullptr);
+    if (scene.uniformRing.buffer)
+        VgtDestroyUniformRing(allocator, scene.uniformRing);
+    if (scene.vertexBuffer)
+        VgtDestroyBuffer(allocator, scene.vertexBuffer, scene.vertexAlloc);
+    vkDestroyFramebuffer(dev.device, scene.framebuffer, nullptr);
+    vkDestroyRenderPass(dev.device, scene.renderPass, nullptr);
+    VgtDestroyBenchColorTarget(allocator, dev.device, scene.color);
+    scene = BenchScene{};
+}
+
+// Per-draw work of Step04_Transform: dynamic UBO offset + draw. The UBOs are written once per
+// draw count, so only the recording itself is timed.
+static void RecordDraws(const BenchScene& scene, uint32_t uboBase, VkDeviceSize uboStride, VkCommandBuffer cmd, uint32_t first,
+    uint32_t count)
+{
+    VkViewport viewport{};
+    viewport.width = static_cast<float>(kExtent.width);
+    viewport.height = static_cast<float>(kExtent.height);
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.extent = kExtent;
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, scene.pipeline);
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(cmd, 0, 1, &scene.vertexBuffer, &offset);
+
+    for (uint32_t i = first; i < first + count; ++i)
+    {
+        const uint32_t uboOffset = uboBase + static_cast<uint32_t>(i * uboStride);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, scene.pipelineLayout, 0, 1, &scene.descSet, 1, &uboOffset);
+        vkCmdDraw(cmd, 3, 1, 0, 0);
+    }
+}
+
+// Records one frame into `primary`: inline without a recorder, otherwise into its secondary buffers.
+static VkResult RecordFrame(const BenchScene& scene, VgtParallelRecorder* recorder, VkCommandBuffer primary, uint32_t drawCount,
+    uint32_t uboBase, VkDeviceSize uboStride)
+{
+    vkResetCommandBuffer(primary, 0);
+
+    VkCommandBufferBeginInfo begin{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(primary, &begin);
+
+    VkClearValue clear{};
+    VkRenderPassBeginInfo rpBegin{ VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
+    rpBegin.renderPass = scene.renderPass;
+    rpBegin.framebuffer = scene.framebuffer;
+    rpBegin.renderArea.extent = kExtent;
+    rpBegin.clearValueCount = 1;
+    rpBegin.pClearValues = &clear;
+
+    VkResult res = VK_SUCCESS;
+    if (recorder)
+    {
+        vkCmdBeginRenderPass(primary, &rpBegin, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        res = VgtRecordParallel(*recorder, 0, primary, scene.renderPass, scene.framebuffer, drawCount,
+            [&](VkCommandBuffer cmd, uint32_t first, uint32_t count) { RecordDraws(scene, uboBase, uboStride, cmd, first, count); });
+    }
+    else
+    {
+        vkCmdBeginRenderPass(primary, &rpBegin, VK_SUBPASS_CONTENTS_INLINE);
+        RecordDraws(scene, uboBase, uboStride, primary, 0, drawCount);
+    }
+
+    vkCmdEndRenderPass(primary);
+    const VkResult endRes = vkEndCommandBuffer(primary);
+    return res != VK_SUCCESS ? res : endRes;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<uint32_t> drawCounts = { 10000, 25000, 50000, 100000 };
+    uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    uint32_t rounds = 10;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--draws") == 0 && i + 1 < argc && VgtParseBenchCounts(argv[i + 1], drawCounts))
+            ++i;
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            maxThreads = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+            rounds = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--draws N[,N...]] [--threads N] [--rounds N]\n", argv[0]);
+            return 1;
+        }
+    }
+    maxThreads = std::max(maxThreads, 1u);
+    rounds = std::max(rounds, 1u);
+
+    VgtBenchDeviceCreateInfo deviceCI{};
+    deviceCI.appName = "RecordBench";
+    VgtBenchDevice dev;
+    if (!VgtCreateBenchDevice(deviceCI, dev))
+    {
+        std::fprintf(stderr, "Failed to create a Vulkan device\n");
+        VgtDestroyBenchDevice(dev);
+        return 1;
+    }
+
+    VgtAllocatorCreateInfo allocatorCI{};
+    allocatorCI.physicalDevice = dev.physicalDevice;
+    allocatorCI.device = dev.device;
+    VgtAllocator allocator;
+    VgtCreateAllocator(allocatorCI, allocator);
+
+    const uint32_t maxDraws = *std::max_element(drawCounts.begin(), drawCounts.end());
+    BenchScene scene;
+    if (!CreateBenchScene(dev, allocator, maxDraws, scene))
+    {
+        std::fprintf(stderr, "Failed to create the Step04 pipeline and resources\n");
+        DestroyBenchScene(dev, allocator, scene);
+        VgtDestroyAllocator(allocator);
+        VgtDestroyBenchDevice(dev);
+        return 1;
+    }
+
+    VkCommandPoolCreateInfo cmdPoolCI{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    cmdPoolCI.queueFamilyIndex = dev.queueFamily;
+    cmdPoolCI.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    VkCommandPool cmdPool = VK_NULL_HANDLE;
+    vkCreateCommandPool(dev.device, &cmdPoolCI, nullptr, &cmdPool);
+
+    VkCommandBufferAllocateInfo cmdAI{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    cmdAI.commandPool = cmdPool;
+    cmdAI.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cmdAI.commandBufferCount = 1;
+    VkCommandBuffer primary = VK_NULL_HANDLE;
+    vkAllocateCommandBuffers(dev.device, &cmdAI, &primary);
+
+    VkFenceCreateInfo fenceCI{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    VkFence fence = VK_NULL_HANDLE;
+    vkCreateFence(dev.device, &fenceCI, nullptr, &fence);
+
+    std::printf("device: %s\n", dev.props.deviceName);
+    std::printf("threads: 1..%u, %u round(s), best round reported\n", maxThreads, rounds);
+    std::printf("%8s  %8s  %10s  %9s  %8s\n", "draws", "threads", "record ms", "ns/draw", "speedup");
+
+    const VkDeviceSize uboStride = VgtUniformRingAlign(scene.uniformRing, sizeof(VgtMat4));
+    bool ok = true;
+    for (uint32_t drawCount : drawCounts)
+    {
+        // A small grid of copies of the triangle, so the submitted frame is not all overdraw.
+        VgtUniformRingBeginFrame(scene.uniformRing, 0);
+        uint32_t uboBase = 0;
+        auto* uboData = static_cast<uint8_t*>(VgtUniformRingAllocate(scene.uniformRing, uboStride * drawCount, uboBase));
+        if (uboData == nullptr)
+        {
+            std::fprintf(stderr, "draws=%u: uniform ring too small\n", drawCount);
+            ok = false;
+            break;
+        }
+        for (uint32_t i = 0; i < drawCount; ++i)
+        {
+            VgtMat4 mvp = VgtMat4Identity();
+            mvp.m[0] = mvp.m[5] = 0.1f;
+            mvp.m[12] = -0.9f + 0.2f * static_cast<float>(i % 10); // row vectors: translation in the last row
+            mvp.m[13] = -0.9f + 0.2f * static_cast<float>((i / 10) % 10);
+            std::memcpy(uboData + i * uboStride, &mvp, sizeof(mvp));
+        }
+
+        double inlineMs = 0.0;
+        // threads == 0 is the inline baseline.
+        for (uint32_t threads = 0; threads <= maxThreads && ok; ++threads)
+        {
+            VgtParallelRecorder recorder;
+            if (threads != 0)
+            {
+                VgtParallelRecorderCreateInfo recorderCI{};
+                recorderCI.device = dev.device;
+                recorderCI.queueFamily = dev.queueFamily;
+                recorderCI.threadCount = threads;
+                recorderCI.framesInFlight = 1;
+                if (VgtCreateParallelRecorder(recorderCI, recorder) != VK_SUCCESS)
+                {
+                    std::fprintf(stderr, "VgtCreateParallelRecorder failed for %u thread(s)\n", threads);
+                    ok = false;
+                    break;
+                }
+            }
+
+            double best = 1e30;
+            VkResult res = VK_SUCCESS;
+            for (uint32_t r = 0; r < rounds && res == VK_SUCCESS; ++r)
+            {
+                const auto t0 = Clock::now();
+                res = RecordFrame(scene, threads != 0 ? &recorder : nullptr, primary, drawCount, uboBase, uboStride);
+                best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+            }
+            if (res == VK_SUCCESS)
+                res = VgtBenchSubmitAndWait(dev, primary, fence);
+            VgtDestroyParallelRecorder(recorder);
+
+            if (res != VK_SUCCESS)
+            {
+                std::fprintf(stderr, "draws=%u threads=%u failed: VkResult=%d\n", drawCount, threads, static_cast<int>(res));
+                ok = false;
+                break;
+            }
+
+            if (threads == 0)
+                inlineMs = best;
+            char label[16] = "inline";
+            if (threads != 0)
+                std::snprintf(label, sizeof(label), "%u", threads);
+            std::printf("%8u  %8s  %10.3f  %9.1f  %7.2fx\n", drawCount, label, best, best * 1e6 / drawCount, best > 0.0 ? inlineMs / best : 0.0);
+        }
+    }
+
+    vkDestroyFence(dev.device, fence, nullptr);
+    vkDestroyCommandPool(dev.device, cmdPool, nullptr);
+    DestroyBenchScene(dev, allocator, scene);
+    VgtDestroyAllocator(allocator);
+    VgtDestroyBenchDevice(dev);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+#include "VgtBenchDevice.h"
+
+#include <cstdlib>
+
+bool VgtCreateBenchDevice(const VgtBenchDeviceCreateInfo& ci, VgtBenchDevice& dev)
+{
+    dev = VgtBenchDevice{};
+
+    VkApplicationInfo appInfo{ VK_STRUCTURE_TYPE_APPLICATION_INFO };
+    appInfo.pApplicationName = ci.appName;
+    appInfo.apiVersion = VK_API_VERSION_1_3;
+
+    VkInstanceCreateInfo instanceCI{ VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO };
+    instanceCI.pApplicationInfo = &appInfo;
+    if (vkCreateInstance(&instanceCI, nullptr, &dev.instance) != VK_SUCCESS)
+        return false;
+
+    uint32_t gpuCount = 0;
+    vkEnumeratePhysicalDevices(dev.instance, &gpuCount, nullptr);
+    if (gpuCount == 0)
+        return false;
+    std::vector<VkPhysicalDevice> gpus(gpuCount);
+    vkEnumeratePhysicalDevices(dev.instance, &gpuCount, gpus.data());
+    dev.physicalDevice = gpus[0];
+    vkGetPhysicalDeviceProperties(dev.physicalDevice, &dev.props);
+    vkGetPhysicalDeviceMemoryProperties(dev.physicalDevice, &dev.memProps);
+
+    uint32_t qCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(dev.physicalDevice, &qCount, nullptr);
+    std::vector<VkQueueFamilyProperties> qProps(qCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(dev.physicalDevice, &qCount, qProps.data());
+    for (uint32_t i = 0; i < qCount && dev.queueFamily == UINT32_MAX; ++i)
+    {
+        if ((qProps[i].queueFlags & ci.queueFlags) == ci.queueFlags)
+            dev.queueFamily = i;
+    }
+    if (dev.queueFamily == UINT32_MAX)
+        return false;
+    dev.timestamps = qProps[dev.queueFamily].timestampValidBits != 0 && dev.props.limits.timestampPeriod > 0.0f;
+
+    VkPhysicalDeviceFeatures supported{};
+    vkGetPhysicalDeviceFeatures(dev.physicalDevice, &supported);
+    VkPhysicalDeviceFeatures enabled{};
+    if (ci.pipelineStatistics)
+        enabled.pipelineStatisticsQuery = supported.pipelineStatisticsQuery;
+    dev.pipelineStatistics = enabled.pipelineStatisticsQuery == VK_TRUE;
+
+    float qPriority = 1.0f;
+    VkDeviceQueueCreateInfo qci{ VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
+    qci.queueFamilyIndex = dev.queueFamily;
+    qci.queueCount = 1;
+    qci.pQueuePriorities = &qPriority;
+
+    VkDeviceCreateInfo deviceCI{ VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
+    deviceCI.queueCreateInfoCount = 1;
+    deviceCI.pQueueCreateInfos = &qci;
+    deviceCI.pEnabledFeatures = &enabled;
+    if (vkCreateDevice(dev.physicalDevice, &deviceCI, nullptr, &dev.device) != VK_SUCCESS)
+        return false;
+
+    vkGetDeviceQueue(dev.device, dev.queueFamily, 0, &dev.queue);
+    return true;
+}
+
+void VgtDestroyBenchDevice(VgtBenchDevice& dev)
+{
+    if (dev.device)
+        vkDestroyDevice(dev.device, nullptr);
+    if (dev.instance)
+        vkDestroyInstance(dev.instance, nullptr);
+    dev = VgtBenchDevice{};
+}
+
+VkResult VgtBenchSubmitAndWait(const VgtBenchDevice& dev, VkCommandBuffer cmd, VkFence fence)
+{
+    VkSubmitInfo submit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    submit.commandBufferCount = 1;
+    submit.pCommandBuffers = &cmd;
+
+    vkResetFences(dev.device, 1, &fence);
+    VkResult res = vkQueueSubmit(dev.queue, 1, &submit, fence);
+    if (res == VK_SUCCESS)
+        res = vkWaitForFences(dev.device, 1, &fence, VK_TRUE, UINT64_MAX);
+    return res;
+}
+
+bool VgtParseBenchCounts(const char* text, std::vector<uint32_t>& counts, uint32_t maxValue)
+{
+    counts.clear();
+    while (*text != '\0')
+    {
+        char* end = nullptr;
+        const unsigned long v = std::strtoul(text, &end, 10);
+        if (end == text || v == 0 || v > maxValue || (*end != ',' && *end != '\0'))
+            return false;
+        counts.push_back(static_cast<uint32_t>(v));
+        text = *end == ',' ? end + 1 : end;
+    }
+    return !counts.empty();
+}
+
+VkResult VgtCreateBenchColorTarget(VgtAllocator& allocator, VkDevice device, VkFormat format, VkExtent2D extent,
+    VgtBenchColorTarget& target)
+{
+    target = VgtBenchColorTarget{};
+
+    VkImageCreateInfo imageCI{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    imageCI.imageType = VK_IMAGE_TYPE_2D;
+    imageCI.format = format;
+    imageCI.extent = { extent.width, extent.height, 1 };
+    imageCI.mipLevels = 1;
+    imageCI.arrayLayers = 1;
+    imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCI.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    VkResult res = VgtCreateImage(allocator, imageCI, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, target.image, target.allocation);
+    if (res != VK_SUCCESS)
+    {
+        target = VgtBenchColorTarget{};
+        return res;
+    }
+
+    VkImageViewCreateInfo viewCI{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    viewCI.image = target.image;
+    viewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewCI.format = format;
+    viewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewCI.subresourceRange.levelCount = 1;
+    viewCI.subresourceRange.layerCount = 1;
+    res = vkCreateImageView(device, &viewCI, nullptr, &target.view);
+    if (res != VK_SUCCESS)
+        VgtDestroyBenchColorTarget(allocator, device, target);
+    return res;
+}
+
+void VgtDestroyBenchColorTarget(VgtAllocator& allocator, VkDevice device, VgtBenchColorTarget& target)
+{
+    if (target.view != VK_NULL_HANDLE)
+        vkDestroyImageView(device, target.view, nullptr);
+    if (target.image != VK_NULL_HANDLE)
+        VgtDestroyImage(allocator, target.image, target.allocation);
+    target = VgtBenchColorTarget{};
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include <VgtAllocator.h>
+
+// Plumbing shared by the benchmarks under benchmarks/ (linked by vgt_add_benchmark).
+//
+// - VgtCreateBenchDevice creates a headless instance and device on the first GPU, with one queue
+//   from the first family that has every flag in `queueFlags`. No surface, no layers: the
+//   benchmarks also run on lavapipe.
+// - Optional features are enabled only when supported; `dev` says which ones are on.
+// - VgtBenchSubmitAndWait submits one command buffer and blocks on its fence (timed runs read
+//   their timestamp queries right after).
+// - VgtCreateBenchColorTarget is the offscreen color attachment every scene renders into.
+struct VgtBenchDeviceCreateInfo
+{
+    const char* appName = "";
+    VkQueueFlags queueFlags = VK_QUEUE_GRAPHICS_BIT;
+    bool pipelineStatistics = false; // request pipelineStatisticsQuery
+};
+
+struct VgtBenchDevice
+{
+    VkInstance instance = VK_NULL_HANDLE;
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkQueue queue = VK_NULL_HANDLE;
+    uint32_t queueFamily = UINT32_MAX;
+    VkPhysicalDeviceProperties props{};
+    VkPhysicalDeviceMemoryProperties memProps{};
+    bool timestamps = false;         // the queue family has valid timestamp bits
+    bool pipelineStatistics = false; // requested and supported
+};
+
+bool VgtCreateBenchDevice(const VgtBenchDeviceCreateInfo& ci, VgtBenchDevice& dev);
+void VgtDestroyBenchDevice(VgtBenchDevice& dev);
+
+VkResult VgtBenchSubmitAndWait(const VgtBenchDevice& dev, VkCommandBuffer cmd, VkFence fence);
+
+// Parses a comma-separated list such as "1,100,1000". Rejects 0 and values above `maxValue`.
+bool VgtParseBenchCounts(const char* text, std::vector<uint32_t>& counts, uint32_t maxValue = UINT32_MAX);
+
+struct VgtBenchColorTarget
+{
+    VkImage image = VK_NULL_HANDLE;
+    VgtAllocation allocation;
+    VkImageView view = VK_NULL_HANDLE;
+};
+
+// Device-local, single-sampled, COLOR_ATTACHMENT usage only.
+VkResult VgtCreateBenchColorTarget(VgtAllocator& allocator, VkDevice device, VkFormat format, VkExtent2D extent,
+    VgtBenchColorTarget& target);
+void VgtDestroyBenchColorTarget(VgtAllocator& allocator, VkDevice device, VgtBenchColorTarget& target);
@@ -2,3 +2,4 @@ include(VgtDependencies)
 include(VgtSample)
 include(VgtShaders)
 include(VgtConfig)
+include(VgtAssetPack)
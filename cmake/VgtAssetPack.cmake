@@ -0,0 +1,57 @@
+# vgt_add_asset_pack(<target> [FILES <name>=<path> ...])
+#
+# Writes <target>.vgtpack (common/VgtAssetPack.h) into the target's binary directory, where
+# VgtOpenAssetPack finds it next to the exe (or one level up for MSBuild's <config>/ folders).
+# FILES are stored under <name>, e.g. "assets/texture.png=${CMAKE_CURRENT_LIST_DIR}/assets/texture.png".
+# With VGT_EMBED_SHADERS=OFF the shaders compiled by vgt_add_glsl_shaders for <target> are
+# packed as well (call that first); embedded shaders are never looked up in the pack.
+# Requires the vgt_pack tool (VGT_BUILD_TOOLS=ON).
+function(vgt_add_asset_pack target)
+  set(options)
+  set(oneValueArgs)
+  set(multiValueArgs FILES)
+  cmake_parse_arguments(VGT "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+
+  if(NOT TARGET vgt_pack)
+    message(FATAL_ERROR "vgt_add_asset_pack requires the vgt_pack tool (VGT_BUILD_TOOLS=ON)")
+  endif()
+
+  set(entries "")
+  set(deps "")
+  if(NOT VGT_EMBED_SHADERS)
+    get_target_property(spv_files ${target} VGT_SPIRV_FILES)
+    if(spv_files)
+      foreach(spv IN LISTS spv_files)
+        get_filename_component(spv_name "${spv}" NAME)
+        list(APPEND entries "${spv_name}=${spv}")
+        list(APPEND deps "${spv}")
+      endforeach()
+    endif()
+  endif()
+
+  foreach(entry IN LISTS VGT_FILES)
+    string(FIND "${entry}" "=" eq)
+    if(eq LESS 1)
+      message(FATAL_ERROR "vgt_add_asset_pack: expected <name>=<path>, got '${entry}'")
+    endif()
+    math(EXPR path_start "${eq} + 1")
+    string(SUBSTRING "${entry}" ${path_start} -1 path)
+    list(APPEND entries "${entry}")
+    list(APPEND deps "${path}")
+  endforeach()
+
+  set(pack "${CMAKE_CURRENT_BINARY_DIR}/${target}.vgtpack")
+  add_custom_command(
+    OUTPUT "${pack}"
+    COMMAND vgt_pack -o "${pack}" ${entries}
+    DEPENDS vgt_pack ${deps}
+    COMMENT "Packing assets for ${target}"
+    VERBATIM
+  )
+
+  add_custom_target(${target}_assets DEPENDS "${pack}")
+  if(TARGET ${target}_shaders)
+    add_dependencies(${target}_assets ${target}_shaders)
+  endif()
+  add_dependencies(${target} ${target}_assets)
+endfunction()
@@ -0,0 +1,28 @@
+include(VgtCommon)
+include(VgtVulkanConfig)
+
+# Console-only executables used to measure the shared helpers in isolation.
+# They do not open a window, so they also run on headless machines (e.g. lavapipe).
+# Each links vgt::bench_common (benchmarks/common: device creation, submission, argument lists).
+function(vgt_add_benchmark)
+  set(options)
+  set(oneValueArgs NAME)
+  set(multiValueArgs SOURCES)
+  cmake_parse_arguments(VGT "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+
+  if(NOT VGT_NAME)
+    message(FATAL_ERROR "vgt_add_benchmark requires NAME")
+  endif()
+
+  add_executable(${VGT_NAME} ${VGT_SOURCES})
+
+  vgt_set_default_warnings(${VGT_NAME})
+  target_compile_features(${VGT_NAME} PRIVATE cxx_std_20)
+
+  vgt_target_setup_vulkan(${VGT_NAME})
+  target_link_libraries(${VGT_NAME} PRIVATE vgt::common vgt::bench_common)
+
+  if(WIN32)
+    target_compile_definitions(${VGT_NAME} PRIVATE WIN32_LEAN_AND_MEAN NOMINMAX)
+  endif()
+endfunction()
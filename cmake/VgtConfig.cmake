@@ -1,3 +1,17 @@
+if(NOT VGT_FRAMES_IN_FLIGHT MATCHES "^[1-8]$")
+  message(FATAL_ERROR "VGT_FRAMES_IN_FLIGHT must be between 1 and 8 (got '${VGT_FRAMES_IN_FLIGHT}')")
+endif()
+
+if(NOT VGT_MATH_SIMD MATCHES "^(AUTO|AVX2|SCALAR)$")
+  message(FATAL_ERROR "VGT_MATH_SIMD must be AUTO, AVX2 or SCALAR (got '${VGT_MATH_SIMD}')")
+endif()
+
+if(VGT_MATH_SIMD STREQUAL "SCALAR")
+  set(VGT_MATH_SCALAR 1)
+else()
+  set(VGT_MATH_SCALAR 0)
+endif()
+
 configure_file(
   "${CMAKE_CURRENT_LIST_DIR}/VgtConfig.h.in"
   "${CMAKE_BINARY_DIR}/generated/VgtConfig.h"
@@ -7,3 +21,12 @@ configure_file(
 add_library(vgt_config INTERFACE)
 target_include_directories(vgt_config INTERFACE "${CMAKE_BINARY_DIR}/generated")
 add_library(vgt::config ALIAS vgt_config)
+
+# VgtMath picks its kernels from the compiler's target macros, so AVX2 only needs the flags.
+if(VGT_MATH_SIMD STREQUAL "AVX2")
+  if(MSVC)
+    target_compile_options(vgt_config INTERFACE /arch:AVX2)
+  else()
+    target_compile_options(vgt_config INTERFACE -mavx2 -mfma)
+  endif()
+endif()
@@ -0,0 +1,46 @@
+# Script mode: turns a SPIR-V binary into a C++ header with a constexpr uint32_t array.
+#
+#   cmake -DSPV=<in.spv> -DOUT=<out.h> -DSYMBOL=<identifier> -P VgtEmbedSpirv.cmake
+#
+# SPIR-V is a stream of little-endian 32-bit words, so the array is emitted word by word;
+# uint32_t storage also satisfies VkShaderModuleCreateInfo::pCode alignment.
+
+if(NOT SPV OR NOT OUT OR NOT SYMBOL)
+  message(FATAL_ERROR "VgtEmbedSpirv.cmake requires SPV, OUT and SYMBOL")
+endif()
+
+file(READ "${SPV}" _hex HEX)
+string(LENGTH "${_hex}" _hex_len)
+math(EXPR _rem "${_hex_len} % 8")
+if(_hex_len EQUAL 0 OR NOT _rem EQUAL 0)
+  message(FATAL_ERROR "${SPV} is not a valid SPIR-V binary (size must be a non-zero multiple of 4)")
+endif()
+math(EXPR _word_count "${_hex_len} / 8")
+
+# aabbccdd (bytes in file order) -> 0xddccbbaau
+string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1u, " _words "${_hex}")
+# 8 words per line (CMake regexes have no {n} quantifier)
+set(_w "0x[0-9a-f]+u, ")
+string(REGEX REPLACE "(${_w}${_w}${_w}${_w}${_w}${_w}${_w}${_w})" "\\1\n    " _words "${_words}")
+string(REGEX REPLACE "[ \n]+$" "" _words "${_words}")
+string(REPLACE ", \n" ",\n" _words "${_words}")
+
+get_filename_component(_spv_name "${SPV}" NAME)
+set(_content "// Generated from ${_spv_name} by cmake/VgtEmbedSpirv.cmake. Do not edit.
+#pragma once
+
+#include <cstdint>
+
+inline constexpr uint32_t ${SYMBOL}[${_word_count}] = {
+    ${_words}
+};
+")
+
+# Only touch the header when the content changes, so dependents are not rebuilt needlessly.
+if(EXISTS "${OUT}")
+  file(READ "${OUT}" _old)
+  if(_old STREQUAL _content)
+    return()
+  endif()
+endif()
+file(WRITE "${OUT}" "${_content}")
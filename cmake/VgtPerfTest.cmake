@@ -0,0 +1,137 @@
+# Script mode: one vgt_perf test (see perf/CMakeLists.txt). Runs a step headless with
+# --benchmark, keeps its JSON report and compares the steady-state numbers with a baseline.
+#
+#   cmake -DEXE=<step executable> -DNAME=<step> -DOUT=<report.json> -DBASELINE=<baseline.json>
+#         [-DWARMUP=N] [-DFRAMES=N] [-DTOLERANCE=<percent>] [-DMIN_DELTA_US=N] [-DUPDATE=ON]
+#         [-DEXTRA_ARGS="..."]
+#         -P VgtPerfTest.cmake
+#
+# Compared metrics (lower is better; a regression is more than TOLERANCE percent above the
+# baseline): present_interval_ms.mean (throughput), cpu_frame_ms.p50 and gpu_ms.frame.p50.
+# Differences below MIN_DELTA_US (default 50 us) never count, so sub-millisecond numbers on a
+# noisy machine do not flap.
+# The startup phases (init, pipeline, upload, ...) are kept in the report for archiving but
+# not compared: they mostly measure driver and file-system caches.
+#
+# Without a baseline file the run prints "vgt_perf: no baseline" and the test is skipped;
+# UPDATE=ON copies the report over the baseline instead of comparing.
+
+foreach(_var EXE NAME OUT BASELINE)
+  if(NOT ${_var})
+    message(FATAL_ERROR "VgtPerfTest.cmake requires EXE, NAME, OUT and BASELINE")
+  endif()
+endforeach()
+if(NOT WARMUP)
+  set(WARMUP 60)
+endif()
+if(NOT FRAMES)
+  set(FRAMES 600)
+endif()
+if(NOT TOLERANCE)
+  set(TOLERANCE 10)
+endif()
+if(NOT DEFINED MIN_DELTA_US)
+  set(MIN_DELTA_US 50)
+endif()
+separate_arguments(_extra_args UNIX_COMMAND "${EXTRA_ARGS}")
+
+get_filename_component(_out_dir "${OUT}" DIRECTORY)
+file(MAKE_DIRECTORY "${_out_dir}")
+file(REMOVE "${OUT}")
+
+# No pipeline cache: every run starts cold, so the startup phases stay comparable.
+execute_process(
+  COMMAND "${EXE}" --headless --no-pipeline-cache --benchmark --benchmark-warmup ${WARMUP}
+          --benchmark-frames ${FRAMES} --benchmark-json "${OUT}" ${_extra_args}
+  RESULT_VARIABLE _rc)
+if(NOT _rc EQUAL 0 OR NOT EXISTS "${OUT}")
+  message(FATAL_ERROR "vgt_perf: ${NAME} failed (exit code ${_rc})")
+endif()
+
+file(READ "${OUT}" _report)
+string(JSON _measured ERROR_VARIABLE _err GET "${_report}" measured_frames)
+if(_err OR NOT _measured EQUAL FRAMES)
+  message(FATAL_ERROR "vgt_perf: ${NAME} measured ${_measured} of ${FRAMES} frames")
+endif()
+
+if(UPDATE)
+  get_filename_component(_baseline_dir "${BASELINE}" DIRECTORY)
+  file(MAKE_DIRECTORY "${_baseline_dir}")
+  file(COPY_FILE "${OUT}" "${BASELINE}")
+  message(STATUS "vgt_perf: ${NAME} baseline written to ${BASELINE}")
+  return()
+endif()
+
+if(NOT EXISTS "${BASELINE}")
+  message(STATUS "vgt_perf: no baseline for ${NAME} (${BASELINE}); report kept at ${OUT}. "
+                 "Record one with -DVGT_PERF_UPDATE_BASELINES=ON on the machine that runs the suite.")
+  return()
+endif()
+file(READ "${BASELINE}" _baseline)
+
+# Numbers from different setups are not comparable.
+foreach(_key label backend present_mode swapchain_images frames_in_flight)
+  string(JSON _now ERROR_VARIABLE _err GET "${_report}" ${_key})
+  string(JSON _then ERROR_VARIABLE _err GET "${_baseline}" ${_key})
+  if(NOT "${_now}" STREQUAL "${_then}")
+    message(FATAL_ERROR "vgt_perf: ${NAME} baseline was recorded with ${_key} = ${_then}, this run has ${_now}")
+  endif()
+endforeach()
+
+# "12.3456" (ms) -> 123456 (units of 0.1 us); math() only knows integers. Exponent forms are
+# tiny values and count as 0.
+function(_vgt_perf_units text out_var)
+  if(text MATCHES "^([0-9]+)(\\.([0-9]*))?$")
+    set(_frac "${CMAKE_MATCH_3}0000")
+    string(SUBSTRING "${_frac}" 0 4 _frac)
+    # "1" prefix: math() would read a leading zero as octal.
+    math(EXPR _units "${CMAKE_MATCH_1} * 10000 + 1${_frac} - 10000")
+  else()
+    set(_units 0)
+  endif()
+  set(${out_var} ${_units} PARENT_SCOPE)
+endfunction()
+
+# 123456 -> "12.3456"
+function(_vgt_perf_format units out_var)
+  math(EXPR _int "${units} / 10000")
+  math(EXPR _frac "${units} % 10000 + 10000")
+  string(SUBSTRING "${_frac}" 1 4 _frac)
+  set(${out_var} "${_int}.${_frac}" PARENT_SCOPE)
+endfunction()
+
+set(_regressions "")
+function(_vgt_perf_compare)
+  string(JSON _now ERROR_VARIABLE _err_now GET "${_report}" ${ARGN})
+  string(JSON _then ERROR_VARIABLE _err_then GET "${_baseline}" ${ARGN})
+  string(REPLACE ";" "." _metric "${ARGN}")
+  if(_err_now OR _err_then OR _now STREQUAL "null" OR _then STREQUAL "null")
+    message(STATUS "vgt_perf: ${NAME} ${_metric}: not in both reports, skipped")
+    return()
+  endif()
+
+  _vgt_perf_units("${_now}" _now_units)
+  _vgt_perf_units("${_then}" _then_units)
+  if(_then_units LESS 1)
+    set(_then_units 1)
+  endif()
+  math(EXPR _delta "(${_now_units} - ${_then_units}) * 100 / ${_then_units}")
+  _vgt_perf_format(${_now_units} _now_text)
+  _vgt_perf_format(${_then_units} _then_text)
+  message(STATUS "vgt_perf: ${NAME} ${_metric}: ${_now_text} ms (baseline ${_then_text} ms, ${_delta}%)")
+  math(EXPR _limit "${_then_units} * (100 + ${TOLERANCE})")
+  math(EXPR _scaled "${_now_units} * 100")
+  math(EXPR _min_delta "${MIN_DELTA_US} * 10")
+  math(EXPR _abs_delta "${_now_units} - ${_then_units}")
+  if(_scaled GREATER _limit AND _abs_delta GREATER _min_delta)
+    set(_regressions "${_regressions} ${_metric}" PARENT_SCOPE)
+  endif()
+endfunction()
+
+_vgt_perf_compare(present_interval_ms mean)
+_vgt_perf_compare(cpu_frame_ms p50)
+_vgt_perf_compare(gpu_ms frame p50)
+
+if(_regressions)
+  message(FATAL_ERROR "vgt_perf: ${NAME} regressed by more than ${TOLERANCE}%:${_regressions}")
+endif()
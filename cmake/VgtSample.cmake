@@ -17,7 +17,7 @@ function(vgt_add_step_executable)
   target_compile_features(${VGT_NAME} PRIVATE cxx_std_20)
 
   vgt_target_setup_vulkan(${VGT_NAME})
-  target_link_libraries(${VGT_NAME} PRIVATE vgt::glfw)
+  target_link_libraries(${VGT_NAME} PRIVATE vgt::glfw vgt::common)
 
   if(WIN32)
     target_compile_definitions(${VGT_NAME} PRIVATE WIN32_LEAN_AND_MEAN NOMINMAX)
@@ -1,3 +1,6 @@
+# Directory of this file, for helper scripts run with `cmake -P`.
+set(VGT_CMAKE_DIR "${CMAKE_CURRENT_LIST_DIR}")
+
 function(vgt_add_glsl_shaders target)
   set(options)
   set(oneValueArgs OUTPUT_DIR)
@@ -34,6 +37,62 @@ function(vgt_add_glsl_shaders target)
     list(APPEND spv_outputs "${out_spv}")
   endforeach()
 
-  add_custom_target(${target}_shaders DEPENDS ${spv_outputs})
+  if(VGT_EMBED_SHADERS)
+    _vgt_embed_spirv(${target} "${spv_outputs}" embed_outputs)
+  endif()
+
+  # For vgt_add_asset_pack (VgtAssetPack.cmake).
+  set_property(TARGET ${target} APPEND PROPERTY VGT_SPIRV_FILES ${spv_outputs})
+
+  add_custom_target(${target}_shaders DEPENDS ${spv_outputs} ${embed_outputs})
   add_dependencies(${target} ${target}_shaders)
 endfunction()
+
+# VGT_EMBED_SHADERS: each .spv becomes a generated header (see VgtEmbedSpirv.cmake), and a
+# generated registry source linked into `target` registers them with VgtLoadSpirv() at startup.
+# The .spv files are still written, so `--shaders-from-disk` keeps working for hot reload.
+function(_vgt_embed_spirv target spv_files out_var)
+  set(gen_dir "${CMAKE_CURRENT_BINARY_DIR}/embedded_shaders")
+  file(MAKE_DIRECTORY "${gen_dir}")
+
+  set(headers "")
+  set(includes "")
+  set(entries "")
+  foreach(spv IN LISTS spv_files)
+    get_filename_component(spv_name "${spv}" NAME)
+    string(MAKE_C_IDENTIFIER "kVgtSpirv_${spv_name}" symbol)
+    set(header "${gen_dir}/${spv_name}.h")
+
+    add_custom_command(
+      OUTPUT "${header}"
+      COMMAND "${CMAKE_COMMAND}" -DSPV=${spv} -DOUT=${header} -DSYMBOL=${symbol}
+              -P "${VGT_CMAKE_DIR}/VgtEmbedSpirv.cmake"
+      DEPENDS "${spv}" "${VGT_CMAKE_DIR}/VgtEmbedSpirv.cmake"
+      VERBATIM
+    )
+
+    list(APPEND headers "${header}")
+    string(APPEND includes "#include \"${spv_name}.h\"\n")
+    string(APPEND entries "    { \"${spv_name}\", ${symbol}, std::size(${symbol}) },\n")
+  endforeach()
+
+  set(registry "${gen_dir}/${target}_embedded_shaders.cpp")
+  file(CONFIGURE OUTPUT "${registry}" @ONLY CONTENT
+"// Generated by vgt_add_glsl_shaders (VGT_EMBED_SHADERS=ON). Do not edit.
+#include <iterator>
+
+#include <VgtSpirv.h>
+
+@includes@
+static const VgtEmbeddedSpirv kShaders[] = {
+@entries@};
+
+[[maybe_unused]] static const bool kRegistered = (VgtRegisterEmbeddedSpirv(kShaders, std::size(kShaders)), true);
+")
+
+  target_sources(${target} PRIVATE "${registry}")
+  target_include_directories(${target} PRIVATE "${gen_dir}")
+  set_source_files_properties("${registry}" PROPERTIES OBJECT_DEPENDS "${headers}")
+
+  set(${out_var} ${headers} PARENT_SCOPE)
+endfunction()
@@ -0,0 +1,435 @@
+#include "VgtAllocator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+// Smallest buddy size. Matches the largest common minUniformBufferOffsetAlignment / nonCoherentAtomSize.
+static constexpr VkDeviceSize kMinAllocSize = 256;
+
+static VkDeviceSize OrderSize(uint32_t order)
+{
+    return kMinAllocSize << order;
+}
+
+static uint32_t OrderForSize(VkDeviceSize size)
+{
+    uint32_t order = 0;
+    while (OrderSize(order) < size)
+        ++order;
+    return order;
+}
+
+static VkDeviceSize FloorPow2(VkDeviceSize v)
+{
+    VkDeviceSize p = 1;
+    while (p <= v / 2)
+        p <<= 1;
+    return p;
+}
+
+static uint32_t PoolIndex(uint32_t memoryTypeIndex, VgtResourceKind kind)
+{
+    return memoryTypeIndex * 2 + static_cast<uint32_t>(kind);
+}
+
+// ---- Buddy block ----------------------------------------------------------------------
+
+static bool BlockAlloc(VgtMemoryBlock& block, uint32_t order, VkDeviceSize& offset)
+{
+    uint32_t o = order;
+    while (o <= block.maxOrder && block.freeLists[o].empty())
+        ++o;
+    if (o > block.maxOrder)
+        return false;
+
+    // Take the lowest free offset to keep allocations packed toward the block start.
+    auto it = block.freeLists[o].begin();
+    offset = *it;
+    block.freeLists[o].erase(it);
+
+    // Split down to the requested order, returning the upper halves to the free lists.
+    while (o > order)
+    {
+        --o;
+        block.freeLists[o].insert(offset + OrderSize(o));
+    }
+    return true;
+}
+
+static void BlockFree(VgtMemoryBlock& block, VkDeviceSize offset, uint32_t order)
+{
+    while (order < block.maxOrder)
+    {
+        const VkDeviceSize buddy = offset ^ OrderSize(order);
+        auto it = block.freeLists[order].find(buddy);
+        if (it == block.freeLists[order].end())
+            break;
+        block.freeLists[order].erase(it);
+        offset = std::min(offset, buddy);
+        ++order;
+    }
+    block.freeLists[order].insert(offset);
+}
+
+static VkDeviceSize BlockLargestFree(const VgtMemoryBlock& block, VkDeviceSize& totalFree)
+{
+    VkDeviceSize largest = 0;
+    for (uint32_t o = 0; o <= block.maxOrder; ++o)
+    {
+        const VkDeviceSize n = static_cast<VkDeviceSize>(block.freeLists[o].size());
+        totalFree += n * OrderSize(o);
+        if (n > 0)
+            largest = OrderSize(o);
+    }
+    return largest;
+}
+
+// ---- Allocator ------------------------------------------------------------------------
+
+VkResult VgtCreateAllocator(const VgtAllocatorCreateInfo& ci, VgtAllocator& allocator)
+{
+    allocator.physicalDevice = ci.physicalDevice;
+    allocator.device = ci.device;
+    allocator.mutex = std::make_unique<std::mutex>();
+    vkGetPhysicalDeviceMemoryProperties(ci.physicalDevice, &allocator.memProps);
+
+    allocator.blockSize = std::max(FloorPow2(ci.blockSize), kMinAllocSize);
+
+    allocator.pools.resize(allocator.memProps.memoryTypeCount * 2);
+    for (uint32_t t = 0; t < allocator.memProps.memoryTypeCount; ++t)
+    {
+        allocator.pools[PoolIndex(t, VgtResourceKind::Linear)].memoryTypeIndex = t;
+        allocator.pools[PoolIndex(t, VgtResourceKind::Linear)].kind = VgtResourceKind::Linear;
+        allocator.pools[PoolIndex(t, VgtResourceKind::Optimal)].memoryTypeIndex = t;
+        allocator.pools[PoolIndex(t, VgtResourceKind::Optimal)].kind = VgtResourceKind::Optimal;
+    }
+    return VK_SUCCESS;
+}
+
+void VgtDestroyAllocator(VgtAllocator& allocator)
+{
+    for (auto& pool : allocator.pools)
+    {
+        for (auto& block : pool.blocks)
+        {
+            if (block.memory == VK_NULL_HANDLE)
+                continue;
+            if (block.allocationCount != 0)
+                std::fprintf(stderr, "VgtAllocator: %u allocation(s) leaked in memory type %u\n", block.allocationCount, pool.memoryTypeIndex);
+            vkFreeMemory(allocator.device, block.memory, nullptr);
+        }
+    }
+    if (allocator.dedicatedCount != 0)
+        std::fprintf(stderr, "VgtAllocator: %u dedicated allocation(s) leaked\n", allocator.dedicatedCount);
+
+    allocator = VgtAllocator{};
+}
+
+uint32_t VgtFindMemoryType(const VgtAllocator& allocator, uint32_t typeBits, VkMemoryPropertyFlags properties)
+{
+    for (uint32_t i = 0; i < allocator.memProps.memoryTypeCount; ++i)
+    {
+        if ((typeBits & (1u << i)) && (allocator.memProps.memoryTypes[i].propertyFlags & properties) == properties)
+            return i;
+    }
+    return UINT32_MAX;
+}
+
+static bool IsHostVisible(const VgtAllocator& allocator, uint32_t memoryTypeIndex)
+{
+    return (allocator.memProps.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
+
+static VkResult AllocateDeviceMemory(VgtAllocator& allocator, uint32_t memoryTypeIndex, VkDeviceSize size,
+    VkDeviceMemory& memory, void*& mapped)
+{
+    VkMemoryAllocateInfo ai{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    ai.allocationSize = size;
+    ai.memoryTypeIndex = memoryTypeIndex;
+
+    VkResult res = vkAllocateMemory(allocator.device, &ai, nullptr, &memory);
+    ++allocator.vkAllocateMemoryCalls;
+    if (res != VK_SUCCESS)
+        return res;
+
+    mapped = nullptr;
+    if (IsHostVisible(allocator, memoryTypeIndex))
+    {
+        res = vkMapMemory(allocator.device, memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+        if (res != VK_SUCCESS)
+        {
+            vkFreeMemory(allocator.device, memory, nullptr);
+            memory = VK_NULL_HANDLE;
+            return res;
+        }
+    }
+    return VK_SUCCESS;
+}
+
+static VkResult AllocateDedicated(VgtAllocator& allocator, uint32_t memoryTypeIndex, const VkMemoryRequirements& req, VgtAllocation& out)
+{
+    void* mapped = nullptr;
+    const VkResult res = AllocateDeviceMemory(allocator, memoryTypeIndex, req.size, out.memory, mapped);
+    if (res != VK_SUCCESS)
+        return res;
+
+    out.offset = 0;
+    out.size = req.size;
+    out.mapped = mapped;
+    out.memoryTypeIndex = memoryTypeIndex;
+    out.poolIndex = UINT32_MAX;
+    out.blockIndex = UINT32_MAX;
+    out.order = 0;
+
+    ++allocator.dedicatedCount;
+    allocator.dedicatedBytes += req.size;
+    allocator.dedicatedUsed += req.size;
+    return VK_SUCCESS;
+}
+
+static VkResult AddBlock(VgtAllocator& allocator, VgtMemoryPool& pool, uint32_t& blockIndex)
+{
+    VkDeviceSize size = allocator.blockSize;
+
+    // Do not let one block eat a large fraction of a small heap.
+    const uint32_t heapIndex = allocator.memProps.memoryTypes[pool.memoryTypeIndex].heapIndex;
+    const VkDeviceSize heapSize = allocator.memProps.memoryHeaps[heapIndex].size;
+    if (heapSize / 8 < size)
+        size = std::max(FloorPow2(heapSize / 8), kMinAllocSize);
+
+    VgtMemoryBlock block;
+    void* mapped = nullptr;
+    const VkResult res = AllocateDeviceMemory(allocator, pool.memoryTypeIndex, size, block.memory, mapped);
+    if (res != VK_SUCCESS)
+        return res;
+
+    block.mapped = static_cast<uint8_t*>(mapped);
+    block.size = size;
+    block.maxOrder = OrderForSize(size);
+    block.freeLists.resize(block.maxOrder + 1);
+    block.freeLists[block.maxOrder].insert(0);
+
+    // Reuse a released slot so existing VgtAllocation::blockIndex values stay valid.
+    for (uint32_t i = 0; i < pool.blocks.size(); ++i)
+    {
+        if (pool.blocks[i].memory == VK_NULL_HANDLE)
+        {
+            pool.blocks[i] = std::move(block);
+            blockIndex = i;
+            return VK_SUCCESS;
+        }
+    }
+    pool.blocks.push_back(std::move(block));
+    blockIndex = static_cast<uint32_t>(pool.blocks.size() - 1);
+    return VK_SUCCESS;
+}
+
+VkResult VgtAllocateMemory(VgtAllocator& allocator, const VkMemoryRequirements& req, VkMemoryPropertyFlags properties,
+    VgtResourceKind kind, VgtAllocation& out)
+{
+    const uint32_t memoryTypeIndex = VgtFindMemoryType(allocator, req.memoryTypeBits, properties);
+    if (memoryTypeIndex == UINT32_MAX)
+        return VK_ERROR_FEATURE_NOT_PRESENT;
+
+    std::lock_guard<std::mutex> lock(*allocator.mutex);
+
+    const VkDeviceSize rounded = std::max(req.size, req.alignment);
+    if (rounded > allocator.blockSize / 2)
+        return AllocateDedicated(allocator, memoryTypeIndex, req, out);
+
+    const uint32_t order = OrderForSize(rounded);
+    const uint32_t poolIndex = PoolIndex(memoryTypeIndex, kind);
+    VgtMemoryPool& pool = allocator.pools[poolIndex];
+
+    VkDeviceSize offset = 0;
+    uint32_t blockIndex = UINT32_MAX;
+    for (uint32_t i = 0; i < pool.blocks.size(); ++i)
+    {
+        VgtMemoryBlock& block = pool.blocks[i];
+        if (block.memory != VK_NULL_HANDLE && order <= block.maxOrder && BlockAlloc(block, order, offset))
+        {
+            blockIndex = i;
+            break;
+        }
+    }
+
+    if (blockIndex == UINT32_MAX)
+    {
+        const VkResult res = AddBlock(allocator, pool, blockIndex);
+        if (res != VK_SUCCESS)
+            return res;
+        VgtMemoryBlock& block = pool.blocks[blockIndex];
+        if (order > block.maxOrder || !BlockAlloc(block, order, offset))
+        {
+            // Heap-clamped block is too small for this request: give the empty block back.
+            vkFreeMemory(allocator.device, block.memory, nullptr);
+            block = VgtMemoryBlock{};
+            return AllocateDedicated(allocator, memoryTypeIndex, req, out);
+        }
+    }
+
+    VgtMemoryBlock& block = pool.blocks[blockIndex];
+    block.bytesAllocated += OrderSize(order);
+    block.bytesUsed += req.size;
+    ++block.allocationCount;
+
+    out.memory = block.memory;
+    out.offset = offset;
+    out.size = req.size;
+    out.mapped = block.mapped ? block.mapped + offset : nullptr;
+    out.memoryTypeIndex = memoryTypeIndex;
+    out.poolIndex = poolIndex;
+    out.blockIndex = blockIndex;
+    out.order = order;
+    return VK_SUCCESS;
+}
+
+void VgtFreeMemory(VgtAllocator& allocator, VgtAllocation& allocation)
+{
+    if (allocation.memory == VK_NULL_HANDLE)
+        return;
+
+    std::lock_guard<std::mutex> lock(*allocator.mutex);
+
+    if (allocation.blockIndex == UINT32_MAX)
+    {
+        vkFreeMemory(allocator.device, allocation.memory, nullptr);
+        --allocator.dedicatedCount;
+        allocator.dedicatedBytes -= allocation.size;
+        allocator.dedicatedUsed -= allocation.size;
+        allocation = VgtAllocation{};
+        return;
+    }
+
+    VgtMemoryPool& pool = allocator.pools[allocation.poolIndex];
+    VgtMemoryBlock& block = pool.blocks[allocation.blockIndex];
+    BlockFree(block, allocation.offset, allocation.order);
+    block.bytesAllocated -= OrderSize(allocation.order);
+    block.bytesUsed -= allocation.size;
+    --block.allocationCount;
+
+    // Release empty blocks, but keep one per pool to avoid churn on alloc/free patterns.
+    if (block.allocationCount == 0)
+    {
+        uint32_t live = 0;
+        for (const auto& b : pool.blocks)
+            live += (b.memory != VK_NULL_HANDLE) ? 1u : 0u;
+        if (live > 1)
+        {
+            vkFreeMemory(allocator.device, block.memory, nullptr);
+            block = VgtMemoryBlock{};
+        }
+    }
+
+    allocation = VgtAllocation{};
+}
+
+VkResult VgtCreateBuffer(VgtAllocator& allocator, const VkBufferCreateInfo& ci, VkMemoryPropertyFlags properties,
+    VkBuffer& buffer, VgtAllocation& allocation)
+{
+    VkResult res = vkCreateBuffer(allocator.device, &ci, nullptr, &buffer);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkMemoryRequirements req{};
+    vkGetBufferMemoryRequirements(allocator.device, buffer, &req);
+
+    res = VgtAllocateMemory(allocator, req, properties, VgtResourceKind::Linear, allocation);
+    if (res == VK_SUCCESS)
+        res = vkBindBufferMemory(allocator.device, buffer, allocation.memory, allocation.offset);
+    if (res != VK_SUCCESS)
+    {
+        VgtDestroyBuffer(allocator, buffer, allocation);
+        buffer = VK_NULL_HANDLE;
+    }
+    return res;
+}
+
+VkResult VgtCreateImage(VgtAllocator& allocator, const VkImageCreateInfo& ci, VkMemoryPropertyFlags properties,
+    VkImage& image, VgtAllocation& allocation)
+{
+    VkResult res = vkCreateImage(allocator.device, &ci, nullptr, &image);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkMemoryRequirements req{};
+    vkGetImageMemoryRequirements(allocator.device, image, &req);
+
+    const VgtResourceKind kind = (ci.tiling == VK_IMAGE_TILING_OPTIMAL) ? VgtResourceKind::Optimal : VgtResourceKind::Linear;
+    res = VgtAllocateMemory(allocator, req, properties, kind, allocation);
+    if (res == VK_SUCCESS)
+        res = vkBindImageMemory(allocator.device, image, allocation.memory, allocation.offset);
+    if (res != VK_SUCCESS)
+    {
+        VgtDestroyImage(allocator, image, allocation);
+        image = VK_NULL_HANDLE;
+    }
+    return res;
+}
+
+void VgtDestroyBuffer(VgtAllocator& allocator, VkBuffer buffer, VgtAllocation& allocation)
+{
+    if (buffer != VK_NULL_HANDLE)
+        vkDestroyBuffer(allocator.device, buffer, nullptr);
+    VgtFreeMemory(allocator, allocation);
+}
+
+void VgtDestroyImage(VgtAllocator& allocator, VkImage image, VgtAllocation& allocation)
+{
+    if (image != VK_NULL_HANDLE)
+        vkDestroyImage(allocator.device, image, nullptr);
+    VgtFreeMemory(allocator, allocation);
+}
+
+VgtAllocatorStats VgtGetAllocatorStats(const VgtAllocator& allocator)
+{
+    VgtAllocatorStats stats;
+    if (!allocator.mutex)
+        return stats;
+
+    std::lock_guard<std::mutex> lock(*allocator.mutex);
+
+    VkDeviceSize totalFree = 0;
+    for (const auto& pool : allocator.pools)
+    {
+        for (const auto& block : pool.blocks)
+        {
+            if (block.memory == VK_NULL_HANDLE)
+                continue;
+            ++stats.blockCount;
+            stats.allocationCount += block.allocationCount;
+            stats.bytesReserved += block.size;
+            stats.bytesAllocated += block.bytesAllocated;
+            stats.bytesUsed += block.bytesUsed;
+            stats.largestFreeRange = std::max(stats.largestFreeRange, BlockLargestFree(block, totalFree));
+        }
+    }
+
+    stats.dedicatedCount = allocator.dedicatedCount;
+    stats.allocationCount += allocator.dedicatedCount;
+    stats.bytesReserved += allocator.dedicatedBytes;
+    stats.bytesAllocated += allocator.dedicatedBytes;
+    stats.bytesUsed += allocator.dedicatedUsed;
+    stats.vkAllocateMemoryCalls = allocator.vkAllocateMemoryCalls;
+
+    if (stats.bytesAllocated > 0)
+        stats.internalFragmentation = 1.0f - static_cast<float>(static_cast<double>(stats.bytesUsed) / static_cast<double>(stats.bytesAllocated));
+    if (totalFree > 0)
+        stats.externalFragmentation = 1.0f - static_cast<float>(static_cast<double>(stats.largestFreeRange) / static_cast<double>(totalFree));
+    return stats;
+}
+
+void VgtPrintAllocatorStats(const char* label, const VgtAllocatorStats& stats, const char* when)
+{
+    const double MiB = 1024.0 * 1024.0;
+    const std::string tag = when ? std::string(" (") + when + ")" : std::string();
+    const char* t = tag.c_str();
+    std::fprintf(stderr,
+        "[%s] memory%s: %u block(s) + %u dedicated, %u allocation(s), %llu vkAllocateMemory call(s)\n"
+        "[%s] memory%s: reserved %.2f MiB, allocated %.2f MiB, used %.2f MiB, largest free %.2f MiB\n"
+        "[%s] memory%s: fragmentation internal %.1f%%, external %.1f%%\n",
+        label, t, stats.blockCount, stats.dedicatedCount, stats.allocationCount, static_cast<unsigned long long>(stats.vkAllocateMemoryCalls),
+        label, t, stats.bytesReserved / MiB, stats.bytesAllocated / MiB, stats.bytesUsed / MiB, stats.largestFreeRange / MiB,
+        label, t, stats.internalFragmentation * 100.0f, stats.externalFragmentation * 100.0f);
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+// Device memory sub-allocator.
+//
+// Instead of one vkAllocateMemory per buffer/image, memory is taken from large blocks
+// (one pool of blocks per memory type) and split with a buddy allocator:
+//
+// - Every allocation is a power-of-two sized range at an offset that is a multiple of
+//   its size, so any alignment up to the rounded size comes for free.
+// - Linear resources (buffers) and optimal-tiling images live in separate pools, so
+//   `bufferImageGranularity` never has to be considered inside a block.
+// - Requests larger than half a block get a dedicated vkAllocateMemory.
+// - Host-visible blocks are mapped once at creation; VgtAllocation::mapped points at
+//   the sub-range, so callers never call vkMapMemory/vkUnmapMemory themselves.
+
+enum class VgtResourceKind : uint32_t
+{
+    Linear = 0,  // buffers, linear images
+    Optimal = 1, // optimal-tiling images
+};
+
+struct VgtAllocation
+{
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;    // size requested by the resource
+    void* mapped = nullptr;   // host pointer to `offset` when the memory is host-visible
+
+    // Bookkeeping (owned by the allocator).
+    uint32_t memoryTypeIndex = UINT32_MAX;
+    uint32_t poolIndex = UINT32_MAX;
+    uint32_t blockIndex = UINT32_MAX; // UINT32_MAX == dedicated allocation
+    uint32_t order = 0;
+};
+
+struct VgtAllocatorStats
+{
+    uint32_t blockCount = 0;             // live pooled blocks
+    uint32_t dedicatedCount = 0;         // live dedicated allocations
+    uint32_t allocationCount = 0;        // live sub-allocations (pooled + dedicated)
+    uint64_t vkAllocateMemoryCalls = 0;  // total since creation
+
+    VkDeviceSize bytesReserved = 0;      // device memory owned by the allocator
+    VkDeviceSize bytesAllocated = 0;     // rounded sizes handed out
+    VkDeviceSize bytesUsed = 0;          // sizes actually requested
+    VkDeviceSize largestFreeRange = 0;   // biggest contiguous free range in any block
+
+    float internalFragmentation = 0.0f;  // 1 - used / allocated (buddy rounding)
+    float externalFragmentation = 0.0f;  // 1 - largestFree / totalFree
+};
+
+struct VgtAllocatorCreateInfo
+{
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkDeviceSize blockSize = 64ull * 1024 * 1024; // rounded down to a power of two
+};
+
+struct VgtMemoryBlock
+{
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    uint8_t* mapped = nullptr;
+    VkDeviceSize size = 0;
+    uint32_t maxOrder = 0;
+    std::vector<std::set<VkDeviceSize>> freeLists; // per order, free offsets
+    VkDeviceSize bytesAllocated = 0;
+    VkDeviceSize bytesUsed = 0;
+    uint32_t allocationCount = 0;
+};
+
+struct VgtMemoryPool
+{
+    uint32_t memoryTypeIndex = 0;
+    VgtResourceKind kind = VgtResourceKind::Linear;
+    std::vector<VgtMemoryBlock> blocks; // freed blocks keep their slot with memory == VK_NULL_HANDLE
+};
+
+struct VgtAllocator
+{
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkPhysicalDeviceMemoryProperties memProps{};
+    VkDeviceSize blockSize = 0;
+
+    // Guards everything below; the allocator may be used from loader threads.
+    std::unique_ptr<std::mutex> mutex;
+    std::vector<VgtMemoryPool> pools; // indexed by memoryTypeIndex * 2 + kind
+
+    uint32_t dedicatedCount = 0;
+    VkDeviceSize dedicatedBytes = 0;
+    VkDeviceSize dedicatedUsed = 0;
+    uint64_t vkAllocateMemoryCalls = 0;
+};
+
+VkResult VgtCreateAllocator(const VgtAllocatorCreateInfo& ci, VgtAllocator& allocator);
+void VgtDestroyAllocator(VgtAllocator& allocator);
+
+// Returns the first memory type allowed by `typeBits` that has all `properties`, or UINT32_MAX.
+uint32_t VgtFindMemoryType(const VgtAllocator& allocator, uint32_t typeBits, VkMemoryPropertyFlags properties);
+
+VkResult VgtAllocateMemory(VgtAllocator& allocator, const VkMemoryRequirements& req, VkMemoryPropertyFlags properties,
+    VgtResourceKind kind, VgtAllocation& out);
+void VgtFreeMemory(VgtAllocator& allocator, VgtAllocation& allocation);
+
+// Create + allocate + bind in one call.
+VkResult VgtCreateBuffer(VgtAllocator& allocator, const VkBufferCreateInfo& ci, VkMemoryPropertyFlags properties,
+    VkBuffer& buffer, VgtAllocation& allocation);
+VkResult VgtCreateImage(VgtAllocator& allocator, const VkImageCreateInfo& ci, VkMemoryPropertyFlags properties,
+    VkImage& image, VgtAllocation& allocation);
+void VgtDestroyBuffer(VgtAllocator& allocator, VkBuffer buffer, VgtAllocation& allocation);
+void VgtDestroyImage(VgtAllocator& allocator, VkImage image, VgtAllocation& allocation);
+
+VgtAllocatorStats VgtGetAllocatorStats(const VgtAllocator& allocator);
+// `when` (optional) tags the lines, e.g. "first frame" or "before teardown".
+void VgtPrintAllocatorStats(const char* label, const VgtAllocatorStats& stats, const char* when = nullptr);
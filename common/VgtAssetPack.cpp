@@ -0,0 +1,103 @@
+#include "VgtAssetPack.h"
+
+#include <cstdio>
+#include <cstring>
+
+static const VgtAssetPack* s_mountedPack = nullptr;
+
+static bool MapAndValidate(const std::string& path, VgtAssetPack& pack)
+{
+    VgtMappedFile file;
+    if (!VgtMapFile(path.c_str(), file))
+        return false;
+
+    VgtPackHeader header{};
+    bool ok = file.size >= sizeof(header);
+    if (ok)
+    {
+        std::memcpy(&header, file.data, sizeof(header));
+        ok = std::memcmp(header.magic, kVgtPackMagic, sizeof(kVgtPackMagic)) == 0 && header.version == kVgtPackVersion &&
+            header.entryCount <= (file.size - sizeof(header)) / sizeof(VgtPackEntry);
+    }
+
+    const auto* entries = reinterpret_cast<const VgtPackEntry*>(file.data + sizeof(VgtPackHeader));
+    for (uint32_t i = 0; ok && i < header.entryCount; ++i)
+    {
+        const VgtPackEntry& e = entries[i];
+        ok = e.name[kVgtPackMaxNameLength] == '\0' && e.offset % kVgtPackAlignment == 0 && e.offset <= file.size &&
+            e.size <= file.size - e.offset && (i == 0 || std::strcmp(entries[i - 1].name, e.name) < 0);
+    }
+    if (!ok)
+    {
+        std::fprintf(stderr, "Ignoring asset pack %s: bad header or table of contents\n", path.c_str());
+        VgtUnmapFile(file);
+        return false;
+    }
+
+    pack.file = file;
+    pack.entries = entries;
+    pack.entryCount = header.entryCount;
+    pack.path = path;
+    return true;
+}
+
+bool VgtOpenAssetPack(const char* relativePath, VgtAssetPack& pack)
+{
+    pack = VgtAssetPack{};
+    if (MapAndValidate(relativePath, pack))
+        return true;
+
+    std::string exeDir = VgtGetExecutableDir();
+    if (exeDir.empty())
+        return false;
+    if (MapAndValidate(exeDir + relativePath, pack))
+        return true;
+
+    // Common MSBuild layout: <target>/Debug/.. == <target>/
+    while (!exeDir.empty() && (exeDir.back() == '\\' || exeDir.back() == '/'))
+        exeDir.pop_back();
+    const size_t parentSlash = exeDir.find_last_of("\\/");
+    if (parentSlash == std::string::npos)
+        return false;
+    exeDir.resize(parentSlash + 1);
+    return MapAndValidate(exeDir + relativePath, pack);
+}
+
+void VgtCloseAssetPack(VgtAssetPack& pack)
+{
+    if (s_mountedPack == &pack)
+        s_mountedPack = nullptr;
+    VgtUnmapFile(pack.file);
+    pack = VgtAssetPack{};
+}
+
+bool VgtFindAsset(const VgtAssetPack& pack, const char* name, VgtAssetView& view)
+{
+    uint32_t lo = 0, hi = pack.entryCount;
+    while (lo < hi)
+    {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        const int cmp = std::strcmp(pack.entries[mid].name, name);
+        if (cmp == 0)
+        {
+            view.data = pack.file.data + pack.entries[mid].offset;
+            view.size = static_cast<size_t>(pack.entries[mid].size);
+            return true;
+        }
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return false;
+}
+
+void VgtMountAssetPack(const VgtAssetPack* pack)
+{
+    s_mountedPack = pack;
+}
+
+bool VgtFindMountedAsset(const char* name, VgtAssetView& view)
+{
+    return s_mountedPack && VgtFindAsset(*s_mountedPack, name, view);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "VgtPlatform.h"
+
+// Read-only asset archive written at build time by tools/vgt_pack and memory-mapped at runtime.
+//
+// Layout (little-endian):
+//   VgtPackHeader                    at 0
+//   VgtPackEntry[entryCount]         right after the header, sorted by name (strcmp)
+//   entry data                       each at a multiple of kVgtPackAlignment
+//
+// The alignment covers SPIR-V words and compressed texel blocks, so VgtLoadSpirv can hand the
+// mapped words straight to vkCreateShaderModule and VgtLoadImageFile can point a KTX2/DDS
+// image at its levels inside the mapping; the staging memcpy then reads the pages directly.
+//
+// A pack can be mounted once at startup; VgtLoadSpirv and VgtLoadImageFile look up names there
+// before they probe the file system (embedded shaders still win). Missing packs are not an
+// error: everything falls back to the loose files.
+
+inline constexpr char kVgtPackMagic[8] = { 'V', 'G', 'T', 'P', 'A', 'C', 'K', '\0' };
+inline constexpr uint32_t kVgtPackVersion = 1;
+inline constexpr size_t kVgtPackAlignment = 64;
+inline constexpr size_t kVgtPackMaxNameLength = 47; // plus the terminator
+
+struct VgtPackHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+    uint64_t dataSize; // bytes after the table of contents, including padding
+    uint64_t reserved;
+};
+
+struct VgtPackEntry
+{
+    char name[kVgtPackMaxNameLength + 1]; // e.g. "texture.vert.spv", "assets/texture.ktx2"
+    uint64_t offset;                      // from the start of the file
+    uint64_t size;
+};
+
+static_assert(sizeof(VgtPackHeader) == 32 && sizeof(VgtPackEntry) == 64, "pack structs are written as-is");
+
+struct VgtAssetView
+{
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+struct VgtAssetPack
+{
+    VgtMappedFile file;
+    const VgtPackEntry* entries = nullptr; // inside the mapping
+    uint32_t entryCount = 0;
+    std::string path;
+};
+
+// Maps `relativePath` (tried as given, next to the executable, then one directory above it)
+// and validates the header and every entry. Returns false for missing or malformed packs.
+bool VgtOpenAssetPack(const char* relativePath, VgtAssetPack& pack);
+void VgtCloseAssetPack(VgtAssetPack& pack);
+
+// Binary search of the table of contents; `view` points into the mapping.
+bool VgtFindAsset(const VgtAssetPack& pack, const char* name, VgtAssetView& view);
+
+// Makes `pack` visible to VgtFindMountedAsset (nullptr unmounts). Not synchronized: mount before
+// any loader thread starts and keep the pack open until everything that borrowed from it is gone
+// (streamed textures are copied into staging memory, so that is the end of the upload).
+void VgtMountAssetPack(const VgtAssetPack* pack);
+bool VgtFindMountedAsset(const char* name, VgtAssetView& view);
@@ -0,0 +1,233 @@
+#include "VgtBenchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "VgtPlatform.h"
+
+static const char* BackendName(VgtPresentBackend backend)
+{
+    switch (backend)
+    {
+    case VgtPresentBackend::Window: return "window";
+    case VgtPresentBackend::HeadlessSurface: return "headless-surface";
+    case VgtPresentBackend::Offscreen: return "offscreen";
+    }
+    return "unknown";
+}
+
+// Same spelling as --present-mode.
+static const char* PresentModeName(VkPresentModeKHR mode)
+{
+    switch (mode)
+    {
+    case VK_PRESENT_MODE_FIFO_KHR: return "fifo";
+    case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "fifo-relaxed";
+    case VK_PRESENT_MODE_MAILBOX_KHR: return "mailbox";
+    case VK_PRESENT_MODE_IMMEDIATE_KHR: return "immediate";
+    default: return "unknown";
+    }
+}
+
+// Moves the GPU samples collected since the last call into the report (or drops them during
+// warm-up). Each scope gains at most a few samples per frame, far below the ring size, so
+// reading them back from VgtGpuScope::history loses nothing in practice.
+static void CollectGpu(VgtBenchmark& bench, const VgtGpuTimer& timer, bool keep)
+{
+    bench.gpuSamplesSeen.resize(timer.scopes.size(), 0);
+    bench.gpuMs.resize(timer.scopes.size());
+    for (size_t i = 0; i < timer.scopes.size(); ++i)
+    {
+        const VgtGpuScope& s = timer.scopes[i];
+        const uint64_t fresh = s.samples - bench.gpuSamplesSeen[i];
+        bench.gpuSamplesSeen[i] = s.samples;
+        if (!keep || fresh == 0)
+            continue;
+
+        const uint32_t n = static_cast<uint32_t>(std::min<uint64_t>(fresh, kVgtGpuTimerWindow));
+        bench.gpuSamplesDropped += fresh - n;
+        for (uint32_t k = n; k > 0; --k)
+            bench.gpuMs[i].push_back(s.history[(s.next + kVgtGpuTimerWindow - k) % kVgtGpuTimerWindow]);
+    }
+}
+
+void VgtBenchmarkBegin(VgtBenchmark& bench, const char* label, const VgtOptions& options)
+{
+    bench = VgtBenchmark{};
+    bench.label = label;
+    bench.enabled = options.benchmark;
+    if (!bench.enabled)
+        return;
+
+    bench.warmupFrames = options.benchmarkWarmup;
+    bench.measuredFrames = options.benchmarkFrames;
+    bench.framesInFlight = options.framesInFlight;
+    bench.jsonPath = options.benchmarkJson;
+    bench.cpuMs.reserve(bench.measuredFrames);
+    bench.presentMs.reserve(bench.measuredFrames);
+    bench.start = VgtGetTimeSeconds();
+
+    std::fprintf(stderr, "[%s] benchmark: %u warm-up + %u measured frames, fixed %.3f ms timestep\n", label,
+        bench.warmupFrames, bench.measuredFrames, 1000.0 * kVgtBenchmarkTimestepSec);
+}
+
+void VgtBenchmarkPhase(VgtBenchmark& bench, const char* name, double ms)
+{
+    if (!bench.enabled)
+        return;
+
+    for (auto& phase : bench.phasesMs)
+    {
+        if (phase.first == name)
+        {
+            phase.second += ms;
+            return;
+        }
+    }
+    bench.phasesMs.emplace_back(name, ms);
+}
+
+double VgtBenchmarkElapsedMs(const VgtBenchmark& bench)
+{
+    return 1000.0 * (VgtGetTimeSeconds() - bench.start);
+}
+
+void VgtBenchmarkBeginFrames(VgtBenchmark& bench, const VgtPresenter& presenter)
+{
+    if (!bench.enabled)
+        return;
+
+    bench.backend = presenter.backend; // a headless surface may have fallen back to offscreen
+    bench.presentMode = presenter.presentMode;
+    bench.swapchainImages = static_cast<uint32_t>(presenter.images.size());
+
+    bench.lastTick = VgtGetTimeSeconds();
+    VgtBenchmarkPhase(bench, "init", 1000.0 * (bench.lastTick - bench.start));
+}
+
+double VgtBenchmarkTime(const VgtBenchmark& bench, double wallTime)
+{
+    if (!bench.enabled)
+        return wallTime;
+    return static_cast<double>(bench.frames) * kVgtBenchmarkTimestepSec;
+}
+
+void VgtBenchmarkTick(VgtBenchmark& bench, const VgtFrameStats& stats, const VgtGpuTimer& timer)
+{
+    if (!bench.enabled)
+        return;
+
+    const double now = VgtGetTimeSeconds();
+    if (bench.frames == 0)
+        VgtBenchmarkPhase(bench, "first_frame", 1000.0 * (now - bench.start));
+    const bool measuring = bench.frames >= bench.warmupFrames;
+    ++bench.frames;
+
+    if (measuring)
+    {
+        bench.presentMs.push_back(1000.0 * (now - bench.lastTick));
+        if (stats.totalCpuSamples != bench.cpuSamplesSeen)
+            bench.cpuMs.push_back(1000.0 * stats.lastCpuSec);
+    }
+    bench.cpuSamplesSeen = stats.totalCpuSamples;
+    bench.lastTick = now;
+    CollectGpu(bench, timer, measuring);
+}
+
+// {"min": .., "mean": .., "p50": .., "p95": .., "p99": .., "samples": n}, or null without samples.
+static void WriteStats(std::FILE* out, std::vector<double> values)
+{
+    if (values.empty())
+    {
+        std::fprintf(out, "null");
+        return;
+    }
+
+    std::sort(values.begin(), values.end());
+    const size_t n = values.size();
+    double sum = 0.0;
+    for (double v : values)
+        sum += v;
+    auto rank = [&](size_t p) { return values[(n * p + 99) / 100 - 1]; };
+
+    std::fprintf(out, "{\"min\": %.4f, \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"samples\": %zu}",
+        values.front(), sum / static_cast<double>(n), rank(50), rank(95), rank(99), n);
+}
+
+void VgtBenchmarkFinish(VgtBenchmark& bench, const VgtGpuTimer& timer)
+{
+    if (!bench.enabled)
+        return;
+
+    CollectGpu(bench, timer, bench.frames > bench.warmupFrames);
+
+    const uint64_t measured = bench.frames > bench.warmupFrames ? bench.frames - bench.warmupFrames : 0;
+    if (measured < bench.measuredFrames)
+    {
+        std::fprintf(stderr, "[%s] benchmark: stopped after %llu of %u measured frames\n", bench.label,
+            static_cast<unsigned long long>(measured), bench.measuredFrames);
+    }
+    if (bench.gpuSamplesDropped > 0)
+    {
+        std::fprintf(stderr, "[%s] benchmark: %llu GPU samples overwritten before they were read\n", bench.label,
+            static_cast<unsigned long long>(bench.gpuSamplesDropped));
+    }
+
+    std::FILE* out = stdout;
+    if (!bench.jsonPath.empty())
+    {
+        out = std::fopen(bench.jsonPath.c_str(), "w");
+        if (out == nullptr)
+        {
+            std::fprintf(stderr, "[%s] benchmark: cannot write %s, using stdout\n", bench.label, bench.jsonPath.c_str());
+            out = stdout;
+        }
+    }
+
+    std::fprintf(out, "{\n");
+    std::fprintf(out, "  \"label\": \"%s\",\n", bench.label);
+    std::fprintf(out, "  \"backend\": \"%s\",\n", BackendName(bench.backend));
+    // Offscreen images are never presented.
+    std::fprintf(out, "  \"present_mode\": \"%s\",\n",
+        bench.backend == VgtPresentBackend::Offscreen ? "none" : PresentModeName(bench.presentMode));
+    std::fprintf(out, "  \"swapchain_images\": %u,\n", bench.swapchainImages);
+    std::fprintf(out, "  \"frames_in_flight\": %u,\n", bench.framesInFlight);
+    std::fprintf(out, "  \"timestep_ms\": %.4f,\n", 1000.0 * kVgtBenchmarkTimestepSec);
+    std::fprintf(out, "  \"warmup_frames\": %u,\n", bench.warmupFrames);
+    std::fprintf(out, "  \"measured_frames\": %llu,\n", static_cast<unsigned long long>(measured));
+    std::fprintf(out, "  \"startup_ms\": {");
+    for (size_t i = 0; i < bench.phasesMs.size(); ++i)
+        std::fprintf(out, "%s\"%s\": %.4f", i == 0 ? "" : ", ", bench.phasesMs[i].first.c_str(), bench.phasesMs[i].second);
+    std::fprintf(out, "},\n");
+    std::fprintf(out, "  \"cpu_frame_ms\": ");
+    WriteStats(out, bench.cpuMs);
+    std::fprintf(out, ",\n  \"present_interval_ms\": ");
+    WriteStats(out, bench.presentMs);
+    std::fprintf(out, ",\n  \"gpu_ms\": ");
+    if (!VgtGpuTimerEnabled(timer))
+    {
+        // Disabled or unsupported (e.g. --static-command-buffers, no timestamp queries).
+        std::fprintf(out, "null");
+    }
+    else
+    {
+        std::fprintf(out, "{");
+        for (size_t i = 0; i < timer.scopes.size(); ++i)
+        {
+            std::fprintf(out, "%s\n    \"%s\": ", i == 0 ? "" : ",", timer.scopes[i].name.c_str());
+            WriteStats(out, i < bench.gpuMs.size() ? bench.gpuMs[i] : std::vector<double>());
+        }
+        std::fprintf(out, "\n  }");
+    }
+    std::fprintf(out, "\n}\n");
+
+    if (out != stdout)
+    {
+        std::fclose(out);
+        std::fprintf(stderr, "[%s] benchmark: wrote %s\n", bench.label, bench.jsonPath.c_str());
+    }
+    else
+    {
+        std::fflush(out);
+    }
+}
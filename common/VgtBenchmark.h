@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "VgtFrameStats.h"
+#include "VgtGpuTimer.h"
+#include "VgtOptions.h"
+#include "VgtPresenter.h"
+
+// Deterministic benchmark runs (--benchmark), so two builds can be compared by a script.
+//
+// - Animation advances by a fixed kVgtBenchmarkTimestepSec per frame instead of wall time
+//   (VgtBenchmarkTime), so every run renders the same sequence of frames.
+// - The first `warmupFrames` frames (pipeline warm-up, driver caches, clocks ramping up) are
+//   discarded; the next `measuredFrames` are recorded. VgtParseOptions sets the frame limit to
+//   their sum and turns on --gpu-timing.
+// - Per measured frame: CPU frame time (VgtFrameStatsCpuBegin/End: recording + submit), the
+//   interval between presents (wall time between ticks), and every GPU timer scope. GPU samples
+//   are read back frames-in-flight frames late; VgtBenchmarkFinish picks up the rest after
+//   VgtGpuTimerFinish collected the last slots.
+// - Startup is broken down too: VgtBenchmarkPhase adds named durations (pipeline creation,
+//   static uploads, ...), VgtBenchmarkBeginFrames records `init`, the time from
+//   VgtBenchmarkBegin (right after option parsing) to the frame loop, and the first
+//   VgtBenchmarkTick `first_frame`, the time until the first frame was presented.
+// - The report names the backend, present mode and image count the frame loop starts with
+//   (VgtBenchmarkBeginFrames), not the requested ones: an unsupported mode falls back to FIFO.
+// - VgtBenchmarkFinish writes min / mean / p50 / p95 / p99 (nearest rank, over all measured
+//   samples, not a rolling window) as one JSON object to --benchmark-json PATH, or stdout (the
+//   steps log to stderr, so stdout carries only the JSON).
+//
+// Everything is a no-op unless options.benchmark is set.
+
+constexpr double kVgtBenchmarkTimestepSec = 1.0 / 60.0;
+
+struct VgtBenchmark
+{
+    const char* label = "";
+    bool enabled = false;
+    uint32_t warmupFrames = 0;
+    uint32_t measuredFrames = 0;
+    uint32_t framesInFlight = 0;
+    // What the presenter actually created, set by VgtBenchmarkBeginFrames.
+    VgtPresentBackend backend = VgtPresentBackend::Window;
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    uint32_t swapchainImages = 0;
+    std::string jsonPath;
+
+    double start = 0.0;
+    std::vector<std::pair<std::string, double>> phasesMs; // startup breakdown, in first-seen order
+
+    uint64_t frames = 0;          // ticked so far, warm-up included
+    double lastTick = 0.0;
+    uint64_t cpuSamplesSeen = 0;  // VgtFrameStats::totalCpuSamples already consumed
+    std::vector<uint64_t> gpuSamplesSeen; // per scope, VgtGpuScope::samples already consumed
+    uint64_t gpuSamplesDropped = 0;
+
+    std::vector<double> cpuMs;
+    std::vector<double> presentMs;
+    std::vector<std::vector<double>> gpuMs; // per scope
+};
+
+// Call right after VgtParseOptions.
+void VgtBenchmarkBegin(VgtBenchmark& bench, const char* label, const VgtOptions& options);
+// Adds `ms` to the named startup phase.
+void VgtBenchmarkPhase(VgtBenchmark& bench, const char* name, double ms);
+// Milliseconds since VgtBenchmarkBegin, for phases that end asynchronously (e.g. a streamed texture).
+double VgtBenchmarkElapsedMs(const VgtBenchmark& bench);
+// Call right before the frame loop, once the swapchain exists.
+void VgtBenchmarkBeginFrames(VgtBenchmark& bench, const VgtPresenter& presenter);
+
+// Animation time of the frame being built: frame index * kVgtBenchmarkTimestepSec when
+// benchmarking, `wallTime` (seconds since the step started animating) otherwise.
+double VgtBenchmarkTime(const VgtBenchmark& bench, double wallTime);
+
+// Call once per presented frame, after VgtFrameStatsTick.
+void VgtBenchmarkTick(VgtBenchmark& bench, const VgtFrameStats& stats, const VgtGpuTimer& timer);
+// Call after VgtGpuTimerFinish; writes the JSON report.
+void VgtBenchmarkFinish(VgtBenchmark& bench, const VgtGpuTimer& timer);
@@ -0,0 +1,289 @@
+#include "VgtClusteredLights.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "VgtSpirv.h"
+
+namespace
+{
+// Matches the Params uniform block of cluster_lights.comp and lighting_clustered.frag (std140).
+struct ClusterParams
+{
+    VgtMat4 view;
+    float projection[4]; // tanHalfFovX, tanHalfFovY, zNear, zFar
+    float screen[4];     // width, height, tile width, tile height (px)
+    float slicing[4];    // slice scale, slice bias
+    uint32_t grid[4];    // tilesX, tilesY, slices, maxLightsPerCluster
+    uint32_t lights[4];  // lightCount
+};
+
+constexpr uint32_t kClusterGroupSize = 64; // local_size_x of cluster_lights.comp
+constexpr uint32_t kClusterBindingCount = 5;
+} // namespace
+
+static VkResult CreateClusterPipeline(VgtClusteredLights& clusters, bool shadersFromDisk)
+{
+    const VgtSpirvCode spv = VgtLoadSpirv("cluster_lights.comp.spv", shadersFromDisk);
+    if (spv.empty())
+        return VK_ERROR_INITIALIZATION_FAILED;
+
+    // 0 params, 1 world lights, 2 view lights, 3 counts, 4 indices.
+    VkDescriptorSetLayoutBinding bindings[kClusterBindingCount]{};
+    for (uint32_t i = 0; i < kClusterBindingCount; ++i)
+    {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = i == 0 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo setLayoutCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    setLayoutCI.bindingCount = kClusterBindingCount;
+    setLayoutCI.pBindings = bindings;
+    VkResult res = vkCreateDescriptorSetLayout(clusters.device, &setLayoutCI, nullptr, &clusters.setLayout);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkPipelineLayoutCreateInfo layoutCI{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    layoutCI.setLayoutCount = 1;
+    layoutCI.pSetLayouts = &clusters.setLayout;
+    res = vkCreatePipelineLayout(clusters.device, &layoutCI, nullptr, &clusters.pipelineLayout);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkShaderModuleCreateInfo moduleCI{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    moduleCI.codeSize = spv.size() * sizeof(uint32_t);
+    moduleCI.pCode = spv.data();
+    VkShaderModule module = VK_NULL_HANDLE;
+    res = vkCreateShaderModule(clusters.device, &moduleCI, nullptr, &module);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkComputePipelineCreateInfo pipelineCI{ VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    pipelineCI.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineCI.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineCI.stage.module = module;
+    pipelineCI.stage.pName = "main";
+    pipelineCI.layout = clusters.pipelineLayout;
+    res = vkCreateComputePipelines(clusters.device, VK_NULL_HANDLE, 1, &pipelineCI, nullptr, &clusters.pipeline);
+    vkDestroyShaderModule(clusters.device, module, nullptr);
+    return res;
+}
+
+static VkResult CreateClusterDescriptors(VgtClusteredLights& clusters, VkBuffer lightBuffer)
+{
+    VkDescriptorPoolSize poolSizes[2]{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    poolSizes[0].descriptorCount = 1;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[1].descriptorCount = kClusterBindingCount - 1;
+
+    VkDescriptorPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolCI.maxSets = 1;
+    poolCI.poolSizeCount = 2;
+    poolCI.pPoolSizes = poolSizes;
+    VkResult res = vkCreateDescriptorPool(clusters.device, &poolCI, nullptr, &clusters.descPool);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkDescriptorSetAllocateInfo setAI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    setAI.descriptorPool = clusters.descPool;
+    setAI.descriptorSetCount = 1;
+    setAI.pSetLayouts = &clusters.setLayout;
+    res = vkAllocateDescriptorSets(clusters.device, &setAI, &clusters.descSet);
+    if (res != VK_SUCCESS)
+        return res;
+
+    const VkBuffer buffers[kClusterBindingCount] = { clusters.paramBuffer, lightBuffer, clusters.viewLightBuffer, clusters.countBuffer,
+        clusters.indexBuffer };
+    VkDescriptorBufferInfo infos[kClusterBindingCount]{};
+    VkWriteDescriptorSet writes[kClusterBindingCount]{};
+    for (uint32_t i = 0; i < kClusterBindingCount; ++i)
+    {
+        infos[i].buffer = buffers[i];
+        infos[i].offset = 0;
+        infos[i].range = VK_WHOLE_SIZE;
+
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = clusters.descSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorType = i == 0 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].descriptorCount = 1;
+        writes[i].pBufferInfo = &infos[i];
+    }
+    vkUpdateDescriptorSets(clusters.device, kClusterBindingCount, writes, 0, nullptr);
+    return VK_SUCCESS;
+}
+
+static VkResult CreateDeviceBuffer(VgtAllocator& allocator, VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer& buffer,
+    VgtAllocation& allocation)
+{
+    VkBufferCreateInfo bufferCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    bufferCI.size = size;
+    bufferCI.usage = usage;
+    bufferCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    return VgtCreateBuffer(allocator, bufferCI, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, allocation);
+}
+
+VkResult VgtCreateClusteredLights(const VgtClusteredLightsCreateInfo& ci, VgtClusteredLights& clusters)
+{
+    clusters = VgtClusteredLights{};
+    clusters.device = ci.device;
+    clusters.allocator = ci.allocator;
+    clusters.lightCount = ci.lightCount;
+    clusters.tilesX = std::max(ci.tilesX, 1u);
+    clusters.tilesY = std::max(ci.tilesY, 1u);
+    clusters.slices = std::max(ci.slices, 1u);
+    clusters.maxLightsPerCluster = std::max(ci.maxLightsPerCluster, 1u);
+
+    const VkDeviceSize clusterCount = VgtClusterCount(clusters);
+    const VkDeviceSize lightCount = std::max(ci.lightCount, 1u); // zero-sized buffers are not allowed
+
+    VkResult res = CreateDeviceBuffer(*ci.allocator, sizeof(ClusterParams), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        clusters.paramBuffer, clusters.paramAlloc);
+    if (res == VK_SUCCESS)
+        res = CreateDeviceBuffer(*ci.allocator, sizeof(VgtLight) * lightCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, clusters.viewLightBuffer,
+            clusters.viewLightAlloc);
+    if (res == VK_SUCCESS)
+        res = CreateDeviceBuffer(*ci.allocator, sizeof(uint32_t) * clusterCount,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, clusters.countBuffer, clusters.countAlloc);
+    if (res == VK_SUCCESS)
+        res = CreateDeviceBuffer(*ci.allocator, sizeof(uint32_t) * clusterCount * clusters.maxLightsPerCluster,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, clusters.indexBuffer, clusters.indexAlloc);
+    if (res == VK_SUCCESS)
+        res = CreateClusterPipeline(clusters, ci.shadersFromDisk);
+    if (res == VK_SUCCESS)
+        res = CreateClusterDescriptors(clusters, ci.lightBuffer);
+    if (res != VK_SUCCESS)
+    {
+        VgtDestroyClusteredLights(clusters);
+        return res;
+    }
+    return VK_SUCCESS;
+}
+
+void VgtDestroyClusteredLights(VgtClusteredLights& clusters)
+{
+    if (clusters.pipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(clusters.device, clusters.pipeline, nullptr);
+    if (clusters.pipelineLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(clusters.device, clusters.pipelineLayout, nullptr);
+    if (clusters.descPool != VK_NULL_HANDLE)
+        vkDestroyDescriptorPool(clusters.device, clusters.descPool, nullptr);
+    if (clusters.setLayout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(clusters.device, clusters.setLayout, nullptr);
+    if (clusters.indexBuffer != VK_NULL_HANDLE)
+        VgtDestroyBuffer(*clusters.allocator, clusters.indexBuffer, clusters.indexAlloc);
+    if (clusters.countBuffer != VK_NULL_HANDLE)
+        VgtDestroyBuffer(*clusters.allocator, clusters.countBuffer, clusters.countAlloc);
+    if (clusters.viewLightBuffer != VK_NULL_HANDLE)
+        VgtDestroyBuffer(*clusters.allocator, clusters.viewLightBuffer, clusters.viewLightAlloc);
+    if (clusters.paramBuffer != VK_NULL_HANDLE)
+        VgtDestroyBuffer(*clusters.allocator, clusters.paramBuffer, clusters.paramAlloc);
+    clusters = VgtClusteredLights{};
+}
+
+static void ClusterBarrier(VkCommandBuffer cmd, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage,
+    VkAccessFlags dstAccess)
+{
+    VkMemoryBarrier barrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    vkCmdPipelineBarrier(cmd, srcStage, dstStage, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void VgtCmdClusterLights(VkCommandBuffer cmd, const VgtClusteredLights& clusters, const VgtMat4& view, float fovY, float aspect,
+    float zNear, float zFar, VkExtent2D extent)
+{
+    ClusterParams params{};
+    params.view = view;
+    params.projection[1] = std::tan(fovY * 0.5f);
+    params.projection[0] = params.projection[1] * aspect;
+    params.projection[2] = zNear;
+    params.projection[3] = zFar;
+    // Tiles cover the extent with whole pixels; the last row/column may reach past it.
+    params.screen[0] = static_cast<float>(extent.width);
+    params.screen[1] = static_cast<float>(extent.height);
+    params.screen[2] = static_cast<float>((extent.width + clusters.tilesX - 1) / clusters.tilesX);
+    params.screen[3] = static_cast<float>((extent.height + clusters.tilesY - 1) / clusters.tilesY);
+    // slice = log(depth) * scale + bias: 0 at zNear, `slices` at zFar.
+    const float logRatio = std::log(zFar / zNear);
+    params.slicing[0] = static_cast<float>(clusters.slices) / logRatio;
+    params.slicing[1] = -static_cast<float>(clusters.slices) * std::log(zNear) / logRatio;
+    params.grid[0] = clusters.tilesX;
+    params.grid[1] = clusters.tilesY;
+    params.grid[2] = clusters.slices;
+    params.grid[3] = clusters.maxLightsPerCluster;
+    params.lights[0] = clusters.lightCount;
+
+    // The previous frame's shading read the parameters and lists: wait for it before rewriting.
+    // A write-after-read hazard needs no memory dependency.
+    ClusterBarrier(cmd, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+        VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0);
+
+    vkCmdUpdateBuffer(cmd, clusters.paramBuffer, 0, sizeof(params), &params);
+    ClusterBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_UNIFORM_READ_BIT);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, clusters.pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, clusters.pipelineLayout, 0, 1, &clusters.descSet, 0, nullptr);
+    vkCmdDispatch(cmd, (VgtClusterCount(clusters) + kClusterGroupSize - 1) / kClusterGroupSize, 1, 1);
+
+    ClusterBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT);
+}
+
+void VgtMakeSpotCone(VgtLight& light, float innerAngle, float outerAngle)
+{
+    const float cosInner = std::cos(innerAngle);
+    const float cosOuter = std::cos(outerAngle);
+    light.spotScale = 1.0f / std::max(cosInner - cosOuter, 1e-4f);
+    light.spotOffset = -cosOuter * light.spotScale;
+}
+
+std::vector<VgtLight> VgtScatterLights(uint32_t count, const float boundsMin[3], const float boundsMax[3], float range,
+    const float target[3], uint32_t seed)
+{
+    // Small LCG: the same scene on every platform and standard library.
+    uint32_t state = seed * 747796405u + 2891336453u;
+    auto next = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) * (1.0f / 16777216.0f);
+    };
+
+    std::vector<VgtLight> lights(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        VgtLight& light = lights[i];
+        for (int c = 0; c < 3; ++c)
+            light.position[c] = boundsMin[c] + (boundsMax[c] - boundsMin[c]) * next();
+        light.range = range;
+
+        // Saturated hue around the color wheel, so overlapping lights stay distinguishable.
+        const float hue = next() * 6.0f;
+        const float offsets[3] = { 5.0f, 3.0f, 1.0f };
+        for (int c = 0; c < 3; ++c)
+        {
+            const float k = std::fmod(offsets[c] + hue, 6.0f);
+            light.color[c] = 1.0f - std::clamp(std::min(k, 4.0f - k), 0.0f, 1.0f);
+        }
+        light.intensity = 1.0f;
+
+        light.spotScale = 0.0f;
+        light.spotOffset = 1.0f;
+        if (i % 4 == 3)
+        {
+            float dir[3] = { target[0] - light.position[0], target[1] - light.position[1], target[2] - light.position[2] };
+            const float len = std::sqrt(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+            for (int c = 0; c < 3; ++c)
+                light.direction[c] = len > 0.0f ? dir[c] / len : (c == 1 ? -1.0f : 0.0f);
+            VgtMakeSpotCone(light, 0.35f, 0.6f);
+        }
+        else
+        {
+            light.direction[1] = -1.0f;
+        }
+    }
+    return lights;
+}
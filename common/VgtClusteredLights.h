@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "VgtAllocator.h"
+#include "VgtMath.h"
+
+// Clustered forward lighting: point and spot lights binned into view-space froxels on the GPU.
+//
+// - The view frustum is split into tilesX x tilesY screen tiles and `slices` depth slices,
+//   spaced exponentially between zNear and zFar so a cluster is roughly as deep as it is wide.
+// - VgtCmdClusterLights runs common/shaders/cluster_lights.comp with one invocation per cluster.
+//   Each workgroup walks the light list in batches through shared memory, transforms the lights
+//   to view space and tests their bounding spheres against its clusters' AABBs. The first
+//   workgroup also writes the view-space lights used for shading.
+// - Each cluster has a fixed slot of maxLightsPerCluster light indices. Its count is stored
+//   unclamped (so overflow can be detected), and shaders must clamp it: that clamp keeps the
+//   per-pixel cost bounded however many lights overlap.
+// - One descriptor set holds everything (VgtClusteredLights::setLayout, compute + fragment
+//   stages). Fragment shaders bind it as their own set and index it with the cluster of the
+//   fragment; see steps/Step05_LightingBasic/shaders/lighting_clustered.frag for the lookup.
+//
+// Steps using it must compile cluster_lights.comp (it is loaded as "cluster_lights.comp.spv").
+
+// One light, std430 layout (4 x vec4). Spot cones use the attenuation
+// clamp(dot(-L, direction) * spotScale + spotOffset, 0, 1)^2; point lights have spotScale 0,
+// spotOffset 1 (see VgtMakeSpotCone).
+struct VgtLight
+{
+    float position[3];
+    float range;
+    float color[3];
+    float intensity;
+    float direction[3];
+    float spotScale;
+    float spotOffset;
+    float pad[3];
+};
+
+struct VgtClusteredLightsCreateInfo
+{
+    VkDevice device = VK_NULL_HANDLE;
+    VgtAllocator* allocator = nullptr;
+    VkBuffer lightBuffer = VK_NULL_HANDLE; // lightCount VgtLight in world space (STORAGE)
+    uint32_t lightCount = 0;
+    uint32_t tilesX = 16;
+    uint32_t tilesY = 9;
+    uint32_t slices = 24;
+    uint32_t maxLightsPerCluster = 128;
+    bool shadersFromDisk = false;          // for cluster_lights.comp.spv, see VgtLoadSpirv
+};
+
+struct VgtClusteredLights
+{
+    VkDevice device = VK_NULL_HANDLE;
+    VgtAllocator* allocator = nullptr;
+    uint32_t lightCount = 0;
+    uint32_t tilesX = 0;
+    uint32_t tilesY = 0;
+    uint32_t slices = 0;
+    uint32_t maxLightsPerCluster = 0;
+
+    VkBuffer paramBuffer = VK_NULL_HANDLE;     // grid and projection parameters (UNIFORM), updated per frame
+    VgtAllocation paramAlloc;
+    VkBuffer viewLightBuffer = VK_NULL_HANDLE; // lights in view space (STORAGE)
+    VgtAllocation viewLightAlloc;
+    VkBuffer countBuffer = VK_NULL_HANDLE;     // uint per cluster, unclamped (STORAGE | TRANSFER_SRC)
+    VgtAllocation countAlloc;
+    VkBuffer indexBuffer = VK_NULL_HANDLE;     // maxLightsPerCluster uint per cluster (STORAGE)
+    VgtAllocation indexAlloc;
+
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descPool = VK_NULL_HANDLE;
+    VkDescriptorSet descSet = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+};
+
+VkResult VgtCreateClusteredLights(const VgtClusteredLightsCreateInfo& ci, VgtClusteredLights& clusters);
+void VgtDestroyClusteredLights(VgtClusteredLights& clusters);
+
+inline uint32_t VgtClusterCount(const VgtClusteredLights& clusters)
+{
+    return clusters.tilesX * clusters.tilesY * clusters.slices;
+}
+
+// Records the binning outside a render pass, for a symmetric perspective projection with the
+// given vertical field of view, aspect and clip distances (as passed to VgtMat4Perspective or
+// VgtMat4PerspectiveReverseZ) rendering to `extent`. Orders itself after the previous frame's
+// shading and the following fragment shaders after the dispatch, on the same queue.
+void VgtCmdClusterLights(VkCommandBuffer cmd, const VgtClusteredLights& clusters, const VgtMat4& view, float fovY, float aspect,
+    float zNear, float zFar, VkExtent2D extent);
+
+// Spot cone attenuation terms for VgtLight, from the inner (full intensity) and outer half-angles.
+void VgtMakeSpotCone(VgtLight& light, float innerAngle, float outerAngle);
+
+// Deterministic test scene: `count` lights with the given range scattered uniformly in the box
+// [boundsMin, boundsMax], in varied colors. Every fourth light is a spot light aimed at `target`.
+std::vector<VgtLight> VgtScatterLights(uint32_t count, const float boundsMin[3], const float boundsMax[3], float range,
+    const float target[3], uint32_t seed = 1);
@@ -0,0 +1,72 @@
+#include "VgtDepth.h"
+
+VkFormat VgtPickDepthFormat(VkPhysicalDevice physicalDevice)
+{
+    const VkFormat candidates[] = {
+        VK_FORMAT_D32_SFLOAT,
+        VK_FORMAT_D32_SFLOAT_S8_UINT,
+        VK_FORMAT_D24_UNORM_S8_UINT,
+        VK_FORMAT_D16_UNORM,
+    };
+    for (const VkFormat format : candidates)
+    {
+        VkFormatProperties props{};
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &props);
+        if (props.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT)
+            return format;
+    }
+    return VK_FORMAT_UNDEFINED;
+}
+
+bool VgtDepthFormatHasStencil(VkFormat format)
+{
+    return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D16_UNORM_S8_UINT ||
+        format == VK_FORMAT_S8_UINT;
+}
+
+VkResult VgtCreateDepthBuffer(VgtAllocator& allocator, VkDevice device, VkFormat format, VkExtent2D extent, VgtDepthBuffer& depth)
+{
+    depth = VgtDepthBuffer{};
+    depth.format = format;
+
+    VkImageCreateInfo imageCI{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    imageCI.imageType = VK_IMAGE_TYPE_2D;
+    imageCI.extent = { extent.width, extent.height, 1 };
+    imageCI.mipLevels = 1;
+    imageCI.arrayLayers = 1;
+    imageCI.format = format;
+    imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageCI.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    imageCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
+    VkResult res = VgtCreateImage(allocator, imageCI, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, depth.image, depth.allocation);
+    if (res != VK_SUCCESS)
+    {
+        depth = VgtDepthBuffer{};
+        return res;
+    }
+
+    // The view only exposes the depth aspect: it is never sampled, and the stencil part of a
+    // combined format is just cleared along with it.
+    VkImageViewCreateInfo viewCI{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    viewCI.image = depth.image;
+    viewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewCI.format = format;
+    viewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+    viewCI.subresourceRange.levelCount = 1;
+    viewCI.subresourceRange.layerCount = 1;
+    res = vkCreateImageView(device, &viewCI, nullptr, &depth.view);
+    if (res != VK_SUCCESS)
+        VgtDestroyDepthBuffer(allocator, device, depth);
+    return res;
+}
+
+void VgtDestroyDepthBuffer(VgtAllocator& allocator, VkDevice device, VgtDepthBuffer& depth)
+{
+    if (depth.view != VK_NULL_HANDLE)
+        vkDestroyImageView(device, depth.view, nullptr);
+    if (depth.image != VK_NULL_HANDLE)
+        VgtDestroyImage(allocator, depth.image, depth.allocation);
+    depth = VgtDepthBuffer{};
+}
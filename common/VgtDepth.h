@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "VgtAllocator.h"
+
+// Depth attachment shared by the steps that draw 3D geometry.
+//
+// - VgtPickDepthFormat takes the first of D32_SFLOAT, D32_SFLOAT_S8_UINT, D24_UNORM_S8_UINT,
+//   D16_UNORM the device supports as an optimal-tiling depth attachment. D16_UNORM is always
+//   supported, so it is the fallback rather than a real choice.
+// - Reverse-Z (VgtMat4PerspectiveReverseZ) only pays off with a float format: near maps to 1,
+//   far to 0, and the dense float values near 0 end up where the projection is coarsest.
+//   With D24/D16 it changes nothing but the test direction.
+// - One depth image is enough for any number of frames in flight: the render pass orders each
+//   frame's depth clear after the previous frame's depth tests (see the steps' subpass dependency).
+struct VgtDepthBuffer
+{
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkImage image = VK_NULL_HANDLE;
+    VgtAllocation allocation;
+    VkImageView view = VK_NULL_HANDLE;
+};
+
+// Returns VK_FORMAT_UNDEFINED when none of the candidates is supported.
+VkFormat VgtPickDepthFormat(VkPhysicalDevice physicalDevice);
+bool VgtDepthFormatHasStencil(VkFormat format);
+
+VkResult VgtCreateDepthBuffer(VgtAllocator& allocator, VkDevice device, VkFormat format, VkExtent2D extent, VgtDepthBuffer& depth);
+void VgtDestroyDepthBuffer(VgtAllocator& allocator, VkDevice device, VgtDepthBuffer& depth);
+
+// Depth clear value and test for the standard (0 near, 1 far) or reversed convention.
+// The OR_EQUAL variants let a second pass over the same geometry (depth pre-pass) use EQUAL.
+inline float VgtDepthClearValue(bool reverseZ)
+{
+    return reverseZ ? 0.0f : 1.0f;
+}
+
+inline VkCompareOp VgtDepthCompareOp(bool reverseZ)
+{
+    return reverseZ ? VK_COMPARE_OP_GREATER_OR_EQUAL : VK_COMPARE_OP_LESS_OR_EQUAL;
+}
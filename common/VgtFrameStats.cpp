@@ -0,0 +1,85 @@
+#include "VgtFrameStats.h"
+
+#include <cstdio>
+
+static double SecondsBetween(VgtFrameStats::Clock::time_point a, VgtFrameStats::Clock::time_point b)
+{
+    return std::chrono::duration<double>(b - a).count();
+}
+
+void VgtFrameStatsBegin(VgtFrameStats& stats, const char* label, bool enabled)
+{
+    stats.label = label;
+    stats.enabled = enabled;
+    stats.start = VgtFrameStats::Clock::now();
+    stats.windowStart = stats.start;
+    stats.totalFrames = 0;
+    stats.windowFrames = 0;
+    stats.lastCpuSec = 0.0;
+    stats.totalCpuSec = 0.0;
+    stats.windowCpuSec = 0.0;
+    stats.totalCpuSamples = 0;
+    stats.windowCpuSamples = 0;
+}
+
+void VgtFrameStatsTick(VgtFrameStats& stats)
+{
+    ++stats.totalFrames;
+    ++stats.windowFrames;
+    if (!stats.enabled)
+        return;
+
+    const auto now = VgtFrameStats::Clock::now();
+    const double elapsed = SecondsBetween(stats.windowStart, now);
+    if (elapsed < stats.reportIntervalSec)
+        return;
+
+    const double fps = static_cast<double>(stats.windowFrames) / elapsed;
+    if (stats.windowCpuSamples > 0)
+    {
+        const double cpuMs = 1000.0 * stats.windowCpuSec / static_cast<double>(stats.windowCpuSamples);
+        std::fprintf(stderr, "[%s] %.1f fps (%.3f ms/frame, cpu %.4f ms/frame)\n", stats.label, fps, 1000.0 / fps, cpuMs);
+    }
+    else
+    {
+        std::fprintf(stderr, "[%s] %.1f fps (%.3f ms/frame)\n", stats.label, fps, 1000.0 / fps);
+    }
+    stats.windowStart = now;
+    stats.windowFrames = 0;
+    stats.windowCpuSec = 0.0;
+    stats.windowCpuSamples = 0;
+}
+
+void VgtFrameStatsCpuBegin(VgtFrameStats& stats)
+{
+    stats.cpuStart = VgtFrameStats::Clock::now();
+}
+
+void VgtFrameStatsCpuEnd(VgtFrameStats& stats)
+{
+    const double sec = SecondsBetween(stats.cpuStart, VgtFrameStats::Clock::now());
+    stats.lastCpuSec = sec;
+    stats.totalCpuSec += sec;
+    stats.windowCpuSec += sec;
+    ++stats.totalCpuSamples;
+    ++stats.windowCpuSamples;
+}
+
+void VgtFrameStatsFinish(VgtFrameStats& stats)
+{
+    if (!stats.enabled || stats.totalFrames == 0)
+        return;
+
+    const double elapsed = SecondsBetween(stats.start, VgtFrameStats::Clock::now());
+    if (elapsed <= 0.0)
+        return;
+
+    const double fps = static_cast<double>(stats.totalFrames) / elapsed;
+    std::fprintf(stderr, "[%s] average: %.1f fps over %llu frames (%.3f ms/frame)\n",
+        stats.label, fps, static_cast<unsigned long long>(stats.totalFrames), 1000.0 / fps);
+    if (stats.totalCpuSamples > 0)
+    {
+        std::fprintf(stderr, "[%s] average cpu: %.4f ms/frame\n",
+            stats.label, 1000.0 * stats.totalCpuSec / static_cast<double>(stats.totalCpuSamples));
+    }
+}
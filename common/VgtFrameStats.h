@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Minimal frame-rate counter used to compare frame pacing settings (e.g. frames in flight).
+// Prints one line per report interval to stderr, plus a summary on VgtFrameStatsFinish().
+// Optionally also accumulates CPU time spent building each frame (between
+// VgtFrameStatsCpuBegin/End), e.g. command recording + submit.
+struct VgtFrameStats
+{
+    using Clock = std::chrono::steady_clock;
+
+    const char* label = "";
+    bool enabled = false;
+    double reportIntervalSec = 2.0;
+
+    Clock::time_point start{};
+    Clock::time_point windowStart{};
+    uint64_t totalFrames = 0;
+    uint64_t windowFrames = 0;
+
+    Clock::time_point cpuStart{};
+    double lastCpuSec = 0.0;
+    double totalCpuSec = 0.0;
+    double windowCpuSec = 0.0;
+    uint64_t totalCpuSamples = 0;
+    uint64_t windowCpuSamples = 0;
+};
+
+void VgtFrameStatsBegin(VgtFrameStats& stats, const char* label, bool enabled);
+void VgtFrameStatsTick(VgtFrameStats& stats);
+void VgtFrameStatsCpuBegin(VgtFrameStats& stats);
+void VgtFrameStatsCpuEnd(VgtFrameStats& stats);
+void VgtFrameStatsFinish(VgtFrameStats& stats);
@@ -0,0 +1,122 @@
+#include "VgtFrameSync.h"
+
+#include <algorithm>
+
+#include "VgtTrace.h"
+
+VkResult VgtCreateFrameSync(VkDevice device, uint32_t framesInFlight, uint32_t swapImageCount, VgtFrameSync& sync)
+{
+    sync.framesInFlight = framesInFlight;
+    sync.currentFrame = 0;
+    sync.inFlight.assign(framesInFlight, VK_NULL_HANDLE);
+    sync.imageAvailable.assign(framesInFlight, VK_NULL_HANDLE);
+    sync.renderFinished.assign(swapImageCount, VK_NULL_HANDLE);
+    sync.imagesInFlight.assign(swapImageCount, VK_NULL_HANDLE);
+
+    VkSemaphoreCreateInfo semCI{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+    VkFenceCreateInfo fenceCI{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    fenceCI.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+    for (uint32_t i = 0; i < framesInFlight; ++i)
+    {
+        VkResult res = vkCreateSemaphore(device, &semCI, nullptr, &sync.imageAvailable[i]);
+        if (res != VK_SUCCESS)
+            return res;
+        res = vkCreateFence(device, &fenceCI, nullptr, &sync.inFlight[i]);
+        if (res != VK_SUCCESS)
+            return res;
+    }
+
+    for (uint32_t i = 0; i < swapImageCount; ++i)
+    {
+        const VkResult res = vkCreateSemaphore(device, &semCI, nullptr, &sync.renderFinished[i]);
+        if (res != VK_SUCCESS)
+            return res;
+    }
+
+    return VK_SUCCESS;
+}
+
+void VgtDestroyFrameSync(VkDevice device, VgtFrameSync& sync)
+{
+    for (auto it = sync.retired.rbegin(); it != sync.retired.rend(); ++it)
+        it->destroy();
+    for (auto s : sync.renderFinished)
+        vkDestroySemaphore(device, s, nullptr);
+    for (auto s : sync.imageAvailable)
+        vkDestroySemaphore(device, s, nullptr);
+    for (auto f : sync.inFlight)
+        vkDestroyFence(device, f, nullptr);
+
+    sync = VgtFrameSync{};
+}
+
+VkResult VgtWaitForFrame(VkDevice device, VgtFrameSync& sync)
+{
+    VgtTraceZone zone("fence wait");
+    const VkResult res = vkWaitForFences(device, 1, &sync.inFlight[sync.currentFrame], VK_TRUE, UINT64_MAX);
+    zone.End();
+    if (res != VK_SUCCESS || sync.retired.empty())
+        return res;
+
+    // The fence of this slot was signaled by frame (frameNumber - framesInFlight), and a fence
+    // signal covers everything submitted to the queue before it: that frame and all older ones
+    // are done. Newest first, so e.g. framebuffers go before the swapchain retired ahead of them.
+    auto done = [&sync](const VgtRetiredObject& r) { return r.frameNumber + sync.framesInFlight <= sync.frameNumber; };
+    for (auto it = sync.retired.rbegin(); it != sync.retired.rend(); ++it)
+    {
+        if (done(*it))
+            it->destroy();
+    }
+    sync.retired.erase(std::remove_if(sync.retired.begin(), sync.retired.end(), done), sync.retired.end());
+    return res;
+}
+
+void VgtRetire(VgtFrameSync& sync, std::function<void()> destroy)
+{
+    sync.retired.push_back({ sync.frameNumber, std::move(destroy) });
+}
+
+VkResult VgtRecreateImageSync(VkDevice device, VgtFrameSync& sync, uint32_t swapImageCount)
+{
+    VgtRetire(sync, [device, semaphores = std::move(sync.renderFinished)]() {
+        for (auto s : semaphores)
+            vkDestroySemaphore(device, s, nullptr);
+    });
+
+    // New images: no frame has rendered to them yet.
+    sync.renderFinished.assign(swapImageCount, VK_NULL_HANDLE);
+    sync.imagesInFlight.assign(swapImageCount, VK_NULL_HANDLE);
+
+    VkSemaphoreCreateInfo semCI{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+    for (uint32_t i = 0; i < swapImageCount; ++i)
+    {
+        const VkResult res = vkCreateSemaphore(device, &semCI, nullptr, &sync.renderFinished[i]);
+        if (res != VK_SUCCESS)
+            return res;
+    }
+    return VK_SUCCESS;
+}
+
+VkResult VgtClaimImage(VkDevice device, VgtFrameSync& sync, uint32_t imageIndex)
+{
+    VkFence frameFence = sync.inFlight[sync.currentFrame];
+    VkFence imageFence = sync.imagesInFlight[imageIndex];
+    if (imageFence != VK_NULL_HANDLE && imageFence != frameFence)
+    {
+        const VkResult res = vkWaitForFences(device, 1, &imageFence, VK_TRUE, UINT64_MAX);
+        if (res != VK_SUCCESS)
+            return res;
+    }
+    sync.imagesInFlight[imageIndex] = frameFence;
+
+    // Reset only once we know a submit will follow; resetting before a failed acquire
+    // would leave the fence unsignaled forever.
+    return vkResetFences(device, 1, &frameFence);
+}
+
+void VgtAdvanceFrame(VgtFrameSync& sync)
+{
+    sync.currentFrame = (sync.currentFrame + 1) % sync.framesInFlight;
+    ++sync.frameNumber;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+// Synchronization for N frames in flight.
+//
+// - Per frame slot: an `inFlight` fence and an `imageAvailable` semaphore.
+//   The fence guards everything owned by that slot (command buffer, per-frame data).
+// - Per swapchain image: a `renderFinished` semaphore. The presentation engine holds it
+//   until the image is re-acquired, so it cannot be tied to a frame slot.
+// - `imagesInFlight[image]` remembers which slot fence last rendered to an image, so an
+//   image acquired out of order is not written while an older frame still uses it.
+// - `retired` holds objects the frames in flight may still use (e.g. a replaced swapchain and
+//   its framebuffers, see VgtRetire). They are destroyed as the frames retire, so replacing
+//   them never needs vkDeviceWaitIdle.
+struct VgtRetiredObject
+{
+    uint64_t frameNumber = 0; // VgtFrameSync::frameNumber when it was retired
+    std::function<void()> destroy;
+};
+
+struct VgtFrameSync
+{
+    uint32_t framesInFlight = 0;
+    uint32_t currentFrame = 0;
+    uint64_t frameNumber = 0; // frames advanced so far
+
+    std::vector<VkFence> inFlight;
+    std::vector<VkSemaphore> imageAvailable;
+    std::vector<VkSemaphore> renderFinished;
+    std::vector<VkFence> imagesInFlight;
+
+    std::vector<VgtRetiredObject> retired;
+};
+
+VkResult VgtCreateFrameSync(VkDevice device, uint32_t framesInFlight, uint32_t swapImageCount, VgtFrameSync& sync);
+// Call after the device is idle: also destroys everything still retired.
+void VgtDestroyFrameSync(VkDevice device, VgtFrameSync& sync);
+
+// Blocks until the current frame slot has retired on the GPU, then destroys the retired
+// objects no frame can use anymore.
+VkResult VgtWaitForFrame(VkDevice device, VgtFrameSync& sync);
+
+// Calls `destroy` once every frame advanced so far, and the one after it, has retired: by
+// then the presents queued with those frames have been processed too. Call between frames
+// (before the acquire, or after VgtAdvanceFrame).
+void VgtRetire(VgtFrameSync& sync, std::function<void()> destroy);
+
+// New renderFinished semaphores for a recreated swapchain with `swapImageCount` images.
+// The old ones may still be waited on by a present of the old swapchain, so they are retired.
+VkResult VgtRecreateImageSync(VkDevice device, VgtFrameSync& sync, uint32_t swapImageCount);
+
+// Call after vkAcquireNextImageKHR succeeded: waits for an older frame still rendering to
+// `imageIndex`, hands the image to the current slot and resets the slot fence for submit.
+VkResult VgtClaimImage(VkDevice device, VgtFrameSync& sync, uint32_t imageIndex);
+
+// Moves to the next frame slot after present.
+void VgtAdvanceFrame(VgtFrameSync& sync);
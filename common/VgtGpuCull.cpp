@@ -0,0 +1,218 @@
+#include "VgtGpuCull.h"
+
+#include <cstring>
+
+#include "VgtSpirv.h"
+
+namespace
+{
+// Matches the push constant block of frustum_cull.comp.
+struct CullPushConstants
+{
+    VgtVec4 planes[6];
+    uint32_t objectCount;
+    uint32_t indexCount;
+    uint32_t compact;
+    uint32_t pad;
+};
+
+constexpr uint32_t kCullGroupSize = 64; // local_size_x of frustum_cull.comp
+} // namespace
+
+static VkResult CreateCullPipeline(VgtGpuCull& cull, bool shadersFromDisk)
+{
+    const VgtSpirvCode spv = VgtLoadSpirv("frustum_cull.comp.spv", shadersFromDisk);
+    if (spv.empty())
+        return VK_ERROR_INITIALIZATION_FAILED;
+
+    VkDescriptorSetLayoutBinding bindings[3]{};
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo setLayoutCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    setLayoutCI.bindingCount = 3;
+    setLayoutCI.pBindings = bindings;
+    VkResult res = vkCreateDescriptorSetLayout(cull.device, &setLayoutCI, nullptr, &cull.setLayout);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkPushConstantRange pushRange{};
+    pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushRange.offset = 0;
+    pushRange.size = sizeof(CullPushConstants);
+
+    VkPipelineLayoutCreateInfo layoutCI{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    layoutCI.setLayoutCount = 1;
+    layoutCI.pSetLayouts = &cull.setLayout;
+    layoutCI.pushConstantRangeCount = 1;
+    layoutCI.pPushConstantRanges = &pushRange;
+    res = vkCreatePipelineLayout(cull.device, &layoutCI, nullptr, &cull.pipelineLayout);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkShaderModuleCreateInfo moduleCI{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    moduleCI.codeSize = spv.size() * sizeof(uint32_t);
+    moduleCI.pCode = spv.data();
+    VkShaderModule module = VK_NULL_HANDLE;
+    res = vkCreateShaderModule(cull.device, &moduleCI, nullptr, &module);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkComputePipelineCreateInfo pipelineCI{ VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    pipelineCI.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineCI.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineCI.stage.module = module;
+    pipelineCI.stage.pName = "main";
+    pipelineCI.layout = cull.pipelineLayout;
+    res = vkCreateComputePipelines(cull.device, VK_NULL_HANDLE, 1, &pipelineCI, nullptr, &cull.pipeline);
+    vkDestroyShaderModule(cull.device, module, nullptr);
+    return res;
+}
+
+static VkResult CreateCullDescriptors(VgtGpuCull& cull, VkBuffer boundsBuffer)
+{
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 3;
+
+    VkDescriptorPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolCI.maxSets = 1;
+    poolCI.poolSizeCount = 1;
+    poolCI.pPoolSizes = &poolSize;
+    VkResult res = vkCreateDescriptorPool(cull.device, &poolCI, nullptr, &cull.descPool);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkDescriptorSetAllocateInfo setAI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    setAI.descriptorPool = cull.descPool;
+    setAI.descriptorSetCount = 1;
+    setAI.pSetLayouts = &cull.setLayout;
+    res = vkAllocateDescriptorSets(cull.device, &setAI, &cull.descSet);
+    if (res != VK_SUCCESS)
+        return res;
+
+    const VkBuffer buffers[3] = { boundsBuffer, cull.commandBuffer, cull.countBuffer };
+    VkDescriptorBufferInfo infos[3]{};
+    VkWriteDescriptorSet writes[3]{};
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        infos[i].buffer = buffers[i];
+        infos[i].offset = 0;
+        infos[i].range = VK_WHOLE_SIZE;
+
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = cull.descSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].descriptorCount = 1;
+        writes[i].pBufferInfo = &infos[i];
+    }
+    vkUpdateDescriptorSets(cull.device, 3, writes, 0, nullptr);
+    return VK_SUCCESS;
+}
+
+VkResult VgtCreateGpuCull(const VgtGpuCullCreateInfo& ci, VgtGpuCull& cull)
+{
+    cull = VgtGpuCull{};
+    cull.device = ci.device;
+    cull.allocator = ci.allocator;
+    cull.path = ci.path;
+    cull.objectCount = ci.objectCount;
+    cull.indexCount = ci.indexCount;
+    cull.commandBuffer = ci.commandBuffer;
+    cull.countBuffer = ci.countBuffer;
+
+    if (ci.path == VgtIndirectPath::Instanced)
+        return VK_ERROR_FEATURE_NOT_PRESENT;
+
+    VkResult res = CreateCullPipeline(cull, ci.shadersFromDisk);
+    if (res == VK_SUCCESS)
+        res = CreateCullDescriptors(cull, ci.boundsBuffer);
+    if (res == VK_SUCCESS)
+    {
+        VkBufferCreateInfo readbackCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+        readbackCI.size = sizeof(uint32_t) * (ci.framesInFlight > 0 ? ci.framesInFlight : 1);
+        readbackCI.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        readbackCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        res = VgtCreateBuffer(*ci.allocator, readbackCI, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            cull.readback, cull.readbackAlloc);
+    }
+    if (res != VK_SUCCESS)
+    {
+        VgtDestroyGpuCull(cull);
+        return res;
+    }
+
+    // Nothing culled yet: report 0 until a slot's first cull has retired.
+    std::memset(cull.readbackAlloc.mapped, 0, static_cast<size_t>(cull.readbackAlloc.size));
+    return VK_SUCCESS;
+}
+
+void VgtDestroyGpuCull(VgtGpuCull& cull)
+{
+    if (cull.readback != VK_NULL_HANDLE)
+        VgtDestroyBuffer(*cull.allocator, cull.readback, cull.readbackAlloc);
+    if (cull.pipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(cull.device, cull.pipeline, nullptr);
+    if (cull.pipelineLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(cull.device, cull.pipelineLayout, nullptr);
+    if (cull.descPool != VK_NULL_HANDLE)
+        vkDestroyDescriptorPool(cull.device, cull.descPool, nullptr);
+    if (cull.setLayout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(cull.device, cull.setLayout, nullptr);
+    cull = VgtGpuCull{};
+}
+
+static void CullBarrier(VkCommandBuffer cmd, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage,
+    VkAccessFlags dstAccess)
+{
+    VkMemoryBarrier barrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    vkCmdPipelineBarrier(cmd, srcStage, dstStage, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void VgtCmdGpuCull(VkCommandBuffer cmd, const VgtGpuCull& cull, uint32_t frame, const VgtMat4& viewProj)
+{
+    // The previous frame's draw (and count copy) read these buffers: wait for them before
+    // rewriting. A write-after-read hazard needs no memory dependency.
+    CullBarrier(cmd, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+        VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0);
+
+    vkCmdFillBuffer(cmd, cull.countBuffer, 0, sizeof(uint32_t), 0);
+    CullBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    CullPushConstants push{};
+    VgtMat4FrustumPlanes(viewProj, push.planes);
+    push.objectCount = cull.objectCount;
+    push.indexCount = cull.indexCount;
+    push.compact = cull.path == VgtIndirectPath::Count ? 1u : 0u;
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, cull.pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, cull.pipelineLayout, 0, 1, &cull.descSet, 0, nullptr);
+    vkCmdPushConstants(cmd, cull.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push), &push);
+    vkCmdDispatch(cmd, (cull.objectCount + kCullGroupSize - 1) / kCullGroupSize, 1, 1);
+
+    CullBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT);
+
+    VkBufferCopy copy{};
+    copy.srcOffset = 0;
+    copy.dstOffset = sizeof(uint32_t) * frame;
+    copy.size = sizeof(uint32_t);
+    vkCmdCopyBuffer(cmd, cull.countBuffer, cull.readback, 1, &copy);
+    CullBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+}
+
+uint32_t VgtGpuCullVisibleCount(const VgtGpuCull& cull, uint32_t frame)
+{
+    uint32_t visible = 0;
+    std::memcpy(&visible, static_cast<const uint8_t*>(cull.readbackAlloc.mapped) + sizeof(uint32_t) * frame, sizeof(visible));
+    return visible;
+}
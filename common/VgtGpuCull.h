@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+#include "VgtAllocator.h"
+#include "VgtIndirectDraw.h"
+#include "VgtMath.h"
+
+// Frustum culling on the GPU, feeding the indirect draw path (see VgtIndirectDraw.h).
+//
+// - common/shaders/frustum_cull.comp runs one invocation per object and tests its bounding
+//   sphere against the six planes of the frame's view-projection (VgtMat4FrustumPlanes).
+// - VgtIndirectPath::Count: visible objects append their command { indexCount, 1, 0, 0, object }
+//   with an atomic on the count buffer, so vkCmdDrawIndexedIndirectCount only walks the
+//   visible ones. Command order changes from frame to frame; nothing here depends on it.
+// - VgtIndirectPath::Multi: one command per object stays in place, culled ones get
+//   instanceCount 0. The count buffer still counts the visible objects.
+// - VgtIndirectPath::Instanced has a single command and cannot be culled per object.
+// - Each frame's count is copied to a host-visible slot per frame in flight, so the visible
+//   count can be reported without stalling.
+//
+// Steps using it must compile frustum_cull.comp (it is loaded as "frustum_cull.comp.spv").
+struct VgtGpuCullCreateInfo
+{
+    VkDevice device = VK_NULL_HANDLE;
+    VgtAllocator* allocator = nullptr;
+    VgtIndirectPath path = VgtIndirectPath::Count; // Count or Multi
+    uint32_t objectCount = 0;
+    uint32_t indexCount = 0;                        // indices per object (one shared mesh)
+    VkBuffer boundsBuffer = VK_NULL_HANDLE;         // vec4 per object: world-space center xyz, radius w (STORAGE)
+    VkBuffer commandBuffer = VK_NULL_HANDLE;        // objectCount VkDrawIndexedIndirectCommand (STORAGE | INDIRECT)
+    VkBuffer countBuffer = VK_NULL_HANDLE;          // uint32_t (STORAGE | INDIRECT | TRANSFER_SRC | TRANSFER_DST)
+    uint32_t framesInFlight = 1;
+    bool shadersFromDisk = false;                   // for frustum_cull.comp.spv, see VgtLoadSpirv
+};
+
+struct VgtGpuCull
+{
+    VkDevice device = VK_NULL_HANDLE;
+    VgtAllocator* allocator = nullptr;
+    VgtIndirectPath path = VgtIndirectPath::Count;
+    uint32_t objectCount = 0;
+    uint32_t indexCount = 0;
+    VkBuffer commandBuffer = VK_NULL_HANDLE;
+    VkBuffer countBuffer = VK_NULL_HANDLE;
+
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descPool = VK_NULL_HANDLE;
+    VkDescriptorSet descSet = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+
+    VkBuffer readback = VK_NULL_HANDLE;             // uint32_t per frame in flight, host-visible
+    VgtAllocation readbackAlloc;
+};
+
+VkResult VgtCreateGpuCull(const VgtGpuCullCreateInfo& ci, VgtGpuCull& cull);
+void VgtDestroyGpuCull(VgtGpuCull& cull);
+
+// Records the cull for frame slot `frame`, outside a render pass. `viewProj` maps the bounds'
+// space to clip space (row vectors, see VgtMat4FrustumPlanes). Orders itself after the previous
+// frame's indirect draw, and the following draw after the dispatch, on the same queue.
+void VgtCmdGpuCull(VkCommandBuffer cmd, const VgtGpuCull& cull, uint32_t frame, const VgtMat4& viewProj);
+
+// Visible objects counted by the last cull recorded for `frame`. Only valid once that
+// submission has retired (after VgtWaitForFrame on the slot); 0 before the first one.
+uint32_t VgtGpuCullVisibleCount(const VgtGpuCull& cull, uint32_t frame);
@@ -0,0 +1,221 @@
+#include "VgtGpuTimer.h"
+
+#include <algorithm>
+
+#include "VgtPlatform.h"
+
+static uint32_t QueryIndex(uint32_t slot, uint32_t scope)
+{
+    return (slot * kVgtGpuTimerMaxScopes + scope) * 2;
+}
+
+VkResult VgtCreateGpuTimer(const VgtGpuTimerCreateInfo& ci, VgtGpuTimer& timer)
+{
+    timer = VgtGpuTimer{};
+    timer.device = ci.device;
+    timer.label = ci.label;
+    timer.slotCount = std::max(ci.slotCount, 1u);
+    timer.slotWritten.assign(timer.slotCount, 0);
+    if (!ci.enabled)
+        return VK_SUCCESS;
+
+    uint32_t qCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(ci.physicalDevice, &qCount, nullptr);
+    std::vector<VkQueueFamilyProperties> qProps(qCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(ci.physicalDevice, &qCount, qProps.data());
+
+    const uint32_t validBits = ci.queueFamily < qCount ? qProps[ci.queueFamily].timestampValidBits : 0;
+    if (validBits == 0)
+    {
+        std::fprintf(stderr, "[%s] GPU timing disabled: queue family %u has no timestamp support\n", ci.label, ci.queueFamily);
+        return VK_SUCCESS;
+    }
+
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(ci.physicalDevice, &props);
+    timer.periodNs = static_cast<double>(props.limits.timestampPeriod);
+    timer.validMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1);
+
+    VkQueryPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+    poolCI.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolCI.queryCount = timer.slotCount * kVgtGpuTimerMaxScopes * 2;
+    const VkResult res = vkCreateQueryPool(ci.device, &poolCI, nullptr, &timer.pool);
+    if (res != VK_SUCCESS)
+        return res;
+
+    if (ci.csvPath != nullptr && *ci.csvPath != '\0')
+    {
+        timer.csv = std::fopen(ci.csvPath, "a");
+        if (timer.csv == nullptr)
+        {
+            std::fprintf(stderr, "[%s] Cannot open %s for GPU timing output\n", ci.label, ci.csvPath);
+        }
+        else
+        {
+            std::fseek(timer.csv, 0, SEEK_END);
+            if (std::ftell(timer.csv) == 0)
+                std::fprintf(timer.csv, "time_s,label,scope,samples,last_ms,min_ms,avg_ms,p99_ms\n");
+        }
+    }
+
+    timer.start = VgtGetTimeSeconds();
+    timer.lastReport = timer.start;
+    return VK_SUCCESS;
+}
+
+void VgtDestroyGpuTimer(VgtGpuTimer& timer)
+{
+    if (timer.csv)
+        std::fclose(timer.csv);
+    if (timer.pool)
+        vkDestroyQueryPool(timer.device, timer.pool, nullptr);
+    timer = VgtGpuTimer{};
+}
+
+uint32_t VgtGpuTimerScope(VgtGpuTimer& timer, const char* name)
+{
+    for (uint32_t i = 0; i < timer.scopes.size(); ++i)
+    {
+        if (timer.scopes[i].name == name)
+            return i;
+    }
+    if (timer.scopes.size() >= kVgtGpuTimerMaxScopes)
+    {
+        std::fprintf(stderr, "[%s] GPU timer: too many scopes, \"%s\" is not timed\n", timer.label, name);
+        return kVgtGpuTimerNoScope;
+    }
+
+    VgtGpuScope scope;
+    scope.name = name;
+    scope.history.assign(kVgtGpuTimerWindow, 0.0);
+    timer.scopes.push_back(std::move(scope));
+    return static_cast<uint32_t>(timer.scopes.size() - 1);
+}
+
+void VgtGpuTimerBeginFrame(VgtGpuTimer& timer, VkCommandBuffer cmd, uint32_t slot)
+{
+    if (!timer.pool || slot >= timer.slotCount)
+        return;
+
+    VgtGpuTimerCollect(timer, slot);
+    timer.currentSlot = slot;
+    vkCmdResetQueryPool(cmd, timer.pool, QueryIndex(slot, 0), kVgtGpuTimerMaxScopes * 2);
+}
+
+void VgtGpuTimerBegin(VgtGpuTimer& timer, VkCommandBuffer cmd, uint32_t scope)
+{
+    if (!timer.pool || scope >= kVgtGpuTimerMaxScopes)
+        return;
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timer.pool, QueryIndex(timer.currentSlot, scope));
+}
+
+void VgtGpuTimerEnd(VgtGpuTimer& timer, VkCommandBuffer cmd, uint32_t scope)
+{
+    if (!timer.pool || scope >= kVgtGpuTimerMaxScopes)
+        return;
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timer.pool, QueryIndex(timer.currentSlot, scope) + 1);
+    timer.slotWritten[timer.currentSlot] |= 1u << scope;
+}
+
+void VgtGpuTimerCollect(VgtGpuTimer& timer, uint32_t slot)
+{
+    if (!timer.pool || slot >= timer.slotCount)
+        return;
+
+    uint32_t written = timer.slotWritten[slot];
+    timer.slotWritten[slot] = 0;
+    for (uint32_t scope = 0; written != 0; ++scope, written >>= 1)
+    {
+        if ((written & 1u) == 0 || scope >= timer.scopes.size())
+            continue;
+
+        // No WAIT flag: the caller already waited for the slot's fence.
+        uint64_t ticks[2] = {};
+        const VkResult res = vkGetQueryPoolResults(timer.device, timer.pool, QueryIndex(slot, scope), 2,
+            sizeof(ticks), ticks, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (res != VK_SUCCESS)
+            continue;
+
+        const uint64_t delta = ((ticks[1] & timer.validMask) - (ticks[0] & timer.validMask)) & timer.validMask;
+        const double ms = static_cast<double>(delta) * timer.periodNs * 1e-6;
+
+        VgtGpuScope& s = timer.scopes[scope];
+        s.history[s.next] = ms;
+        s.next = (s.next + 1) % kVgtGpuTimerWindow;
+        s.lastMs = ms;
+        ++s.samples;
+    }
+}
+
+bool VgtGetGpuScopeStats(const VgtGpuTimer& timer, uint32_t scope, VgtGpuScopeStats& stats)
+{
+    if (scope >= timer.scopes.size() || timer.scopes[scope].samples == 0)
+        return false;
+
+    const VgtGpuScope& s = timer.scopes[scope];
+    const size_t n = static_cast<size_t>(std::min<uint64_t>(s.samples, kVgtGpuTimerWindow));
+    std::vector<double> window(s.history.begin(), s.history.begin() + n);
+
+    double sum = 0.0;
+    for (double v : window)
+        sum += v;
+
+    stats.name = s.name.c_str();
+    stats.samples = s.samples;
+    stats.lastMs = s.lastMs;
+    stats.minMs = *std::min_element(window.begin(), window.end());
+    stats.avgMs = sum / static_cast<double>(n);
+
+    const size_t p99 = (n * 99 + 99) / 100 - 1;
+    std::nth_element(window.begin(), window.begin() + p99, window.end());
+    stats.p99Ms = window[p99];
+    return true;
+}
+
+static void Report(VgtGpuTimer& timer, double now, bool onlyNewSamples)
+{
+    for (uint32_t i = 0; i < timer.scopes.size(); ++i)
+    {
+        VgtGpuScope& s = timer.scopes[i];
+        if (onlyNewSamples && s.samples == s.reportedSamples)
+            continue;
+
+        VgtGpuScopeStats stats;
+        if (!VgtGetGpuScopeStats(timer, i, stats))
+            continue;
+        s.reportedSamples = s.samples;
+
+        std::fprintf(stderr, "[%s] gpu %-12s min %.4f avg %.4f p99 %.4f ms (%llu samples)\n",
+            timer.label, stats.name, stats.minMs, stats.avgMs, stats.p99Ms, static_cast<unsigned long long>(stats.samples));
+        if (timer.csv)
+        {
+            std::fprintf(timer.csv, "%.3f,%s,%s,%llu,%.6f,%.6f,%.6f,%.6f\n", now - timer.start, timer.label, stats.name,
+                static_cast<unsigned long long>(stats.samples), stats.lastMs, stats.minMs, stats.avgMs, stats.p99Ms);
+        }
+    }
+    if (timer.csv)
+        std::fflush(timer.csv);
+}
+
+void VgtGpuTimerTick(VgtGpuTimer& timer)
+{
+    if (!timer.pool)
+        return;
+
+    const double now = VgtGetTimeSeconds();
+    if (now - timer.lastReport < timer.reportIntervalSec)
+        return;
+    timer.lastReport = now;
+    Report(timer, now, true);
+}
+
+void VgtGpuTimerFinish(VgtGpuTimer& timer)
+{
+    if (!timer.pool)
+        return;
+
+    // Slots still holding results of the last frames (the device is idle by now).
+    for (uint32_t slot = 0; slot < timer.slotCount; ++slot)
+        VgtGpuTimerCollect(timer, slot);
+    Report(timer, VgtGetTimeSeconds(), false);
+}
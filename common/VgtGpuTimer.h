@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+// GPU time measured with timestamp queries.
+//
+// The query pool holds one range per slot (normally one slot per frame in flight). Each named
+// scope writes a begin and an end timestamp into the current slot. A slot is read back the
+// next time it is begun, i.e. after the caller waited for that slot's fence, so collecting
+// results never stalls the CPU. One-shot work (e.g. a texture upload) can use a spare slot
+// and call VgtGpuTimerCollect after vkQueueWaitIdle.
+//
+// Every scope keeps rolling min / avg / p99 statistics over its last kVgtGpuTimerWindow
+// samples. VgtGpuTimerTick prints them to stderr (and appends them to a CSV file) once per
+// report interval.
+//
+// The steps time "frame" around the whole command buffer and "render_pass" around
+// vkCmdBeginRenderPass..vkCmdEndRenderPass only; the two differ by the work recorded
+// outside the render pass (cull, light clustering).
+//
+// All functions are no-ops when the timer is disabled or the queue family has no timestamp
+// support, so render loops can call them unconditionally.
+
+constexpr uint32_t kVgtGpuTimerWindow = 256;
+constexpr uint32_t kVgtGpuTimerMaxScopes = 32;
+constexpr uint32_t kVgtGpuTimerNoScope = UINT32_MAX; // Begin/End ignore it
+
+struct VgtGpuTimerCreateInfo
+{
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    uint32_t queueFamily = 0;   // queue the timed command buffers are submitted to
+    uint32_t slotCount = 1;     // usually framesInFlight (+1 for one-shot work)
+    const char* label = "";
+    bool enabled = false;
+    const char* csvPath = nullptr; // optional, rows appended once per report interval
+};
+
+struct VgtGpuScopeStats
+{
+    const char* name = "";
+    uint64_t samples = 0; // total since creation
+    double lastMs = 0.0;
+    double minMs = 0.0;   // over the rolling window
+    double avgMs = 0.0;
+    double p99Ms = 0.0;
+};
+
+struct VgtGpuScope
+{
+    std::string name;
+    std::vector<double> history; // ring of the last kVgtGpuTimerWindow samples (ms)
+    uint32_t next = 0;
+    uint64_t samples = 0;
+    uint64_t reportedSamples = 0; // `samples` at the previous report
+    double lastMs = 0.0;
+};
+
+struct VgtGpuTimer
+{
+    VkDevice device = VK_NULL_HANDLE;
+    VkQueryPool pool = VK_NULL_HANDLE;
+    const char* label = "";
+    double periodNs = 1.0;
+    uint64_t validMask = ~0ull;
+    uint32_t slotCount = 0;
+    uint32_t currentSlot = 0;
+
+    std::vector<VgtGpuScope> scopes;
+    std::vector<uint32_t> slotWritten; // per slot, bit per scope with both timestamps recorded
+
+    double reportIntervalSec = 2.0;
+    double start = 0.0;
+    double lastReport = 0.0;
+    std::FILE* csv = nullptr;
+};
+
+// Succeeds with a disabled timer when timing is off or unsupported.
+VkResult VgtCreateGpuTimer(const VgtGpuTimerCreateInfo& ci, VgtGpuTimer& timer);
+void VgtDestroyGpuTimer(VgtGpuTimer& timer);
+
+inline bool VgtGpuTimerEnabled(const VgtGpuTimer& timer) { return timer.pool != VK_NULL_HANDLE; }
+
+// Registers a named scope and returns its id. Past kVgtGpuTimerMaxScopes it logs the scope as
+// untimed and returns kVgtGpuTimerNoScope.
+uint32_t VgtGpuTimerScope(VgtGpuTimer& timer, const char* name);
+
+// Collects the slot's previous results and resets its queries. Record outside a render pass,
+// after the slot's fence was waited on.
+void VgtGpuTimerBeginFrame(VgtGpuTimer& timer, VkCommandBuffer cmd, uint32_t slot);
+void VgtGpuTimerBegin(VgtGpuTimer& timer, VkCommandBuffer cmd, uint32_t scope);
+void VgtGpuTimerEnd(VgtGpuTimer& timer, VkCommandBuffer cmd, uint32_t scope);
+
+// Reads back the slot's finished timestamps into the rolling statistics.
+void VgtGpuTimerCollect(VgtGpuTimer& timer, uint32_t slot);
+
+bool VgtGetGpuScopeStats(const VgtGpuTimer& timer, uint32_t scope, VgtGpuScopeStats& stats);
+
+// Call once per frame; prints/appends the statistics when the report interval elapsed.
+void VgtGpuTimerTick(VgtGpuTimer& timer);
+// Prints the final statistics of every scope.
+void VgtGpuTimerFinish(VgtGpuTimer& timer);
@@ -0,0 +1,385 @@
+#include "VgtImageFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "VgtAssetPack.h"
+#include "VgtPlatform.h"
+
+struct FormatInfo
+{
+    VkFormat format;
+    uint32_t blockWidth;
+    uint32_t blockHeight;
+    uint32_t blockBytes;
+    uint32_t dxgi; // 0 == no DXGI equivalent
+    const char* name;
+};
+
+static const FormatInfo kFormats[] = {
+    { VK_FORMAT_R8G8B8A8_UNORM, 1, 1, 4, 28, "RGBA8" },
+    { VK_FORMAT_R8G8B8A8_SRGB, 1, 1, 4, 29, "RGBA8_SRGB" },
+    { VK_FORMAT_BC1_RGB_UNORM_BLOCK, 4, 4, 8, 0, "BC1_RGB" },
+    { VK_FORMAT_BC1_RGB_SRGB_BLOCK, 4, 4, 8, 0, "BC1_RGB_SRGB" },
+    { VK_FORMAT_BC1_RGBA_UNORM_BLOCK, 4, 4, 8, 71, "BC1" },
+    { VK_FORMAT_BC1_RGBA_SRGB_BLOCK, 4, 4, 8, 72, "BC1_SRGB" },
+    { VK_FORMAT_BC3_UNORM_BLOCK, 4, 4, 16, 77, "BC3" },
+    { VK_FORMAT_BC3_SRGB_BLOCK, 4, 4, 16, 78, "BC3_SRGB" },
+    { VK_FORMAT_BC4_UNORM_BLOCK, 4, 4, 8, 80, "BC4" },
+    { VK_FORMAT_BC5_UNORM_BLOCK, 4, 4, 16, 83, "BC5" },
+    { VK_FORMAT_BC5_SNORM_BLOCK, 4, 4, 16, 84, "BC5_SNORM" },
+    { VK_FORMAT_BC7_UNORM_BLOCK, 4, 4, 16, 98, "BC7" },
+    { VK_FORMAT_BC7_SRGB_BLOCK, 4, 4, 16, 99, "BC7_SRGB" },
+    { VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, 4, 4, 8, 0, "ETC2_RGB8" },
+    { VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK, 4, 4, 8, 0, "ETC2_RGB8_SRGB" },
+    { VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK, 4, 4, 8, 0, "ETC2_RGB8A1" },
+    { VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, 4, 4, 16, 0, "ETC2_RGBA8" },
+    { VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK, 4, 4, 16, 0, "ETC2_RGBA8_SRGB" },
+    { VK_FORMAT_ASTC_4x4_UNORM_BLOCK, 4, 4, 16, 0, "ASTC_4x4" },
+    { VK_FORMAT_ASTC_4x4_SRGB_BLOCK, 4, 4, 16, 0, "ASTC_4x4_SRGB" },
+    { VK_FORMAT_ASTC_5x5_UNORM_BLOCK, 5, 5, 16, 0, "ASTC_5x5" },
+    { VK_FORMAT_ASTC_5x5_SRGB_BLOCK, 5, 5, 16, 0, "ASTC_5x5_SRGB" },
+    { VK_FORMAT_ASTC_6x6_UNORM_BLOCK, 6, 6, 16, 0, "ASTC_6x6" },
+    { VK_FORMAT_ASTC_6x6_SRGB_BLOCK, 6, 6, 16, 0, "ASTC_6x6_SRGB" },
+    { VK_FORMAT_ASTC_8x8_UNORM_BLOCK, 8, 8, 16, 0, "ASTC_8x8" },
+    { VK_FORMAT_ASTC_8x8_SRGB_BLOCK, 8, 8, 16, 0, "ASTC_8x8_SRGB" },
+};
+
+static const FormatInfo* FindFormat(VkFormat format)
+{
+    for (const auto& info : kFormats)
+    {
+        if (info.format == format)
+            return &info;
+    }
+    return nullptr;
+}
+
+bool VgtGetFormatBlockInfo(VkFormat format, uint32_t& blockWidth, uint32_t& blockHeight, uint32_t& blockBytes)
+{
+    const FormatInfo* info = FindFormat(format);
+    if (!info)
+        return false;
+    blockWidth = info->blockWidth;
+    blockHeight = info->blockHeight;
+    blockBytes = info->blockBytes;
+    return true;
+}
+
+size_t VgtGetImageLevelSize(VkFormat format, uint32_t width, uint32_t height)
+{
+    const FormatInfo* info = FindFormat(format);
+    if (!info)
+        return 0;
+    const size_t blocksX = (width + info->blockWidth - 1) / info->blockWidth;
+    const size_t blocksY = (height + info->blockHeight - 1) / info->blockHeight;
+    return blocksX * blocksY * info->blockBytes;
+}
+
+const char* VgtGetFormatName(VkFormat format)
+{
+    const FormatInfo* info = FindFormat(format);
+    return info ? info->name : "unknown";
+}
+
+uint32_t VgtDxgiFromVkFormat(VkFormat format)
+{
+    const FormatInfo* info = FindFormat(format);
+    return info ? info->dxgi : 0;
+}
+
+VkFormat VgtVkFormatFromDxgi(uint32_t dxgiFormat)
+{
+    for (const auto& info : kFormats)
+    {
+        if (info.dxgi != 0 && info.dxgi == dxgiFormat)
+            return info.format;
+    }
+    return VK_FORMAT_UNDEFINED;
+}
+
+template <typename T>
+static T ReadLE(const uint8_t* p)
+{
+    T v{};
+    std::memcpy(&v, p, sizeof(T)); // containers are little-endian, as are all targets we build for
+    return v;
+}
+
+static bool ReadFile(const char* path, std::vector<uint8_t>& bytes)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+    const std::streamsize size = file.tellg();
+    if (size <= 0)
+        return false;
+    bytes.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(bytes.data()), size));
+}
+
+// Points `image` at its levels: `levelOffsets[i]` is where level i starts in `file`. With
+// `borrow` the pixels stay in `file` (a mapped asset pack); otherwise the span holding every
+// level is copied into image.storage. Level offsets are relative to that span either way.
+static bool AttachLevels(const VgtAssetView& file, const std::vector<size_t>& levelOffsets, bool borrow, VgtImageData& image)
+{
+    size_t begin = file.size, end = 0;
+    for (size_t i = 0; i < image.levels.size(); ++i)
+    {
+        if (levelOffsets[i] > file.size || image.levels[i].size > file.size - levelOffsets[i])
+            return false;
+        begin = std::min(begin, levelOffsets[i]);
+        end = std::max(end, levelOffsets[i] + image.levels[i].size);
+    }
+    for (size_t i = 0; i < image.levels.size(); ++i)
+        image.levels[i].offset = levelOffsets[i] - begin;
+
+    if (borrow)
+    {
+        image.pixels = file.data + begin;
+    }
+    else
+    {
+        image.storage.assign(file.data + begin, file.data + end);
+        image.pixels = image.storage.data();
+    }
+    image.size = end - begin;
+    return true;
+}
+
+// Length of the full mip chain, floor(log2(max(width, height))) + 1. Headers claiming more
+// levels are corrupt: past 1x1 every level would repeat the last one.
+static uint32_t MaxLevelCount(uint32_t width, uint32_t height)
+{
+    uint32_t levels = 1;
+    while ((width | height) >> levels)
+        ++levels;
+    return levels;
+}
+
+static void SetLevelExtents(VgtImageData& image, uint32_t levelCount)
+{
+    image.levels.resize(levelCount);
+    uint32_t w = image.width, h = image.height;
+    for (auto& level : image.levels)
+    {
+        level.width = w;
+        level.height = h;
+        level.size = VgtGetImageLevelSize(image.format, w, h);
+        w = w > 1 ? w / 2 : 1;
+        h = h > 1 ? h / 2 : 1;
+    }
+}
+
+static bool LoadKtx2(const VgtAssetView& file, bool borrow, VgtImageData& image)
+{
+    if (file.size < kVgtKtx2HeaderSize)
+        return false;
+
+    const uint8_t* h = file.data + sizeof(kVgtKtx2Identifier);
+    const VkFormat format = static_cast<VkFormat>(ReadLE<uint32_t>(h + 0));
+    const uint32_t pixelWidth = ReadLE<uint32_t>(h + 8);
+    const uint32_t pixelHeight = ReadLE<uint32_t>(h + 12);
+    const uint32_t pixelDepth = ReadLE<uint32_t>(h + 16);
+    const uint32_t layerCount = ReadLE<uint32_t>(h + 20);
+    const uint32_t faceCount = ReadLE<uint32_t>(h + 24);
+    const uint32_t levelCount = ReadLE<uint32_t>(h + 28);
+    const uint32_t supercompression = ReadLE<uint32_t>(h + 32);
+
+    if (!FindFormat(format) || pixelWidth == 0 || pixelHeight == 0 || pixelDepth > 1 || layerCount > 1 ||
+        faceCount != 1 || supercompression != 0)
+        return false;
+
+    // levelCount 0 means "generate mips at load time"; the file then holds only level 0.
+    const uint32_t storedLevels = levelCount == 0 ? 1 : levelCount;
+    if (storedLevels > MaxLevelCount(pixelWidth, pixelHeight))
+        return false;
+    if (file.size < kVgtKtx2HeaderSize + storedLevels * kVgtKtx2LevelIndexEntry)
+        return false;
+
+    image.width = pixelWidth;
+    image.height = pixelHeight;
+    image.format = format;
+    SetLevelExtents(image, storedLevels);
+
+    std::vector<size_t> offsets(storedLevels);
+    for (uint32_t i = 0; i < storedLevels; ++i)
+    {
+        const uint8_t* entry = file.data + kVgtKtx2HeaderSize + i * kVgtKtx2LevelIndexEntry;
+        const uint64_t byteOffset = ReadLE<uint64_t>(entry + 0);
+        const uint64_t byteLength = ReadLE<uint64_t>(entry + 8);
+        if (byteLength != image.levels[i].size)
+            return false;
+        offsets[i] = static_cast<size_t>(byteOffset);
+    }
+    return AttachLevels(file, offsets, borrow, image);
+}
+
+static uint32_t FourCC(char a, char b, char c, char d)
+{
+    return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+}
+
+static bool LoadDds(const VgtAssetView& file, bool borrow, VgtImageData& image)
+{
+    if (file.size < 4 + kVgtDdsHeaderSize)
+        return false;
+
+    const uint8_t* h = file.data + 4;
+    const uint32_t flags = ReadLE<uint32_t>(h + 4);
+    const uint32_t height = ReadLE<uint32_t>(h + 8);
+    const uint32_t width = ReadLE<uint32_t>(h + 12);
+    const uint32_t depth = ReadLE<uint32_t>(h + 20);
+    const uint32_t mipCount = ReadLE<uint32_t>(h + 24);
+    const uint8_t* pf = h + 72; // DDS_PIXELFORMAT
+    const uint32_t pfFlags = ReadLE<uint32_t>(pf + 4);
+    const uint32_t fourCC = ReadLE<uint32_t>(pf + 8);
+    const uint32_t caps2 = ReadLE<uint32_t>(h + 108);
+
+    constexpr uint32_t kDdsdMipMapCount = 0x20000;
+    constexpr uint32_t kDdpfFourCC = 0x4;
+    constexpr uint32_t kDdpfRgb = 0x40;
+    constexpr uint32_t kCaps2CubeMap = 0x200;
+    constexpr uint32_t kCaps2Volume = 0x200000;
+    if (width == 0 || height == 0 || depth > 1 || (caps2 & (kCaps2CubeMap | kCaps2Volume)))
+        return false;
+
+    // dwMipMapCount is only meaningful with DDSD_MIPMAPCOUNT; some writers leave garbage in it.
+    const uint32_t levelCount = (flags & kDdsdMipMapCount) && mipCount != 0 ? mipCount : 1;
+    if (levelCount > MaxLevelCount(width, height))
+        return false;
+
+    size_t dataOffset = 4 + kVgtDdsHeaderSize;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    if ((pfFlags & kDdpfFourCC) && fourCC == FourCC('D', 'X', '1', '0'))
+    {
+        if (file.size < dataOffset + kVgtDdsDx10HeaderSize)
+            return false;
+        const uint8_t* dx10 = file.data + dataOffset;
+        const uint32_t dimension = ReadLE<uint32_t>(dx10 + 4);
+        const uint32_t arraySize = ReadLE<uint32_t>(dx10 + 12);
+        constexpr uint32_t kDimensionTexture2D = 3;
+        if (dimension != kDimensionTexture2D || arraySize > 1)
+            return false;
+        format = VgtVkFormatFromDxgi(ReadLE<uint32_t>(dx10 + 0));
+        dataOffset += kVgtDdsDx10HeaderSize;
+    }
+    else if (pfFlags & kDdpfFourCC)
+    {
+        if (fourCC == FourCC('D', 'X', 'T', '1'))
+            format = VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        else if (fourCC == FourCC('D', 'X', 'T', '5'))
+            format = VK_FORMAT_BC3_UNORM_BLOCK;
+        else if (fourCC == FourCC('A', 'T', 'I', '1') || fourCC == FourCC('B', 'C', '4', 'U'))
+            format = VK_FORMAT_BC4_UNORM_BLOCK;
+        else if (fourCC == FourCC('A', 'T', 'I', '2') || fourCC == FourCC('B', 'C', '5', 'U'))
+            format = VK_FORMAT_BC5_UNORM_BLOCK;
+    }
+    else if (pfFlags & kDdpfRgb)
+    {
+        const uint32_t bitCount = ReadLE<uint32_t>(pf + 12);
+        const uint32_t rMask = ReadLE<uint32_t>(pf + 16);
+        const uint32_t aMask = ReadLE<uint32_t>(pf + 28);
+        if (bitCount == 32 && rMask == 0x000000FF && (aMask == 0xFF000000 || aMask == 0))
+            format = VK_FORMAT_R8G8B8A8_UNORM;
+    }
+    if (format == VK_FORMAT_UNDEFINED)
+        return false;
+
+    image.width = width;
+    image.height = height;
+    image.format = format;
+    SetLevelExtents(image, levelCount);
+
+    // DDS levels are stored largest first, back to back.
+    std::vector<size_t> offsets(image.levels.size());
+    for (size_t i = 0; i < image.levels.size(); ++i)
+    {
+        offsets[i] = dataOffset;
+        dataOffset += image.levels[i].size;
+    }
+    return AttachLevels(file, offsets, borrow, image);
+}
+
+// `borrow`: the bytes outlive `image` (a mapped asset pack), so containers need no copy.
+static bool LoadFromMemory(const VgtAssetView& file, bool borrow, VgtImageData& image)
+{
+    if (file.size >= sizeof(kVgtKtx2Identifier) && std::memcmp(file.data, kVgtKtx2Identifier, sizeof(kVgtKtx2Identifier)) == 0)
+    {
+        if (LoadKtx2(file, borrow, image))
+            return true;
+        VgtFreeImageData(image);
+        return false;
+    }
+    if (file.size >= 4 && ReadLE<uint32_t>(file.data) == kVgtDdsMagic)
+    {
+        if (LoadDds(file, borrow, image))
+            return true;
+        VgtFreeImageData(image);
+        return false;
+    }
+
+    int width = 0, height = 0, channels = 0;
+    stbi_uc* pixels = stbi_load_from_memory(file.data, static_cast<int>(file.size), &width, &height, &channels, STBI_rgb_alpha);
+    if (!pixels)
+        return false;
+
+    image.width = static_cast<uint32_t>(width);
+    image.height = static_cast<uint32_t>(height);
+    image.pixels = pixels;
+    image.size = static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+    image.format = VK_FORMAT_R8G8B8A8_UNORM;
+    image.levels.assign(1, VgtImageLevel{ 0, image.size, image.width, image.height });
+    image.stbPixels = true;
+    return true;
+}
+
+static bool LoadFromPath(const char* path, VgtImageData& image)
+{
+    std::vector<uint8_t> file;
+    if (!ReadFile(path, file))
+        return false;
+    return LoadFromMemory(VgtAssetView{ file.data(), file.size() }, false, image);
+}
+
+bool VgtLoadImageFile(const char* relativePath, VgtImageData& image)
+{
+    // A mounted asset pack wins over loose files
+    VgtAssetView packed;
+    if (VgtFindMountedAsset(relativePath, packed))
+        return LoadFromMemory(packed, true, image);
+
+    // Try direct path first
+    if (LoadFromPath(relativePath, image))
+        return true;
+
+    // Fallback: locate the file relative to the executable
+    std::string exeDir = VgtGetExecutableDir();
+    if (exeDir.empty())
+        return false;
+
+    if (LoadFromPath((exeDir + relativePath).c_str(), image))
+        return true;
+
+    // Common MSBuild layout: <target>/Debug/.. == <target>/
+    while (!exeDir.empty() && (exeDir.back() == '\\' || exeDir.back() == '/'))
+        exeDir.pop_back();
+    const size_t parentSlash = exeDir.find_last_of("\\/");
+    if (parentSlash == std::string::npos)
+        return false;
+    exeDir.resize(parentSlash + 1);
+    return LoadFromPath((exeDir + relativePath).c_str(), image);
+}
+
+void VgtFreeImageData(VgtImageData& image)
+{
+    if (image.stbPixels)
+        stbi_image_free(const_cast<uint8_t*>(image.pixels));
+    image = VgtImageData{};
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+// Image files for textures:
+// - PNG/JPEG/... decoded to tightly packed RGBA8 (stb_image), a single level.
+// - KTX2 and DDS containers loaded as-is, including their mip chain and block-compressed
+//   formats (BC1/BC3/BC5/BC7, ETC2, ASTC LDR). Supercompressed KTX2, arrays, cube maps and
+//   3D textures are rejected.
+
+struct VgtImageLevel
+{
+    size_t offset = 0; // from VgtImageData::pixels, a multiple of the block size
+    size_t size = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+struct VgtImageData
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    const uint8_t* pixels = nullptr; // every level, valid until VgtFreeImageData
+    size_t size = 0;                 // bytes from `pixels` to the end of the last level
+    VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+    std::vector<VgtImageLevel> levels; // at least one after a successful load
+
+    // Who owns `pixels`: stb_image (decoded images), `storage` (containers read from a file),
+    // or neither (containers inside a mounted VgtAssetPack, which must stay open).
+    bool stbPixels = false;
+    std::vector<uint8_t> storage;
+};
+
+// Looks `relativePath` up in the mounted asset pack (VgtAssetPack.h), then tries it as given,
+// next to the executable and one directory above it (MSBuild puts the exe in a <config>/
+// subfolder). The container is detected from the file contents, not the extension.
+// Safe to call from several threads.
+bool VgtLoadImageFile(const char* relativePath, VgtImageData& image);
+void VgtFreeImageData(VgtImageData& image);
+
+// Texel block footprint of the formats above (1x1 for uncompressed ones).
+// Returns false for formats the loader does not know.
+bool VgtGetFormatBlockInfo(VkFormat format, uint32_t& blockWidth, uint32_t& blockHeight, uint32_t& blockBytes);
+
+// Bytes of one level of `width` x `height` texels (whole blocks), or 0 for unknown formats.
+size_t VgtGetImageLevelSize(VkFormat format, uint32_t width, uint32_t height);
+
+const char* VgtGetFormatName(VkFormat format);
+
+// KTX2 / DDS layout constants, shared with tools/vgt_texconv.
+inline constexpr uint8_t kVgtKtx2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+inline constexpr size_t kVgtKtx2HeaderSize = 80;    // identifier + header + index, before the level index
+inline constexpr size_t kVgtKtx2LevelIndexEntry = 24; // byteOffset, byteLength, uncompressedByteLength (uint64 each)
+inline constexpr uint32_t kVgtDdsMagic = 0x20534444;  // "DDS "
+inline constexpr size_t kVgtDdsHeaderSize = 124;
+inline constexpr size_t kVgtDdsDx10HeaderSize = 20;
+
+// DXGI_FORMAT <-> VkFormat for the formats above (0 / VK_FORMAT_UNDEFINED when there is none).
+uint32_t VgtDxgiFromVkFormat(VkFormat format);
+VkFormat VgtVkFormatFromDxgi(uint32_t dxgiFormat);
@@ -0,0 +1,59 @@
+#include "VgtIndirectDraw.h"
+
+VgtIndirectPath VgtEnableIndirectDrawFeatures(VkPhysicalDevice physicalDevice, VkPhysicalDeviceFeatures& features,
+    VkPhysicalDeviceVulkan12Features& features12)
+{
+    VkPhysicalDeviceFeatures supported{};
+    vkGetPhysicalDeviceFeatures(physicalDevice, &supported);
+    if (!supported.multiDrawIndirect || !supported.drawIndirectFirstInstance)
+        return VgtIndirectPath::Instanced;
+
+    features.multiDrawIndirect = VK_TRUE;
+    features.drawIndirectFirstInstance = VK_TRUE;
+
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+    if (props.apiVersion < VK_API_VERSION_1_2)
+        return VgtIndirectPath::Multi;
+
+    VkPhysicalDeviceVulkan12Features supported12{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+    VkPhysicalDeviceFeatures2 supported2{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+    supported2.pNext = &supported12;
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &supported2);
+    if (!supported12.drawIndirectCount)
+        return VgtIndirectPath::Multi;
+
+    features12.drawIndirectCount = VK_TRUE;
+    return VgtIndirectPath::Count;
+}
+
+const char* VgtIndirectPathName(VgtIndirectPath path)
+{
+    switch (path)
+    {
+    case VgtIndirectPath::Count: return "vkCmdDrawIndexedIndirectCount";
+    case VgtIndirectPath::Multi: return "vkCmdDrawIndexedIndirect (multi-draw)";
+    default: return "vkCmdDrawIndexedIndirect (instanced)";
+    }
+}
+
+std::vector<VkDrawIndexedIndirectCommand> VgtBuildIndirectCommands(VgtIndirectPath path, uint32_t objectCount, uint32_t indexCount)
+{
+    if (path == VgtIndirectPath::Instanced)
+        return { VkDrawIndexedIndirectCommand{ indexCount, objectCount, 0, 0, 0 } };
+
+    std::vector<VkDrawIndexedIndirectCommand> commands(objectCount);
+    for (uint32_t i = 0; i < objectCount; ++i)
+        commands[i] = VkDrawIndexedIndirectCommand{ indexCount, 1, 0, 0, i };
+    return commands;
+}
+
+void VgtCmdDrawIndexedIndirectObjects(VkCommandBuffer cmd, VgtIndirectPath path, VkBuffer commandBuffer, VkBuffer countBuffer,
+    uint32_t maxDrawCount)
+{
+    const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    if (path == VgtIndirectPath::Count)
+        vkCmdDrawIndexedIndirectCount(cmd, commandBuffer, 0, countBuffer, 0, maxDrawCount, stride);
+    else
+        vkCmdDrawIndexedIndirect(cmd, commandBuffer, 0, maxDrawCount, stride);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+// GPU-driven drawing: many objects that share one mesh, drawn from a VkDrawIndexedIndirectCommand
+// buffer with a single vkCmdDrawIndexedIndirect(Count) call. Per-object data lives in a storage
+// buffer indexed by gl_InstanceIndex, so the CPU cost per frame no longer depends on the object count.
+//
+// Three paths, picked from the device features:
+// - Count:     one command per object (firstInstance = object index), the number of commands read
+//              from a count buffer (drawIndirectCount, Vulkan 1.2). A compute pass can cull by
+//              compacting the commands and writing the count.
+// - Multi:     one command per object, the count fixed at record time (multiDrawIndirect).
+// - Instanced: a single command with instanceCount = object count, for devices without
+//              multiDrawIndirect / drawIndirectFirstInstance.
+// gl_InstanceIndex is the object index in all three, so the shaders do not care which one runs.
+enum class VgtIndirectPath : uint32_t
+{
+    Count,
+    Multi,
+    Instanced,
+};
+
+// Picks the best supported path and turns on the features it needs in `features` / `features12`.
+// Chain `features12` into VkDeviceCreateInfo::pNext only for VgtIndirectPath::Count (it needs a
+// Vulkan 1.2 device). Call before vkCreateDevice.
+VgtIndirectPath VgtEnableIndirectDrawFeatures(VkPhysicalDevice physicalDevice, VkPhysicalDeviceFeatures& features,
+    VkPhysicalDeviceVulkan12Features& features12);
+
+const char* VgtIndirectPathName(VgtIndirectPath path);
+
+// Commands drawing `objectCount` copies of an `indexCount`-index mesh: one per object, or a single
+// instanced command for VgtIndirectPath::Instanced.
+std::vector<VkDrawIndexedIndirectCommand> VgtBuildIndirectCommands(VgtIndirectPath path, uint32_t objectCount, uint32_t indexCount);
+
+// Records the draw. `countBuffer` holds a uint32_t command count (only read by the Count path);
+// `maxDrawCount` is the number of commands in `commandBuffer`.
+void VgtCmdDrawIndexedIndirectObjects(VkCommandBuffer cmd, VgtIndirectPath path, VkBuffer commandBuffer, VkBuffer countBuffer,
+    uint32_t maxDrawCount);
@@ -0,0 +1,158 @@
+#include "VgtLatency.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "VgtPlatform.h"
+
+static void AddSample(VgtLatencyMeter& meter, double ms)
+{
+    meter.history[meter.next] = ms;
+    meter.next = (meter.next + 1) % kVgtLatencyWindow;
+    ++meter.samples;
+}
+
+static void WaiterMain(VgtLatencyMeter& meter)
+{
+    std::unique_lock<std::mutex> lock(meter.mutex);
+    while (!meter.stop)
+    {
+        if (meter.pending.empty())
+        {
+            meter.wake.wait(lock);
+            continue;
+        }
+
+        // Re-read every time: the lock was dropped while sleeping, and a recreation may have
+        // forgotten the swapchain in the meantime.
+        const VgtLatencyPending p = meter.pending.front();
+        const VkResult res = meter.waitForPresent(meter.device, p.swapchain, p.presentId, 0);
+        if (res == VK_TIMEOUT)
+        {
+            lock.unlock();
+            std::this_thread::sleep_for(std::chrono::microseconds(kVgtLatencyPollUs));
+            lock.lock();
+            continue;
+        }
+
+        meter.pending.pop_front();
+        if (res == VK_SUCCESS || res == VK_SUBOPTIMAL_KHR)
+            AddSample(meter, 1000.0 * (VgtGetTimeSeconds() - p.inputTime));
+        // Anything else (out of date, surface lost): the present never completed, no sample.
+    }
+}
+
+void VgtLatencyStart(VgtLatencyMeter& meter, VkDevice device, bool presentWait)
+{
+    meter.device = device;
+    meter.history.assign(kVgtLatencyWindow, 0.0);
+    meter.lastReport = VgtGetTimeSeconds();
+    if (presentWait)
+    {
+        meter.waitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(device, "vkWaitForPresentKHR"));
+        meter.presentWait = meter.waitForPresent != nullptr;
+    }
+
+    if (meter.presentWait)
+    {
+        meter.stop = false;
+        meter.waiter = std::thread(WaiterMain, std::ref(meter));
+        std::fprintf(stderr, "[%s] latency: input to present complete (VK_KHR_present_wait)\n", meter.label);
+    }
+    else
+    {
+        std::fprintf(stderr, "[%s] latency: input to vkQueuePresentKHR only (no VK_KHR_present_wait; display queueing not included)\n",
+            meter.label);
+    }
+}
+
+static void Report(VgtLatencyMeter& meter, bool onlyNewSamples)
+{
+    std::vector<double> window;
+    uint64_t samples = 0;
+    {
+        std::lock_guard<std::mutex> lock(meter.mutex);
+        if (meter.samples == 0 || (onlyNewSamples && meter.samples == meter.reportedSamples))
+            return;
+        meter.reportedSamples = meter.samples;
+        samples = meter.samples;
+        const size_t n = static_cast<size_t>(std::min<uint64_t>(samples, kVgtLatencyWindow));
+        window.assign(meter.history.begin(), meter.history.begin() + n);
+    }
+
+    const size_t n = window.size();
+    double sum = 0.0;
+    for (double v : window)
+        sum += v;
+    const double minMs = *std::min_element(window.begin(), window.end());
+    const size_t p99 = (n * 99 + 99) / 100 - 1;
+    std::nth_element(window.begin(), window.begin() + p99, window.end());
+
+    std::fprintf(stderr, "[%s] latency %s x%u: min %.3f avg %.3f p99 %.3f ms (%llu samples)\n", meter.label, meter.modeName,
+        meter.imageCount, minMs, sum / static_cast<double>(n), window[p99], static_cast<unsigned long long>(samples));
+}
+
+void VgtLatencyStop(VgtLatencyMeter& meter)
+{
+    if (meter.device == VK_NULL_HANDLE)
+        return;
+
+    if (meter.waiter.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(meter.mutex);
+            meter.stop = true;
+        }
+        meter.wake.notify_one();
+        meter.waiter.join();
+    }
+    meter.pending.clear();
+    Report(meter, false);
+    meter.device = VK_NULL_HANDLE;
+}
+
+std::unique_lock<std::mutex> VgtLatencyLockSwapchain(VgtLatencyMeter& meter)
+{
+    if (!meter.waiter.joinable())
+        return std::unique_lock<std::mutex>();
+    return std::unique_lock<std::mutex>(meter.mutex);
+}
+
+uint64_t VgtLatencyNextPresentId(VgtLatencyMeter& meter)
+{
+    return meter.presentWait ? meter.nextPresentId++ : 0;
+}
+
+void VgtLatencyPresented(VgtLatencyMeter& meter, VkSwapchainKHR swapchain, uint64_t presentId, double inputTime)
+{
+    if (meter.device == VK_NULL_HANDLE)
+        return;
+
+    if (presentId == 0)
+    {
+        AddSample(meter, 1000.0 * (VgtGetTimeSeconds() - inputTime));
+        return;
+    }
+    meter.pending.push_back({ swapchain, presentId, inputTime });
+    meter.wake.notify_one();
+}
+
+void VgtLatencyForget(VgtLatencyMeter& meter, VkSwapchainKHR swapchain)
+{
+    meter.pending.erase(std::remove_if(meter.pending.begin(), meter.pending.end(),
+                            [swapchain](const VgtLatencyPending& p) { return p.swapchain == swapchain; }),
+        meter.pending.end());
+}
+
+void VgtLatencyTick(VgtLatencyMeter& meter)
+{
+    if (meter.device == VK_NULL_HANDLE)
+        return;
+
+    const double now = VgtGetTimeSeconds();
+    if (now - meter.lastReport < meter.reportIntervalSec)
+        return;
+    meter.lastReport = now;
+    Report(meter, true);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+// Input-to-photon latency of presented frames (--latency), owned by VgtPresenter (which
+// creates one only when measuring).
+//
+// - A frame's input time is when VgtPresenterRunning polled the window events the frame was
+//   built from; the sample ends when the presentation engine reports the image on screen.
+// - That end point comes from VK_KHR_present_id + VK_KHR_present_wait: every present carries
+//   an id, and a waiter thread polls vkWaitForPresentKHR for the oldest pending one. Host
+//   access to the swapchain must be externally synchronized, so the thread only polls with a
+//   zero timeout under `mutex` (which acquire / present / recreation also take) and sleeps
+//   kVgtLatencyPollUs between polls: that is the measurement resolution.
+// - Without those extensions (or offscreen) the sample ends at vkQueuePresentKHR instead, which
+//   covers the CPU side only, not the time the image waits in the presentation queue.
+//
+// Rolling min / avg / p99 over the last kVgtLatencyWindow samples are printed to stderr once
+// per report interval and on VgtLatencyStop, next to the present mode and image count, so the
+// modes can be compared together with --show-fps.
+
+constexpr uint32_t kVgtLatencyWindow = 256;
+constexpr uint32_t kVgtLatencyPollUs = 250;
+
+struct VgtLatencyPending
+{
+    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+    uint64_t presentId = 0;
+    double inputTime = 0.0;
+};
+
+struct VgtLatencyMeter
+{
+    const char* label = "";
+    bool presentWait = false; // samples end at present completion (see above)
+    VkDevice device = VK_NULL_HANDLE;
+    PFN_vkWaitForPresentKHR waitForPresent = nullptr;
+    const char* modeName = "";
+    uint32_t imageCount = 0;
+
+    std::mutex mutex; // guards the swapchain (present-wait mode), `pending` and the samples
+    std::condition_variable wake;
+    std::thread waiter;
+    bool stop = false;
+    std::deque<VgtLatencyPending> pending;
+    uint64_t nextPresentId = 1;
+
+    std::vector<double> history; // ring of the last kVgtLatencyWindow samples (ms)
+    uint32_t next = 0;
+    uint64_t samples = 0;
+    uint64_t reportedSamples = 0;
+    double reportIntervalSec = 2.0;
+    double lastReport = 0.0;
+};
+
+// Starts measuring; `presentWait` when both extensions and their features are enabled on `device`.
+void VgtLatencyStart(VgtLatencyMeter& meter, VkDevice device, bool presentWait);
+// Joins the waiter thread and prints the summary. Call before the swapchain is destroyed.
+void VgtLatencyStop(VgtLatencyMeter& meter);
+
+// Lock to hold around every vkAcquireNextImageKHR / vkQueuePresentKHR / swapchain recreation.
+// Owns nothing unless the waiter thread runs.
+std::unique_lock<std::mutex> VgtLatencyLockSwapchain(VgtLatencyMeter& meter);
+
+// Present id for the next present (0 == do not chain VkPresentIdKHR). Call under the lock.
+uint64_t VgtLatencyNextPresentId(VgtLatencyMeter& meter);
+// Records a successful present of `presentId` on `swapchain` whose input was sampled at
+// `inputTime` (VgtGetTimeSeconds). Call under the lock, right after vkQueuePresentKHR.
+void VgtLatencyPresented(VgtLatencyMeter& meter, VkSwapchainKHR swapchain, uint64_t presentId, double inputTime);
+// Drops the pending presents of a swapchain that is about to be retired. Call under the lock.
+void VgtLatencyForget(VgtLatencyMeter& meter, VkSwapchainKHR swapchain);
+
+// Prints the rolling statistics once per report interval.
+void VgtLatencyTick(VgtLatencyMeter& meter);
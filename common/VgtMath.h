@@ -0,0 +1,433 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#include <VgtConfig.h>
+
+// Small header-only 4x4 matrix library used by the steps (replaces the Mat4* helpers that
+// used to be copy-pasted into each main.cpp).
+//
+// Storage: 16 contiguous floats, rows contiguous. VgtMat4Mul(a, b) is the usual row-major
+// product out[r][c] = sum_k a[r][k] * b[k][c], which is exactly what the old Mat4Multiply
+// computed, and the shaders read the matrices with layout(row_major). The builders
+// (RotateY, LookAt, Perspective) produce the same numbers as the old helpers.
+// They are laid out for row vectors (v * M, see VgtMat4MulVec4), so transforms compose left to
+// right: VgtMat4Mul(model, VgtMat4Mul(view, proj)), and shaders compute `v * M`.
+//
+// Kernels are picked at build time:
+// - AVX2 (+FMA): two output rows per 256-bit op (-DVGT_MATH_SIMD=AVX2 adds the flags)
+// - SSE2:        default on x86/x64
+// - NEON:        default on ARM
+// - scalar:      anything else, or -DVGT_MATH_SIMD=SCALAR
+//
+// SSE/NEON/scalar results are bit-identical; AVX2 uses FMA and may differ in the last ulp.
+
+#if !VGT_MATH_SCALAR && defined(__AVX2__)
+#define VGT_MATH_AVX2 1
+#include <immintrin.h>
+#elif !VGT_MATH_SCALAR && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define VGT_MATH_SSE 1
+#include <emmintrin.h>
+#elif !VGT_MATH_SCALAR && (defined(__ARM_NEON) || defined(_M_ARM64))
+#define VGT_MATH_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(VGT_MATH_AVX2)
+#define VGT_MATH_KERNEL "avx2"
+#elif defined(VGT_MATH_SSE)
+#define VGT_MATH_KERNEL "sse2"
+#elif defined(VGT_MATH_NEON)
+#define VGT_MATH_KERNEL "neon"
+#else
+#define VGT_MATH_KERNEL "scalar"
+#endif
+
+struct alignas(16) VgtVec4
+{
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+    float w = 0.0f;
+};
+
+struct alignas(16) VgtMat4
+{
+    float m[16] = {};
+
+    float* data() { return m; }
+    const float* data() const { return m; }
+};
+
+static_assert(sizeof(VgtMat4) == 64, "VgtMat4 must stay a tightly packed float[16] (uploaded as-is)");
+
+// --- kernels -----------------------------------------------------------------------------
+
+// out = a * b for one matrix. `out` may alias `a` or `b`.
+inline void VgtMat4MulRaw(float* out, const float* a, const float* b)
+{
+#if defined(VGT_MATH_AVX2)
+    const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 0));
+    const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 4));
+    const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 8));
+    const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 12));
+    __m256 r[2];
+    for (int i = 0; i < 2; ++i)
+    {
+        // Rows 2i and 2i+1 of `a`, one per 128-bit lane.
+        const __m256 rows = _mm256_loadu_ps(a + i * 8);
+        __m256 acc = _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0x00), b0);
+#if defined(__FMA__) || defined(_MSC_VER)
+        acc = _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, 0x55), b1, acc);
+        acc = _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, 0xAA), b2, acc);
+        acc = _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, 0xFF), b3, acc);
+#else
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0x55), b1));
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0xAA), b2));
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0xFF), b3));
+#endif
+        r[i] = acc;
+    }
+    _mm256_storeu_ps(out + 0, r[0]);
+    _mm256_storeu_ps(out + 8, r[1]);
+#elif defined(VGT_MATH_SSE)
+    const __m128 b0 = _mm_loadu_ps(b + 0);
+    const __m128 b1 = _mm_loadu_ps(b + 4);
+    const __m128 b2 = _mm_loadu_ps(b + 8);
+    const __m128 b3 = _mm_loadu_ps(b + 12);
+    __m128 r[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        __m128 acc = _mm_mul_ps(_mm_set1_ps(a[i * 4 + 0]), b0);
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 1]), b1));
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 2]), b2));
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 3]), b3));
+        r[i] = acc;
+    }
+    for (int i = 0; i < 4; ++i)
+        _mm_storeu_ps(out + i * 4, r[i]);
+#elif defined(VGT_MATH_NEON)
+    const float32x4_t b0 = vld1q_f32(b + 0);
+    const float32x4_t b1 = vld1q_f32(b + 4);
+    const float32x4_t b2 = vld1q_f32(b + 8);
+    const float32x4_t b3 = vld1q_f32(b + 12);
+    float32x4_t r[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        float32x4_t acc = vmulq_n_f32(b0, a[i * 4 + 0]);
+        acc = vaddq_f32(acc, vmulq_n_f32(b1, a[i * 4 + 1]));
+        acc = vaddq_f32(acc, vmulq_n_f32(b2, a[i * 4 + 2]));
+        acc = vaddq_f32(acc, vmulq_n_f32(b3, a[i * 4 + 3]));
+        r[i] = acc;
+    }
+    for (int i = 0; i < 4; ++i)
+        vst1q_f32(out + i * 4, r[i]);
+#else
+    float temp[16];
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int col = 0; col < 4; ++col)
+        {
+            float sum = a[row * 4 + 0] * b[0 * 4 + col];
+            sum += a[row * 4 + 1] * b[1 * 4 + col];
+            sum += a[row * 4 + 2] * b[2 * 4 + col];
+            sum += a[row * 4 + 3] * b[3 * 4 + col];
+            temp[row * 4 + col] = sum;
+        }
+    }
+    std::memcpy(out, temp, sizeof(temp));
+#endif
+}
+
+inline VgtMat4 VgtMat4Mul(const VgtMat4& a, const VgtMat4& b)
+{
+    VgtMat4 out;
+    VgtMat4MulRaw(out.m, a.m, b.m);
+    return out;
+}
+
+// out[i] = a[i] * b, e.g. per-object model matrices times a shared view-projection.
+// The rows of `b` are loaded once for the whole batch. SSE2/NEON multiply two matrices per
+// iteration, so eight independent row products are in flight between the loads and the stores;
+// AVX2 splits each matrix between shuffles and broadcast loads (see below). Results are
+// bit-identical to VgtMat4Mul. `out` may alias `a`, not `b`.
+inline void VgtMat4MulBatch(VgtMat4* out, const VgtMat4* a, const VgtMat4& b, size_t count)
+{
+    size_t i = 0;
+#if defined(VGT_MATH_AVX2)
+    const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.m + 0));
+    const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.m + 4));
+    const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.m + 8));
+    const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.m + 12));
+    for (; i < count; ++i)
+    {
+        // Rows 0-1 as in VgtMat4MulRaw (in-register shuffles), rows 2-3 from scalar broadcast
+        // loads, so the shuffle port and the load ports share the work.
+        const float* rows = a[i].m;
+        const __m256 pair = _mm256_loadu_ps(rows);
+        __m256 r01 = _mm256_mul_ps(_mm256_shuffle_ps(pair, pair, 0x00), b0);
+        __m128 r2 = _mm_mul_ps(_mm_broadcast_ss(rows + 8), _mm256_castps256_ps128(b0));
+        __m128 r3 = _mm_mul_ps(_mm_broadcast_ss(rows + 12), _mm256_castps256_ps128(b0));
+#if defined(__FMA__) || defined(_MSC_VER)
+        r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(pair, pair, 0x55), b1, r01);
+        r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(pair, pair, 0xAA), b2, r01);
+        r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(pair, pair, 0xFF), b3, r01);
+        r2 = _mm_fmadd_ps(_mm_broadcast_ss(rows + 9), _mm256_castps256_ps128(b1), r2);
+        r2 = _mm_fmadd_ps(_mm_broadcast_ss(rows + 10), _mm256_castps256_ps128(b2), r2);
+        r2 = _mm_fmadd_ps(_mm_broadcast_ss(rows + 11), _mm256_castps256_ps128(b3), r2);
+        r3 = _mm_fmadd_ps(_mm_broadcast_ss(rows + 13), _mm256_castps256_ps128(b1), r3);
+        r3 = _mm_fmadd_ps(_mm_broadcast_ss(rows + 14), _mm256_castps256_ps128(b2), r3);
+        r3 = _mm_fmadd_ps(_mm_broadcast_ss(rows + 15), _mm256_castps256_ps128(b3), r3);
+#else
+        r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(pair, pair, 0x55), b1));
+        r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(pair, pair, 0xAA), b2));
+        r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(pair, pair, 0xFF), b3));
+        r2 = _mm_add_ps(r2, _mm_mul_ps(_mm_broadcast_ss(rows + 9), _mm256_castps256_ps128(b1)));
+        r2 = _mm_add_ps(r2, _mm_mul_ps(_mm_broadcast_ss(rows + 10), _mm256_castps256_ps128(b2)));
+        r2 = _mm_add_ps(r2, _mm_mul_ps(_mm_broadcast_ss(rows + 11), _mm256_castps256_ps128(b3)));
+        r3 = _mm_add_ps(r3, _mm_mul_ps(_mm_broadcast_ss(rows + 13), _mm256_castps256_ps128(b1)));
+        r3 = _mm_add_ps(r3, _mm_mul_ps(_mm_broadcast_ss(rows + 14), _mm256_castps256_ps128(b2)));
+        r3 = _mm_add_ps(r3, _mm_mul_ps(_mm_broadcast_ss(rows + 15), _mm256_castps256_ps128(b3)));
+#endif
+        _mm256_storeu_ps(out[i].m + 0, r01);
+        _mm_storeu_ps(out[i].m + 8, r2);
+        _mm_storeu_ps(out[i].m + 12, r3);
+    }
+#elif defined(VGT_MATH_SSE)
+    const __m128 b0 = _mm_loadu_ps(b.m + 0);
+    const __m128 b1 = _mm_loadu_ps(b.m + 4);
+    const __m128 b2 = _mm_loadu_ps(b.m + 8);
+    const __m128 b3 = _mm_loadu_ps(b.m + 12);
+    for (; i + 2 <= count; i += 2)
+    {
+        // Rows 0-3 of a[i], then rows 0-3 of a[i + 1] (the two matrices are contiguous).
+        const float* rows = a[i].m;
+        __m128 r[8];
+        for (int k = 0; k < 8; ++k)
+        {
+            const __m128 row = _mm_loadu_ps(rows + k * 4);
+            __m128 acc = _mm_mul_ps(_mm_shuffle_ps(row, row, 0x00), b0);
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_shuffle_ps(row, row, 0x55), b1));
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_shuffle_ps(row, row, 0xAA), b2));
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_shuffle_ps(row, row, 0xFF), b3));
+            r[k] = acc;
+        }
+        for (int k = 0; k < 8; ++k)
+            _mm_storeu_ps(out[i].m + k * 4, r[k]);
+    }
+#elif defined(VGT_MATH_NEON)
+    const float32x4_t b0 = vld1q_f32(b.m + 0);
+    const float32x4_t b1 = vld1q_f32(b.m + 4);
+    const float32x4_t b2 = vld1q_f32(b.m + 8);
+    const float32x4_t b3 = vld1q_f32(b.m + 12);
+    for (; i + 2 <= count; i += 2)
+    {
+        // Rows 0-3 of a[i], then rows 0-3 of a[i + 1] (the two matrices are contiguous).
+        const float* rows = a[i].m;
+        float32x4_t r[8];
+        for (int k = 0; k < 8; ++k)
+        {
+            float32x4_t acc = vmulq_n_f32(b0, rows[k * 4 + 0]);
+            acc = vaddq_f32(acc, vmulq_n_f32(b1, rows[k * 4 + 1]));
+            acc = vaddq_f32(acc, vmulq_n_f32(b2, rows[k * 4 + 2]));
+            acc = vaddq_f32(acc, vmulq_n_f32(b3, rows[k * 4 + 3]));
+            r[k] = acc;
+        }
+        for (int k = 0; k < 8; ++k)
+            vst1q_f32(out[i].m + k * 4, r[k]);
+    }
+#endif
+    // The odd matrix at the end (SSE2/NEON), and every matrix with the scalar kernel.
+    for (; i < count; ++i)
+        VgtMat4MulRaw(out[i].m, a[i].m, b.m);
+}
+
+inline VgtMat4 VgtMat4Transpose(const VgtMat4& m)
+{
+    VgtMat4 out;
+#if defined(VGT_MATH_SSE) || defined(VGT_MATH_AVX2)
+    __m128 r0 = _mm_loadu_ps(m.m + 0);
+    __m128 r1 = _mm_loadu_ps(m.m + 4);
+    __m128 r2 = _mm_loadu_ps(m.m + 8);
+    __m128 r3 = _mm_loadu_ps(m.m + 12);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(out.m + 0, r0);
+    _mm_storeu_ps(out.m + 4, r1);
+    _mm_storeu_ps(out.m + 8, r2);
+    _mm_storeu_ps(out.m + 12, r3);
+#elif defined(VGT_MATH_NEON)
+    const float32x4x4_t rows = vld4q_f32(m.m); // de-interleaving load == transpose
+    vst1q_f32(out.m + 0, rows.val[0]);
+    vst1q_f32(out.m + 4, rows.val[1]);
+    vst1q_f32(out.m + 8, rows.val[2]);
+    vst1q_f32(out.m + 12, rows.val[3]);
+#else
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int col = 0; col < 4; ++col)
+            out.m[col * 4 + row] = m.m[row * 4 + col];
+    }
+#endif
+    return out;
+}
+
+// Row vector times matrix (v * m), matching VgtMat4Mul's convention.
+inline VgtVec4 VgtMat4MulVec4(const VgtVec4& v, const VgtMat4& m)
+{
+    VgtVec4 out;
+#if defined(VGT_MATH_SSE) || defined(VGT_MATH_AVX2)
+    __m128 acc = _mm_mul_ps(_mm_set1_ps(v.x), _mm_loadu_ps(m.m + 0));
+    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(v.y), _mm_loadu_ps(m.m + 4)));
+    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(v.z), _mm_loadu_ps(m.m + 8)));
+    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(v.w), _mm_loadu_ps(m.m + 12)));
+    _mm_store_ps(&out.x, acc);
+#elif defined(VGT_MATH_NEON)
+    float32x4_t acc = vmulq_n_f32(vld1q_f32(m.m + 0), v.x);
+    acc = vaddq_f32(acc, vmulq_n_f32(vld1q_f32(m.m + 4), v.y));
+    acc = vaddq_f32(acc, vmulq_n_f32(vld1q_f32(m.m + 8), v.z));
+    acc = vaddq_f32(acc, vmulq_n_f32(vld1q_f32(m.m + 12), v.w));
+    vst1q_f32(&out.x, acc);
+#else
+    const float in[4] = { v.x, v.y, v.z, v.w };
+    float r[4];
+    for (int col = 0; col < 4; ++col)
+        r[col] = in[0] * m.m[col] + in[1] * m.m[4 + col] + in[2] * m.m[8 + col] + in[3] * m.m[12 + col];
+    out.x = r[0];
+    out.y = r[1];
+    out.z = r[2];
+    out.w = r[3];
+#endif
+    return out;
+}
+
+// --- builders (same layout as the former per-step helpers) -------------------------------
+
+inline VgtMat4 VgtMat4Identity()
+{
+    VgtMat4 out;
+    out.m[0] = out.m[5] = out.m[10] = out.m[15] = 1.0f;
+    return out;
+}
+
+inline VgtMat4 VgtMat4RotateY(float angle)
+{
+    const float c = std::cos(angle);
+    const float s = std::sin(angle);
+    VgtMat4 out = VgtMat4Identity();
+    out.m[0] = c;
+    out.m[2] = -s;
+    out.m[8] = s;
+    out.m[10] = c;
+    return out;
+}
+
+inline VgtMat4 VgtMat4LookAt(float eyeX, float eyeY, float eyeZ,
+                             float centerX, float centerY, float centerZ,
+                             float upX, float upY, float upZ)
+{
+    // Forward vector (normalized)
+    float fx = centerX - eyeX;
+    float fy = centerY - eyeY;
+    float fz = centerZ - eyeZ;
+    const float rlf = 1.0f / std::sqrt(fx * fx + fy * fy + fz * fz);
+    fx *= rlf;
+    fy *= rlf;
+    fz *= rlf;
+
+    // Right vector (normalized)
+    float sx = fy * upZ - fz * upY;
+    float sy = fz * upX - fx * upZ;
+    float sz = fx * upY - fy * upX;
+    const float rls = 1.0f / std::sqrt(sx * sx + sy * sy + sz * sz);
+    sx *= rls;
+    sy *= rls;
+    sz *= rls;
+
+    // Up vector
+    const float ux = sy * fz - sz * fy;
+    const float uy = sz * fx - sx * fz;
+    const float uz = sx * fy - sy * fx;
+
+    VgtMat4 out;
+    out.m[0] = sx;
+    out.m[1] = sy;
+    out.m[2] = sz;
+    out.m[4] = ux;
+    out.m[5] = uy;
+    out.m[6] = uz;
+    out.m[8] = -fx;
+    out.m[9] = -fy;
+    out.m[10] = -fz;
+    out.m[12] = -(sx * eyeX + sy * eyeY + sz * eyeZ);
+    out.m[13] = -(ux * eyeX + uy * eyeY + uz * eyeZ);
+    out.m[14] = (fx * eyeX + fy * eyeY + fz * eyeZ);
+    out.m[15] = 1.0f;
+    return out;
+}
+
+// Vulkan clip space: depth in [0, 1] and Y pointing down (handled by negating m[5]).
+inline VgtMat4 VgtMat4Perspective(float fovY, float aspect, float zNear, float zFar)
+{
+    const float tanHalfFovy = std::tan(fovY / 2.0f);
+    VgtMat4 out;
+    out.m[0] = 1.0f / (aspect * tanHalfFovy);
+    out.m[5] = -(1.0f / tanHalfFovy);
+    out.m[10] = zFar / (zNear - zFar);
+    out.m[11] = -1.0f;
+    out.m[14] = -(zFar * zNear) / (zFar - zNear);
+    return out;
+}
+
+// Reverse-Z variant of VgtMat4Perspective: depth 1 at zNear and 0 at zFar. Clear depth to 0 and
+// test with GREATER. With a float depth buffer the precision of the float exponent near 0 then
+// falls on the far range, where the 1/z mapping is coarsest, instead of piling up near the camera.
+inline VgtMat4 VgtMat4PerspectiveReverseZ(float fovY, float aspect, float zNear, float zFar)
+{
+    const float tanHalfFovy = std::tan(fovY / 2.0f);
+    VgtMat4 out;
+    out.m[0] = 1.0f / (aspect * tanHalfFovy);
+    out.m[5] = -(1.0f / tanHalfFovy);
+    out.m[10] = zNear / (zFar - zNear);
+    out.m[11] = -1.0f;
+    out.m[14] = (zFar * zNear) / (zFar - zNear);
+    return out;
+}
+
+// The six clip planes of `viewProj` (left, right, bottom, top, near, far) in the space it is applied
+// to, for row vectors (clip = v * viewProj) and Vulkan's 0..w depth range. Each plane is
+// normalized so that dot(p.xyz, point) + p.w is the signed distance, positive inside.
+inline void VgtMat4FrustumPlanes(const VgtMat4& viewProj, VgtVec4 planes[6])
+{
+    const float* m = viewProj.m;
+    auto column = [m](int c) { return VgtVec4{ m[c], m[4 + c], m[8 + c], m[12 + c] }; };
+    const VgtVec4 x = column(0);
+    const VgtVec4 y = column(1);
+    const VgtVec4 z = column(2);
+    const VgtVec4 w = column(3);
+
+    planes[0] = { w.x + x.x, w.y + x.y, w.z + x.z, w.w + x.w };
+    planes[1] = { w.x - x.x, w.y - x.y, w.z - x.z, w.w - x.w };
+    planes[2] = { w.x + y.x, w.y + y.y, w.z + y.z, w.w + y.w };
+    planes[3] = { w.x - y.x, w.y - y.y, w.z - y.z, w.w - y.w };
+    planes[4] = z;
+    planes[5] = { w.x - z.x, w.y - z.y, w.z - z.z, w.w - z.w };
+    for (int i = 0; i < 6; ++i)
+    {
+        VgtVec4& p = planes[i];
+        const float rl = 1.0f / std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+        p = { p.x * rl, p.y * rl, p.z * rl, p.w * rl };
+    }
+}
+
+// Transposed upper-left 3x3 of `m`, padded with identity. Equals transpose(inverse(mat3(m)))
+// as long as `m` is a rotation plus translation (no scale).
+inline VgtMat4 VgtMat4NormalMatrix(const VgtMat4& m)
+{
+    VgtMat4 out = VgtMat4Transpose(m);
+    out.m[3] = out.m[7] = out.m[11] = 0.0f;
+    out.m[12] = out.m[13] = out.m[14] = 0.0f;
+    out.m[15] = 1.0f;
+    return out;
+}
@@ -0,0 +1,340 @@
+#include "VgtOptions.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+bool VgtGetEnv(const char* name, std::string& value)
+{
+#ifdef _WIN32
+    char* val = nullptr;
+    size_t len = 0;
+    if (_dupenv_s(&val, &len, name) != 0 || val == nullptr)
+        return false;
+    value = val;
+    std::free(val);
+    return true;
+#else
+    const char* val = std::getenv(name);
+    if (val == nullptr)
+        return false;
+    value = val;
+    return true;
+#endif
+}
+
+static bool ParseUint(const char* text, uint32_t& out)
+{
+    if (text == nullptr || *text == '\0')
+        return false;
+    char* end = nullptr;
+    const unsigned long v = std::strtoul(text, &end, 10);
+    if (end == text || *end != '\0')
+        return false;
+    out = static_cast<uint32_t>(v);
+    return true;
+}
+
+// Matches "--name value" and "--name=value". Advances `i` past a separate value argument.
+static bool MatchValue(int argc, char** argv, int& i, const char* name, const char*& value)
+{
+    const size_t nameLen = std::strlen(name);
+    if (std::strncmp(argv[i], name, nameLen) != 0)
+        return false;
+
+    if (argv[i][nameLen] == '=')
+    {
+        value = argv[i] + nameLen + 1;
+        return true;
+    }
+    if (argv[i][nameLen] == '\0' && i + 1 < argc)
+    {
+        value = argv[++i];
+        return true;
+    }
+    return false;
+}
+
+static void SetFramesInFlight(VgtOptions& options, const char* text, const char* source)
+{
+    uint32_t v = 0;
+    if (!ParseUint(text, v) || v == 0 || v > kVgtMaxFramesInFlight)
+    {
+        std::fprintf(stderr, "Ignoring %s=%s (expected 1..%u)\n", source, text ? text : "", kVgtMaxFramesInFlight);
+        return;
+    }
+    options.framesInFlight = v;
+}
+
+static void SetPresentMode(VgtOptions& options, const char* text, const char* source)
+{
+    if (std::strcmp(text, "fifo") == 0)
+        options.presentMode = VgtPresentMode::Fifo;
+    else if (std::strcmp(text, "fifo-relaxed") == 0)
+        options.presentMode = VgtPresentMode::FifoRelaxed;
+    else if (std::strcmp(text, "mailbox") == 0)
+        options.presentMode = VgtPresentMode::Mailbox;
+    else if (std::strcmp(text, "immediate") == 0)
+        options.presentMode = VgtPresentMode::Immediate;
+    else
+        std::fprintf(stderr, "Ignoring %s=%s (expected fifo, fifo-relaxed, mailbox or immediate)\n", source, text);
+}
+
+static void SetSwapchainImages(VgtOptions& options, const char* text, const char* source)
+{
+    uint32_t v = 0;
+    if (!ParseUint(text, v) || v > kVgtMaxSwapchainImages)
+    {
+        std::fprintf(stderr, "Ignoring %s=%s (expected 0..%u)\n", source, text ? text : "", kVgtMaxSwapchainImages);
+        return;
+    }
+    options.swapchainImages = v;
+}
+
+static void SetFrameLimit(VgtOptions& options, const char* text, const char* source)
+{
+    uint32_t v = 0;
+    if (!ParseUint(text, v))
+    {
+        std::fprintf(stderr, "Ignoring %s=%s (expected a frame count)\n", source, text ? text : "");
+        return;
+    }
+    options.frameLimit = v;
+}
+
+static void SetBenchmarkFrames(uint32_t& out, const char* text, const char* source, bool allowZero)
+{
+    uint32_t v = 0;
+    if (!ParseUint(text, v) || (v == 0 && !allowZero))
+    {
+        std::fprintf(stderr, "Ignoring %s=%s (expected a%s frame count)\n", source, text ? text : "", allowZero ? "" : " positive");
+        return;
+    }
+    out = v;
+}
+
+static void SetHeadless(VgtOptions& options, const char* text)
+{
+    if (std::strcmp(text, "surface") == 0)
+        options.backend = VgtPresentBackend::HeadlessSurface;
+    else if (std::strcmp(text, "0") != 0)
+        options.backend = VgtPresentBackend::Offscreen;
+}
+
+static void SetMipmaps(VgtOptions& options, const char* text, const char* source)
+{
+    if (std::strcmp(text, "blit") == 0)
+        options.mipmaps = VgtMipmapMode::Blit;
+    else if (std::strcmp(text, "compute") == 0)
+        options.mipmaps = VgtMipmapMode::Compute;
+    else if (std::strcmp(text, "off") == 0)
+        options.mipmaps = VgtMipmapMode::Off;
+    else
+        std::fprintf(stderr, "Ignoring %s=%s (expected blit, compute or off)\n", source, text);
+}
+
+static void SetTextureRepeat(VgtOptions& options, const char* text, const char* source)
+{
+    uint32_t v = 0;
+    if (!ParseUint(text, v) || v == 0)
+    {
+        std::fprintf(stderr, "Ignoring %s=%s (expected a positive repeat count)\n", source, text ? text : "");
+        return;
+    }
+    options.textureRepeat = v;
+}
+
+static void SetDrawCount(VgtOptions& options, const char* text, const char* source)
+{
+    uint32_t v = 0;
+    if (!ParseUint(text, v) || v == 0 || v > kVgtMaxDraws)
+    {
+        std::fprintf(stderr, "Ignoring %s=%s (expected 1..%u)\n", source, text ? text : "", kVgtMaxDraws);
+        return;
+    }
+    options.drawCount = v;
+}
+
+static void SetRecordThreads(VgtOptions& options, const char* text, const char* source)
+{
+    uint32_t v = 0;
+    if (!ParseUint(text, v) || v > kVgtMaxRecordThreads)
+    {
+        std::fprintf(stderr, "Ignoring %s=%s (expected 0..%u)\n", source, text ? text : "", kVgtMaxRecordThreads);
+        return;
+    }
+    options.recordThreads = v;
+}
+
+static void SetOverdraw(VgtOptions& options, const char* text, const char* source)
+{
+    uint32_t v = 0;
+    if (!ParseUint(text, v) || v == 0 || v > kVgtMaxOverdraw)
+    {
+        std::fprintf(stderr, "Ignoring %s=%s (expected 1..%u)\n", source, text ? text : "", kVgtMaxOverdraw);
+        return;
+    }
+    options.overdraw = v;
+}
+
+static void SetLights(VgtOptions& options, const char* text, const char* source)
+{
+    uint32_t v = 0;
+    if (!ParseUint(text, v) || v > kVgtMaxLights)
+    {
+        std::fprintf(stderr, "Ignoring %s=%s (expected 0..%u)\n", source, text ? text : "", kVgtMaxLights);
+        return;
+    }
+    options.lights = v;
+}
+
+VgtOptions VgtParseOptions(int argc, char** argv)
+{
+    VgtOptions options;
+
+    std::string env;
+    if (VgtGetEnv("VGT_FRAMES_IN_FLIGHT", env))
+        SetFramesInFlight(options, env.c_str(), "VGT_FRAMES_IN_FLIGHT");
+    if (VgtGetEnv("VGT_SHOW_FPS", env))
+        options.showFps = true;
+    if (VgtGetEnv("VGT_MEMORY_STATS", env))
+        options.memoryStats = true;
+    if (VgtGetEnv("VGT_STATIC_COMMAND_BUFFERS", env))
+        options.staticCommandBuffers = true;
+    if (VgtGetEnv("VGT_NO_PIPELINE_CACHE", env))
+        options.pipelineCache = false;
+    if (VgtGetEnv("VGT_SHADERS_FROM_DISK", env))
+        options.shadersFromDisk = true;
+    if (VgtGetEnv("VGT_HEADLESS", env))
+        SetHeadless(options, env.c_str());
+    if (VgtGetEnv("VGT_PRESENT_MODE", env))
+        SetPresentMode(options, env.c_str(), "VGT_PRESENT_MODE");
+    if (VgtGetEnv("VGT_SWAPCHAIN_IMAGES", env))
+        SetSwapchainImages(options, env.c_str(), "VGT_SWAPCHAIN_IMAGES");
+    if (VgtGetEnv("VGT_LATENCY", env))
+        options.latency = true;
+    if (VgtGetEnv("VGT_TRACE", env))
+        options.tracePath = env;
+    if (VgtGetEnv("VGT_FRAMES", env))
+        SetFrameLimit(options, env.c_str(), "VGT_FRAMES");
+    if (VgtGetEnv("VGT_GPU_TIMING", env))
+        options.gpuTiming = true;
+    if (VgtGetEnv("VGT_GPU_TIMING_CSV", env))
+        options.gpuTimingCsv = env;
+    if (VgtGetEnv("VGT_BENCHMARK", env))
+        options.benchmark = true;
+    if (VgtGetEnv("VGT_BENCHMARK_WARMUP", env))
+        SetBenchmarkFrames(options.benchmarkWarmup, env.c_str(), "VGT_BENCHMARK_WARMUP", true);
+    if (VgtGetEnv("VGT_BENCHMARK_FRAMES", env))
+        SetBenchmarkFrames(options.benchmarkFrames, env.c_str(), "VGT_BENCHMARK_FRAMES", false);
+    if (VgtGetEnv("VGT_BENCHMARK_JSON", env))
+        options.benchmarkJson = env;
+    if (VgtGetEnv("VGT_MIPMAPS", env))
+        SetMipmaps(options, env.c_str(), "VGT_MIPMAPS");
+    if (VgtGetEnv("VGT_TEXTURE_REPEAT", env))
+        SetTextureRepeat(options, env.c_str(), "VGT_TEXTURE_REPEAT");
+    if (VgtGetEnv("VGT_TEXTURE", env))
+        options.texturePath = env;
+    if (VgtGetEnv("VGT_SERIAL_STARTUP", env))
+        options.serialStartup = true;
+    if (VgtGetEnv("VGT_DRAWS", env))
+        SetDrawCount(options, env.c_str(), "VGT_DRAWS");
+    if (VgtGetEnv("VGT_RECORD_THREADS", env))
+        SetRecordThreads(options, env.c_str(), "VGT_RECORD_THREADS");
+    if (VgtGetEnv("VGT_INDIRECT", env))
+        options.indirect = true;
+    if (VgtGetEnv("VGT_CULL", env))
+        options.cull = true;
+    if (VgtGetEnv("VGT_REVERSE_Z", env))
+        options.reverseZ = true;
+    if (VgtGetEnv("VGT_DEPTH_PREPASS", env))
+        options.depthPrepass = true;
+    if (VgtGetEnv("VGT_OVERDRAW", env))
+        SetOverdraw(options, env.c_str(), "VGT_OVERDRAW");
+    if (VgtGetEnv("VGT_LIGHTS", env))
+        SetLights(options, env.c_str(), "VGT_LIGHTS");
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* value = nullptr;
+        if (MatchValue(argc, argv, i, "--frames-in-flight", value))
+            SetFramesInFlight(options, value, "--frames-in-flight");
+        else if (std::strcmp(argv[i], "--show-fps") == 0)
+            options.showFps = true;
+        else if (std::strcmp(argv[i], "--memory-stats") == 0)
+            options.memoryStats = true;
+        else if (std::strcmp(argv[i], "--static-command-buffers") == 0)
+            options.staticCommandBuffers = true;
+        else if (std::strcmp(argv[i], "--no-pipeline-cache") == 0)
+            options.pipelineCache = false;
+        else if (std::strcmp(argv[i], "--shaders-from-disk") == 0)
+            options.shadersFromDisk = true;
+        else if (std::strcmp(argv[i], "--headless") == 0)
+            options.backend = VgtPresentBackend::Offscreen;
+        else if (std::strcmp(argv[i], "--headless-surface") == 0)
+            options.backend = VgtPresentBackend::HeadlessSurface;
+        else if (MatchValue(argc, argv, i, "--present-mode", value))
+            SetPresentMode(options, value, "--present-mode");
+        else if (MatchValue(argc, argv, i, "--swapchain-images", value))
+            SetSwapchainImages(options, value, "--swapchain-images");
+        else if (std::strcmp(argv[i], "--latency") == 0)
+            options.latency = true;
+        else if (MatchValue(argc, argv, i, "--trace", value))
+            options.tracePath = value;
+        else if (MatchValue(argc, argv, i, "--frames", value))
+            SetFrameLimit(options, value, "--frames");
+        else if (std::strcmp(argv[i], "--gpu-timing") == 0)
+            options.gpuTiming = true;
+        else if (MatchValue(argc, argv, i, "--gpu-timing-csv", value))
+            options.gpuTimingCsv = value;
+        else if (std::strcmp(argv[i], "--benchmark") == 0)
+            options.benchmark = true;
+        else if (MatchValue(argc, argv, i, "--benchmark-warmup", value))
+            SetBenchmarkFrames(options.benchmarkWarmup, value, "--benchmark-warmup", true);
+        else if (MatchValue(argc, argv, i, "--benchmark-frames", value))
+            SetBenchmarkFrames(options.benchmarkFrames, value, "--benchmark-frames", false);
+        else if (MatchValue(argc, argv, i, "--benchmark-json", value))
+            options.benchmarkJson = value;
+        else if (MatchValue(argc, argv, i, "--mipmaps", value))
+            SetMipmaps(options, value, "--mipmaps");
+        else if (MatchValue(argc, argv, i, "--texture-repeat", value))
+            SetTextureRepeat(options, value, "--texture-repeat");
+        else if (MatchValue(argc, argv, i, "--texture", value))
+            options.texturePath = value;
+        else if (std::strcmp(argv[i], "--serial-startup") == 0)
+            options.serialStartup = true;
+        else if (MatchValue(argc, argv, i, "--draws", value))
+            SetDrawCount(options, value, "--draws");
+        else if (MatchValue(argc, argv, i, "--record-threads", value))
+            SetRecordThreads(options, value, "--record-threads");
+        else if (std::strcmp(argv[i], "--indirect") == 0)
+            options.indirect = true;
+        else if (std::strcmp(argv[i], "--cull") == 0)
+            options.cull = true;
+        else if (std::strcmp(argv[i], "--reverse-z") == 0)
+            options.reverseZ = true;
+        else if (std::strcmp(argv[i], "--depth-prepass") == 0)
+            options.depthPrepass = true;
+        else if (MatchValue(argc, argv, i, "--overdraw", value))
+            SetOverdraw(options, value, "--overdraw");
+        else if (MatchValue(argc, argv, i, "--lights", value))
+            SetLights(options, value, "--lights");
+        else
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+    }
+
+    if (!options.gpuTimingCsv.empty())
+        options.gpuTiming = true;
+    if (options.cull)
+        options.indirect = true;
+    if (options.benchmark)
+    {
+        options.gpuTiming = true;
+        options.frameLimit = options.benchmarkWarmup + options.benchmarkFrames;
+    }
+
+    if (options.backend != VgtPresentBackend::Window && options.frameLimit == 0)
+        options.frameLimit = kVgtDefaultHeadlessFrames;
+
+    return options;
+}
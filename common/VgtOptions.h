@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <VgtConfig.h>
+
+enum class VgtPresentBackend : uint32_t
+{
+    Window,          // GLFW window + swapchain
+    HeadlessSurface, // VK_EXT_headless_surface + swapchain
+    Offscreen,       // offscreen images, no WSI
+};
+
+// Swapchain present modes (see VgtPresenter.h for the image count each one gets).
+enum class VgtPresentMode : uint32_t
+{
+    Fifo,        // vsync, never tears; the only mode every driver supports
+    FifoRelaxed, // vsync, but a late frame is shown immediately (tears instead of waiting a refresh)
+    Mailbox,     // vsync, the newest finished frame replaces the queued one: low latency, no tearing
+    Immediate,   // no vsync: lowest latency, tears
+};
+
+enum class VgtMipmapMode : uint32_t
+{
+    Blit,    // vkCmdBlitImage, or the compute shader when the format cannot be linearly blitted
+    Compute, // always use the compute shader (common/shaders/mipgen.comp)
+    Off,     // single mip level
+};
+
+// Defaults for VgtOptions::benchmarkWarmup / benchmarkFrames.
+constexpr uint32_t kVgtDefaultBenchmarkWarmup = 120;
+constexpr uint32_t kVgtDefaultBenchmarkFrames = 1000;
+
+// Runtime knobs shared by every step.
+// Values come from environment variables first, then command-line flags override them.
+struct VgtOptions
+{
+    // Number of frames the CPU may record ahead of the GPU (1 == fully serialized).
+    // env: VGT_FRAMES_IN_FLIGHT, flag: --frames-in-flight N
+    uint32_t framesInFlight = VGT_DEFAULT_FRAMES_IN_FLIGHT;
+
+    // Print a frames-per-second line to stderr periodically and on exit.
+    // env: VGT_SHOW_FPS, flag: --show-fps
+    bool showFps = false;
+
+    // Print device memory allocator statistics on exit.
+    // env: VGT_MEMORY_STATS, flag: --memory-stats
+    bool memoryStats = false;
+
+    // Record one command buffer per swapchain image at startup and resubmit it every frame
+    // (only for steps whose frame content never changes).
+    // env: VGT_STATIC_COMMAND_BUFFERS, flag: --static-command-buffers
+    bool staticCommandBuffers = false;
+
+    // Load/save the pipeline cache file next to the executable. Disable to measure cold creation.
+    // env: VGT_NO_PIPELINE_CACHE, flag: --no-pipeline-cache
+    bool pipelineCache = true;
+
+    // Load .spv files from disk even when shaders are embedded (VGT_EMBED_SHADERS), so edited
+    // shaders can be picked up by rebuilding only the shader target.
+    // env: VGT_SHADERS_FROM_DISK, flag: --shaders-from-disk
+    bool shadersFromDisk = false;
+
+    // Render without a window (see VgtPresenter.h). Headless runs default to kVgtDefaultHeadlessFrames.
+    // env: VGT_HEADLESS=offscreen|surface, flags: --headless, --headless-surface
+    VgtPresentBackend backend = VgtPresentBackend::Window;
+
+    // Swapchain present mode; falls back to FIFO when the surface does not support it.
+    // env: VGT_PRESENT_MODE=fifo|fifo-relaxed|mailbox|immediate, flag: --present-mode MODE
+    VgtPresentMode presentMode = VgtPresentMode::Fifo;
+
+    // Swapchain image count (0 == picked for the present mode and frames in flight, see VgtPresenter.h).
+    // Clamped to what the surface allows.
+    // env: VGT_SWAPCHAIN_IMAGES, flag: --swapchain-images N
+    uint32_t swapchainImages = 0;
+
+    // Measure input-to-photon latency of every presented frame (see VgtLatency.h) and print
+    // rolling min/avg/p99 periodically and on exit.
+    // env: VGT_LATENCY, flag: --latency
+    bool latency = false;
+
+    // Record CPU zones (startup and every frame phase, see VgtTrace.h) and write them to PATH
+    // as Chrome trace JSON on exit, for Perfetto / chrome://tracing.
+    // env: VGT_TRACE, flag: --trace PATH
+    std::string tracePath;
+
+    // Exit after this many frames (0 == run until the window is closed).
+    // env: VGT_FRAMES, flag: --frames N
+    uint32_t frameLimit = 0;
+
+    // Measure GPU time per frame / render pass with timestamp queries (see VgtGpuTimer.h)
+    // and print rolling min/avg/p99 periodically and on exit.
+    // env: VGT_GPU_TIMING, flag: --gpu-timing
+    bool gpuTiming = false;
+
+    // Also append the GPU timing statistics to this CSV file (implies gpuTiming).
+    // env: VGT_GPU_TIMING_CSV, flag: --gpu-timing-csv PATH
+    std::string gpuTimingCsv;
+
+    // Deterministic benchmark run (see VgtBenchmark.h): fixed animation timestep, --benchmark-warmup
+    // frames discarded, then --benchmark-frames measured and reported as JSON. Overrides --frames
+    // and implies gpuTiming.
+    // env: VGT_BENCHMARK, flag: --benchmark
+    bool benchmark = false;
+    // env: VGT_BENCHMARK_WARMUP, flag: --benchmark-warmup N
+    uint32_t benchmarkWarmup = kVgtDefaultBenchmarkWarmup;
+    // env: VGT_BENCHMARK_FRAMES, flag: --benchmark-frames N
+    uint32_t benchmarkFrames = kVgtDefaultBenchmarkFrames;
+    // Where the JSON report goes (empty == stdout).
+    // env: VGT_BENCHMARK_JSON, flag: --benchmark-json PATH
+    std::string benchmarkJson;
+
+    // How streamed textures get their mip chain (see VgtTextureStreamer.h).
+    // env: VGT_MIPMAPS=blit|compute|off, flag: --mipmaps blit|compute|off
+    VgtMipmapMode mipmaps = VgtMipmapMode::Blit;
+
+    // Step03 only: tile the texture N times across the quad, so it is heavily minified
+    // (compare --mipmaps off / blit with --gpu-timing).
+    // env: VGT_TEXTURE_REPEAT, flag: --texture-repeat N
+    uint32_t textureRepeat = 1;
+
+    // Step03 only: image to stream (PNG/JPEG, or KTX2/DDS with their own mips and BCn/ETC2/ASTC format).
+    // env: VGT_TEXTURE, flag: --texture PATH
+    std::string texturePath = "assets/texture.png";
+
+    // Step03 only: run the startup tasks (shader loading, pipeline cache, pipeline creation; see
+    // VgtTaskGraph.h) one after another on the main thread instead of next to swapchain creation,
+    // to compare the time to the first frame.
+    // env: VGT_SERIAL_STARTUP, flag: --serial-startup
+    bool serialStartup = false;
+
+    // Step04 only: draw the triangle N times (a grid of small copies, one UBO slice each).
+    // env: VGT_DRAWS, flag: --draws N
+    uint32_t drawCount = 1;
+
+    // Step04 only: record the draws into secondary command buffers on N threads
+    // (see VgtParallelRecorder.h). 0 == record everything inline into the primary buffer.
+    // env: VGT_RECORD_THREADS, flag: --record-threads N
+    uint32_t recordThreads = 0;
+
+    // Step04 only: draw the --draws N objects GPU-driven, from a storage buffer of model matrices
+    // and one vkCmdDrawIndexedIndirect(Count) call (see VgtIndirectDraw.h). Ignores --record-threads.
+    // env: VGT_INDIRECT, flag: --indirect
+    bool indirect = false;
+
+    // Step04 only: frustum-cull the --indirect objects in a compute pass that writes the draw
+    // commands and their count (see VgtGpuCull.h), with the grid spread well beyond the view.
+    // Implies --indirect. Reports visible vs. submitted objects periodically and on exit.
+    // env: VGT_CULL, flag: --cull
+    bool cull = false;
+
+    // Step04/Step05: reverse-Z depth (near plane at 1, far plane at 0, GREATER test; see VgtDepth.h).
+    // env: VGT_REVERSE_Z, flag: --reverse-z
+    bool reverseZ = false;
+
+    // Step05 only: lay down depth in a depth-only pass first, then shade with an EQUAL depth test
+    // and depth writes off, so lighting.frag runs at most once per pixel.
+    // env: VGT_DEPTH_PREPASS, flag: --depth-prepass
+    bool depthPrepass = false;
+
+    // Step05 only: draw the triangle as N stacked layers, back to front, so every pixel it covers
+    // is shaded N times without --depth-prepass (the worst case for early depth testing).
+    // env: VGT_OVERDRAW, flag: --overdraw N
+    uint32_t overdraw = 1;
+
+    // Step05 only: add N point/spot lights around the scene, shaded with clustered forward
+    // lighting (lights binned into view-space clusters by a compute pass; see VgtClusteredLights.h).
+    // 0 == directional light only.
+    // env: VGT_LIGHTS, flag: --lights N
+    uint32_t lights = 0;
+};
+
+// Upper bound for VgtOptions::framesInFlight. Per-frame arrays are sized at runtime,
+// this only guards against nonsense values.
+constexpr uint32_t kVgtMaxFramesInFlight = 8;
+
+// Upper bound for VgtOptions::swapchainImages.
+constexpr uint32_t kVgtMaxSwapchainImages = 8;
+
+// Frame limit used for headless runs when none was given, so batch jobs always terminate.
+constexpr uint32_t kVgtDefaultHeadlessFrames = 300;
+
+// Upper bounds for VgtOptions::drawCount / recordThreads. Without --indirect the UBO ring holds
+// one slice per draw, so stay well below the bound there.
+constexpr uint32_t kVgtMaxDraws = 1000000;
+constexpr uint32_t kVgtMaxRecordThreads = 64;
+constexpr uint32_t kVgtMaxOverdraw = 1024;
+constexpr uint32_t kVgtMaxLights = 65536;
+
+VgtOptions VgtParseOptions(int argc, char** argv);
+
+// Returns true and fills `value` when the environment variable is set.
+bool VgtGetEnv(const char* name, std::string& value);
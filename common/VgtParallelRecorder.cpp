@@ -0,0 +1,113 @@
+#include "VgtParallelRecorder.h"
+
+#include <algorithm>
+#include <thread>
+
+VkResult VgtCreateParallelRecorder(const VgtParallelRecorderCreateInfo& ci, VgtParallelRecorder& recorder)
+{
+    recorder = VgtParallelRecorder{};
+    recorder.device = ci.device;
+    recorder.threadCount = ci.threadCount != 0 ? ci.threadCount : std::max(std::thread::hardware_concurrency(), 1u);
+    recorder.framesInFlight = std::max(ci.framesInFlight, 1u);
+
+    const uint32_t poolCount = recorder.threadCount * recorder.framesInFlight;
+    recorder.pools.resize(poolCount, VK_NULL_HANDLE);
+    recorder.buffers.resize(poolCount, VK_NULL_HANDLE);
+    recorder.results.resize(recorder.threadCount, VK_SUCCESS);
+
+    // Buffers are only ever reset through their pool, so no RESET_COMMAND_BUFFER_BIT.
+    VkCommandPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    poolCI.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolCI.queueFamilyIndex = ci.queueFamily;
+
+    for (uint32_t i = 0; i < poolCount; ++i)
+    {
+        VkResult res = vkCreateCommandPool(ci.device, &poolCI, nullptr, &recorder.pools[i]);
+        if (res == VK_SUCCESS)
+        {
+            VkCommandBufferAllocateInfo cmdAI{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+            cmdAI.commandPool = recorder.pools[i];
+            cmdAI.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            cmdAI.commandBufferCount = 1;
+            res = vkAllocateCommandBuffers(ci.device, &cmdAI, &recorder.buffers[i]);
+        }
+        if (res != VK_SUCCESS)
+        {
+            VgtDestroyParallelRecorder(recorder);
+            return res;
+        }
+    }
+
+    if (recorder.threadCount > 1)
+        recorder.workers = std::make_unique<VgtThreadPool>(recorder.threadCount - 1);
+    return VK_SUCCESS;
+}
+
+void VgtDestroyParallelRecorder(VgtParallelRecorder& recorder)
+{
+    // Joins the workers first; they hold no Vulkan objects of their own.
+    recorder.workers.reset();
+
+    // Destroying a pool frees its buffers.
+    for (VkCommandPool pool : recorder.pools)
+    {
+        if (pool != VK_NULL_HANDLE)
+            vkDestroyCommandPool(recorder.device, pool, nullptr);
+    }
+    recorder = VgtParallelRecorder{};
+}
+
+static VkResult RecordSlot(VkDevice device, VkCommandPool pool, VkCommandBuffer cmd, const VkCommandBufferInheritanceInfo& inheritance,
+    uint32_t first, uint32_t count, const VgtRecordRangeFn& recordRange)
+{
+    VkResult res = vkResetCommandPool(device, pool, 0);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkCommandBufferBeginInfo begin{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    begin.pInheritanceInfo = &inheritance;
+    res = vkBeginCommandBuffer(cmd, &begin);
+    if (res != VK_SUCCESS)
+        return res;
+
+    recordRange(cmd, first, count);
+    return vkEndCommandBuffer(cmd);
+}
+
+VkResult VgtRecordParallel(VgtParallelRecorder& recorder, uint32_t frame, VkCommandBuffer primary, VkRenderPass renderPass,
+    VkFramebuffer framebuffer, uint32_t drawCount, const VgtRecordRangeFn& recordRange)
+{
+    // Fewer draws than threads: one draw per slot, the remaining slots stay idle.
+    const uint32_t slotCount = std::clamp(drawCount, 1u, recorder.threadCount);
+    const uint32_t perSlot = drawCount / slotCount;
+    const uint32_t remainder = drawCount % slotCount;
+
+    VkCommandBufferInheritanceInfo inheritance{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO };
+    inheritance.renderPass = renderPass;
+    inheritance.subpass = 0;
+    inheritance.framebuffer = framebuffer;
+
+    const uint32_t base = frame * recorder.threadCount;
+    auto recordSlot = [&](uint32_t slot) {
+        const uint32_t first = slot * perSlot + std::min(slot, remainder);
+        const uint32_t count = perSlot + (slot < remainder ? 1u : 0u);
+        recorder.results[slot] =
+            RecordSlot(recorder.device, recorder.pools[base + slot], recorder.buffers[base + slot], inheritance, first, count, recordRange);
+    };
+
+    for (uint32_t slot = 1; slot < slotCount; ++slot)
+        recorder.workers->submit([&recordSlot, slot] { recordSlot(slot); });
+    recordSlot(0);
+    if (slotCount > 1)
+        recorder.workers->waitIdle();
+
+    for (uint32_t slot = 0; slot < slotCount; ++slot)
+    {
+        if (recorder.results[slot] != VK_SUCCESS)
+            return recorder.results[slot];
+    }
+
+    vkCmdExecuteCommands(primary, slotCount, &recorder.buffers[base]);
+    return VK_SUCCESS;
+}
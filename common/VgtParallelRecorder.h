@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "VgtThreadPool.h"
+
+// Records the draws of one render pass on several threads.
+//
+// - The draw range is split into one contiguous range per recording slot. Slot 0 is recorded on
+//   the calling thread, the others on a private VgtThreadPool.
+// - Every slot owns one VkCommandPool per frame in flight. Command pools are externally
+//   synchronized, so no two threads ever share one, and a slot is recycled with a single
+//   vkResetCommandPool instead of resetting buffers one by one.
+// - Each slot records a VK_COMMAND_BUFFER_LEVEL_SECONDARY buffer that continues the caller's
+//   render pass. The caller begins the pass with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+//   VgtRecordParallel then executes the secondaries in slot order, so the draw order is the
+//   same as with single-threaded recording.
+// - A secondary buffer inherits only the render pass: every range has to set its own dynamic
+//   state (viewport, scissor) and bind the pipeline, descriptor sets and vertex buffers.
+struct VgtParallelRecorderCreateInfo
+{
+    VkDevice device = VK_NULL_HANDLE;
+    uint32_t queueFamily = 0;
+    uint32_t threadCount = 1;    // recording threads including the caller (0 == one per hardware thread)
+    uint32_t framesInFlight = 1;
+};
+
+// Records draws [first, first + count) into `cmd`. Called once per non-empty slot, concurrently,
+// between vkBeginCommandBuffer and vkEndCommandBuffer.
+using VgtRecordRangeFn = std::function<void(VkCommandBuffer cmd, uint32_t first, uint32_t count)>;
+
+struct VgtParallelRecorder
+{
+    VkDevice device = VK_NULL_HANDLE;
+    uint32_t threadCount = 0;
+    uint32_t framesInFlight = 0;
+
+    std::vector<VkCommandPool> pools;       // [frame * threadCount + slot]
+    std::vector<VkCommandBuffer> buffers;   // one secondary buffer per pool
+    std::vector<VkResult> results;          // per slot, written by the recording thread
+    std::unique_ptr<VgtThreadPool> workers; // threadCount - 1 threads, none for a single slot
+};
+
+VkResult VgtCreateParallelRecorder(const VgtParallelRecorderCreateInfo& ci, VgtParallelRecorder& recorder);
+void VgtDestroyParallelRecorder(VgtParallelRecorder& recorder);
+
+// Records `drawCount` draws into `frame`'s secondary buffers and executes them in `primary`,
+// which must be inside `renderPass` (subpass 0, begun with SECONDARY_COMMAND_BUFFERS contents).
+// Call after the frame slot's fence wait (VgtWaitForFrame): that is what makes resetting the
+// slot's pools safe. Returns once every slot has finished recording.
+VkResult VgtRecordParallel(VgtParallelRecorder& recorder, uint32_t frame, VkCommandBuffer primary, VkRenderPass renderPass,
+    VkFramebuffer framebuffer, uint32_t drawCount, const VgtRecordRangeFn& recordRange);
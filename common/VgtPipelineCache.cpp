@@ -0,0 +1,155 @@
+#include "VgtPipelineCache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "VgtPlatform.h"
+#include "VgtTrace.h"
+
+// Layout of VkPipelineCacheHeaderVersionOne (Vulkan spec, "Pipeline Cache").
+static constexpr size_t kHeaderSize = 16 + VK_UUID_SIZE;
+
+static bool ReadFile(const std::string& path, std::vector<char>& data)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+    const std::streamsize size = file.tellg();
+    if (size <= 0)
+        return false;
+    data.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    file.read(data.data(), size);
+    return static_cast<bool>(file);
+}
+
+static bool HeaderMatches(const std::vector<char>& data, const VkPhysicalDeviceProperties& props)
+{
+    if (data.size() < kHeaderSize)
+        return false;
+
+    uint32_t header[4] = {};
+    std::memcpy(header, data.data(), sizeof(header));
+    const uint32_t headerSize = header[0];
+    const uint32_t headerVersion = header[1];
+    const uint32_t vendorID = header[2];
+    const uint32_t deviceID = header[3];
+
+    if (headerSize < kHeaderSize || headerSize > data.size())
+        return false;
+    if (headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+        return false;
+    if (vendorID != props.vendorID || deviceID != props.deviceID)
+        return false;
+    return std::memcmp(data.data() + 16, props.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+VkResult VgtCreatePipelineCache(VkPhysicalDevice physicalDevice, VkDevice device, const char* name, bool persistent,
+    VgtPipelineCache& cache)
+{
+    VGT_TRACE_ZONE("pipeline cache load");
+    cache = VgtPipelineCache{};
+    cache.persistent = persistent;
+
+    std::vector<char> data;
+    if (persistent)
+    {
+        cache.path = VgtGetExecutableDir() + name + ".pipeline_cache";
+
+        if (ReadFile(cache.path, data))
+        {
+            VkPhysicalDeviceProperties props{};
+            vkGetPhysicalDeviceProperties(physicalDevice, &props);
+            if (!HeaderMatches(data, props))
+            {
+                std::fprintf(stderr, "Ignoring %s (created by a different device or driver)\n", cache.path.c_str());
+                data.clear();
+            }
+        }
+    }
+
+    VkPipelineCacheCreateInfo cacheCI{ VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+    cacheCI.initialDataSize = data.size();
+    cacheCI.pInitialData = data.empty() ? nullptr : data.data();
+
+    VkResult res = vkCreatePipelineCache(device, &cacheCI, nullptr, &cache.cache);
+    if (res != VK_SUCCESS && !data.empty())
+    {
+        // The driver may still reject data that passed the header check; start cold instead.
+        cacheCI.initialDataSize = 0;
+        cacheCI.pInitialData = nullptr;
+        data.clear();
+        res = vkCreatePipelineCache(device, &cacheCI, nullptr, &cache.cache);
+    }
+
+    cache.warm = (res == VK_SUCCESS) && !data.empty();
+    cache.loadedBytes = data.size();
+    return res;
+}
+
+void VgtDestroyPipelineCache(VkDevice device, VgtPipelineCache& cache)
+{
+    if (cache.cache == VK_NULL_HANDLE)
+        return;
+
+    if (cache.persistent && !cache.path.empty())
+    {
+        size_t size = 0;
+        std::vector<char> data;
+        if (vkGetPipelineCacheData(device, cache.cache, &size, nullptr) == VK_SUCCESS && size > 0)
+        {
+            data.resize(size);
+            if (vkGetPipelineCacheData(device, cache.cache, &size, data.data()) != VK_SUCCESS)
+                data.clear();
+        }
+
+        if (!data.empty())
+        {
+            // Write to a temporary file first so an interrupted run never leaves a truncated cache.
+            const std::string tmpPath = cache.path + ".tmp";
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            file.write(data.data(), static_cast<std::streamsize>(size));
+            file.close();
+            if (file)
+            {
+                // One replace: a crash leaves the old cache or the new one, never neither.
+                if (!VgtReplaceFile(tmpPath.c_str(), cache.path.c_str()))
+                {
+                    std::remove(tmpPath.c_str());
+                    std::fprintf(stderr, "Failed to write %s\n", cache.path.c_str());
+                }
+            }
+            else
+            {
+                std::remove(tmpPath.c_str());
+                std::fprintf(stderr, "Failed to write %s\n", tmpPath.c_str());
+            }
+        }
+    }
+
+    vkDestroyPipelineCache(device, cache.cache, nullptr);
+    cache.cache = VK_NULL_HANDLE;
+}
+
+VkResult VgtCreateGraphicsPipelines(VkDevice device, VgtPipelineCache& cache, uint32_t count,
+    const VkGraphicsPipelineCreateInfo* createInfos, VkPipeline* pipelines)
+{
+    VGT_TRACE_ZONE("pipeline creation");
+    const auto t0 = std::chrono::steady_clock::now();
+    const VkResult res = vkCreateGraphicsPipelines(device, cache.cache, count, createInfos, nullptr, pipelines);
+    cache.creationMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    cache.pipelineCount += count;
+    return res;
+}
+
+void VgtPrintPipelineCacheStats(const char* label, const VgtPipelineCache& cache)
+{
+    std::fprintf(stderr, "[%s] pipeline creation: %.3f ms for %u pipeline(s), %s cache",
+        label, cache.creationMs, cache.pipelineCount, cache.warm ? "warm" : "cold");
+    if (cache.warm)
+        std::fprintf(stderr, " (%zu bytes loaded)", cache.loadedBytes);
+    std::fprintf(stderr, "\n");
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <vulkan/vulkan.h>
+
+// VkPipelineCache persisted next to the executable as `<name>.pipeline_cache`.
+//
+// The file is only used when its VkPipelineCacheHeaderVersionOne header matches the
+// current device (header version, vendor ID, device ID and pipelineCacheUUID); a
+// driver update or a different GPU silently falls back to an empty (cold) cache.
+struct VgtPipelineCache
+{
+    VkPipelineCache cache = VK_NULL_HANDLE;
+    std::string path;
+    bool persistent = true;    // write back on destroy
+    bool warm = false;         // started from a valid file
+    size_t loadedBytes = 0;
+
+    double creationMs = 0.0;   // accumulated by VgtCreateGraphicsPipelines
+    uint32_t pipelineCount = 0;
+};
+
+// `persistent == false` creates an empty cache that is neither loaded nor saved.
+VkResult VgtCreatePipelineCache(VkPhysicalDevice physicalDevice, VkDevice device, const char* name, bool persistent,
+    VgtPipelineCache& cache);
+
+// Saves the cache (when persistent) and destroys it.
+void VgtDestroyPipelineCache(VkDevice device, VgtPipelineCache& cache);
+
+// vkCreateGraphicsPipelines through the cache; times the call for VgtPrintPipelineCacheStats.
+VkResult VgtCreateGraphicsPipelines(VkDevice device, VgtPipelineCache& cache, uint32_t count,
+    const VkGraphicsPipelineCreateInfo* createInfos, VkPipeline* pipelines);
+
+// One line to stderr: cold/warm and the time spent creating pipelines.
+// Steps print it only with --show-fps or --benchmark.
+void VgtPrintPipelineCacheStats(const char* label, const VgtPipelineCache& cache);
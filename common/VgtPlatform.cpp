@@ -0,0 +1,140 @@
+#include "VgtPlatform.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <climits>
+#endif
+
+static bool s_errorDialogs = true;
+
+std::string VgtGetExecutableDir()
+{
+    std::string exeDir;
+#ifdef _WIN32
+    char exePath[MAX_PATH] = {};
+    const DWORD len = GetModuleFileNameA(nullptr, exePath, MAX_PATH);
+    if (len == 0 || len >= MAX_PATH)
+        return {};
+    exeDir.assign(exePath, len);
+#else
+    char exePath[PATH_MAX] = {};
+    const ssize_t len = readlink("/proc/self/exe", exePath, sizeof(exePath) - 1);
+    if (len <= 0)
+        return {};
+    exeDir.assign(exePath, static_cast<size_t>(len));
+#endif
+
+    const size_t lastSlash = exeDir.find_last_of("\\/");
+    if (lastSlash == std::string::npos)
+        return {};
+    exeDir.resize(lastSlash + 1);
+    return exeDir;
+}
+
+bool VgtMapFile(const char* path, VgtMappedFile& file)
+{
+    file = VgtMappedFile{};
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart <= 0)
+    {
+        CloseHandle(handle);
+        return false;
+    }
+
+    // The view keeps the mapping (and the file) alive, so both handles can be closed right away.
+    HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(handle);
+    if (!mapping)
+        return false;
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view)
+        return false;
+
+    file.data = static_cast<const uint8_t*>(view);
+    file.size = static_cast<size_t>(size.QuadPart);
+#else
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    // The mapping outlives the descriptor.
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED)
+        return false;
+
+    file.data = static_cast<const uint8_t*>(view);
+    file.size = static_cast<size_t>(st.st_size);
+#endif
+    return true;
+}
+
+void VgtUnmapFile(VgtMappedFile& file)
+{
+    if (file.data)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(file.data);
+#else
+        munmap(const_cast<uint8_t*>(file.data), file.size);
+#endif
+    }
+    file = VgtMappedFile{};
+}
+
+bool VgtReplaceFile(const char* from, const char* to)
+{
+#ifdef _WIN32
+    // std::rename fails on Windows when `to` exists; MoveFileExW replaces it.
+    return MoveFileExW(std::filesystem::path(from).c_str(), std::filesystem::path(to).c_str(),
+               MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    std::error_code ec;
+    std::filesystem::rename(from, to, ec);
+    return !ec;
+#endif
+}
+
+double VgtGetTimeSeconds()
+{
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void VgtShowError(const char* title, const char* message)
+{
+    std::fprintf(stderr, "%s\n", message);
+#ifdef _WIN32
+    if (s_errorDialogs)
+        MessageBoxA(nullptr, message, title, MB_OK | MB_ICONERROR);
+#else
+    (void)title;
+#endif
+}
+
+void VgtEnableErrorDialogs(bool enabled)
+{
+    s_errorDialogs = enabled;
+}
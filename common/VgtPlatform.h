@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Thin OS helpers shared by the steps, so step code does not include <Windows.h> directly.
+
+// Directory containing the running executable, with a trailing separator.
+// Returns an empty string when it cannot be determined.
+std::string VgtGetExecutableDir();
+
+// Read-only mapping of a whole file (mmap / MapViewOfFile). The OS pages it in on first
+// touch, so nothing is read up front. `data` stays valid until VgtUnmapFile.
+struct VgtMappedFile
+{
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+// Returns false (and leaves `file` empty) when the file is missing or empty.
+bool VgtMapFile(const char* path, VgtMappedFile& file);
+void VgtUnmapFile(VgtMappedFile& file);
+
+// Moves `from` over `to` in one step (rename / MoveFileExW with MOVEFILE_REPLACE_EXISTING), so
+// `to` always holds either the old or the new contents, even if the process dies in between.
+bool VgtReplaceFile(const char* from, const char* to);
+
+// Seconds since the first call (monotonic). Replaces glfwGetTime() so headless runs need no GLFW.
+double VgtGetTimeSeconds();
+
+// Prints `message` to stderr; on Windows also shows a message box unless dialogs are disabled.
+void VgtShowError(const char* title, const char* message);
+void VgtEnableErrorDialogs(bool enabled);
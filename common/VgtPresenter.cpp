@@ -0,0 +1,622 @@
+#include "VgtPresenter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "VgtPlatform.h"
+#include "VgtTrace.h"
+
+static bool HasInstanceExtension(const char* name)
+{
+    uint32_t count = 0;
+    vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr);
+    std::vector<VkExtensionProperties> props(count);
+    vkEnumerateInstanceExtensionProperties(nullptr, &count, props.data());
+    for (const auto& p : props)
+    {
+        if (std::strcmp(p.extensionName, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool VgtPresenterInit(const VgtPresenterCreateInfo& ci, VgtPresenter& presenter)
+{
+    presenter = VgtPresenter{};
+    presenter.backend = ci.backend;
+    presenter.title = ci.title;
+    presenter.width = ci.width;
+    presenter.height = ci.height;
+    presenter.frameLimit = ci.frameLimit;
+    presenter.requestedPresentMode = ci.presentMode;
+    presenter.requestedImages = ci.swapchainImages;
+    presenter.framesInFlight = ci.framesInFlight;
+    if (ci.measureLatency)
+    {
+        presenter.latency = std::make_unique<VgtLatencyMeter>();
+        presenter.latency->label = ci.title;
+    }
+
+    if (presenter.backend != VgtPresentBackend::Window)
+    {
+        // Nobody is around to click a message box on a batch node.
+        VgtEnableErrorDialogs(false);
+        return true;
+    }
+
+    VGT_TRACE_ZONE("window creation");
+    if (!glfwInit())
+        return false;
+
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+    presenter.window = glfwCreateWindow(static_cast<int>(ci.width), static_cast<int>(ci.height), ci.title, nullptr, nullptr);
+    if (!presenter.window)
+    {
+        glfwTerminate();
+        return false;
+    }
+
+    // Not every platform reports a resize through VK_ERROR_OUT_OF_DATE_KHR (e.g. Wayland).
+    glfwSetWindowUserPointer(presenter.window, &presenter);
+    glfwSetFramebufferSizeCallback(presenter.window, [](GLFWwindow* window, int, int) {
+        static_cast<VgtPresenter*>(glfwGetWindowUserPointer(window))->needsRecreate = true;
+    });
+    return true;
+}
+
+void VgtPresenterShutdown(VgtPresenter& presenter)
+{
+    if (presenter.window)
+    {
+        glfwDestroyWindow(presenter.window);
+        glfwTerminate();
+        presenter.window = nullptr;
+    }
+}
+
+void VgtPresenterGetInstanceExtensions(VgtPresenter& presenter, std::vector<const char*>& extensions)
+{
+    switch (presenter.backend)
+    {
+    case VgtPresentBackend::Window:
+    {
+        uint32_t count = 0;
+        const char** glfwExts = glfwGetRequiredInstanceExtensions(&count);
+        extensions.insert(extensions.end(), glfwExts, glfwExts + count);
+        break;
+    }
+    case VgtPresentBackend::HeadlessSurface:
+        if (HasInstanceExtension(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME))
+        {
+            extensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+            extensions.push_back(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME);
+        }
+        else
+        {
+            std::fprintf(stderr, "%s not available, rendering offscreen instead\n", VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME);
+            presenter.backend = VgtPresentBackend::Offscreen;
+        }
+        break;
+    case VgtPresentBackend::Offscreen:
+        break;
+    }
+}
+
+void VgtPresenterGetDeviceExtensions(const VgtPresenter& presenter, std::vector<const char*>& extensions)
+{
+    if (presenter.backend != VgtPresentBackend::Offscreen)
+        extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+}
+
+static bool HasDeviceExtension(const std::vector<VkExtensionProperties>& props, const char* name)
+{
+    for (const auto& p : props)
+    {
+        if (std::strcmp(p.extensionName, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+void VgtPresenterEnableDeviceFeatures(VgtPresenter& presenter, VkPhysicalDevice physicalDevice,
+    std::vector<const char*>& extensions, VkDeviceCreateInfo& deviceCI)
+{
+    if (!presenter.latency || presenter.backend == VgtPresentBackend::Offscreen)
+        return;
+
+    uint32_t count = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, nullptr);
+    std::vector<VkExtensionProperties> props(count);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, props.data());
+    if (!HasDeviceExtension(props, VK_KHR_PRESENT_ID_EXTENSION_NAME) || !HasDeviceExtension(props, VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+        return;
+
+    VkPhysicalDevicePresentWaitFeaturesKHR waitFeatures{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR };
+    VkPhysicalDevicePresentIdFeaturesKHR idFeatures{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR };
+    idFeatures.pNext = &waitFeatures;
+    VkPhysicalDeviceFeatures2 features2{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+    features2.pNext = &idFeatures;
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+    if (!idFeatures.presentId || !waitFeatures.presentWait)
+        return;
+
+    presenter.presentIdFeatures.pNext = const_cast<void*>(deviceCI.pNext);
+    presenter.presentIdFeatures.presentId = VK_TRUE;
+    presenter.presentWaitFeatures.pNext = &presenter.presentIdFeatures;
+    presenter.presentWaitFeatures.presentWait = VK_TRUE;
+    deviceCI.pNext = &presenter.presentWaitFeatures;
+
+    extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+    extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    deviceCI.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    deviceCI.ppEnabledExtensionNames = extensions.data();
+    presenter.presentWait = true;
+}
+
+VkResult VgtPresenterCreateSurface(VgtPresenter& presenter, VkInstance instance)
+{
+    presenter.instance = instance;
+
+    switch (presenter.backend)
+    {
+    case VgtPresentBackend::Window:
+        return glfwCreateWindowSurface(instance, presenter.window, nullptr, &presenter.surface);
+    case VgtPresentBackend::HeadlessSurface:
+    {
+        auto vkCreateHeadlessSurfaceEXT_ =
+            reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(vkGetInstanceProcAddr(instance, "vkCreateHeadlessSurfaceEXT"));
+        if (!vkCreateHeadlessSurfaceEXT_)
+            return VK_ERROR_EXTENSION_NOT_PRESENT;
+        VkHeadlessSurfaceCreateInfoEXT surfaceCI{ VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT };
+        return vkCreateHeadlessSurfaceEXT_(instance, &surfaceCI, nullptr, &presenter.surface);
+    }
+    case VgtPresentBackend::Offscreen:
+        break;
+    }
+    return VK_SUCCESS;
+}
+
+void VgtPresenterDestroySurface(VgtPresenter& presenter)
+{
+    if (presenter.surface)
+        vkDestroySurfaceKHR(presenter.instance, presenter.surface, nullptr);
+    presenter.surface = VK_NULL_HANDLE;
+}
+
+bool VgtPresenterSupportsPresent(const VgtPresenter& presenter, VkPhysicalDevice physicalDevice, uint32_t queueFamily)
+{
+    if (presenter.surface == VK_NULL_HANDLE)
+        return true;
+
+    VkBool32 supported = VK_FALSE;
+    vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, queueFamily, presenter.surface, &supported);
+    return supported == VK_TRUE;
+}
+
+// Offscreen images always use this format.
+static constexpr VkFormat kOffscreenFormat = VK_FORMAT_B8G8R8A8_UNORM;
+
+static VkResult CreateOffscreenImages(VgtPresenter& presenter, const VgtSwapchainDesc& desc)
+{
+    constexpr uint32_t kOffscreenImageCount = 3;
+
+    presenter.format = kOffscreenFormat;
+    presenter.extent = { presenter.width, presenter.height };
+    presenter.presentLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    presenter.images.assign(kOffscreenImageCount, VK_NULL_HANDLE);
+    presenter.imageMemory.assign(kOffscreenImageCount, VK_NULL_HANDLE);
+
+    VkPhysicalDeviceMemoryProperties memProps{};
+    vkGetPhysicalDeviceMemoryProperties(presenter.physicalDevice, &memProps);
+
+    for (uint32_t i = 0; i < kOffscreenImageCount; ++i)
+    {
+        VkImageCreateInfo imageCI{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+        imageCI.imageType = VK_IMAGE_TYPE_2D;
+        imageCI.format = presenter.format;
+        imageCI.extent = { presenter.extent.width, presenter.extent.height, 1 };
+        imageCI.mipLevels = 1;
+        imageCI.arrayLayers = 1;
+        imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageCI.usage = desc.imageUsage | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        imageCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageCI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        VkResult res = vkCreateImage(presenter.device, &imageCI, nullptr, &presenter.images[i]);
+        if (res != VK_SUCCESS)
+            return res;
+
+        VkMemoryRequirements req{};
+        vkGetImageMemoryRequirements(presenter.device, presenter.images[i], &req);
+
+        // A handful of render targets: dedicated allocations are fine here.
+        VkMemoryAllocateInfo ai{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+        ai.allocationSize = req.size;
+        ai.memoryTypeIndex = UINT32_MAX;
+        for (uint32_t t = 0; t < memProps.memoryTypeCount; ++t)
+        {
+            if ((req.memoryTypeBits & (1u << t)) && (memProps.memoryTypes[t].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
+            {
+                ai.memoryTypeIndex = t;
+                break;
+            }
+        }
+        if (ai.memoryTypeIndex == UINT32_MAX)
+        {
+            for (uint32_t t = 0; t < memProps.memoryTypeCount && ai.memoryTypeIndex == UINT32_MAX; ++t)
+            {
+                if (req.memoryTypeBits & (1u << t))
+                    ai.memoryTypeIndex = t;
+            }
+        }
+
+        res = vkAllocateMemory(presenter.device, &ai, nullptr, &presenter.imageMemory[i]);
+        if (res != VK_SUCCESS)
+            return res;
+        res = vkBindImageMemory(presenter.device, presenter.images[i], presenter.imageMemory[i], 0);
+        if (res != VK_SUCCESS)
+            return res;
+    }
+    return VK_SUCCESS;
+}
+
+static VkPresentModeKHR ToVkPresentMode(VgtPresentMode mode)
+{
+    switch (mode)
+    {
+    case VgtPresentMode::FifoRelaxed:
+        return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+    case VgtPresentMode::Mailbox:
+        return VK_PRESENT_MODE_MAILBOX_KHR;
+    case VgtPresentMode::Immediate:
+        return VK_PRESENT_MODE_IMMEDIATE_KHR;
+    default:
+        return VK_PRESENT_MODE_FIFO_KHR;
+    }
+}
+
+static const char* PresentModeName(VkPresentModeKHR mode)
+{
+    switch (mode)
+    {
+    case VK_PRESENT_MODE_FIFO_KHR:
+        return "FIFO";
+    case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+        return "FIFO_RELAXED";
+    case VK_PRESENT_MODE_MAILBOX_KHR:
+        return "MAILBOX";
+    case VK_PRESENT_MODE_IMMEDIATE_KHR:
+        return "IMMEDIATE";
+    default:
+        return "other";
+    }
+}
+
+// See the present mode notes in VgtPresenter.h.
+static uint32_t PickImageCount(const VgtPresenter& presenter, const VkSurfaceCapabilitiesKHR& caps, VkPresentModeKHR presentMode)
+{
+    uint32_t imageCount = presenter.requestedImages;
+    if (imageCount == 0)
+        imageCount = presenter.framesInFlight + (presentMode == VK_PRESENT_MODE_MAILBOX_KHR ? 2 : 1);
+    imageCount = std::max(imageCount, caps.minImageCount);
+    if (caps.maxImageCount > 0)
+        imageCount = std::min(imageCount, caps.maxImageCount);
+    return imageCount;
+}
+
+// B8G8R8A8_UNORM with sRGB-nonlinear color space when the surface offers it, else its first format.
+static bool PickSurfaceFormat(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, VkSurfaceFormatKHR& surfaceFormat)
+{
+    uint32_t formatCount = 0;
+    vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, nullptr);
+    std::vector<VkSurfaceFormatKHR> formats(formatCount);
+    vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, formats.data());
+    if (formats.empty())
+        return false;
+
+    surfaceFormat = formats[0];
+    for (const auto& f : formats)
+    {
+        if (f.format == VK_FORMAT_B8G8R8A8_UNORM && f.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+        {
+            surfaceFormat = f;
+            break;
+        }
+    }
+    return true;
+}
+
+static VkResult CreateSwapchain(VgtPresenter& presenter, VkSwapchainKHR oldSwapchain)
+{
+    const VkPhysicalDevice physicalDevice = presenter.physicalDevice;
+    const VkDevice device = presenter.device;
+    const VgtSwapchainDesc& desc = presenter.desc;
+
+    VkSurfaceCapabilitiesKHR caps{};
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, presenter.surface, &caps);
+
+    VkSurfaceFormatKHR surfaceFormat{};
+    if (!PickSurfaceFormat(physicalDevice, presenter.surface, surfaceFormat))
+        return VK_ERROR_FORMAT_NOT_SUPPORTED;
+
+    uint32_t presentModeCount = 0;
+    vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, presenter.surface, &presentModeCount, nullptr);
+    std::vector<VkPresentModeKHR> presentModes(presentModeCount);
+    vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, presenter.surface, &presentModeCount, presentModes.data());
+
+    const VkPresentModeKHR requestedMode = ToVkPresentMode(presenter.requestedPresentMode);
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR; // always supported
+    if (std::find(presentModes.begin(), presentModes.end(), requestedMode) != presentModes.end())
+        presentMode = requestedMode;
+    else if (oldSwapchain == VK_NULL_HANDLE)
+        std::fprintf(stderr, "[%s] Present mode %s not supported, using FIFO\n", presenter.title, PresentModeName(requestedMode));
+
+    VkExtent2D extent = caps.currentExtent;
+    if (extent.width == UINT32_MAX)
+    {
+        // The surface lets us choose (always the case for headless surfaces).
+        extent = { presenter.width, presenter.height };
+        if (presenter.window)
+        {
+            int w = 0, h = 0;
+            glfwGetFramebufferSize(presenter.window, &w, &h);
+            extent.width = static_cast<uint32_t>(w);
+            extent.height = static_cast<uint32_t>(h);
+        }
+    }
+
+    const uint32_t imageCount = PickImageCount(presenter, caps, presentMode);
+
+    VkSwapchainCreateInfoKHR swapCI{ VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR };
+    swapCI.surface = presenter.surface;
+    swapCI.minImageCount = imageCount;
+    swapCI.imageFormat = surfaceFormat.format;
+    swapCI.imageColorSpace = surfaceFormat.colorSpace;
+    swapCI.imageExtent = extent;
+    swapCI.imageArrayLayers = 1;
+    swapCI.imageUsage = desc.imageUsage;
+    swapCI.preTransform = caps.currentTransform;
+    swapCI.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+    swapCI.presentMode = presentMode;
+    swapCI.clipped = VK_TRUE;
+    swapCI.oldSwapchain = oldSwapchain;
+    swapCI.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    const uint32_t qIndices[] = { desc.graphicsQueueFamily, desc.presentQueueFamily };
+    if (desc.graphicsQueueFamily != desc.presentQueueFamily)
+    {
+        swapCI.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
+        swapCI.queueFamilyIndexCount = 2;
+        swapCI.pQueueFamilyIndices = qIndices;
+    }
+
+    const VkResult res = vkCreateSwapchainKHR(device, &swapCI, nullptr, &presenter.swapchain);
+    if (res != VK_SUCCESS)
+        return res;
+
+    presenter.format = surfaceFormat.format;
+    presenter.colorSpace = surfaceFormat.colorSpace;
+    presenter.presentMode = presentMode;
+    presenter.extent = extent;
+    presenter.presentLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    uint32_t swapImageCount = 0;
+    vkGetSwapchainImagesKHR(device, presenter.swapchain, &swapImageCount, nullptr);
+    presenter.images.resize(swapImageCount);
+    vkGetSwapchainImagesKHR(device, presenter.swapchain, &swapImageCount, presenter.images.data());
+
+    if (presenter.latency)
+    {
+        presenter.latency->modeName = PresentModeName(presentMode);
+        presenter.latency->imageCount = swapImageCount;
+    }
+    return VK_SUCCESS;
+}
+
+VkResult VgtPresenterChooseFormat(VgtPresenter& presenter, VkPhysicalDevice physicalDevice)
+{
+    if (presenter.backend == VgtPresentBackend::Offscreen)
+    {
+        presenter.format = kOffscreenFormat;
+        presenter.presentLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        return VK_SUCCESS;
+    }
+
+    VkSurfaceFormatKHR surfaceFormat{};
+    if (!PickSurfaceFormat(physicalDevice, presenter.surface, surfaceFormat))
+        return VK_ERROR_FORMAT_NOT_SUPPORTED;
+    presenter.format = surfaceFormat.format;
+    presenter.colorSpace = surfaceFormat.colorSpace;
+    presenter.presentLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    return VK_SUCCESS;
+}
+
+VkResult VgtPresenterCreateSwapchain(VgtPresenter& presenter, VkPhysicalDevice physicalDevice, VkDevice device,
+    const VgtSwapchainDesc& desc)
+{
+    presenter.physicalDevice = physicalDevice;
+    presenter.device = device;
+    presenter.desc = desc;
+    presenter.needsRecreate = false;
+    vkGetDeviceQueue(device, desc.presentQueueFamily, 0, &presenter.presentQueue);
+
+    VGT_TRACE_ZONE("swapchain creation");
+    const VkResult res = presenter.backend == VgtPresentBackend::Offscreen ? CreateOffscreenImages(presenter, desc)
+                                                                           : CreateSwapchain(presenter, VK_NULL_HANDLE);
+    if (res == VK_SUCCESS && presenter.latency)
+    {
+        if (presenter.swapchain == VK_NULL_HANDLE)
+        {
+            presenter.latency->modeName = "offscreen";
+            presenter.latency->imageCount = static_cast<uint32_t>(presenter.images.size());
+        }
+        VgtLatencyStart(*presenter.latency, device, presenter.presentWait);
+    }
+    return res;
+}
+
+VkResult VgtPresenterRecreateSwapchain(VgtPresenter& presenter, VkSwapchainKHR& retired)
+{
+    retired = VK_NULL_HANDLE;
+    presenter.needsRecreate = false;
+    if (presenter.swapchain == VK_NULL_HANDLE)
+        return VK_SUCCESS; // offscreen images never go out of date
+
+    // A minimized window has a 0x0 surface, for which no swapchain can be created.
+    if (presenter.window)
+    {
+        int w = 0, h = 0;
+        glfwGetFramebufferSize(presenter.window, &w, &h);
+        while ((w == 0 || h == 0) && !glfwWindowShouldClose(presenter.window))
+        {
+            glfwWaitEvents();
+            glfwGetFramebufferSize(presenter.window, &w, &h);
+        }
+        if (glfwWindowShouldClose(presenter.window))
+            return VK_SUCCESS;
+    }
+
+    VGT_TRACE_ZONE("swapchain recreation");
+
+    // On failure the old swapchain is retired all the same (it cannot be used after being
+    // passed as oldSwapchain), and presenter.swapchain is left empty.
+    std::unique_lock<std::mutex> lock;
+    if (presenter.latency)
+    {
+        lock = VgtLatencyLockSwapchain(*presenter.latency);
+        VgtLatencyForget(*presenter.latency, presenter.swapchain);
+    }
+    retired = presenter.swapchain;
+    presenter.swapchain = VK_NULL_HANDLE;
+    presenter.images.clear();
+    return CreateSwapchain(presenter, retired);
+}
+
+VkResult VgtRecreateSwapchain(VgtPresenter& presenter, VgtFrameSync& sync)
+{
+    VkSwapchainKHR retired = VK_NULL_HANDLE;
+    VkResult res = VgtPresenterRecreateSwapchain(presenter, retired);
+    if (retired == VK_NULL_HANDLE)
+        return res;
+
+    const VkDevice device = presenter.device;
+    VgtRetire(sync, [device, retired]() { vkDestroySwapchainKHR(device, retired, nullptr); });
+    if (res == VK_SUCCESS)
+        res = VgtRecreateImageSync(device, sync, static_cast<uint32_t>(presenter.images.size()));
+    return res;
+}
+
+void VgtPresenterDestroySwapchain(VgtPresenter& presenter)
+{
+    if (presenter.latency)
+        VgtLatencyStop(*presenter.latency);
+
+    if (presenter.swapchain)
+    {
+        vkDestroySwapchainKHR(presenter.device, presenter.swapchain, nullptr);
+        presenter.swapchain = VK_NULL_HANDLE;
+    }
+    else
+    {
+        for (auto image : presenter.images)
+            vkDestroyImage(presenter.device, image, nullptr);
+        for (auto memory : presenter.imageMemory)
+            vkFreeMemory(presenter.device, memory, nullptr);
+    }
+    presenter.images.clear();
+    presenter.imageMemory.clear();
+}
+
+bool VgtPresenterRunning(VgtPresenter& presenter)
+{
+    if (presenter.frameLimit != 0 && presenter.framesPresented >= presenter.frameLimit)
+        return false;
+
+    if (presenter.latency)
+        VgtLatencyTick(*presenter.latency);
+
+    VGT_TRACE_ZONE("poll");
+    if (presenter.window)
+        glfwPollEvents();
+    presenter.inputTime = VgtGetTimeSeconds();
+    return presenter.window == nullptr || !glfwWindowShouldClose(presenter.window);
+}
+
+VkResult VgtPresenterAcquire(VgtPresenter& presenter, VkSemaphore signalSemaphore, uint32_t& imageIndex)
+{
+    VGT_TRACE_ZONE("acquire");
+    if (presenter.swapchain)
+    {
+        std::unique_lock<std::mutex> lock;
+        if (presenter.latency)
+            lock = VgtLatencyLockSwapchain(*presenter.latency);
+        const VkResult res =
+            vkAcquireNextImageKHR(presenter.device, presenter.swapchain, UINT64_MAX, signalSemaphore, VK_NULL_HANDLE, &imageIndex);
+        if (res == VK_SUBOPTIMAL_KHR || res == VK_ERROR_OUT_OF_DATE_KHR)
+            presenter.needsRecreate = true;
+        return res == VK_SUBOPTIMAL_KHR ? VK_SUCCESS : res;
+    }
+
+    // Offscreen: round-robin; the caller's VgtClaimImage still waits for the image's last frame.
+    imageIndex = presenter.nextImage;
+    presenter.nextImage = (presenter.nextImage + 1) % static_cast<uint32_t>(presenter.images.size());
+
+    VkSubmitInfo submit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    submit.signalSemaphoreCount = 1;
+    submit.pSignalSemaphores = &signalSemaphore;
+    return vkQueueSubmit(presenter.presentQueue, 1, &submit, VK_NULL_HANDLE);
+}
+
+VkResult VgtPresenterPresent(VgtPresenter& presenter, VkSemaphore waitSemaphore, uint32_t imageIndex)
+{
+    VGT_TRACE_ZONE("present");
+    ++presenter.framesPresented;
+
+    if (presenter.swapchain)
+    {
+        VkPresentInfoKHR present{ VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
+        present.waitSemaphoreCount = 1;
+        present.pWaitSemaphores = &waitSemaphore;
+        present.swapchainCount = 1;
+        present.pSwapchains = &presenter.swapchain;
+        present.pImageIndices = &imageIndex;
+
+        std::unique_lock<std::mutex> lock;
+        uint64_t presentId = 0;
+        VkPresentIdKHR presentIdInfo{ VK_STRUCTURE_TYPE_PRESENT_ID_KHR };
+        if (presenter.latency)
+        {
+            lock = VgtLatencyLockSwapchain(*presenter.latency);
+            presentId = VgtLatencyNextPresentId(*presenter.latency);
+            if (presentId != 0)
+            {
+                presentIdInfo.swapchainCount = 1;
+                presentIdInfo.pPresentIds = &presentId;
+                present.pNext = &presentIdInfo;
+            }
+        }
+
+        const VkResult res = vkQueuePresentKHR(presenter.presentQueue, &present);
+        if (presenter.latency && (res == VK_SUCCESS || res == VK_SUBOPTIMAL_KHR))
+            VgtLatencyPresented(*presenter.latency, presenter.swapchain, presentId, presenter.inputTime);
+        if (res == VK_SUBOPTIMAL_KHR || res == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            presenter.needsRecreate = true;
+            return VK_SUCCESS;
+        }
+        return res;
+    }
+
+    // Offscreen: consume the render-finished semaphore so it can be signaled again.
+    const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    VkSubmitInfo submit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    submit.waitSemaphoreCount = 1;
+    submit.pWaitSemaphores = &waitSemaphore;
+    submit.pWaitDstStageMask = &waitStage;
+    const VkResult res = vkQueueSubmit(presenter.presentQueue, 1, &submit, VK_NULL_HANDLE);
+    if (presenter.latency && res == VK_SUCCESS)
+        VgtLatencyPresented(*presenter.latency, VK_NULL_HANDLE, 0, presenter.inputTime);
+    return res;
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "VgtFrameSync.h"
+#include "VgtLatency.h"
+#include "VgtOptions.h"
+
+// Where frames go. The steps keep their own instance/device/render pass setup and talk to
+// the presenter only for the window-system parts, so the same render loop runs on:
+//
+// - Window:          GLFW window + VkSurfaceKHR + swapchain (the default).
+// - HeadlessSurface: VK_EXT_headless_surface + swapchain, no window system required.
+//                    Falls back to Offscreen when the extension is missing.
+// - Offscreen:       plain VkImages, no WSI extensions at all (e.g. Mesa lavapipe on a
+//                    GPU-less node). Acquire/present become empty queue submits that signal
+//                    and consume the step's semaphores, so the frame sync is unchanged.
+//
+// Images end their render pass in `presentLayout` (PRESENT_SRC_KHR, or TRANSFER_SRC_OPTIMAL
+// offscreen so they can be read back).
+//
+// When the window is resized, or acquire/present report VK_SUBOPTIMAL_KHR or
+// VK_ERROR_OUT_OF_DATE_KHR, `needsRecreate` is set; the render loop then calls
+// VgtRecreateSwapchain before its next acquire and rebuilds its image views and framebuffers.
+// Pipelines survive: the steps set viewport and scissor as dynamic state.
+//
+// Present mode and image count (--present-mode, --swapchain-images) apply to every swapchain
+// the presenter creates. An unsupported mode falls back to FIFO. Unless set explicitly, the
+// image count is one per frame in flight plus the one on screen, and one more for MAILBOX
+// (the image waiting in the mailbox); more images than that only queue up and add latency in
+// the FIFO modes. The count is kept within the surface's min / max.
+
+struct VgtPresenterCreateInfo
+{
+    const char* title = "";
+    uint32_t width = 1280;
+    uint32_t height = 720;
+    VgtPresentBackend backend = VgtPresentBackend::Window;
+    uint32_t frameLimit = 0; // 0 == until the window is closed
+    VgtPresentMode presentMode = VgtPresentMode::Fifo;
+    uint32_t swapchainImages = 0; // 0 == picked for the present mode, see above
+    uint32_t framesInFlight = 2;
+    bool measureLatency = false;  // see VgtLatency.h
+};
+
+struct VgtSwapchainDesc
+{
+    uint32_t graphicsQueueFamily = 0;
+    uint32_t presentQueueFamily = 0;
+    VkImageUsageFlags imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+};
+
+struct VgtPresenter
+{
+    VgtPresentBackend backend = VgtPresentBackend::Window;
+    const char* title = "";
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t frameLimit = 0;
+    uint64_t framesPresented = 0;
+    VgtPresentMode requestedPresentMode = VgtPresentMode::Fifo;
+    uint32_t requestedImages = 0;
+    uint32_t framesInFlight = 2;
+    double inputTime = 0.0; // when VgtPresenterRunning last polled events
+
+    GLFWwindow* window = nullptr;
+    VkInstance instance = VK_NULL_HANDLE;
+    VkSurfaceKHR surface = VK_NULL_HANDLE;
+
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkQueue presentQueue = VK_NULL_HANDLE;
+    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkColorSpaceKHR colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    VkExtent2D extent{};
+    VkImageLayout presentLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    std::vector<VkImage> images;
+
+    VgtSwapchainDesc desc; // as passed to VgtPresenterCreateSwapchain, reused on recreation
+    bool needsRecreate = false;
+
+    // --latency only
+    std::unique_ptr<VgtLatencyMeter> latency;
+    bool presentWait = false; // VK_KHR_present_id + VK_KHR_present_wait enabled on the device
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR };
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR };
+
+    // Offscreen only
+    std::vector<VkDeviceMemory> imageMemory;
+    uint32_t nextImage = 0;
+};
+
+// Creates the window (Window backend only). Call before creating the instance.
+// Headless backends also turn off Windows error dialogs (VgtEnableErrorDialogs).
+bool VgtPresenterInit(const VgtPresenterCreateInfo& ci, VgtPresenter& presenter);
+void VgtPresenterShutdown(VgtPresenter& presenter);
+
+// Appends the instance / device extensions the backend needs.
+void VgtPresenterGetInstanceExtensions(VgtPresenter& presenter, std::vector<const char*>& extensions);
+void VgtPresenterGetDeviceExtensions(const VgtPresenter& presenter, std::vector<const char*>& extensions);
+
+// Call right before vkCreateDevice, after the step has built its own deviceCI.pNext chain.
+// With --latency, enables VK_KHR_present_id + VK_KHR_present_wait when the device supports
+// them: appends the extensions (and points deviceCI at `extensions` again) and chains their
+// feature structs, which live in the presenter. Does nothing otherwise.
+void VgtPresenterEnableDeviceFeatures(VgtPresenter& presenter, VkPhysicalDevice physicalDevice,
+    std::vector<const char*>& extensions, VkDeviceCreateInfo& deviceCI);
+
+VkResult VgtPresenterCreateSurface(VgtPresenter& presenter, VkInstance instance);
+void VgtPresenterDestroySurface(VgtPresenter& presenter);
+
+// Offscreen: any queue family can "present".
+bool VgtPresenterSupportsPresent(const VgtPresenter& presenter, VkPhysicalDevice physicalDevice, uint32_t queueFamily);
+
+// Fills `format` and `presentLayout` with what VgtPresenterCreateSwapchain is going to use, so
+// render passes and pipelines can be created before (or while) the swapchain is.
+VkResult VgtPresenterChooseFormat(VgtPresenter& presenter, VkPhysicalDevice physicalDevice);
+
+// Creates the swapchain (or offscreen images) and fills format/extent/images.
+VkResult VgtPresenterCreateSwapchain(VgtPresenter& presenter, VkPhysicalDevice physicalDevice, VkDevice device,
+    const VgtSwapchainDesc& desc);
+void VgtPresenterDestroySwapchain(VgtPresenter& presenter);
+
+// Replaces the swapchain with one for the current window size, passing the old one as
+// oldSwapchain so the presentation engine can hand over its resources. The old swapchain is
+// returned in `retired` (VK_NULL_HANDLE if nothing was replaced); the caller destroys it once
+// no frame in flight uses its images. While the window is minimized this waits for events;
+// if the window is closed meanwhile, nothing is replaced.
+VkResult VgtPresenterRecreateSwapchain(VgtPresenter& presenter, VkSwapchainKHR& retired);
+
+// VgtPresenterRecreateSwapchain for a render loop: the old swapchain and the per-image
+// semaphores are retired through `sync` (VgtRetire), so the frames in flight finish with them
+// while the next frame already renders to the new images. Call between frames; the caller
+// retires and rebuilds its own views / framebuffers the same way.
+VkResult VgtRecreateSwapchain(VgtPresenter& presenter, VgtFrameSync& sync);
+
+// Polls window events (the input time of the next frame for --latency); false once the window
+// closed or the frame limit was reached.
+bool VgtPresenterRunning(VgtPresenter& presenter);
+
+// vkAcquireNextImageKHR / vkQueuePresentKHR equivalents. VK_SUBOPTIMAL_KHR is reported as
+// VK_SUCCESS (the image was acquired / presented) with `needsRecreate` set. Acquire returns
+// VK_ERROR_OUT_OF_DATE_KHR when no image could be acquired: skip the frame and recreate.
+// Present never returns it: the frame was submitted either way, so only `needsRecreate` is set.
+VkResult VgtPresenterAcquire(VgtPresenter& presenter, VkSemaphore signalSemaphore, uint32_t& imageIndex);
+VkResult VgtPresenterPresent(VgtPresenter& presenter, VkSemaphore waitSemaphore, uint32_t imageIndex);
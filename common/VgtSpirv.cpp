@@ -0,0 +1,91 @@
+#include "VgtSpirv.h"
+
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "VgtAssetPack.h"
+#include "VgtPlatform.h"
+#include "VgtTrace.h"
+
+// Function-local so registration from other translation units never runs before construction.
+static std::vector<VgtEmbeddedSpirv>& EmbeddedRegistry()
+{
+    static std::vector<VgtEmbeddedSpirv> registry;
+    return registry;
+}
+
+void VgtRegisterEmbeddedSpirv(const VgtEmbeddedSpirv* shaders, size_t count)
+{
+    auto& registry = EmbeddedRegistry();
+    registry.insert(registry.end(), shaders, shaders + count);
+}
+
+static std::vector<uint32_t> ReadSpirvFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return {};
+
+    const std::streamsize size = file.tellg();
+    if (size <= 0 || size % 4 != 0)
+        return {};
+
+    std::vector<uint32_t> data(static_cast<size_t>(size / 4));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(data.data()), size);
+    if (!file)
+        return {};
+    return data;
+}
+
+static std::vector<uint32_t> ReadSpirvWithFallback(const char* name)
+{
+    // Runtime layout first (when shaders are copied next to the working directory).
+    auto data = ReadSpirvFile(name);
+    if (!data.empty())
+        return data;
+
+    // Relative to the executable, for when the working directory is elsewhere.
+    std::string exeDir = VgtGetExecutableDir();
+    if (!exeDir.empty())
+    {
+        data = ReadSpirvFile(exeDir + "compiled_shaders/" + name);
+        if (!data.empty())
+            return data;
+
+        // Common MSBuild layout: <target>/Debug/.. == <target>/
+        while (!exeDir.empty() && (exeDir.back() == '\\' || exeDir.back() == '/'))
+            exeDir.pop_back();
+        const size_t parentSlash = exeDir.find_last_of("\\/");
+        if (parentSlash != std::string::npos)
+        {
+            exeDir.resize(parentSlash + 1);
+            data = ReadSpirvFile(exeDir + "compiled_shaders/" + name);
+            if (!data.empty())
+                return data;
+        }
+    }
+
+    // Build tree: e.g. build-ninja/.../steps/Step01_MinimalTriangle/compiled_shaders
+    return ReadSpirvFile(std::string("compiled_shaders/") + name);
+}
+
+VgtSpirvCode VgtLoadSpirv(const char* name, bool fromDisk)
+{
+    VGT_TRACE_ZONE("shader load");
+    if (!fromDisk)
+    {
+        for (const auto& shader : EmbeddedRegistry())
+        {
+            if (std::strcmp(shader.name, name) == 0)
+                return VgtSpirvCode(shader.code, shader.wordCount);
+        }
+
+        // Pack entries are kVgtPackAlignment-aligned, so the mapping can be used as words directly.
+        VgtAssetView packed;
+        if (VgtFindMountedAsset(name, packed) && packed.size % 4 == 0)
+            return VgtSpirvCode(reinterpret_cast<const uint32_t*>(packed.data), packed.size / 4);
+    }
+    return VgtSpirvCode(ReadSpirvWithFallback(name));
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// SPIR-V loading for the steps.
+//
+// With VGT_EMBED_SHADERS=ON (default) every compiled shader is also linked into the
+// executable and registered here at static-init time, so VgtLoadSpirv() returns a view of
+// read-only data without touching the file system. Next comes the mounted asset pack
+// (VgtAssetPack.h), again as a view into the mapping. Otherwise, or with `fromDisk` (the
+// `--shaders-from-disk` flag, for iterating on shaders without relinking), the .spv is read
+// from disk: next to the working directory, then `compiled_shaders/` beside the exe or its
+// parent directory (MSBuild config subfolders), then `compiled_shaders/` in the working directory.
+
+struct VgtEmbeddedSpirv
+{
+    const char* name;      // e.g. "triangle.vert.spv"
+    const uint32_t* code;
+    size_t wordCount;
+};
+
+// Called by the generated registry source; not meant to be called by hand.
+void VgtRegisterEmbeddedSpirv(const VgtEmbeddedSpirv* shaders, size_t count);
+
+// SPIR-V words, either borrowed from embedded data / a mapped pack or owned after a file read.
+class VgtSpirvCode
+{
+public:
+    VgtSpirvCode() = default;
+    VgtSpirvCode(const uint32_t* code, size_t wordCount) : m_code(code), m_wordCount(wordCount) {}
+    explicit VgtSpirvCode(std::vector<uint32_t>&& words)
+        : m_storage(std::move(words)), m_code(m_storage.data()), m_wordCount(m_storage.size()) {}
+
+    VgtSpirvCode(const VgtSpirvCode&) = delete;
+    VgtSpirvCode& operator=(const VgtSpirvCode&) = delete;
+    VgtSpirvCode(VgtSpirvCode&&) = default;
+    VgtSpirvCode& operator=(VgtSpirvCode&&) = default;
+
+    const uint32_t* data() const { return m_code; }
+    size_t size() const { return m_wordCount; } // in 32-bit words
+    bool empty() const { return m_wordCount == 0; }
+    bool embedded() const { return m_code != nullptr && m_storage.empty(); } // or mapped from a pack
+
+private:
+    std::vector<uint32_t> m_storage;
+    const uint32_t* m_code = nullptr;
+    size_t m_wordCount = 0;
+};
+
+// Returns empty code when the shader is neither embedded nor found on disk.
+VgtSpirvCode VgtLoadSpirv(const char* name, bool fromDisk);
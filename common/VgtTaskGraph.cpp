@@ -0,0 +1,126 @@
+#include "VgtTaskGraph.h"
+
+#include <cassert>
+
+#include "VgtPlatform.h"
+#include "VgtTrace.h"
+
+VgtTaskGraph::~VgtTaskGraph()
+{
+    VgtTaskGraphWaitAll(*this);
+}
+
+uint32_t VgtTaskGraphAdd(VgtTaskGraph& graph, const char* name, std::function<VkResult()> job,
+    std::initializer_list<uint32_t> dependencies)
+{
+    assert(!graph.running);
+    const uint32_t handle = static_cast<uint32_t>(graph.tasks.size());
+
+    VgtTask& task = graph.tasks.emplace_back();
+    task.name = name;
+    task.job = std::move(job);
+    for (uint32_t dependency : dependencies)
+    {
+        assert(dependency < handle);
+        graph.tasks[dependency].dependents.push_back(handle);
+        ++task.pendingDependencies;
+    }
+    return handle;
+}
+
+static void Execute(VgtTaskGraph& graph, uint32_t handle)
+{
+    VgtTask& task = graph.tasks[handle];
+    VgtThreadPool* const pool = graph.pool;
+
+    // A failed dependency already stored its result here.
+    VkResult res = VK_SUCCESS;
+    {
+        std::lock_guard<std::mutex> lock(graph.mutex);
+        res = task.result;
+    }
+
+    double ms = 0.0;
+    if (res == VK_SUCCESS)
+    {
+        VgtTraceZone zone(task.name);
+        const double start = VgtGetTimeSeconds();
+        res = task.job();
+        ms = 1000.0 * (VgtGetTimeSeconds() - start);
+    }
+    task.job = nullptr; // release what the job captured
+
+    std::vector<uint32_t> ready;
+    {
+        std::lock_guard<std::mutex> lock(graph.mutex);
+        task.result = res;
+        task.ms = ms;
+        task.done = true;
+        --graph.remaining;
+        for (uint32_t d : task.dependents)
+        {
+            VgtTask& dependent = graph.tasks[d];
+            if (res != VK_SUCCESS && dependent.result == VK_SUCCESS)
+                dependent.result = res;
+            if (--dependent.pendingDependencies == 0)
+                ready.push_back(d);
+        }
+        // Under the lock: once `remaining` is 0 a waiter may return and destroy the graph.
+        graph.taskDone.notify_all();
+    }
+
+    // Serially, the dependents come later in the order of addition anyway. Only touch the graph
+    // again when something is left to run: it is kept alive until those tasks finish.
+    if (pool != nullptr)
+    {
+        for (uint32_t d : ready)
+            pool->submit([&graph, d] { Execute(graph, d); });
+    }
+}
+
+void VgtTaskGraphRun(VgtTaskGraph& graph, VgtThreadPool* pool)
+{
+    assert(!graph.running);
+    graph.pool = pool;
+    graph.running = true;
+    graph.remaining = static_cast<uint32_t>(graph.tasks.size());
+
+    if (pool == nullptr)
+    {
+        for (uint32_t i = 0; i < graph.tasks.size(); ++i)
+            Execute(graph, i);
+        return;
+    }
+
+    // Collect the roots first: a root may finish and release other tasks while we submit.
+    std::vector<uint32_t> roots;
+    for (uint32_t i = 0; i < graph.tasks.size(); ++i)
+    {
+        if (graph.tasks[i].pendingDependencies == 0)
+            roots.push_back(i);
+    }
+    for (uint32_t i : roots)
+        pool->submit([&graph, i] { Execute(graph, i); });
+}
+
+VkResult VgtTaskGraphWait(VgtTaskGraph& graph, uint32_t task)
+{
+    std::unique_lock<std::mutex> lock(graph.mutex);
+    graph.taskDone.wait(lock, [&] { return graph.tasks[task].done; });
+    return graph.tasks[task].result;
+}
+
+VkResult VgtTaskGraphWaitAll(VgtTaskGraph& graph)
+{
+    if (!graph.running)
+        return VK_SUCCESS;
+
+    std::unique_lock<std::mutex> lock(graph.mutex);
+    graph.taskDone.wait(lock, [&] { return graph.remaining == 0; });
+    for (const VgtTask& task : graph.tasks)
+    {
+        if (task.result != VK_SUCCESS)
+            return task.result;
+    }
+    return VK_SUCCESS;
+}
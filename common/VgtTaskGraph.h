@@ -0,0 +1,74 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "VgtThreadPool.h"
+
+// Startup work as a small dependency graph on a VgtThreadPool, so independent steps (reading
+// SPIR-V, creating shader modules, loading the pipeline cache, creating pipelines) run on the
+// workers while the main thread creates the swapchain.
+//
+// - VgtTaskGraphAdd registers a job with the tasks it depends on. Dependencies must have been
+//   added before, so the graph cannot have cycles. Add everything before VgtTaskGraphRun.
+// - VgtTaskGraphRun submits every task without pending dependencies; a finishing task submits
+//   the dependents it unblocked. The calling thread is free meanwhile and joins with
+//   VgtTaskGraphWait / VgtTaskGraphWaitAll.
+// - Jobs return a VkResult. A failed task skips everything that depends on it, and those
+//   report the same result.
+// - Without a pool, VgtTaskGraphRun executes the tasks on the calling thread in the order they
+//   were added (the serial baseline for --serial-startup).
+// - Each task is a trace zone of its own (--trace, see VgtTrace.h) and keeps its duration in `ms`.
+//
+// Jobs run concurrently: they must only touch what no other task or the main thread uses until
+// the task is waited for (Vulkan object creation on a VkDevice is thread-safe; queues and
+// command pools are not). The destructor waits for all tasks, so declare the graph after the
+// variables its jobs write to.
+
+struct VgtTask
+{
+    const char* name = "";
+    std::function<VkResult()> job;
+    std::vector<uint32_t> dependents;
+    uint32_t pendingDependencies = 0;
+    bool done = false;
+    VkResult result = VK_SUCCESS;
+    double ms = 0.0;
+};
+
+struct VgtTaskGraph
+{
+    VgtTaskGraph() = default;
+    ~VgtTaskGraph();
+
+    VgtTaskGraph(const VgtTaskGraph&) = delete;
+    VgtTaskGraph& operator=(const VgtTaskGraph&) = delete;
+
+    VgtThreadPool* pool = nullptr;
+    bool running = false;
+
+    // Guards everything below once the graph runs.
+    std::mutex mutex;
+    std::condition_variable taskDone;
+    std::deque<VgtTask> tasks; // indexed by the handles VgtTaskGraphAdd returns
+    uint32_t remaining = 0;
+};
+
+// `name` must outlive the graph (a string literal). Returns the task's handle.
+uint32_t VgtTaskGraphAdd(VgtTaskGraph& graph, const char* name, std::function<VkResult()> job,
+    std::initializer_list<uint32_t> dependencies = {});
+
+// Starts the graph on `pool`, or runs it to completion on the calling thread when `pool` is null.
+void VgtTaskGraphRun(VgtTaskGraph& graph, VgtThreadPool* pool);
+
+// Blocks until `task` has finished (or was skipped) and returns its result.
+VkResult VgtTaskGraphWait(VgtTaskGraph& graph, uint32_t task);
+// Blocks until every task has finished; returns the first failure in the order the tasks were added.
+VkResult VgtTaskGraphWaitAll(VgtTaskGraph& graph);
@@ -0,0 +1,846 @@
+#include "VgtTextureStreamer.h"
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "VgtPlatform.h"
+#include "VgtSpirv.h"
+#include "VgtTrace.h"
+
+// Stages that first touch an image on the graphics queue (mip generation).
+static constexpr VkPipelineStageFlags kMipStages = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+static uint32_t MipLevelCount(uint32_t width, uint32_t height)
+{
+    uint32_t levels = 1;
+    while ((width | height) >> levels)
+        ++levels;
+    return levels;
+}
+
+static VkResult CreatePoolAndBuffer(VkDevice device, uint32_t queueFamily, VkCommandPool& pool, VkCommandBuffer& cmd)
+{
+    VkCommandPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    poolCI.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolCI.queueFamilyIndex = queueFamily;
+    VkResult res = vkCreateCommandPool(device, &poolCI, nullptr, &pool);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkCommandBufferAllocateInfo cmdAI{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    cmdAI.commandPool = pool;
+    cmdAI.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cmdAI.commandBufferCount = 1;
+    return vkAllocateCommandBuffers(device, &cmdAI, &cmd);
+}
+
+// Frees everything but the textures themselves (those belong to VgtStreamedTexture).
+static void DestroyBatch(VgtTextureStreamer& streamer, VgtTextureBatch& batch)
+{
+    for (size_t i = 0; i < batch.staging.size(); ++i)
+        VgtDestroyBuffer(*streamer.allocator, batch.staging[i], batch.stagingAllocs[i]);
+    for (VkImageView view : batch.mipViews)
+        vkDestroyImageView(streamer.device, view, nullptr);
+    for (VkImageView view : batch.failedViews)
+        vkDestroyImageView(streamer.device, view, nullptr);
+    for (size_t i = 0; i < batch.failedImages.size(); ++i)
+        VgtDestroyImage(*streamer.allocator, batch.failedImages[i], batch.failedAllocs[i]);
+
+    if (batch.mipDescriptorPool)
+        vkDestroyDescriptorPool(streamer.device, batch.mipDescriptorPool, nullptr);
+    if (batch.fence)
+        vkDestroyFence(streamer.device, batch.fence, nullptr);
+    if (batch.ownershipSemaphore)
+        vkDestroySemaphore(streamer.device, batch.ownershipSemaphore, nullptr);
+    if (batch.graphicsPool)
+        vkDestroyCommandPool(streamer.device, batch.graphicsPool, nullptr);
+    if (batch.transferPool)
+        vkDestroyCommandPool(streamer.device, batch.transferPool, nullptr);
+    batch = VgtTextureBatch{};
+}
+
+// Hands a failed texture's image, memory and view to `batch`, which destroys them in DestroyBatch.
+static void RetireFailedTexture(VgtTextureBatch& batch, VkImage& image, VgtAllocation& allocation, VkImageView& view)
+{
+    if (view)
+        batch.failedViews.push_back(view);
+    if (image || allocation.memory)
+    {
+        batch.failedImages.push_back(image);
+        batch.failedAllocs.push_back(allocation);
+    }
+    image = VK_NULL_HANDLE;
+    allocation = VgtAllocation{};
+    view = VK_NULL_HANDLE;
+}
+
+// Each batch gets its own transient pools, so the transfer thread never shares a pool with
+// the render thread (command and descriptor pools are externally synchronized).
+// `mipSetCount` is the number of compute dispatches (one descriptor set each) in the batch.
+static VkResult BeginBatch(VgtTextureStreamer& streamer, VgtTextureBatch& batch, uint32_t mipSetCount)
+{
+    VkResult res = CreatePoolAndBuffer(streamer.device, streamer.transferQueueFamily, batch.transferPool, batch.transferCmd);
+    batch.graphicsCmd = batch.transferCmd;
+    if (res == VK_SUCCESS && streamer.dedicatedTransfer)
+    {
+        res = CreatePoolAndBuffer(streamer.device, streamer.graphicsQueueFamily, batch.graphicsPool, batch.graphicsCmd);
+        if (res == VK_SUCCESS)
+        {
+            VkSemaphoreCreateInfo semCI{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+            res = vkCreateSemaphore(streamer.device, &semCI, nullptr, &batch.ownershipSemaphore);
+        }
+    }
+    if (res == VK_SUCCESS && mipSetCount > 0)
+    {
+        VkDescriptorPoolSize poolSize{};
+        poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        poolSize.descriptorCount = mipSetCount * 2;
+
+        VkDescriptorPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+        poolCI.maxSets = mipSetCount;
+        poolCI.poolSizeCount = 1;
+        poolCI.pPoolSizes = &poolSize;
+        res = vkCreateDescriptorPool(streamer.device, &poolCI, nullptr, &batch.mipDescriptorPool);
+    }
+    if (res == VK_SUCCESS)
+    {
+        VkFenceCreateInfo fenceCI{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+        res = vkCreateFence(streamer.device, &fenceCI, nullptr, &batch.fence);
+    }
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    res = vkBeginCommandBuffer(batch.transferCmd, &beginInfo);
+    if (res == VK_SUCCESS && batch.graphicsCmd != batch.transferCmd)
+        res = vkBeginCommandBuffer(batch.graphicsCmd, &beginInfo);
+    return res;
+}
+
+static VkResult EndBatch(VgtTextureBatch& batch)
+{
+    VkResult res = vkEndCommandBuffer(batch.transferCmd);
+    if (res == VK_SUCCESS && batch.graphicsCmd != batch.transferCmd)
+        res = vkEndCommandBuffer(batch.graphicsCmd);
+    return res;
+}
+
+static VkImageMemoryBarrier ImageBarrier(VkImage image, uint32_t baseLevel, uint32_t levelCount,
+    VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags srcAccess, VkAccessFlags dstAccess)
+{
+    VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = baseLevel;
+    barrier.subresourceRange.levelCount = levelCount;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    return barrier;
+}
+
+static void CmdBarrier(VkCommandBuffer cmd, VkPipelineStageFlags srcStages, VkPipelineStageFlags dstStages,
+    const VkImageMemoryBarrier& barrier)
+{
+    vkCmdPipelineBarrier(cmd, srcStages, dstStages, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+// Level 0 is in TRANSFER_DST_OPTIMAL; every level ends in SHADER_READ_ONLY_OPTIMAL.
+static void RecordBlitMips(VkCommandBuffer cmd, VkImage image, uint32_t width, uint32_t height, uint32_t mipLevels)
+{
+    for (uint32_t level = 1; level < mipLevels; ++level)
+    {
+        CmdBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            ImageBarrier(image, level - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT));
+
+        const int32_t srcW = static_cast<int32_t>(width);
+        const int32_t srcH = static_cast<int32_t>(height);
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+
+        VkImageBlit blit{};
+        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.srcSubresource.mipLevel = level - 1;
+        blit.srcSubresource.layerCount = 1;
+        blit.srcOffsets[1] = { srcW, srcH, 1 };
+        blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.dstSubresource.mipLevel = level;
+        blit.dstSubresource.layerCount = 1;
+        blit.dstOffsets[1] = { static_cast<int32_t>(width), static_cast<int32_t>(height), 1 };
+        vkCmdBlitImage(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1, &blit, VK_FILTER_LINEAR);
+
+        CmdBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            ImageBarrier(image, level - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT));
+    }
+
+    CmdBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        ImageBarrier(image, mipLevels - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT));
+}
+
+// Same contract as RecordBlitMips, using mipgen.comp (the image needs STORAGE usage).
+static VkResult RecordComputeMips(VgtTextureStreamer& streamer, VgtTextureBatch& batch, VkImage image,
+    uint32_t width, uint32_t height, uint32_t mipLevels)
+{
+    VkCommandBuffer cmd = batch.graphicsCmd;
+    const size_t firstView = batch.mipViews.size();
+    for (uint32_t level = 0; level < mipLevels; ++level)
+    {
+        VkImageViewCreateInfo viewCI{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+        viewCI.image = image;
+        viewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewCI.format = VK_FORMAT_R8G8B8A8_UNORM;
+        viewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewCI.subresourceRange.baseMipLevel = level;
+        viewCI.subresourceRange.levelCount = 1;
+        viewCI.subresourceRange.layerCount = 1;
+
+        VkImageView view = VK_NULL_HANDLE;
+        const VkResult res = vkCreateImageView(streamer.device, &viewCI, nullptr, &view);
+        if (res != VK_SUCCESS)
+            return res;
+        batch.mipViews.push_back(view);
+    }
+
+    CmdBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        ImageBarrier(image, 0, mipLevels, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL,
+            VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT));
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, streamer.mipPipeline);
+
+    for (uint32_t level = 1; level < mipLevels; ++level)
+    {
+        VkDescriptorSetAllocateInfo setAI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+        setAI.descriptorPool = batch.mipDescriptorPool;
+        setAI.descriptorSetCount = 1;
+        setAI.pSetLayouts = &streamer.mipSetLayout;
+
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        const VkResult res = vkAllocateDescriptorSets(streamer.device, &setAI, &set);
+        if (res != VK_SUCCESS)
+            return res;
+
+        VkDescriptorImageInfo images[2]{};
+        images[0].imageView = batch.mipViews[firstView + level - 1];
+        images[0].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        images[1].imageView = batch.mipViews[firstView + level];
+        images[1].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkWriteDescriptorSet writes[2]{};
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = set;
+            writes[i].dstBinding = i;
+            writes[i].descriptorCount = 1;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            writes[i].pImageInfo = &images[i];
+        }
+        vkUpdateDescriptorSets(streamer.device, 2, writes, 0, nullptr);
+
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, streamer.mipPipelineLayout, 0, 1, &set, 0, nullptr);
+        vkCmdDispatch(cmd, (width + 7) / 8, (height + 7) / 8, 1);
+
+        // The next dispatch reads this level.
+        CmdBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            ImageBarrier(image, level, 1, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL,
+                VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT));
+    }
+
+    CmdBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        ImageBarrier(image, 0, mipLevels, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT));
+    return VK_SUCCESS;
+}
+
+// Creates the image and its view and records the staging copy plus mip generation into `batch`.
+// Levels beyond the ones in `data` are generated (RGBA8 only, see TextureMipLevels).
+static VkResult RecordTexture(VgtTextureStreamer& streamer, VgtTextureBatch& batch, const VgtImageData& data,
+    uint32_t mipLevels, VkImage& image, VgtAllocation& allocation, VkImageView& view)
+{
+    const uint32_t fileLevels = static_cast<uint32_t>(data.levels.size());
+
+    VkBufferCreateInfo stagingCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    stagingCI.size = data.size;
+    stagingCI.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    stagingCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkBuffer staging = VK_NULL_HANDLE;
+    VgtAllocation stagingAlloc;
+    VkResult res = VgtCreateBuffer(*streamer.allocator, stagingCI,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, staging, stagingAlloc);
+    if (res != VK_SUCCESS)
+        return res;
+    std::memcpy(stagingAlloc.mapped, data.pixels, data.size);
+    batch.staging.push_back(staging);
+    batch.stagingAllocs.push_back(stagingAlloc);
+
+    const bool generateMips = mipLevels > fileLevels;
+    const bool computeMips = generateMips && streamer.mipmaps == VgtMipmapMode::Compute;
+
+    VkImageCreateInfo imageCI{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    imageCI.imageType = VK_IMAGE_TYPE_2D;
+    imageCI.extent = { data.width, data.height, 1 };
+    imageCI.mipLevels = mipLevels;
+    imageCI.arrayLayers = 1;
+    imageCI.format = data.format;
+    imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageCI.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    if (computeMips)
+        imageCI.usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+    else if (generateMips)
+        imageCI.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
+    res = VgtCreateImage(*streamer.allocator, imageCI, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, allocation);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkImageViewCreateInfo viewCI{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    viewCI.image = image;
+    viewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewCI.format = data.format;
+    viewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewCI.subresourceRange.levelCount = mipLevels;
+    viewCI.subresourceRange.layerCount = 1;
+    res = vkCreateImageView(streamer.device, &viewCI, nullptr, &view);
+    if (res != VK_SUCCESS)
+        return res;
+
+    CmdBarrier(batch.transferCmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        ImageBarrier(image, 0, mipLevels, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            0, VK_ACCESS_TRANSFER_WRITE_BIT));
+
+    // One region per level in the file; compressed levels are whole blocks, and the extent is
+    // the level's texel size (Vulkan allows a partial last block when it matches the level).
+    std::vector<VkBufferImageCopy> regions(fileLevels);
+    for (uint32_t level = 0; level < fileLevels; ++level)
+    {
+        VkBufferImageCopy& region = regions[level];
+        region.bufferOffset = data.levels[level].offset;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = level;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = { data.levels[level].width, data.levels[level].height, 1 };
+    }
+    vkCmdCopyBufferToImage(batch.transferCmd, staging, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, fileLevels, regions.data());
+
+    if (streamer.dedicatedTransfer)
+    {
+        // Hand every level to the graphics family unchanged; mips and the final layout are done there.
+        // Release on the transfer queue (dstAccessMask ignored) ...
+        VkImageMemoryBarrier ownership = ImageBarrier(image, 0, mipLevels, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, 0);
+        ownership.srcQueueFamilyIndex = streamer.transferQueueFamily;
+        ownership.dstQueueFamilyIndex = streamer.graphicsQueueFamily;
+        CmdBarrier(batch.transferCmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, ownership);
+
+        // ... and acquire on the graphics queue (srcAccessMask ignored); the semaphore wait covers kMipStages.
+        ownership.srcAccessMask = 0;
+        ownership.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        CmdBarrier(batch.graphicsCmd, kMipStages, kMipStages, ownership);
+    }
+
+    if (!generateMips)
+    {
+        CmdBarrier(batch.graphicsCmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            ImageBarrier(image, 0, mipLevels, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT));
+        return VK_SUCCESS;
+    }
+    if (computeMips)
+        return RecordComputeMips(streamer, batch, image, data.width, data.height, mipLevels);
+
+    RecordBlitMips(batch.graphicsCmd, image, data.width, data.height, mipLevels);
+    return VK_SUCCESS;
+}
+
+// Render thread only: the queues are not used from any other thread.
+static VkResult SubmitBatch(VgtTextureStreamer& streamer, VgtTextureBatch& batch)
+{
+    if (!streamer.dedicatedTransfer)
+    {
+        VkSubmitInfo submit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+        submit.commandBufferCount = 1;
+        submit.pCommandBuffers = &batch.transferCmd;
+        return vkQueueSubmit(streamer.graphicsQueue, 1, &submit, batch.fence);
+    }
+
+    VkSubmitInfo transferSubmit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    transferSubmit.commandBufferCount = 1;
+    transferSubmit.pCommandBuffers = &batch.transferCmd;
+    transferSubmit.signalSemaphoreCount = 1;
+    transferSubmit.pSignalSemaphores = &batch.ownershipSemaphore;
+    VkResult res = vkQueueSubmit(streamer.transferQueue, 1, &transferSubmit, VK_NULL_HANDLE);
+    if (res != VK_SUCCESS)
+        return res;
+
+    // The acquire barrier chains off this wait.
+    const VkPipelineStageFlags waitStage = kMipStages;
+    VkSubmitInfo acquireSubmit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    acquireSubmit.waitSemaphoreCount = 1;
+    acquireSubmit.pWaitSemaphores = &batch.ownershipSemaphore;
+    acquireSubmit.pWaitDstStageMask = &waitStage;
+    acquireSubmit.commandBufferCount = 1;
+    acquireSubmit.pCommandBuffers = &batch.graphicsCmd;
+    return vkQueueSubmit(streamer.graphicsQueue, 1, &acquireSubmit, batch.fence);
+}
+
+// Files that bring their own levels (KTX2/DDS) or use a block-compressed format are uploaded
+// as they are: neither a blit nor mipgen.comp can write compressed texels.
+static uint32_t TextureMipLevels(const VgtTextureStreamer& streamer, const VgtImageData& data)
+{
+    const uint32_t fileLevels = static_cast<uint32_t>(data.levels.size());
+    if (fileLevels > 1 || data.format != VK_FORMAT_R8G8B8A8_UNORM || streamer.mipmaps == VgtMipmapMode::Off)
+        return fileLevels;
+    return MipLevelCount(data.width, data.height);
+}
+
+static bool IsFormatSampleable(VkPhysicalDevice physicalDevice, VkFormat format)
+{
+    VkFormatProperties props{};
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &props);
+    const VkFormatFeatureFlags needed = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+    return (props.optimalTilingFeatures & needed) == needed;
+}
+
+static void TransferThreadLoop(VgtTextureStreamer& streamer)
+{
+    VgtTraceSetThreadName("texture transfer");
+    for (;;)
+    {
+        std::vector<VgtDecodedTexture> work;
+        {
+            std::unique_lock<std::mutex> lock(streamer.mutex);
+            streamer.decodedAvailable.wait(lock, [&] { return streamer.stop || !streamer.decoded.empty(); });
+            if (streamer.stop)
+                return;
+            // Everything that finished decoding meanwhile goes into one batch.
+            work.swap(streamer.decoded);
+        }
+
+        struct Result
+        {
+            VkImage image = VK_NULL_HANDLE;
+            VgtAllocation allocation;
+            VkImageView view = VK_NULL_HANDLE;
+            uint32_t mipLevels = 1;
+            bool ok = false;
+        };
+        std::vector<Result> results(work.size());
+
+        uint32_t mipSetCount = 0;
+        for (size_t i = 0; i < work.size(); ++i)
+        {
+            results[i].mipLevels = TextureMipLevels(streamer, work[i].data);
+            if (streamer.mipmaps == VgtMipmapMode::Compute)
+                mipSetCount += results[i].mipLevels - 1;
+        }
+
+        VgtTraceZone recordZone("texture batch record");
+        VgtTextureBatch batch;
+        VkResult res = BeginBatch(streamer, batch, mipSetCount);
+        for (size_t i = 0; res == VK_SUCCESS && i < work.size(); ++i)
+        {
+            Result& r = results[i];
+            r.ok = RecordTexture(streamer, batch, work[i].data, r.mipLevels, r.image, r.allocation, r.view) == VK_SUCCESS;
+            if (r.ok)
+                batch.handles.push_back(work[i].handle);
+            else
+                RetireFailedTexture(batch, r.image, r.allocation, r.view);
+            VgtFreeImageData(work[i].data);
+        }
+        if (res == VK_SUCCESS)
+            res = EndBatch(batch);
+        recordZone.End();
+        if (res != VK_SUCCESS)
+        {
+            std::fprintf(stderr, "[%s] texture batch recording failed: VkResult=%d\n", streamer.label.c_str(), static_cast<int>(res));
+            for (auto& item : work)
+                VgtFreeImageData(item.data);
+            for (Result& r : results)
+                RetireFailedTexture(batch, r.image, r.allocation, r.view);
+            DestroyBatch(streamer, batch);
+        }
+
+        std::lock_guard<std::mutex> lock(streamer.mutex);
+        for (size_t i = 0; i < work.size(); ++i)
+        {
+            VgtStreamedTexture& tex = streamer.textures[work[i].handle];
+            tex.image = results[i].image;
+            tex.allocation = results[i].allocation;
+            tex.view = results[i].view;
+            tex.mipLevels = results[i].mipLevels;
+            tex.state = (res == VK_SUCCESS && results[i].ok) ? VgtTextureState::Uploading : VgtTextureState::Failed;
+        }
+        if (res == VK_SUCCESS && !batch.handles.empty())
+            streamer.recorded.push_back(batch);
+        else if (res == VK_SUCCESS)
+            DestroyBatch(streamer, batch);
+    }
+}
+
+static VkResult CreateMipPipeline(VgtTextureStreamer& streamer, bool shadersFromDisk)
+{
+    const VgtSpirvCode spv = VgtLoadSpirv("mipgen.comp.spv", shadersFromDisk);
+    if (spv.empty())
+        return VK_ERROR_INITIALIZATION_FAILED;
+
+    VkDescriptorSetLayoutBinding bindings[2]{};
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo setLayoutCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    setLayoutCI.bindingCount = 2;
+    setLayoutCI.pBindings = bindings;
+    VkResult res = vkCreateDescriptorSetLayout(streamer.device, &setLayoutCI, nullptr, &streamer.mipSetLayout);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkPipelineLayoutCreateInfo layoutCI{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    layoutCI.setLayoutCount = 1;
+    layoutCI.pSetLayouts = &streamer.mipSetLayout;
+    res = vkCreatePipelineLayout(streamer.device, &layoutCI, nullptr, &streamer.mipPipelineLayout);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkShaderModuleCreateInfo moduleCI{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    moduleCI.codeSize = spv.size() * sizeof(uint32_t);
+    moduleCI.pCode = spv.data();
+    VkShaderModule module = VK_NULL_HANDLE;
+    res = vkCreateShaderModule(streamer.device, &moduleCI, nullptr, &module);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkComputePipelineCreateInfo pipelineCI{ VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    pipelineCI.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineCI.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineCI.stage.module = module;
+    pipelineCI.stage.pName = "main";
+    pipelineCI.layout = streamer.mipPipelineLayout;
+    res = vkCreateComputePipelines(streamer.device, VK_NULL_HANDLE, 1, &pipelineCI, nullptr, &streamer.mipPipeline);
+    vkDestroyShaderModule(streamer.device, module, nullptr);
+    return res;
+}
+
+// Picks how mips are generated: blit needs linear-filter blits of RGBA8, the compute path needs
+// RGBA8 storage images and a compute-capable graphics queue. Falls back to a single level.
+static void SelectMipmapMode(VgtTextureStreamer& streamer, const VgtTextureStreamerCreateInfo& ci)
+{
+    streamer.mipmaps = ci.mipmaps;
+    if (streamer.mipmaps == VgtMipmapMode::Off)
+        return;
+
+    VkFormatProperties formatProps{};
+    vkGetPhysicalDeviceFormatProperties(ci.physicalDevice, VK_FORMAT_R8G8B8A8_UNORM, &formatProps);
+    const VkFormatFeatureFlags features = formatProps.optimalTilingFeatures;
+    const VkFormatFeatureFlags blitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+        VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    if (streamer.mipmaps == VgtMipmapMode::Blit && (features & blitFeatures) != blitFeatures)
+        streamer.mipmaps = VgtMipmapMode::Compute;
+    if (streamer.mipmaps == VgtMipmapMode::Blit)
+        return;
+
+    uint32_t qCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(ci.physicalDevice, &qCount, nullptr);
+    std::vector<VkQueueFamilyProperties> qProps(qCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(ci.physicalDevice, &qCount, qProps.data());
+    const bool graphicsCompute = ci.graphicsQueueFamily < qCount && (qProps[ci.graphicsQueueFamily].queueFlags & VK_QUEUE_COMPUTE_BIT);
+
+    if (!(features & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) || !graphicsCompute)
+    {
+        std::fprintf(stderr, "[%s] mipmaps disabled: no linear blit or compute support for RGBA8\n", streamer.label.c_str());
+        streamer.mipmaps = VgtMipmapMode::Off;
+        return;
+    }
+
+    const VkResult res = CreateMipPipeline(streamer, ci.shadersFromDisk);
+    if (res != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "[%s] mipmaps disabled: cannot create the mipgen.comp pipeline (VkResult=%d)\n",
+            streamer.label.c_str(), static_cast<int>(res));
+        streamer.mipmaps = VgtMipmapMode::Off;
+    }
+}
+
+VkResult VgtCreateTextureStreamer(const VgtTextureStreamerCreateInfo& ci, VgtTextureStreamer& streamer)
+{
+    streamer.device = ci.device;
+    streamer.physicalDevice = ci.physicalDevice;
+    streamer.allocator = ci.allocator;
+    streamer.graphicsQueueFamily = ci.graphicsQueueFamily;
+    streamer.dedicatedTransfer = ci.transferQueueFamily != UINT32_MAX && ci.transferQueueFamily != ci.graphicsQueueFamily;
+    streamer.transferQueueFamily = streamer.dedicatedTransfer ? ci.transferQueueFamily : ci.graphicsQueueFamily;
+    streamer.label = ci.label ? ci.label : "";
+    streamer.verbose = ci.verbose;
+
+    vkGetDeviceQueue(ci.device, streamer.graphicsQueueFamily, 0, &streamer.graphicsQueue);
+    if (streamer.dedicatedTransfer)
+        vkGetDeviceQueue(ci.device, streamer.transferQueueFamily, 0, &streamer.transferQueue);
+
+    SelectMipmapMode(streamer, ci);
+    // Blit -> compute is silent otherwise; "off" was already reported by SelectMipmapMode.
+    if (streamer.verbose || (streamer.mipmaps == VgtMipmapMode::Compute && ci.mipmaps != VgtMipmapMode::Compute))
+    {
+        static const char* const kMipmapModeNames[] = { "blit", "compute", "off" };
+        std::fprintf(stderr, "[%s] texture mipmaps: %s\n", streamer.label.c_str(),
+            kMipmapModeNames[static_cast<uint32_t>(streamer.mipmaps)]);
+    }
+
+    // 8x8 grey checker, uploaded synchronously: it has to be valid before the first frame.
+    uint8_t checker[8 * 8 * 4];
+    for (uint32_t y = 0; y < 8; ++y)
+    {
+        for (uint32_t x = 0; x < 8; ++x)
+        {
+            const uint8_t v = ((x / 2 + y / 2) & 1) ? 160 : 96;
+            uint8_t* p = &checker[(y * 8 + x) * 4];
+            p[0] = v;
+            p[1] = v;
+            p[2] = v;
+            p[3] = 255;
+        }
+    }
+
+    VgtImageData placeholder;
+    placeholder.width = 8;
+    placeholder.height = 8;
+    placeholder.pixels = checker;
+    placeholder.size = sizeof(checker);
+    placeholder.levels.assign(1, VgtImageLevel{ 0, sizeof(checker), 8, 8 });
+
+    VgtTextureBatch batch;
+    VkResult res = BeginBatch(streamer, batch, 0);
+    if (res == VK_SUCCESS)
+        res = RecordTexture(streamer, batch, placeholder, 1, streamer.placeholderImage, streamer.placeholderAllocation, streamer.placeholderView);
+    if (res == VK_SUCCESS)
+        res = EndBatch(batch);
+    if (res == VK_SUCCESS)
+        res = SubmitBatch(streamer, batch);
+    if (res == VK_SUCCESS)
+        res = vkWaitForFences(ci.device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+    DestroyBatch(streamer, batch);
+    if (res != VK_SUCCESS)
+        return res;
+
+    streamer.decodePool = std::make_unique<VgtThreadPool>(ci.decodeThreads);
+    streamer.transferThread = std::thread([&streamer] { TransferThreadLoop(streamer); });
+    return VK_SUCCESS;
+}
+
+void VgtDestroyTextureStreamer(VgtTextureStreamer& streamer)
+{
+    // Finish the decode jobs first: they push into `decoded`.
+    streamer.decodePool.reset();
+
+    {
+        std::lock_guard<std::mutex> lock(streamer.mutex);
+        streamer.stop = true;
+    }
+    streamer.decodedAvailable.notify_all();
+    if (streamer.transferThread.joinable())
+        streamer.transferThread.join();
+
+    for (auto& item : streamer.decoded)
+        VgtFreeImageData(item.data);
+    streamer.decoded.clear();
+
+    // Recorded batches were never submitted; submitted ones may still be executing.
+    for (auto& batch : streamer.recorded)
+        DestroyBatch(streamer, batch);
+    streamer.recorded.clear();
+    for (auto& batch : streamer.submitted)
+    {
+        vkWaitForFences(streamer.device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+        DestroyBatch(streamer, batch);
+    }
+    streamer.submitted.clear();
+
+    for (auto& tex : streamer.textures)
+    {
+        if (tex.view)
+            vkDestroyImageView(streamer.device, tex.view, nullptr);
+        if (tex.image)
+            VgtDestroyImage(*streamer.allocator, tex.image, tex.allocation);
+    }
+    streamer.textures.clear();
+
+    if (streamer.placeholderView)
+        vkDestroyImageView(streamer.device, streamer.placeholderView, nullptr);
+    if (streamer.placeholderImage)
+        VgtDestroyImage(*streamer.allocator, streamer.placeholderImage, streamer.placeholderAllocation);
+    streamer.placeholderView = VK_NULL_HANDLE;
+    streamer.placeholderImage = VK_NULL_HANDLE;
+
+    if (streamer.mipPipeline)
+        vkDestroyPipeline(streamer.device, streamer.mipPipeline, nullptr);
+    if (streamer.mipPipelineLayout)
+        vkDestroyPipelineLayout(streamer.device, streamer.mipPipelineLayout, nullptr);
+    if (streamer.mipSetLayout)
+        vkDestroyDescriptorSetLayout(streamer.device, streamer.mipSetLayout, nullptr);
+    streamer.mipPipeline = VK_NULL_HANDLE;
+    streamer.mipPipelineLayout = VK_NULL_HANDLE;
+    streamer.mipSetLayout = VK_NULL_HANDLE;
+}
+
+uint32_t VgtRequestTexture(VgtTextureStreamer& streamer, const char* relativePath)
+{
+    uint32_t handle = 0;
+    {
+        std::lock_guard<std::mutex> lock(streamer.mutex);
+        handle = static_cast<uint32_t>(streamer.textures.size());
+        VgtStreamedTexture tex;
+        tex.path = relativePath;
+        tex.requestTime = VgtGetTimeSeconds();
+        streamer.textures.push_back(tex);
+    }
+
+    std::string path = relativePath;
+    streamer.decodePool->submit([&streamer, handle, path]
+    {
+        VgtDecodedTexture item;
+        item.handle = handle;
+        VgtTraceZone decodeZone("texture decode");
+        const bool ok = VgtLoadImageFile(path.c_str(), item.data);
+        decodeZone.End();
+
+        const bool supported = ok && IsFormatSampleable(streamer.physicalDevice, item.data.format);
+
+        std::lock_guard<std::mutex> lock(streamer.mutex);
+        if (!supported)
+        {
+            if (ok)
+                std::fprintf(stderr, "[%s] %s: format %s is not supported by this device\n", streamer.label.c_str(),
+                    path.c_str(), VgtGetFormatName(item.data.format));
+            else
+                std::fprintf(stderr, "[%s] failed to load %s\n", streamer.label.c_str(), path.c_str());
+            VgtFreeImageData(item.data);
+            streamer.textures[handle].state = VgtTextureState::Failed;
+            return;
+        }
+        VgtStreamedTexture& tex = streamer.textures[handle];
+        tex.width = item.data.width;
+        tex.height = item.data.height;
+        tex.format = item.data.format;
+        tex.fileBytes = item.data.size;
+        tex.state = VgtTextureState::Uploading;
+        streamer.decoded.push_back(std::move(item));
+        streamer.decodedAvailable.notify_one();
+    });
+    return handle;
+}
+
+uint32_t VgtTextureStreamerUpdate(VgtTextureStreamer& streamer)
+{
+    std::vector<VgtTextureBatch> toSubmit;
+    {
+        std::lock_guard<std::mutex> lock(streamer.mutex);
+        toSubmit.swap(streamer.recorded);
+    }
+
+    uint32_t changed = 0;
+    for (auto& batch : toSubmit)
+    {
+        const VkResult res = SubmitBatch(streamer, batch);
+        if (res == VK_SUCCESS)
+        {
+            streamer.submitted.push_back(batch);
+            continue;
+        }
+
+        std::fprintf(stderr, "[%s] texture batch submit failed: VkResult=%d\n", streamer.label.c_str(), static_cast<int>(res));
+        {
+            std::lock_guard<std::mutex> lock(streamer.mutex);
+            for (uint32_t handle : batch.handles)
+                streamer.textures[handle].state = VgtTextureState::Failed;
+        }
+        DestroyBatch(streamer, batch);
+    }
+
+    for (size_t i = 0; i < streamer.submitted.size();)
+    {
+        VgtTextureBatch& batch = streamer.submitted[i];
+        if (vkGetFenceStatus(streamer.device, batch.fence) != VK_SUCCESS)
+        {
+            ++i;
+            continue;
+        }
+
+        const double now = VgtGetTimeSeconds();
+        {
+            std::lock_guard<std::mutex> lock(streamer.mutex);
+            for (uint32_t handle : batch.handles)
+            {
+                VgtStreamedTexture& tex = streamer.textures[handle];
+                tex.state = VgtTextureState::Ready;
+                if (streamer.verbose)
+                    std::fprintf(stderr, "[%s] texture %s (%ux%u %s, %u mips, %zu KiB uploaded) ready after %.1f ms\n",
+                        streamer.label.c_str(), tex.path.c_str(), tex.width, tex.height, VgtGetFormatName(tex.format),
+                        tex.mipLevels, tex.fileBytes / 1024, (now - tex.requestTime) * 1000.0);
+            }
+        }
+        changed += static_cast<uint32_t>(batch.handles.size());
+        DestroyBatch(streamer, batch);
+        streamer.submitted.erase(streamer.submitted.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+    return changed;
+}
+
+VgtTextureState VgtGetTextureState(VgtTextureStreamer& streamer, uint32_t handle)
+{
+    std::lock_guard<std::mutex> lock(streamer.mutex);
+    return handle < streamer.textures.size() ? streamer.textures[handle].state : VgtTextureState::Failed;
+}
+
+VkImageView VgtGetTextureView(VgtTextureStreamer& streamer, uint32_t handle)
+{
+    std::lock_guard<std::mutex> lock(streamer.mutex);
+    if (handle < streamer.textures.size() && streamer.textures[handle].state == VgtTextureState::Ready)
+        return streamer.textures[handle].view;
+    return streamer.placeholderView;
+}
+
+uint32_t VgtGetTextureMipLevels(VgtTextureStreamer& streamer, uint32_t handle)
+{
+    std::lock_guard<std::mutex> lock(streamer.mutex);
+    if (handle < streamer.textures.size() && streamer.textures[handle].state == VgtTextureState::Ready)
+        return streamer.textures[handle].mipLevels;
+    return 1;
+}
+
+uint32_t VgtTextureStreamerPending(VgtTextureStreamer& streamer)
+{
+    std::lock_guard<std::mutex> lock(streamer.mutex);
+    uint32_t pending = 0;
+    for (const auto& tex : streamer.textures)
+    {
+        if (tex.state == VgtTextureState::Decoding || tex.state == VgtTextureState::Uploading)
+            ++pending;
+    }
+    return pending;
+}
+
+void VgtEnableTextureCompressionFeatures(VkPhysicalDevice physicalDevice, VkPhysicalDeviceFeatures& features)
+{
+    VkPhysicalDeviceFeatures supported{};
+    vkGetPhysicalDeviceFeatures(physicalDevice, &supported);
+    features.textureCompressionBC = supported.textureCompressionBC;
+    features.textureCompressionETC2 = supported.textureCompressionETC2;
+    features.textureCompressionASTC_LDR = supported.textureCompressionASTC_LDR;
+}
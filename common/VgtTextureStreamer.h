@@ -0,0 +1,168 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "VgtAllocator.h"
+#include "VgtImageFile.h"
+#include "VgtOptions.h"
+#include "VgtThreadPool.h"
+
+// Loads textures in the background while the renderer keeps drawing.
+//
+// - VgtRequestTexture returns immediately; the file is decoded on a VgtThreadPool worker.
+// - A transfer thread collects every decoded image that is waiting, creates the images and
+//   staging buffers and records one batch of copies (plus the layout transitions).
+// - VgtTextureStreamerUpdate, called once per frame on the render thread, submits recorded
+//   batches and polls their fences. Queues are only ever touched from that thread, so the
+//   render loop needs no extra locking around vkQueueSubmit.
+// - Until a texture's batch fence has signaled, VgtGetTextureView returns a small checker
+//   placeholder, so descriptors can be written right away and refreshed when it changes.
+//
+// With a dedicated transfer queue family the copies run there and the images are handed to
+// the graphics family with release/acquire barriers chained by a semaphore (see VgtUpload.h).
+//
+// Each RGBA8 texture with a single level gets a full mip chain, generated on the graphics queue
+// after the copy: vkCmdBlitImage level by level, or common/shaders/mipgen.comp (2x2 box filter,
+// one dispatch per level) when the format has no linear-filter blit support. Steps using the
+// streamer must compile that shader (it is loaded as "mipgen.comp.spv").
+//
+// KTX2/DDS files are uploaded with the levels and the (block-compressed) format they contain.
+// A format the device cannot sample leaves the texture Failed, so the placeholder stays bound;
+// enable the compression features with VgtEnableTextureCompressionFeatures at device creation.
+
+enum class VgtTextureState : uint32_t
+{
+    Decoding = 0,
+    Uploading = 1,
+    Ready = 2,
+    Failed = 3,
+};
+
+struct VgtTextureStreamerCreateInfo
+{
+    VkDevice device = VK_NULL_HANDLE;
+    VgtAllocator* allocator = nullptr;
+    uint32_t graphicsQueueFamily = 0;
+    uint32_t transferQueueFamily = UINT32_MAX; // UINT32_MAX (or == graphics) uploads on the graphics queue
+    uint32_t decodeThreads = 0;                // 0 == VgtThreadPool default
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VgtMipmapMode mipmaps = VgtMipmapMode::Blit;
+    bool shadersFromDisk = false;              // for mipgen.comp.spv, see VgtLoadSpirv
+    const char* label = "";                    // log prefix
+    bool verbose = false;                      // print the mip mode and per-texture load times to stderr
+};
+
+struct VgtStreamedTexture
+{
+    std::string path;
+    VgtTextureState state = VgtTextureState::Decoding;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipLevels = 1;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    size_t fileBytes = 0; // staging size, every level in the file
+    VkImage image = VK_NULL_HANDLE;
+    VgtAllocation allocation;
+    VkImageView view = VK_NULL_HANDLE;
+    double requestTime = 0.0;
+};
+
+struct VgtDecodedTexture
+{
+    uint32_t handle = 0;
+    VgtImageData data;
+};
+
+// One recorded upload: every texture decoded while the transfer thread was busy.
+struct VgtTextureBatch
+{
+    std::vector<uint32_t> handles;
+    std::vector<VkBuffer> staging;
+    std::vector<VgtAllocation> stagingAllocs;
+    VkCommandPool transferPool = VK_NULL_HANDLE; // copy commands (transfer family, or graphics)
+    VkCommandPool graphicsPool = VK_NULL_HANDLE; // ownership acquire (dedicated transfer only)
+    VkCommandBuffer transferCmd = VK_NULL_HANDLE;
+    VkCommandBuffer graphicsCmd = VK_NULL_HANDLE; // acquire + mip generation; == transferCmd without a transfer queue
+    VkDescriptorPool mipDescriptorPool = VK_NULL_HANDLE; // compute mip generation only
+    std::vector<VkImageView> mipViews;                  // single-level views for the compute shader
+    // Textures that failed while the batch was recorded. Its commands may still reference them,
+    // so they are destroyed with the batch instead of living on until shutdown.
+    std::vector<VkImage> failedImages;
+    std::vector<VgtAllocation> failedAllocs;
+    std::vector<VkImageView> failedViews;
+    VkSemaphore ownershipSemaphore = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+};
+
+struct VgtTextureStreamer
+{
+    VkDevice device = VK_NULL_HANDLE;
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VgtAllocator* allocator = nullptr;
+    uint32_t graphicsQueueFamily = 0;
+    uint32_t transferQueueFamily = 0;
+    bool dedicatedTransfer = false;
+    std::string label;
+    bool verbose = false;
+    VgtMipmapMode mipmaps = VgtMipmapMode::Blit; // resolved: Blit only if the format supports it
+
+    VkDescriptorSetLayout mipSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout mipPipelineLayout = VK_NULL_HANDLE;
+    VkPipeline mipPipeline = VK_NULL_HANDLE;
+
+    VkQueue graphicsQueue = VK_NULL_HANDLE;
+    VkQueue transferQueue = VK_NULL_HANDLE;
+
+    VkImage placeholderImage = VK_NULL_HANDLE;
+    VgtAllocation placeholderAllocation;
+    VkImageView placeholderView = VK_NULL_HANDLE;
+
+    std::unique_ptr<VgtThreadPool> decodePool;
+    std::thread transferThread;
+
+    // Guards everything below.
+    std::mutex mutex;
+    std::condition_variable decodedAvailable;
+    bool stop = false;
+    std::deque<VgtStreamedTexture> textures;  // indexed by handle
+    std::vector<VgtDecodedTexture> decoded;   // waiting for the transfer thread
+    std::vector<VgtTextureBatch> recorded;    // waiting for VgtTextureStreamerUpdate to submit
+
+    // Render thread only.
+    std::vector<VgtTextureBatch> submitted;   // waiting for their fence
+};
+
+VkResult VgtCreateTextureStreamer(const VgtTextureStreamerCreateInfo& ci, VgtTextureStreamer& streamer);
+void VgtDestroyTextureStreamer(VgtTextureStreamer& streamer);
+
+// Queues `relativePath` (resolved like VgtLoadImageFile) and returns its handle.
+uint32_t VgtRequestTexture(VgtTextureStreamer& streamer, const char* relativePath);
+
+// Submits recorded batches and retires finished ones. Returns the number of textures whose
+// view changed during this call; refresh descriptors when it is non-zero.
+uint32_t VgtTextureStreamerUpdate(VgtTextureStreamer& streamer);
+
+VgtTextureState VgtGetTextureState(VgtTextureStreamer& streamer, uint32_t handle);
+
+// The texture's view once it is ready, the placeholder before that (or if loading failed).
+// Always in SHADER_READ_ONLY_OPTIMAL, owned by the graphics queue family.
+VkImageView VgtGetTextureView(VgtTextureStreamer& streamer, uint32_t handle);
+
+// Mip levels behind VgtGetTextureView (1 for the placeholder); use it for VkSamplerCreateInfo::maxLod.
+uint32_t VgtGetTextureMipLevels(VgtTextureStreamer& streamer, uint32_t handle);
+
+// Textures that are still decoding or uploading.
+uint32_t VgtTextureStreamerPending(VgtTextureStreamer& streamer);
+
+// Turns on textureCompressionBC/ETC2/ASTC_LDR in `features` where the device supports them.
+// Call before vkCreateDevice; block-compressed formats cannot be sampled without them.
+void VgtEnableTextureCompressionFeatures(VkPhysicalDevice physicalDevice, VkPhysicalDeviceFeatures& features);
@@ -0,0 +1,77 @@
+#include "VgtThreadPool.h"
+
+#include <algorithm>
+
+#include "VgtTrace.h"
+
+VgtThreadPool::VgtThreadPool(uint32_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        const uint32_t hw = std::thread::hardware_concurrency();
+        threadCount = std::max(hw, 2u) - 1;
+    }
+
+    m_threads.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i)
+        m_threads.emplace_back([this] {
+            VgtTraceSetThreadName("worker");
+            workerLoop();
+        });
+}
+
+VgtThreadPool::~VgtThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_jobAvailable.notify_all();
+    for (auto& t : m_threads)
+        t.join();
+}
+
+void VgtThreadPool::submit(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_jobAvailable.notify_one();
+}
+
+void VgtThreadPool::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_jobs.empty() && m_running == 0; });
+}
+
+void VgtThreadPool::workerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobAvailable.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+            // Drain remaining jobs before honoring m_stop.
+            if (m_jobs.empty())
+                return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            ++m_running;
+        }
+
+        {
+            VGT_TRACE_ZONE("job");
+            job();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_running;
+            if (m_jobs.empty() && m_running == 0)
+                m_idle.notify_all();
+        }
+    }
+}
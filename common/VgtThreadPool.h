@@ -0,0 +1,40 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size worker pool for CPU-side jobs (image decode, command recording, startup work).
+// Jobs run in FIFO order on whichever worker is free; the destructor drains the queue.
+class VgtThreadPool
+{
+public:
+    // 0 == one worker per hardware thread minus one (the main thread), at least one.
+    explicit VgtThreadPool(uint32_t threadCount = 0);
+    ~VgtThreadPool();
+
+    VgtThreadPool(const VgtThreadPool&) = delete;
+    VgtThreadPool& operator=(const VgtThreadPool&) = delete;
+
+    void submit(std::function<void()> job);
+
+    // Blocks until the queue is empty and no job is running.
+    void waitIdle();
+
+    uint32_t threadCount() const { return static_cast<uint32_t>(m_threads.size()); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> m_threads;
+    std::deque<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_jobAvailable;
+    std::condition_variable m_idle;
+    uint32_t m_running = 0;
+    bool m_stop = false;
+};
@@ -0,0 +1,138 @@
+#include "VgtTrace.h"
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct VgtTraceEvent
+{
+    const char* name = nullptr;
+    uint64_t startNs = 0;
+    uint64_t endNs = 0;
+};
+
+struct VgtTraceRing
+{
+    uint32_t tid = 0;
+    std::string threadName;
+    std::vector<VgtTraceEvent> events; // kVgtTraceRingEvents slots
+    std::atomic<uint64_t> count{ 0 };  // zones recorded, including overwritten ones
+};
+
+// Rings are shared with the registry, so zones of threads that already exited still get written.
+static std::mutex s_mutex;
+static std::vector<std::shared_ptr<VgtTraceRing>> s_rings;
+static std::string s_path;
+static std::string s_label;
+static uint64_t s_originNs = 0;
+static uint32_t s_nextTid = 1;
+static thread_local std::shared_ptr<VgtTraceRing> t_ring;
+
+static VgtTraceRing& ThreadRing()
+{
+    if (!t_ring)
+    {
+        auto ring = std::make_shared<VgtTraceRing>();
+        ring->events.resize(kVgtTraceRingEvents);
+        std::lock_guard<std::mutex> lock(s_mutex);
+        ring->tid = s_nextTid++;
+        ring->threadName = "thread " + std::to_string(ring->tid);
+        s_rings.push_back(ring);
+        t_ring = std::move(ring);
+    }
+    return *t_ring;
+}
+
+void VgtTraceStart(const char* path, const char* label)
+{
+    if (path == nullptr || *path == '\0')
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_path = path;
+        s_label = label;
+        s_originNs = VgtTraceNow();
+    }
+    g_vgtTraceEnabled.store(true, std::memory_order_relaxed);
+    VgtTraceSetThreadName("main");
+}
+
+void VgtTraceSetThreadName(const char* name)
+{
+    if (!VgtTraceEnabled())
+        return;
+
+    VgtTraceRing& ring = ThreadRing();
+    std::lock_guard<std::mutex> lock(s_mutex);
+    ring.threadName = name;
+}
+
+void VgtTraceRecord(const char* name, uint64_t startNs, uint64_t endNs)
+{
+    if (!VgtTraceEnabled())
+        return;
+
+    // Only this thread writes the ring; the release store publishes the slot to VgtTraceStop.
+    VgtTraceRing& ring = ThreadRing();
+    const uint64_t n = ring.count.load(std::memory_order_relaxed);
+    ring.events[n % kVgtTraceRingEvents] = VgtTraceEvent{ name, startNs, endNs };
+    ring.count.store(n + 1, std::memory_order_release);
+}
+
+static double ToUs(uint64_t ns, uint64_t originNs)
+{
+    return ns > originNs ? static_cast<double>(ns - originNs) * 1e-3 : 0.0;
+}
+
+void VgtTraceStop()
+{
+    if (!VgtTraceEnabled())
+        return;
+    g_vgtTraceEnabled.store(false, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    std::FILE* out = std::fopen(s_path.c_str(), "w");
+    if (out == nullptr)
+    {
+        std::fprintf(stderr, "[%s] trace: cannot write %s\n", s_label.c_str(), s_path.c_str());
+        return;
+    }
+
+    // Complete ("X") events in microseconds since VgtTraceStart, plus process / thread names.
+    std::fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    std::fprintf(out, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"%s\"}}", s_label.c_str());
+    uint64_t written = 0;
+    uint64_t dropped = 0;
+    for (const auto& ring : s_rings)
+    {
+        std::fprintf(out, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": \"%s\"}}",
+            ring->tid, ring->threadName.c_str());
+
+        const uint64_t count = ring->count.load(std::memory_order_acquire);
+        const uint64_t first = count > kVgtTraceRingEvents ? count - kVgtTraceRingEvents : 0;
+        for (uint64_t i = first; i < count; ++i)
+        {
+            const VgtTraceEvent& e = ring->events[i % kVgtTraceRingEvents];
+            std::fprintf(out, ",\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}", e.name,
+                ring->tid, ToUs(e.startNs, s_originNs), static_cast<double>(e.endNs - e.startNs) * 1e-3);
+        }
+        written += count - first;
+        dropped += first;
+    }
+    std::fprintf(out, "\n]}\n");
+    std::fclose(out);
+
+    if (dropped > 0)
+    {
+        std::fprintf(stderr, "[%s] trace: wrote %llu zones to %s (%llu oldest overwritten)\n", s_label.c_str(),
+            static_cast<unsigned long long>(written), s_path.c_str(), static_cast<unsigned long long>(dropped));
+    }
+    else
+    {
+        std::fprintf(stderr, "[%s] trace: wrote %llu zones to %s\n", s_label.c_str(), static_cast<unsigned long long>(written),
+            s_path.c_str());
+    }
+}
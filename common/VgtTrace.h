@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Scoped CPU zones written as Chrome trace JSON (--trace PATH), which Perfetto
+// (ui.perfetto.dev) and chrome://tracing open directly.
+//
+// - VGT_TRACE_ZONE("name") times the rest of the enclosing scope. A named VgtTraceZone can be
+//   ended early with End(), for phases that are not a block of their own. Only the name
+//   pointer is stored, so names must outlive the trace (string literals).
+// - Every thread records into its own ring of kVgtTraceRingEvents completed zones, with no
+//   locking on the hot path. A full ring overwrites its oldest zones, so very long runs keep
+//   their most recent frames (bound the run with --frames to keep startup in the trace).
+// - Disabled (the default), a zone costs one relaxed atomic load and a branch in the
+//   constructor and in the destructor.
+// - VgtTraceStop writes the file. Call it while no other thread is inside a zone (e.g. after
+//   vkDeviceWaitIdle and with the thread pools idle); later zones are dropped.
+//
+// The shared helpers mark their own work (swapchain creation, shader loading, pipeline
+// creation, uploads, fence waits, acquire / present, thread-pool jobs); the steps add
+// instance / device creation and the phases of their frame loop.
+
+constexpr uint32_t kVgtTraceRingEvents = 1u << 16;
+
+inline std::atomic<bool> g_vgtTraceEnabled{ false };
+
+inline bool VgtTraceEnabled()
+{
+    return g_vgtTraceEnabled.load(std::memory_order_relaxed);
+}
+
+inline uint64_t VgtTraceNow()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Starts recording when `path` is non-empty; `label` names the process in the trace.
+void VgtTraceStart(const char* path, const char* label);
+// Writes the trace and stops recording.
+void VgtTraceStop();
+
+// Names the calling thread's track (the thread that called VgtTraceStart is "main").
+void VgtTraceSetThreadName(const char* name);
+
+// Appends one completed zone to the calling thread's ring.
+void VgtTraceRecord(const char* name, uint64_t startNs, uint64_t endNs);
+
+class VgtTraceZone
+{
+public:
+    explicit VgtTraceZone(const char* name) : m_name(name), m_start(VgtTraceEnabled() ? VgtTraceNow() : 0) {}
+    ~VgtTraceZone() { End(); }
+
+    VgtTraceZone(const VgtTraceZone&) = delete;
+    VgtTraceZone& operator=(const VgtTraceZone&) = delete;
+
+    void End()
+    {
+        if (m_start != 0)
+        {
+            VgtTraceRecord(m_name, m_start, VgtTraceNow());
+            m_start = 0;
+        }
+    }
+
+private:
+    const char* m_name;
+    uint64_t m_start;
+};
+
+#define VGT_TRACE_CONCAT_INNER(a, b) a##b
+#define VGT_TRACE_CONCAT(a, b) VGT_TRACE_CONCAT_INNER(a, b)
+#define VGT_TRACE_ZONE(name) VgtTraceZone VGT_TRACE_CONCAT(vgtTraceZone, __LINE__)(name)
@@ -0,0 +1,73 @@
+#include "VgtUniformRing.h"
+
+#include <cstdio>
+#include <cstring>
+
+VkResult VgtCreateUniformRing(VgtAllocator& allocator, VkDeviceSize uniformSize, uint32_t uniformsPerFrame, uint32_t framesInFlight,
+    VgtUniformRing& ring)
+{
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(allocator.physicalDevice, &props);
+
+    ring.alignment = props.limits.minUniformBufferOffsetAlignment;
+    if (ring.alignment == 0)
+        ring.alignment = 1;
+    ring.framesInFlight = framesInFlight;
+    ring.sliceSize = VgtUniformRingAlign(ring, uniformSize) * uniformsPerFrame;
+    ring.sliceBegin = 0;
+    ring.head = 0;
+
+    VkBufferCreateInfo bufCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    bufCI.size = ring.sliceSize * framesInFlight;
+    bufCI.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    bufCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    const VkResult res = VgtCreateBuffer(allocator, bufCI, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        ring.buffer, ring.allocation);
+    if (res == VK_SUCCESS && ring.allocation.mapped == nullptr)
+    {
+        std::fprintf(stderr, "VgtCreateUniformRing: uniform memory is not host-visible\n");
+        VgtDestroyUniformRing(allocator, ring);
+        return VK_ERROR_MEMORY_MAP_FAILED;
+    }
+    return res;
+}
+
+void VgtDestroyUniformRing(VgtAllocator& allocator, VgtUniformRing& ring)
+{
+    VgtDestroyBuffer(allocator, ring.buffer, ring.allocation);
+    ring = VgtUniformRing{};
+}
+
+VkDeviceSize VgtUniformRingAlign(const VgtUniformRing& ring, VkDeviceSize size)
+{
+    return (size + ring.alignment - 1) / ring.alignment * ring.alignment;
+}
+
+void VgtUniformRingBeginFrame(VgtUniformRing& ring, uint32_t frame)
+{
+    ring.sliceBegin = ring.sliceSize * frame;
+    ring.head = 0;
+}
+
+void* VgtUniformRingAllocate(VgtUniformRing& ring, VkDeviceSize size, uint32_t& dynamicOffset)
+{
+    const VkDeviceSize aligned = VgtUniformRingAlign(ring, size);
+    if (ring.head + aligned > ring.sliceSize)
+        return nullptr;
+
+    const VkDeviceSize offset = ring.sliceBegin + ring.head;
+    ring.head += aligned;
+    dynamicOffset = static_cast<uint32_t>(offset);
+    return static_cast<uint8_t*>(ring.allocation.mapped) + offset;
+}
+
+uint32_t VgtUniformRingPush(VgtUniformRing& ring, const void* data, VkDeviceSize size)
+{
+    uint32_t dynamicOffset = UINT32_MAX;
+    void* dst = VgtUniformRingAllocate(ring, size, dynamicOffset);
+    if (dst == nullptr)
+        return UINT32_MAX;
+    std::memcpy(dst, data, static_cast<size_t>(size));
+    return dynamicOffset;
+}
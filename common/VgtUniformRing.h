@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+#include "VgtAllocator.h"
+
+// Persistently mapped uniform buffer split into one slice per frame in flight.
+//
+// - Bind it with VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC (offset 0, range = one UBO) and
+//   pass the offset returned by VgtUniformRingPush as the dynamic offset.
+// - Each push is aligned to `minUniformBufferOffsetAlignment`, so a frame can hold many
+//   per-object UBOs.
+// - A frame's slice is only rewritten after VgtWaitForFrame on the same slot, so the CPU
+//   never overwrites data the GPU is still reading.
+struct VgtUniformRing
+{
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VgtAllocation allocation;
+
+    VkDeviceSize alignment = 0;     // minUniformBufferOffsetAlignment
+    VkDeviceSize sliceSize = 0;     // bytes per frame slice (multiple of alignment)
+    uint32_t framesInFlight = 0;
+
+    VkDeviceSize sliceBegin = 0;    // start of the current frame's slice
+    VkDeviceSize head = 0;          // next free byte inside the current slice
+};
+
+// Sizes each slice for `uniformsPerFrame` pushes of up to `uniformSize` bytes.
+VkResult VgtCreateUniformRing(VgtAllocator& allocator, VkDeviceSize uniformSize, uint32_t uniformsPerFrame, uint32_t framesInFlight,
+    VgtUniformRing& ring);
+void VgtDestroyUniformRing(VgtAllocator& allocator, VgtUniformRing& ring);
+
+// Rounds `size` up to the ring's dynamic offset alignment.
+VkDeviceSize VgtUniformRingAlign(const VgtUniformRing& ring, VkDeviceSize size);
+
+// Starts writing into `frame`'s slice. Call after VgtWaitForFrame for that slot.
+void VgtUniformRingBeginFrame(VgtUniformRing& ring, uint32_t frame);
+
+// Reserves `size` bytes in the current slice and returns a host pointer to them.
+// `dynamicOffset` receives the offset for vkCmdBindDescriptorSets. Returns nullptr when full.
+void* VgtUniformRingAllocate(VgtUniformRing& ring, VkDeviceSize size, uint32_t& dynamicOffset);
+
+// Copies `data` into the current slice. Returns the dynamic offset, or UINT32_MAX when full.
+uint32_t VgtUniformRingPush(VgtUniformRing& ring, const void* data, VkDeviceSize size);
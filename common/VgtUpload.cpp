@@ -0,0 +1,312 @@
+#include "VgtUpload.h"
+
+#include <chrono>
+#include <cstring>
+
+#include "VgtTrace.h"
+
+uint32_t VgtFindTransferQueueFamily(VkPhysicalDevice physicalDevice)
+{
+    uint32_t qCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &qCount, nullptr);
+    std::vector<VkQueueFamilyProperties> qProps(qCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &qCount, qProps.data());
+
+    for (uint32_t i = 0; i < qCount; ++i)
+    {
+        const VkQueueFlags flags = qProps[i].queueFlags;
+        if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+            return i;
+    }
+    return UINT32_MAX;
+}
+
+static VkResult CreatePoolAndBuffer(VkDevice device, uint32_t queueFamily, VkCommandPool& pool, VkCommandBuffer& cmd)
+{
+    VkCommandPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    poolCI.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolCI.queueFamilyIndex = queueFamily;
+    VkResult res = vkCreateCommandPool(device, &poolCI, nullptr, &pool);
+    if (res != VK_SUCCESS)
+        return res;
+
+    VkCommandBufferAllocateInfo cmdAI{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    cmdAI.commandPool = pool;
+    cmdAI.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cmdAI.commandBufferCount = 1;
+    return vkAllocateCommandBuffers(device, &cmdAI, &cmd);
+}
+
+VkResult VgtCreateUploadContext(const VgtUploadContextCreateInfo& ci, VgtUploadContext& ctx)
+{
+    ctx.device = ci.device;
+    ctx.allocator = ci.allocator;
+    ctx.graphicsQueueFamily = ci.graphicsQueueFamily;
+    ctx.dedicatedTransfer = ci.transferQueueFamily != UINT32_MAX && ci.transferQueueFamily != ci.graphicsQueueFamily;
+    ctx.transferQueueFamily = ctx.dedicatedTransfer ? ci.transferQueueFamily : ci.graphicsQueueFamily;
+
+    vkGetDeviceQueue(ci.device, ctx.graphicsQueueFamily, 0, &ctx.graphicsQueue);
+    VkResult res = CreatePoolAndBuffer(ci.device, ctx.graphicsQueueFamily, ctx.graphicsPool, ctx.graphicsCmd);
+    if (res != VK_SUCCESS)
+        return res;
+
+    if (ctx.dedicatedTransfer)
+    {
+        vkGetDeviceQueue(ci.device, ctx.transferQueueFamily, 0, &ctx.transferQueue);
+        res = CreatePoolAndBuffer(ci.device, ctx.transferQueueFamily, ctx.transferPool, ctx.transferCmd);
+        if (res != VK_SUCCESS)
+            return res;
+
+        VkSemaphoreCreateInfo semCI{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+        res = vkCreateSemaphore(ci.device, &semCI, nullptr, &ctx.ownershipSemaphore);
+        if (res != VK_SUCCESS)
+            return res;
+    }
+
+    VkFenceCreateInfo fenceCI{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    return vkCreateFence(ci.device, &fenceCI, nullptr, &ctx.fence);
+}
+
+void VgtDestroyUploadContext(VgtUploadContext& ctx)
+{
+    if (!ctx.pending.empty())
+        VgtFlushUploads(ctx);
+
+    if (ctx.fence)
+        vkDestroyFence(ctx.device, ctx.fence, nullptr);
+    if (ctx.ownershipSemaphore)
+        vkDestroySemaphore(ctx.device, ctx.ownershipSemaphore, nullptr);
+    if (ctx.transferPool)
+        vkDestroyCommandPool(ctx.device, ctx.transferPool, nullptr);
+    if (ctx.graphicsPool)
+        vkDestroyCommandPool(ctx.device, ctx.graphicsPool, nullptr);
+    ctx = VgtUploadContext{};
+}
+
+// Where the graphics queue first reads a buffer with this usage.
+static void DestinationScope(VkBufferUsageFlags usage, VkAccessFlags& access, VkPipelineStageFlags& stages)
+{
+    access = 0;
+    stages = 0;
+    if (usage & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
+    {
+        access |= VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+        stages |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    }
+    if (usage & VK_BUFFER_USAGE_INDEX_BUFFER_BIT)
+    {
+        access |= VK_ACCESS_INDEX_READ_BIT;
+        stages |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    }
+    if (usage & VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT)
+    {
+        access |= VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+        stages |= VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+    }
+    if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+    {
+        access |= VK_ACCESS_UNIFORM_READ_BIT;
+        stages |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    }
+    if (usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+    {
+        access |= VK_ACCESS_SHADER_READ_BIT;
+        stages |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    }
+    if (usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+    {
+        access |= VK_ACCESS_TRANSFER_READ_BIT;
+        stages |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+    }
+    if (stages == 0)
+        stages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+}
+
+static VkResult UploadBuffer(VgtUploadContext& ctx, const void* data, VkDeviceSize size, VkBufferUsageFlags usage,
+    VkBuffer& buffer, VgtAllocation& allocation)
+{
+    VkBufferCreateInfo bufCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    bufCI.size = size;
+    bufCI.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VkResult res = VgtCreateBuffer(*ctx.allocator, bufCI, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, allocation);
+    if (res != VK_SUCCESS)
+        return res;
+
+    // Integrated GPUs: device-local memory may be mapped, skip the copy.
+    const VkMemoryPropertyFlags memFlags = ctx.allocator->memProps.memoryTypes[allocation.memoryTypeIndex].propertyFlags;
+    if (allocation.mapped && (memFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+    {
+        std::memcpy(allocation.mapped, data, static_cast<size_t>(size));
+        ctx.bytesDirect += size;
+        return VK_SUCCESS;
+    }
+
+    VgtPendingUpload upload;
+    VkBufferCreateInfo stagingCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    stagingCI.size = size;
+    stagingCI.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    stagingCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    res = VgtCreateBuffer(*ctx.allocator, stagingCI, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        upload.staging, upload.stagingAlloc);
+    if (res != VK_SUCCESS)
+    {
+        VgtDestroyBuffer(*ctx.allocator, buffer, allocation);
+        buffer = VK_NULL_HANDLE;
+        return res;
+    }
+    std::memcpy(upload.stagingAlloc.mapped, data, static_cast<size_t>(size));
+
+    upload.dst = buffer;
+    upload.size = size;
+    DestinationScope(usage, upload.dstAccess, upload.dstStages);
+    ctx.pending.push_back(upload);
+    return VK_SUCCESS;
+}
+
+// Records and submits the copies for ctx.pending and waits for them; FlushUploads frees the
+// staging buffers afterwards, whichever step failed.
+static VkResult SubmitUploads(VgtUploadContext& ctx)
+{
+    VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    VkPipelineStageFlags dstStages = 0;
+    std::vector<VkBufferMemoryBarrier> release;
+    std::vector<VkBufferMemoryBarrier> acquire;
+    for (const auto& upload : ctx.pending)
+    {
+        dstStages |= upload.dstStages;
+
+        VkBufferMemoryBarrier barrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+        barrier.buffer = upload.dst;
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = upload.dstAccess;
+        if (ctx.dedicatedTransfer)
+        {
+            // Release on the transfer queue (dstAccessMask ignored) ...
+            barrier.srcQueueFamilyIndex = ctx.transferQueueFamily;
+            barrier.dstQueueFamilyIndex = ctx.graphicsQueueFamily;
+            barrier.dstAccessMask = 0;
+            release.push_back(barrier);
+
+            // ... and acquire on the graphics queue (srcAccessMask ignored).
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = upload.dstAccess;
+        }
+        acquire.push_back(barrier);
+    }
+
+    VkCommandBuffer copyCmd = ctx.dedicatedTransfer ? ctx.transferCmd : ctx.graphicsCmd;
+    VkResult res = vkBeginCommandBuffer(copyCmd, &beginInfo);
+    if (res != VK_SUCCESS)
+        return res;
+    for (const auto& upload : ctx.pending)
+    {
+        VkBufferCopy region{};
+        region.size = upload.size;
+        vkCmdCopyBuffer(copyCmd, upload.staging, upload.dst, 1, &region);
+    }
+
+    if (ctx.dedicatedTransfer)
+    {
+        vkCmdPipelineBarrier(ctx.transferCmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+            0, nullptr, static_cast<uint32_t>(release.size()), release.data(), 0, nullptr);
+        res = vkEndCommandBuffer(ctx.transferCmd);
+        if (res != VK_SUCCESS)
+            return res;
+
+        VkSubmitInfo transferSubmit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+        transferSubmit.commandBufferCount = 1;
+        transferSubmit.pCommandBuffers = &ctx.transferCmd;
+        transferSubmit.signalSemaphoreCount = 1;
+        transferSubmit.pSignalSemaphores = &ctx.ownershipSemaphore;
+        res = vkQueueSubmit(ctx.transferQueue, 1, &transferSubmit, VK_NULL_HANDLE);
+        if (res != VK_SUCCESS)
+            return res;
+
+        res = vkBeginCommandBuffer(ctx.graphicsCmd, &beginInfo);
+        if (res != VK_SUCCESS)
+        {
+            // The copies are already in flight; let them finish before the staging buffers go.
+            vkQueueWaitIdle(ctx.transferQueue);
+            return res;
+        }
+        // The semaphore wait below covers dstStages, so the acquire chains off it.
+        vkCmdPipelineBarrier(ctx.graphicsCmd, dstStages, dstStages, 0,
+            0, nullptr, static_cast<uint32_t>(acquire.size()), acquire.data(), 0, nullptr);
+    }
+    else
+    {
+        vkCmdPipelineBarrier(ctx.graphicsCmd, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStages, 0,
+            0, nullptr, static_cast<uint32_t>(acquire.size()), acquire.data(), 0, nullptr);
+    }
+
+    res = vkEndCommandBuffer(ctx.graphicsCmd);
+    if (res == VK_SUCCESS)
+    {
+        VkSubmitInfo submit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+        submit.commandBufferCount = 1;
+        submit.pCommandBuffers = &ctx.graphicsCmd;
+        if (ctx.dedicatedTransfer)
+        {
+            submit.waitSemaphoreCount = 1;
+            submit.pWaitSemaphores = &ctx.ownershipSemaphore;
+            submit.pWaitDstStageMask = &dstStages;
+        }
+        res = vkQueueSubmit(ctx.graphicsQueue, 1, &submit, ctx.fence);
+    }
+    if (res != VK_SUCCESS)
+    {
+        if (ctx.dedicatedTransfer)
+            vkQueueWaitIdle(ctx.transferQueue);
+        return res;
+    }
+    return vkWaitForFences(ctx.device, 1, &ctx.fence, VK_TRUE, UINT64_MAX);
+}
+
+static VkResult FlushUploads(VgtUploadContext& ctx)
+{
+    if (ctx.pending.empty())
+        return VK_SUCCESS;
+
+    const VkResult res = SubmitUploads(ctx);
+
+    // Every exit path of SubmitUploads ends here, so a failed flush does not leak its staging buffers.
+    vkResetFences(ctx.device, 1, &ctx.fence);
+    vkResetCommandPool(ctx.device, ctx.graphicsPool, 0);
+    if (ctx.transferPool)
+        vkResetCommandPool(ctx.device, ctx.transferPool, 0);
+
+    for (auto& upload : ctx.pending)
+    {
+        if (res == VK_SUCCESS)
+            ctx.bytesStaged += upload.size;
+        VgtDestroyBuffer(*ctx.allocator, upload.staging, upload.stagingAlloc);
+    }
+    ctx.pending.clear();
+    return res;
+}
+
+VkResult VgtUploadBuffer(VgtUploadContext& ctx, const void* data, VkDeviceSize size, VkBufferUsageFlags usage,
+    VkBuffer& buffer, VgtAllocation& allocation)
+{
+    VGT_TRACE_ZONE("upload");
+    const auto t0 = std::chrono::steady_clock::now();
+    const VkResult res = UploadBuffer(ctx, data, size, usage, buffer, allocation);
+    ctx.uploadMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return res;
+}
+
+VkResult VgtFlushUploads(VgtUploadContext& ctx)
+{
+    VGT_TRACE_ZONE("upload flush");
+    const auto t0 = std::chrono::steady_clock::now();
+    const VkResult res = FlushUploads(ctx);
+    ctx.uploadMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return res;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "VgtAllocator.h"
+
+// Uploads static data (vertex/index/uniform buffers) into DEVICE_LOCAL memory.
+//
+// VgtUploadBuffer creates the destination buffer and queues a copy from a host-visible
+// staging buffer; VgtFlushUploads submits every queued copy at once and waits for it.
+//
+// When the device has a dedicated transfer queue family (VgtFindTransferQueueFamily), the
+// copies run there and each buffer is released by the transfer queue and acquired by the
+// graphics queue (queue family ownership transfer), chained with a semaphore. Otherwise the
+// copies are recorded on the graphics queue followed by a plain barrier.
+//
+// If the destination memory is also host-visible and coherent (integrated GPUs), the data
+// is written directly and no staging copy is queued.
+
+struct VgtUploadContextCreateInfo
+{
+    VkDevice device = VK_NULL_HANDLE;
+    VgtAllocator* allocator = nullptr;
+    uint32_t graphicsQueueFamily = 0;
+    uint32_t transferQueueFamily = UINT32_MAX; // UINT32_MAX (or == graphics) uploads on the graphics queue
+};
+
+struct VgtPendingUpload
+{
+    VkBuffer staging = VK_NULL_HANDLE;
+    VgtAllocation stagingAlloc;
+    VkBuffer dst = VK_NULL_HANDLE;
+    VkDeviceSize size = 0;
+    VkAccessFlags dstAccess = 0;
+    VkPipelineStageFlags dstStages = 0;
+};
+
+struct VgtUploadContext
+{
+    VkDevice device = VK_NULL_HANDLE;
+    VgtAllocator* allocator = nullptr;
+    uint32_t graphicsQueueFamily = 0;
+    uint32_t transferQueueFamily = 0;
+    bool dedicatedTransfer = false;
+
+    VkQueue graphicsQueue = VK_NULL_HANDLE;
+    VkQueue transferQueue = VK_NULL_HANDLE;
+    VkCommandPool graphicsPool = VK_NULL_HANDLE;
+    VkCommandPool transferPool = VK_NULL_HANDLE;
+    VkCommandBuffer graphicsCmd = VK_NULL_HANDLE;
+    VkCommandBuffer transferCmd = VK_NULL_HANDLE;
+    VkSemaphore ownershipSemaphore = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+
+    std::vector<VgtPendingUpload> pending;
+    VkDeviceSize bytesStaged = 0;  // total copied through staging buffers
+    VkDeviceSize bytesDirect = 0;  // total written directly (host-visible device-local memory)
+    double uploadMs = 0.0;         // CPU time spent in VgtUploadBuffer / VgtFlushUploads (fence wait included)
+};
+
+// Returns a queue family that supports transfers but neither graphics nor compute (usually a
+// copy engine), or UINT32_MAX.
+uint32_t VgtFindTransferQueueFamily(VkPhysicalDevice physicalDevice);
+
+// The device must have been created with a queue in `transferQueueFamily` when one is given.
+VkResult VgtCreateUploadContext(const VgtUploadContextCreateInfo& ci, VgtUploadContext& ctx);
+void VgtDestroyUploadContext(VgtUploadContext& ctx);
+
+// Creates a DEVICE_LOCAL buffer with `usage | TRANSFER_DST` and queues the copy of `data`.
+// The buffer may only be used after VgtFlushUploads returned.
+VkResult VgtUploadBuffer(VgtUploadContext& ctx, const void* data, VkDeviceSize size, VkBufferUsageFlags usage,
+    VkBuffer& buffer, VgtAllocation& allocation);
+
+// Submits all queued copies, waits for them and frees the staging buffers (also when it fails).
+VkResult VgtFlushUploads(VgtUploadContext& ctx);
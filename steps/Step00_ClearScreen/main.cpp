@@ -4,10 +4,16 @@
 #include <vector>
 #include <string>
 
-#define GLFW_INCLUDE_VULKAN
-#include <GLFW/glfw3.h>
+#include <vulkan/vulkan.h>
 
 #include <VgtConfig.h>
+#include <VgtBenchmark.h>
+#include <VgtFrameStats.h>
+#include <VgtFrameSync.h>
+#include <VgtGpuTimer.h>
+#include <VgtOptions.h>
+#include <VgtPresenter.h>
+#include <VgtTrace.h>
 
 static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(
     VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
@@ -22,35 +28,39 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(
     return VK_FALSE;
 }
 
-static std::vector<const char*> GetRequiredInstanceExtensions()
+static std::vector<const char*> GetRequiredInstanceExtensions(VgtPresenter& presenter)
 {
-    uint32_t count = 0;
-    const char** glfwExt = glfwGetRequiredInstanceExtensions(&count);
-
+    // Surface extensions (none when rendering offscreen).
     std::vector<const char*> exts;
-    exts.reserve(count + 1);
-    for (uint32_t i = 0; i < count; ++i)
-        exts.push_back(glfwExt[i]);
+    VgtPresenterGetInstanceExtensions(presenter, exts);
 
     // Debug utils for validation messages.
     exts.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
     return exts;
 }
 
-int main()
+int main(int argc, char** argv)
 {
-    if (!glfwInit())
-    {
-        std::fprintf(stderr, "Failed to init GLFW\n");
-        return 1;
-    }
-
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-    GLFWwindow* window = glfwCreateWindow(1280, 720, "Step00_ClearScreen", nullptr, nullptr);
-    if (!window)
+    const VgtOptions options = VgtParseOptions(argc, argv);
+    VgtTraceStart(options.tracePath.c_str(), "Step00_ClearScreen");
+    VgtTraceZone initZone("init");
+    VgtBenchmark bench;
+    VgtBenchmarkBegin(bench, "Step00_ClearScreen", options);
+
+    // Window (or nothing, when rendering headless)
+    VgtPresenterCreateInfo presenterCI{};
+    presenterCI.title = "Step00_ClearScreen";
+    presenterCI.backend = options.backend;
+    presenterCI.frameLimit = options.frameLimit;
+    presenterCI.presentMode = options.presentMode;
+    presenterCI.swapchainImages = options.swapchainImages;
+    presenterCI.framesInFlight = options.framesInFlight;
+    presenterCI.measureLatency = options.latency;
+
+    VgtPresenter presenter;
+    if (!VgtPresenterInit(presenterCI, presenter))
     {
         std::fprintf(stderr, "Failed to create GLFW window\n");
-        glfwTerminate();
         return 1;
     }
 
@@ -62,7 +72,7 @@ int main()
     appInfo.engineVersion = VK_MAKE_VERSION(0, 0, 0);
     appInfo.apiVersion = VK_API_VERSION_1_3;
 
-    std::vector<const char*> instanceExtensions = GetRequiredInstanceExtensions();
+    std::vector<const char*> instanceExtensions = GetRequiredInstanceExtensions(presenter);
 
     std::vector<const char*> validationLayers;
 #if VGT_ENABLE_VALIDATION
@@ -77,7 +87,9 @@ int main()
     instanceCI.ppEnabledLayerNames = validationLayers.empty() ? nullptr : validationLayers.data();
 
     VkInstance instance = VK_NULL_HANDLE;
+    VgtTraceZone instanceZone("instance creation");
     VkResult res = vkCreateInstance(&instanceCI, nullptr, &instance);
+    instanceZone.End();
     if (res != VK_SUCCESS)
     {
         std::fprintf(stderr, "vkCreateInstance failed: %d\n", res);
@@ -108,12 +120,11 @@ int main()
     }
 #endif
 
-    // Surface (Win32 via GLFW)
-    VkSurfaceKHR surface = VK_NULL_HANDLE;
-    res = glfwCreateWindowSurface(instance, window, nullptr, &surface);
+    // Surface (GLFW window or VK_EXT_headless_surface; none offscreen)
+    res = VgtPresenterCreateSurface(presenter, instance);
     if (res != VK_SUCCESS)
     {
-        std::fprintf(stderr, "glfwCreateWindowSurface failed: %d\n", res);
+        std::fprintf(stderr, "VgtPresenterCreateSurface failed: %d\n", res);
         return 1;
     }
 
@@ -142,9 +153,7 @@ int main()
         if ((qProps[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) && graphicsQ == UINT32_MAX)
             graphicsQ = i;
 
-        VkBool32 presentSupport = VK_FALSE;
-        vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentSupport);
-        if (presentSupport && presentQ == UINT32_MAX)
+        if (VgtPresenterSupportsPresent(presenter, physicalDevice, i) && presentQ == UINT32_MAX)
             presentQ = i;
     }
 
@@ -174,7 +183,7 @@ int main()
     }
 
     std::vector<const char*> deviceExtensions;
-    deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    VgtPresenterGetDeviceExtensions(presenter, deviceExtensions);
 
     VkPhysicalDeviceFeatures deviceFeatures{};
 
@@ -182,15 +191,20 @@ int main()
     deviceCI.queueCreateInfoCount = static_cast<uint32_t>(queueCIs.size());
     deviceCI.pQueueCreateInfos = queueCIs.data();
     deviceCI.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-    deviceCI.ppEnabledExtensionNames = deviceExtensions.data();
+    deviceCI.ppEnabledExtensionNames = deviceExtensions.empty() ? nullptr : deviceExtensions.data();
     deviceCI.pEnabledFeatures = &deviceFeatures;
 
     // For older loaders, enabling layers on the device can help tooling.
     deviceCI.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
     deviceCI.ppEnabledLayerNames = validationLayers.empty() ? nullptr : validationLayers.data();
 
+    // --latency: present id / present wait for input-to-photon timing, when supported.
+    VgtPresenterEnableDeviceFeatures(presenter, physicalDevice, deviceExtensions, deviceCI);
+
     VkDevice device = VK_NULL_HANDLE;
+    VgtTraceZone deviceZone("device creation");
     res = vkCreateDevice(physicalDevice, &deviceCI, nullptr, &device);
+    deviceZone.End();
     if (res != VK_SUCCESS)
     {
         std::fprintf(stderr, "vkCreateDevice failed: %d\n", res);
@@ -198,96 +212,25 @@ int main()
     }
 
     VkQueue graphicsQueue = VK_NULL_HANDLE;
-    VkQueue presentQueue = VK_NULL_HANDLE;
     vkGetDeviceQueue(device, graphicsQ, 0, &graphicsQueue);
-    vkGetDeviceQueue(device, presentQ, 0, &presentQueue);
-
-    // Swapchain
-    VkSurfaceCapabilitiesKHR caps{};
-    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, surface, &caps);
-
-    uint32_t formatCount = 0;
-    vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, nullptr);
-    std::vector<VkSurfaceFormatKHR> formats(formatCount);
-    vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, formats.data());
-
-    VkSurfaceFormatKHR surfaceFormat = formats[0];
-    for (const auto& f : formats)
-    {
-        if (f.format == VK_FORMAT_B8G8R8A8_UNORM && f.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
-        {
-            surfaceFormat = f;
-            break;
-        }
-    }
-
-    uint32_t presentModeCount = 0;
-    vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, &presentModeCount, nullptr);
-    std::vector<VkPresentModeKHR> presentModes(presentModeCount);
-    vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, &presentModeCount, presentModes.data());
-
-    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
-    for (auto m : presentModes)
-    {
-        if (m == VK_PRESENT_MODE_MAILBOX_KHR)
-        {
-            presentMode = m;
-            break;
-        }
-    }
 
-    VkExtent2D extent = caps.currentExtent;
-    if (extent.width == UINT32_MAX)
-    {
-        int w = 0, h = 0;
-        glfwGetFramebufferSize(window, &w, &h);
-        extent.width = static_cast<uint32_t>(w);
-        extent.height = static_cast<uint32_t>(h);
-    }
+    // Swapchain (offscreen images when headless). Present mode from --present-mode, FIFO by default.
+    VgtSwapchainDesc swapDesc{};
+    swapDesc.graphicsQueueFamily = graphicsQ;
+    swapDesc.presentQueueFamily = presentQ;
+    swapDesc.imageUsage = VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
-    uint32_t imageCount = caps.minImageCount + 1;
-    if (caps.maxImageCount > 0 && imageCount > caps.maxImageCount)
-        imageCount = caps.maxImageCount;
-
-    VkSwapchainCreateInfoKHR swapCI{ VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR };
-    swapCI.surface = surface;
-    swapCI.minImageCount = imageCount;
-    swapCI.imageFormat = surfaceFormat.format;
-    swapCI.imageColorSpace = surfaceFormat.colorSpace;
-    swapCI.imageExtent = extent;
-    swapCI.imageArrayLayers = 1;
-    swapCI.imageUsage = VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-    swapCI.preTransform = caps.currentTransform;
-    swapCI.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-    swapCI.presentMode = presentMode;
-    swapCI.clipped = VK_TRUE;
-
-    uint32_t qFamilyIndices[] = { graphicsQ, presentQ };
-    if (graphicsQ != presentQ)
-    {
-        swapCI.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
-        swapCI.queueFamilyIndexCount = 2;
-        swapCI.pQueueFamilyIndices = qFamilyIndices;
-    }
-    else
-    {
-        swapCI.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    }
-
-    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
-    res = vkCreateSwapchainKHR(device, &swapCI, nullptr, &swapchain);
+    res = VgtPresenterCreateSwapchain(presenter, physicalDevice, device, swapDesc);
     if (res != VK_SUCCESS)
     {
-        std::fprintf(stderr, "vkCreateSwapchainKHR failed: %d\n", res);
+        std::fprintf(stderr, "VgtPresenterCreateSwapchain failed: %d\n", res);
         return 1;
     }
 
-    uint32_t swapImageCount = 0;
-    vkGetSwapchainImagesKHR(device, swapchain, &swapImageCount, nullptr);
-    std::vector<VkImage> swapImages(swapImageCount);
-    vkGetSwapchainImagesKHR(device, swapchain, &swapImageCount, swapImages.data());
+    const uint32_t swapImageCount = static_cast<uint32_t>(presenter.images.size());
+    const std::vector<VkImage>& swapImages = presenter.images;
 
-    // Command pool / buffer
+    // Command pool / buffers (one per frame in flight)
     VkCommandPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
     poolCI.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
     poolCI.queueFamilyIndex = graphicsQ;
@@ -298,40 +241,78 @@ int main()
     VkCommandBufferAllocateInfo cmdAI{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
     cmdAI.commandPool = cmdPool;
     cmdAI.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    cmdAI.commandBufferCount = 1;
-
-    VkCommandBuffer cmd = VK_NULL_HANDLE;
-    vkAllocateCommandBuffers(device, &cmdAI, &cmd);
-
-    // Sync
-    VkSemaphoreCreateInfo semCI{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
-    VkFenceCreateInfo fenceCI{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
-    fenceCI.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    cmdAI.commandBufferCount = options.framesInFlight;
 
-    VkSemaphore imageAvailable = VK_NULL_HANDLE;
-    VkSemaphore renderFinished = VK_NULL_HANDLE;
-    VkFence inFlight = VK_NULL_HANDLE;
+    std::vector<VkCommandBuffer> cmdBuffers(options.framesInFlight);
+    vkAllocateCommandBuffers(device, &cmdAI, cmdBuffers.data());
 
-    vkCreateSemaphore(device, &semCI, nullptr, &imageAvailable);
-    vkCreateSemaphore(device, &semCI, nullptr, &renderFinished);
-    vkCreateFence(device, &fenceCI, nullptr, &inFlight);
+    // Sync (per frame in flight + per swapchain image)
+    VgtFrameSync sync;
+    res = VgtCreateFrameSync(device, options.framesInFlight, swapImageCount, sync);
+    if (res != VK_SUCCESS)
+    {
+        std::fprintf(stderr, "VgtCreateFrameSync failed: %d\n", res);
+        return 1;
+    }
 
-    while (!glfwWindowShouldClose(window))
+    // GPU timestamps (--gpu-timing): one query range per frame in flight.
+    // Pre-recorded static command buffers are not timed (their slot is not known when recording).
+    VgtGpuTimerCreateInfo gpuTimerCI{};
+    gpuTimerCI.physicalDevice = physicalDevice;
+    gpuTimerCI.device = device;
+    gpuTimerCI.queueFamily = graphicsQ;
+    gpuTimerCI.slotCount = options.framesInFlight;
+    gpuTimerCI.label = "Step00_ClearScreen";
+    gpuTimerCI.enabled = options.gpuTiming && !options.staticCommandBuffers;
+    gpuTimerCI.csvPath = options.gpuTimingCsv.c_str();
+
+    VgtGpuTimer gpuTimer;
+    VgtCreateGpuTimer(gpuTimerCI, gpuTimer);
+    const uint32_t gpuFrameScope = VgtGpuTimerScope(gpuTimer, "frame");
+    const uint32_t gpuClearScope = VgtGpuTimerScope(gpuTimer, "clear");
+
+    VgtFrameStats frameStats;
+    VgtFrameStatsBegin(frameStats, "Step00_ClearScreen", options.showFps);
+
+    initZone.End();
+    VgtBenchmarkBeginFrames(bench, presenter);
+
+    while (VgtPresenterRunning(presenter))
     {
-        glfwPollEvents();
+        VGT_TRACE_ZONE("frame");
+        const uint32_t frame = sync.currentFrame;
+        VgtWaitForFrame(device, sync);
 
-        vkWaitForFences(device, 1, &inFlight, VK_TRUE, UINT64_MAX);
-        vkResetFences(device, 1, &inFlight);
+        // Resized or out of date: switch to a new swapchain before acquiring. The old one is
+        // destroyed once the frames in flight are done with it.
+        if (presenter.needsRecreate)
+        {
+            res = VgtRecreateSwapchain(presenter, sync);
+            if (res != VK_SUCCESS)
+            {
+                std::fprintf(stderr, "VgtRecreateSwapchain failed: %d\n", res);
+                break;
+            }
+        }
 
         uint32_t imageIndex = 0;
-        res = vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, imageAvailable, VK_NULL_HANDLE, &imageIndex);
+        res = VgtPresenterAcquire(presenter, sync.imageAvailable[frame], imageIndex);
+        if (res == VK_ERROR_OUT_OF_DATE_KHR)
+            continue; // no image this time; the swapchain is recreated first thing next iteration
         if (res != VK_SUCCESS)
             break;
 
+        VgtClaimImage(device, sync, imageIndex);
+
+        VgtFrameStatsCpuBegin(frameStats);
+        VgtTraceZone recordZone("record");
+        VkCommandBuffer cmd = cmdBuffers[frame];
         vkResetCommandBuffer(cmd, 0);
 
         VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
         vkBeginCommandBuffer(cmd, &beginInfo);
+        VgtGpuTimerBeginFrame(gpuTimer, cmd, frame);
+        VgtGpuTimerBegin(gpuTimer, cmd, gpuFrameScope);
 
         VkImageSubresourceRange range{};
         range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -358,13 +339,15 @@ int main()
             0, nullptr,
             1, &toTransfer);
 
+        VgtGpuTimerBegin(gpuTimer, cmd, gpuClearScope);
         VkClearColorValue clearColor{ {0.1f, 0.2f, 0.4f, 1.0f} };
         vkCmdClearColorImage(cmd, swapImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clearColor, 1, &range);
+        VgtGpuTimerEnd(gpuTimer, cmd, gpuClearScope);
 
-        // Transition: transfer dst -> present
+        // Transition: transfer dst -> present (transfer src offscreen)
         VkImageMemoryBarrier toPresent{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
         toPresent.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        toPresent.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        toPresent.newLayout = presenter.presentLayout;
         toPresent.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         toPresent.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         toPresent.image = swapImages[imageIndex];
@@ -381,42 +364,54 @@ int main()
             0, nullptr,
             1, &toPresent);
 
+        VgtGpuTimerEnd(gpuTimer, cmd, gpuFrameScope);
         vkEndCommandBuffer(cmd);
 
         VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
         VkSubmitInfo submit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
         submit.waitSemaphoreCount = 1;
-        submit.pWaitSemaphores = &imageAvailable;
+        submit.pWaitSemaphores = &sync.imageAvailable[frame];
         submit.pWaitDstStageMask = &waitStage;
         submit.commandBufferCount = 1;
         submit.pCommandBuffers = &cmd;
         submit.signalSemaphoreCount = 1;
-        submit.pSignalSemaphores = &renderFinished;
+        submit.pSignalSemaphores = &sync.renderFinished[imageIndex];
 
-        vkQueueSubmit(graphicsQueue, 1, &submit, inFlight);
+        recordZone.End();
+        VgtTraceZone submitZone("submit");
+        vkQueueSubmit(graphicsQueue, 1, &submit, sync.inFlight[frame]);
+        submitZone.End();
+        VgtFrameStatsCpuEnd(frameStats);
+
+        res = VgtPresenterPresent(presenter, sync.renderFinished[imageIndex], imageIndex);
+        if (res != VK_SUCCESS)
+        {
+            std::fprintf(stderr, "VgtPresenterPresent failed: %d\n", res);
+            break;
+        }
 
-        VkPresentInfoKHR present{ VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
-        present.waitSemaphoreCount = 1;
-        present.pWaitSemaphores = &renderFinished;
-        present.swapchainCount = 1;
-        present.pSwapchains = &swapchain;
-        present.pImageIndices = &imageIndex;
-        vkQueuePresentKHR(presentQueue, &present);
+        VgtAdvanceFrame(sync);
+        VgtFrameStatsTick(frameStats);
+        VgtBenchmarkTick(bench, frameStats, gpuTimer);
+        VgtGpuTimerTick(gpuTimer);
     }
 
     vkDeviceWaitIdle(device);
+    VgtFrameStatsFinish(frameStats);
+    VgtGpuTimerFinish(gpuTimer);
+    VgtBenchmarkFinish(bench, gpuTimer);
+    VgtTraceStop();
 
-    vkDestroyFence(device, inFlight, nullptr);
-    vkDestroySemaphore(device, renderFinished, nullptr);
-    vkDestroySemaphore(device, imageAvailable, nullptr);
+    VgtDestroyFrameSync(device, sync);
+    VgtDestroyGpuTimer(gpuTimer);
 
-    vkFreeCommandBuffers(device, cmdPool, 1, &cmd);
+    vkFreeCommandBuffers(device, cmdPool, options.framesInFlight, cmdBuffers.data());
     vkDestroyCommandPool(device, cmdPool, nullptr);
 
-    vkDestroySwapchainKHR(device, swapchain, nullptr);
+    VgtPresenterDestroySwapchain(presenter);
     vkDestroyDevice(device, nullptr);
 
-    vkDestroySurfaceKHR(instance, surface, nullptr);
+    VgtPresenterDestroySurface(presenter);
 
 #if VGT_ENABLE_VALIDATION
     if (vkDestroyDebugUtilsMessengerEXT_ && debugMessenger)
@@ -425,8 +420,7 @@ int main()
 
     vkDestroyInstance(instance, nullptr);
 
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    VgtPresenterShutdown(presenter);
 
     return 0;
 }
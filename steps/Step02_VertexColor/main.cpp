@@ -6,12 +6,21 @@
 #include <fstream>
 #include <cstring>
 
-#include <Windows.h>
-
-#define GLFW_INCLUDE_VULKAN
-#include <GLFW/glfw3.h>
+#include <vulkan/vulkan.h>
 
 #include <VgtConfig.h>
+#include <VgtAllocator.h>
+#include <VgtBenchmark.h>
+#include <VgtFrameStats.h>
+#include <VgtFrameSync.h>
+#include <VgtGpuTimer.h>
+#include <VgtOptions.h>
+#include <VgtPipelineCache.h>
+#include <VgtPlatform.h>
+#include <VgtPresenter.h>
+#include <VgtSpirv.h>
+#include <VgtTrace.h>
+#include <VgtUpload.h>
 
 static void PrintVkResult(const char* what, VkResult res)
 {
@@ -22,8 +31,7 @@ static void PrintVkResult(const char* what, VkResult res)
 
 static void ShowFatal(const char* msg)
 {
-    std::fprintf(stderr, "%s\n", msg);
-    MessageBoxA(nullptr, msg, "Step02_VertexColor", MB_OK | MB_ICONERROR);
+    VgtShowError("Step02_VertexColor", msg);
 }
 
 struct Vertex
@@ -32,117 +40,29 @@ struct Vertex
     float color[3];
 };
 
-static std::vector<uint32_t> ReadSpirvFile(const char* path)
+int main(int argc, char** argv)
 {
-    std::ifstream file(path, std::ios::binary | std::ios::ate);
-    if (!file)
-        return {};
-
-    const std::streamsize size = file.tellg();
-    if (size <= 0)
-        return {};
-
-    std::vector<uint32_t> data(static_cast<size_t>(size / 4));
-    file.seekg(0);
-    file.read(reinterpret_cast<char*>(data.data()), size);
-    return data;
-}
-
-static std::vector<uint32_t> ReadSpirvWithFallback(const char* relativePath)
-{
-    // Try runtime layout first (when shaders are copied next to the exe).
-    {
-        auto data = ReadSpirvFile(relativePath);
-        if (!data.empty())
-            return data;
-    }
-
-    // Fallback: locate shader outputs relative to the executable.
-    // This handles cases where the working directory is not the exe directory.
-    {
-        char exePath[MAX_PATH] = {};
-        const DWORD len = GetModuleFileNameA(nullptr, exePath, MAX_PATH);
-        if (len > 0 && len < MAX_PATH)
-        {
-            std::string exeDir(exePath);
-            const size_t lastSlash = exeDir.find_last_of("\\/");
-            if (lastSlash != std::string::npos)
-                exeDir.resize(lastSlash + 1);
-
-            std::string fromExeDir = exeDir + std::string("compiled_shaders/") + relativePath;
-            {
-                auto data = ReadSpirvFile(fromExeDir.c_str());
-                if (!data.empty())
-                    return data;
-            }
-
-            // Common MSBuild layout: <target>/Debug/.. == <target>/
-            std::string exeParentDir = exeDir;
-            if (!exeParentDir.empty())
-            {
-                // remove trailing slash
-                while (!exeParentDir.empty() && (exeParentDir.back() == '\\' || exeParentDir.back() == '/'))
-                    exeParentDir.pop_back();
-                const size_t parentSlash = exeParentDir.find_last_of("\\/");
-                if (parentSlash != std::string::npos)
-                {
-                    exeParentDir.resize(parentSlash + 1);
-                    std::string fromExeParentDir = exeParentDir + std::string("compiled_shaders/") + relativePath;
-                    {
-                        auto data = ReadSpirvFile(fromExeParentDir.c_str());
-                        if (!data.empty())
-                            return data;
-                    }
-                }
-            }
-        }
-    }
-
-    // Fallback: run from build tree.
-    // e.g. build-ninja/.../steps/Step02_VertexColor/compiled_shaders
-    std::string alt = std::string("compiled_shaders/") + relativePath;
-    {
-        auto data = ReadSpirvFile(alt.c_str());
-        if (!data.empty())
-            return data;
-    }
-
-    return {};
-}
-
-static uint32_t FindMemoryTypeIndex(VkPhysicalDevice physicalDevice, uint32_t typeBits, VkMemoryPropertyFlags properties)
-{
-    VkPhysicalDeviceMemoryProperties memProps{};
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProps);
-
-    for (uint32_t i = 0; i < memProps.memoryTypeCount; ++i)
-    {
-        if ((typeBits & (1u << i)) && (memProps.memoryTypes[i].propertyFlags & properties) == properties)
-            return i;
-    }
-
-    return UINT32_MAX;
-}
-
-int main()
-{
-    bool pauseOnExit = false;
-    {
-        char* val = nullptr;
-        size_t len = 0;
-        if (_dupenv_s(&val, &len, "VGT_PAUSE_ON_EXIT") == 0 && val != nullptr)
-        {
-            pauseOnExit = true;
-            std::free(val);
-        }
-    }
-
-    if (!glfwInit())
-        return 1;
-
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-    GLFWwindow* window = glfwCreateWindow(1280, 720, "Step02_VertexColor", nullptr, nullptr);
-    if (!window)
+    const VgtOptions options = VgtParseOptions(argc, argv);
+    VgtTraceStart(options.tracePath.c_str(), "Step02_VertexColor");
+    VgtTraceZone initZone("init");
+    VgtBenchmark bench;
+    VgtBenchmarkBegin(bench, "Step02_VertexColor", options);
+
+    std::string pauseEnv;
+    const bool pauseOnExit = VgtGetEnv("VGT_PAUSE_ON_EXIT", pauseEnv);
+
+    // Window (or nothing, when rendering headless)
+    VgtPresenterCreateInfo presenterCI{};
+    presenterCI.title = "Step02_VertexColor";
+    presenterCI.backend = options.backend;
+    presenterCI.frameLimit = options.frameLimit;
+    presenterCI.presentMode = options.presentMode;
+    presenterCI.swapchainImages = options.swapchainImages;
+    presenterCI.framesInFlight = options.framesInFlight;
+    presenterCI.measureLatency = options.latency;
+
+    VgtPresenter presenter;
+    if (!VgtPresenterInit(presenterCI, presenter))
         return 1;
 
     // Instance
@@ -150,9 +70,8 @@ int main()
     appInfo.pApplicationName = "vulkan-glsl-tutorial";
     appInfo.apiVersion = VK_API_VERSION_1_3;
 
-    uint32_t glfwExtCount = 0;
-    const char** glfwExts = glfwGetRequiredInstanceExtensions(&glfwExtCount);
-    std::vector<const char*> instanceExts(glfwExts, glfwExts + glfwExtCount);
+    std::vector<const char*> instanceExts;
+    VgtPresenterGetInstanceExtensions(presenter, instanceExts);
 
     std::vector<const char*> layers;
 #if VGT_ENABLE_VALIDATION
@@ -169,6 +88,7 @@ int main()
 
     VkInstance instance = VK_NULL_HANDLE;
     {
+        VGT_TRACE_ZONE("instance creation");
         const VkResult res = vkCreateInstance(&instanceCI, nullptr, &instance);
         if (res != VK_SUCCESS)
         {
@@ -180,14 +100,13 @@ int main()
         }
     }
 
-    // Surface
-    VkSurfaceKHR surface = VK_NULL_HANDLE;
+    // Surface (none when rendering offscreen)
     {
-        const VkResult res = glfwCreateWindowSurface(instance, window, nullptr, &surface);
+        const VkResult res = VgtPresenterCreateSurface(presenter, instance);
         if (res != VK_SUCCESS)
         {
-            PrintVkResult("glfwCreateWindowSurface", res);
-            ShowFatal("glfwCreateWindowSurface failed");
+            PrintVkResult("VgtPresenterCreateSurface", res);
+            ShowFatal("Surface creation failed");
             if (pauseOnExit)
                 (void)std::getchar();
             return 1;
@@ -214,12 +133,13 @@ int main()
         if ((qProps[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) && graphicsQ == UINT32_MAX)
             graphicsQ = i;
 
-        VkBool32 presentSupport = VK_FALSE;
-        vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentSupport);
-        if (presentSupport && presentQ == UINT32_MAX)
+        if (VgtPresenterSupportsPresent(presenter, physicalDevice, i) && presentQ == UINT32_MAX)
             presentQ = i;
     }
 
+    // Dedicated copy queue for static uploads (see VgtUpload.h), when the device has one.
+    const uint32_t transferQ = VgtFindTransferQueueFamily(physicalDevice);
+
     float qPriority = 1.0f;
     std::vector<VkDeviceQueueCreateInfo> queueCIs;
     {
@@ -237,18 +157,32 @@ int main()
             pqci.pQueuePriorities = &qPriority;
             queueCIs.push_back(pqci);
         }
+
+        if (transferQ != UINT32_MAX && transferQ != graphicsQ && transferQ != presentQ)
+        {
+            VkDeviceQueueCreateInfo tqci{ VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
+            tqci.queueFamilyIndex = transferQ;
+            tqci.queueCount = 1;
+            tqci.pQueuePriorities = &qPriority;
+            queueCIs.push_back(tqci);
+        }
     }
 
-    const char* deviceExts[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+    std::vector<const char*> deviceExts;
+    VgtPresenterGetDeviceExtensions(presenter, deviceExts);
 
     VkDeviceCreateInfo deviceCI{ VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
     deviceCI.queueCreateInfoCount = static_cast<uint32_t>(queueCIs.size());
     deviceCI.pQueueCreateInfos = queueCIs.data();
-    deviceCI.enabledExtensionCount = 1;
-    deviceCI.ppEnabledExtensionNames = deviceExts;
+    deviceCI.enabledExtensionCount = static_cast<uint32_t>(deviceExts.size());
+    deviceCI.ppEnabledExtensionNames = deviceExts.empty() ? nullptr : deviceExts.data();
+
+    // --latency: present id / present wait for input-to-photon timing, when supported.
+    VgtPresenterEnableDeviceFeatures(presenter, physicalDevice, deviceExts, deviceCI);
 
     VkDevice device = VK_NULL_HANDLE;
     {
+        VGT_TRACE_ZONE("device creation");
         const VkResult res = vkCreateDevice(physicalDevice, &deviceCI, nullptr, &device);
         if (res != VK_SUCCESS)
         {
@@ -261,98 +195,61 @@ int main()
     }
 
     VkQueue graphicsQueue = VK_NULL_HANDLE;
-    VkQueue presentQueue = VK_NULL_HANDLE;
     vkGetDeviceQueue(device, graphicsQ, 0, &graphicsQueue);
-    vkGetDeviceQueue(device, presentQ, 0, &presentQueue);
 
-    // Swapchain
-    VkSurfaceCapabilitiesKHR caps{};
-    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, surface, &caps);
+    // Device memory: buffers and images are sub-allocated from large per-memory-type blocks.
+    VgtAllocatorCreateInfo allocatorCI{};
+    allocatorCI.physicalDevice = physicalDevice;
+    allocatorCI.device = device;
+
+    VgtAllocator allocator;
+    VgtCreateAllocator(allocatorCI, allocator);
 
-    uint32_t formatCount = 0;
-    vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, nullptr);
-    std::vector<VkSurfaceFormatKHR> formats(formatCount);
-    vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, formats.data());
+    // Static geometry goes to DEVICE_LOCAL memory through staging copies.
+    VgtUploadContextCreateInfo uploadCI{};
+    uploadCI.device = device;
+    uploadCI.allocator = &allocator;
+    uploadCI.graphicsQueueFamily = graphicsQ;
+    uploadCI.transferQueueFamily = transferQ;
 
-    VkSurfaceFormatKHR surfaceFormat = formats[0];
-    for (const auto& f : formats)
+    VgtUploadContext upload;
     {
-        if (f.format == VK_FORMAT_B8G8R8A8_UNORM && f.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+        const VkResult res = VgtCreateUploadContext(uploadCI, upload);
+        if (res != VK_SUCCESS)
         {
-            surfaceFormat = f;
-            break;
+            PrintVkResult("VgtCreateUploadContext", res);
+            return 1;
         }
     }
 
-    VkExtent2D extent = caps.currentExtent;
-    if (extent.width == UINT32_MAX)
-    {
-        int w = 0, h = 0;
-        glfwGetFramebufferSize(window, &w, &h);
-        extent.width = static_cast<uint32_t>(w);
-        extent.height = static_cast<uint32_t>(h);
-    }
-
-    VkSwapchainCreateInfoKHR swapCI{ VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR };
-    swapCI.surface = surface;
-    swapCI.minImageCount = caps.minImageCount + 1;
-    swapCI.imageFormat = surfaceFormat.format;
-    swapCI.imageColorSpace = surfaceFormat.colorSpace;
-    swapCI.imageExtent = extent;
-    swapCI.imageArrayLayers = 1;
-    swapCI.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-    swapCI.preTransform = caps.currentTransform;
-    swapCI.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-    swapCI.presentMode = VK_PRESENT_MODE_FIFO_KHR;
-    swapCI.clipped = VK_TRUE;
-
-    uint32_t qIndices[] = { graphicsQ, presentQ };
-    if (graphicsQ != presentQ)
-    {
-        swapCI.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
-        swapCI.queueFamilyIndexCount = 2;
-        swapCI.pQueueFamilyIndices = qIndices;
-    }
-
-    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+    // Swapchain (offscreen images when headless)
+    VgtSwapchainDesc swapDesc{};
+    swapDesc.graphicsQueueFamily = graphicsQ;
+    swapDesc.presentQueueFamily = presentQ;
     {
-        const VkResult res = vkCreateSwapchainKHR(device, &swapCI, nullptr, &swapchain);
+        const VkResult res = VgtPresenterCreateSwapchain(presenter, physicalDevice, device, swapDesc);
         if (res != VK_SUCCESS)
         {
-            PrintVkResult("vkCreateSwapchainKHR", res);
-            ShowFatal("vkCreateSwapchainKHR failed");
+            PrintVkResult("VgtPresenterCreateSwapchain", res);
+            ShowFatal("Swapchain creation failed");
             if (pauseOnExit)
                 (void)std::getchar();
             return 1;
         }
     }
 
-    uint32_t swapImageCount = 0;
-    vkGetSwapchainImagesKHR(device, swapchain, &swapImageCount, nullptr);
-    std::vector<VkImage> swapImages(swapImageCount);
-    vkGetSwapchainImagesKHR(device, swapchain, &swapImageCount, swapImages.data());
-
-    std::vector<VkImageView> swapImageViews(swapImageCount);
-    for (uint32_t i = 0; i < swapImageCount; ++i)
-    {
-        VkImageViewCreateInfo viewCI{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
-        viewCI.image = swapImages[i];
-        viewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        viewCI.format = surfaceFormat.format;
-        viewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        viewCI.subresourceRange.levelCount = 1;
-        viewCI.subresourceRange.layerCount = 1;
-        vkCreateImageView(device, &viewCI, nullptr, &swapImageViews[i]);
-    }
+    // References: both change when the swapchain is recreated.
+    const VkExtent2D& extent = presenter.extent;
+    const std::vector<VkImage>& swapImages = presenter.images;
 
     // Render pass
     VkAttachmentDescription colorAttachment{};
-    colorAttachment.format = surfaceFormat.format;
+    colorAttachment.format = presenter.format;
     colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
     colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    colorAttachment.finalLayout = presenter.presentLayout;
 
     VkAttachmentReference colorRef{};
     colorRef.attachment = 0;
@@ -372,20 +269,37 @@ int main()
     VkRenderPass renderPass = VK_NULL_HANDLE;
     vkCreateRenderPass(device, &rpCI, nullptr, &renderPass);
 
-    // Framebuffers
-    std::vector<VkFramebuffer> framebuffers(swapImageCount);
-    for (uint32_t i = 0; i < swapImageCount; ++i)
+    // Image views and framebuffers, one per swapchain image; rebuilt by recreateSwapchain below.
+    std::vector<VkImageView> swapImageViews;
+    std::vector<VkFramebuffer> framebuffers;
+    auto createSwapchainTargets = [&]()
     {
-        VkImageView attachments[] = { swapImageViews[i] };
-        VkFramebufferCreateInfo fbCI{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
-        fbCI.renderPass = renderPass;
-        fbCI.attachmentCount = 1;
-        fbCI.pAttachments = attachments;
-        fbCI.width = extent.width;
-        fbCI.height = extent.height;
-        fbCI.layers = 1;
-        vkCreateFramebuffer(device, &fbCI, nullptr, &framebuffers[i]);
-    }
+        const uint32_t imageCount = static_cast<uint32_t>(swapImages.size());
+        swapImageViews.assign(imageCount, VK_NULL_HANDLE);
+        framebuffers.assign(imageCount, VK_NULL_HANDLE);
+        for (uint32_t i = 0; i < imageCount; ++i)
+        {
+            VkImageViewCreateInfo viewCI{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+            viewCI.image = swapImages[i];
+            viewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewCI.format = presenter.format;
+            viewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            viewCI.subresourceRange.levelCount = 1;
+            viewCI.subresourceRange.layerCount = 1;
+            vkCreateImageView(device, &viewCI, nullptr, &swapImageViews[i]);
+
+            VkImageView attachments[] = { swapImageViews[i] };
+            VkFramebufferCreateInfo fbCI{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
+            fbCI.renderPass = renderPass;
+            fbCI.attachmentCount = 1;
+            fbCI.pAttachments = attachments;
+            fbCI.width = extent.width;
+            fbCI.height = extent.height;
+            fbCI.layers = 1;
+            vkCreateFramebuffer(device, &fbCI, nullptr, &framebuffers[i]);
+        }
+    };
+    createSwapchainTargets();
 
     // Vertex buffer
     Vertex vertices[3] = {
@@ -394,34 +308,18 @@ int main()
         { {-0.5f,  0.5f }, { 0.0f, 0.0f, 1.0f } },
     };
 
-    VkBufferCreateInfo bufCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-    bufCI.size = sizeof(vertices);
-    bufCI.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-    bufCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
     VkBuffer vertexBuffer = VK_NULL_HANDLE;
-    vkCreateBuffer(device, &bufCI, nullptr, &vertexBuffer);
-
-    VkMemoryRequirements memReq{};
-    vkGetBufferMemoryRequirements(device, vertexBuffer, &memReq);
-
-    uint32_t memType = FindMemoryTypeIndex(
-        physicalDevice,
-        memReq.memoryTypeBits,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-    VkMemoryAllocateInfo alloc{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-    alloc.allocationSize = memReq.size;
-    alloc.memoryTypeIndex = memType;
-
-    VkDeviceMemory vertexMem = VK_NULL_HANDLE;
-    vkAllocateMemory(device, &alloc, nullptr, &vertexMem);
-    vkBindBufferMemory(device, vertexBuffer, vertexMem, 0);
-
-    void* mapped = nullptr;
-    vkMapMemory(device, vertexMem, 0, sizeof(vertices), 0, &mapped);
-    std::memcpy(mapped, vertices, sizeof(vertices));
-    vkUnmapMemory(device, vertexMem);
+    VgtAllocation vertexAlloc;
+    {
+        VkResult res = VgtUploadBuffer(upload, vertices, sizeof(vertices), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer, vertexAlloc);
+        if (res == VK_SUCCESS)
+            res = VgtFlushUploads(upload);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("Vertex buffer upload", res);
+            return 1;
+        }
+    }
 
     // Pipeline layout
     VkPipelineLayoutCreateInfo plCI{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
@@ -429,8 +327,8 @@ int main()
     vkCreatePipelineLayout(device, &plCI, nullptr, &pipelineLayout);
 
     // Shader modules
-    const auto vertSpv = ReadSpirvWithFallback("vertex_color.vert.spv");
-    const auto fragSpv = ReadSpirvWithFallback("vertex_color.frag.spv");
+    const auto vertSpv = VgtLoadSpirv("vertex_color.vert.spv", options.shadersFromDisk);
+    const auto fragSpv = VgtLoadSpirv("vertex_color.frag.spv", options.shadersFromDisk);
     if (vertSpv.empty() || fragSpv.empty())
     {
         ShowFatal("Failed to load shaders. Did you build the project (which runs glslangValidator)?");
@@ -542,8 +440,21 @@ int main()
     gpCI.layout = pipelineLayout;
     gpCI.renderPass = renderPass;
 
+    // Pipeline cache persisted next to the exe: the first run compiles (cold), later runs reuse it (warm).
+    VgtPipelineCache pipelineCache;
+    {
+        const VkResult res = VgtCreatePipelineCache(physicalDevice, device, "Step02_VertexColor", options.pipelineCache, pipelineCache);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtCreatePipelineCache", res);
+            return 1;
+        }
+    }
+
     VkPipeline pipeline = VK_NULL_HANDLE;
-    vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &gpCI, nullptr, &pipeline);
+    VgtCreateGraphicsPipelines(device, pipelineCache, 1, &gpCI, &pipeline);
+    if (options.showFps || options.benchmark)
+        VgtPrintPipelineCacheStats("Step02_VertexColor", pipelineCache);
 
     // Command pool / buffers
     VkCommandPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
@@ -553,46 +464,48 @@ int main()
     VkCommandPool cmdPool = VK_NULL_HANDLE;
     vkCreateCommandPool(device, &poolCI, nullptr, &cmdPool);
 
-    std::vector<VkCommandBuffer> cmdBuffers(swapImageCount);
+    // One command buffer per frame in flight; the frame fence guards its reuse.
+    std::vector<VkCommandBuffer> cmdBuffers(options.framesInFlight);
     VkCommandBufferAllocateInfo cmdAI{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
     cmdAI.commandPool = cmdPool;
     cmdAI.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    cmdAI.commandBufferCount = swapImageCount;
+    cmdAI.commandBufferCount = options.framesInFlight;
     vkAllocateCommandBuffers(device, &cmdAI, cmdBuffers.data());
 
-    VkSemaphoreCreateInfo semCI{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
-    VkFenceCreateInfo fenceCI{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
-    fenceCI.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-    VkSemaphore imageAvailable = VK_NULL_HANDLE;
-    VkSemaphore renderFinished = VK_NULL_HANDLE;
-    VkFence inFlight = VK_NULL_HANDLE;
-    vkCreateSemaphore(device, &semCI, nullptr, &imageAvailable);
-    vkCreateSemaphore(device, &semCI, nullptr, &renderFinished);
-    vkCreateFence(device, &fenceCI, nullptr, &inFlight);
-
-    while (!glfwWindowShouldClose(window))
+    // Sync primitives: per frame in flight (fence + imageAvailable) and per swapchain image (renderFinished).
+    VgtFrameSync sync;
     {
-        glfwPollEvents();
-
-        vkWaitForFences(device, 1, &inFlight, VK_TRUE, UINT64_MAX);
-        vkResetFences(device, 1, &inFlight);
-
-        uint32_t imageIndex = 0;
+        const VkResult res = VgtCreateFrameSync(device, options.framesInFlight, static_cast<uint32_t>(swapImages.size()), sync);
+        if (res != VK_SUCCESS)
         {
-            const VkResult res = vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, imageAvailable, VK_NULL_HANDLE, &imageIndex);
-            if (res != VK_SUCCESS)
-            {
-                PrintVkResult("vkAcquireNextImageKHR", res);
-                break;
-            }
+            PrintVkResult("VgtCreateFrameSync", res);
+            return 1;
         }
+    }
 
-        VkCommandBuffer cmd = cmdBuffers[imageIndex];
-        vkResetCommandBuffer(cmd, 0);
-
+    // GPU timestamps (--gpu-timing): one query range per frame in flight.
+    // Pre-recorded static command buffers are not timed (their slot is not known when recording).
+    VgtGpuTimerCreateInfo gpuTimerCI{};
+    gpuTimerCI.physicalDevice = physicalDevice;
+    gpuTimerCI.device = device;
+    gpuTimerCI.queueFamily = graphicsQ;
+    gpuTimerCI.slotCount = options.framesInFlight;
+    gpuTimerCI.label = "Step02_VertexColor";
+    gpuTimerCI.enabled = options.gpuTiming && !options.staticCommandBuffers;
+    gpuTimerCI.csvPath = options.gpuTimingCsv.c_str();
+
+    VgtGpuTimer gpuTimer;
+    VgtCreateGpuTimer(gpuTimerCI, gpuTimer);
+    const uint32_t gpuFrameScope = VgtGpuTimerScope(gpuTimer, "frame");
+    const uint32_t gpuRenderPassScope = VgtGpuTimerScope(gpuTimer, "render_pass");
+
+    // Records the whole frame for swapchain image `imageIndex` into `cmd`.
+    auto recordFrame = [&](VkCommandBuffer cmd, uint32_t imageIndex) -> VkResult
+    {
         VkCommandBufferBeginInfo begin{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
         vkBeginCommandBuffer(cmd, &begin);
+        VgtGpuTimerBeginFrame(gpuTimer, cmd, sync.currentFrame);
+        VgtGpuTimerBegin(gpuTimer, cmd, gpuFrameScope);
 
         VkClearValue clear{};
         clear.color.float32[0] = 0.02f;
@@ -608,6 +521,7 @@ int main()
         rpBegin.clearValueCount = 1;
         rpBegin.pClearValues = &clear;
 
+        VgtGpuTimerBegin(gpuTimer, cmd, gpuRenderPassScope);
         vkCmdBeginRenderPass(cmd, &rpBegin, VK_SUBPASS_CONTENTS_INLINE);
 
         VkViewport drawViewport{};
@@ -631,47 +545,169 @@ int main()
         vkCmdDraw(cmd, 3, 1, 0, 0);
 
         vkCmdEndRenderPass(cmd);
-        vkEndCommandBuffer(cmd);
+        VgtGpuTimerEnd(gpuTimer, cmd, gpuRenderPassScope);
+        VgtGpuTimerEnd(gpuTimer, cmd, gpuFrameScope);
+        return vkEndCommandBuffer(cmd);
+    };
+
+    // --static-command-buffers: nothing in the frame changes, so record one command buffer per
+    // swapchain image up front and just resubmit it. Re-recorded when the swapchain is recreated.
+    std::vector<VkCommandBuffer> staticCmdBuffers;
+    auto recordStaticCommandBuffers = [&]() -> VkResult
+    {
+        const uint32_t imageCount = static_cast<uint32_t>(swapImages.size());
+        staticCmdBuffers.resize(imageCount);
+        VkCommandBufferAllocateInfo staticAI = cmdAI;
+        staticAI.commandBufferCount = imageCount;
+        VkResult res = vkAllocateCommandBuffers(device, &staticAI, staticCmdBuffers.data());
+        for (uint32_t i = 0; res == VK_SUCCESS && i < imageCount; ++i)
+            res = recordFrame(staticCmdBuffers[i], i);
+        if (res != VK_SUCCESS)
+            PrintVkResult("recordFrame (static)", res);
+        return res;
+    };
+    if (options.staticCommandBuffers && recordStaticCommandBuffers() != VK_SUCCESS)
+        return 1;
+
+    // Resize / out of date: the old swapchain and everything built on its images are retired to
+    // `sync` and destroyed as the frames in flight finish, without idling the device. The render
+    // pass, pipeline and vertex buffer do not depend on the extent and are kept.
+    auto recreateSwapchain = [&]() -> VkResult
+    {
+        const VkResult res = VgtRecreateSwapchain(presenter, sync);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtRecreateSwapchain", res);
+            return res;
+        }
+
+        VgtRetire(sync, [device, views = std::move(swapImageViews), fbs = std::move(framebuffers)]() {
+            for (auto fb : fbs)
+                vkDestroyFramebuffer(device, fb, nullptr);
+            for (auto v : views)
+                vkDestroyImageView(device, v, nullptr);
+        });
+        createSwapchainTargets();
+        if (staticCmdBuffers.empty())
+            return VK_SUCCESS;
+
+        VgtRetire(sync, [device, cmdPool, cmds = std::move(staticCmdBuffers)]() {
+            vkFreeCommandBuffers(device, cmdPool, static_cast<uint32_t>(cmds.size()), cmds.data());
+        });
+        return recordStaticCommandBuffers();
+    };
+
+    VgtFrameStats frameStats;
+    VgtFrameStatsBegin(frameStats, "Step02_VertexColor", options.showFps);
+
+    VgtBenchmarkPhase(bench, "pipeline", pipelineCache.creationMs);
+    VgtBenchmarkPhase(bench, "upload", upload.uploadMs);
+    initZone.End();
+    VgtBenchmarkBeginFrames(bench, presenter);
+
+    while (VgtPresenterRunning(presenter))
+    {
+        VGT_TRACE_ZONE("frame");
+        // Wait until this frame slot's previous submission retired before touching its resources.
+        const uint32_t frame = sync.currentFrame;
+        VgtWaitForFrame(device, sync);
+
+        if (presenter.needsRecreate && recreateSwapchain() != VK_SUCCESS)
+            break;
+
+        uint32_t imageIndex = 0;
+        {
+            const VkResult res = VgtPresenterAcquire(presenter, sync.imageAvailable[frame], imageIndex);
+            if (res == VK_ERROR_OUT_OF_DATE_KHR)
+                continue; // nothing acquired; recreated at the top of the next iteration
+            if (res != VK_SUCCESS)
+            {
+                PrintVkResult("VgtPresenterAcquire", res);
+                break;
+            }
+        }
+
+        VgtClaimImage(device, sync, imageIndex);
+
+        // Static mode resubmits the image's pre-recorded buffer; otherwise re-record this slot's buffer.
+        VgtFrameStatsCpuBegin(frameStats);
+        VgtTraceZone recordZone("record");
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        if (options.staticCommandBuffers)
+        {
+            cmd = staticCmdBuffers[imageIndex];
+        }
+        else
+        {
+            cmd = cmdBuffers[frame];
+            vkResetCommandBuffer(cmd, 0);
+            const VkResult res = recordFrame(cmd, imageIndex);
+            if (res != VK_SUCCESS)
+            {
+                PrintVkResult("recordFrame", res);
+                break;
+            }
+        }
 
         VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
         VkSubmitInfo submit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
         submit.waitSemaphoreCount = 1;
-        submit.pWaitSemaphores = &imageAvailable;
+        submit.pWaitSemaphores = &sync.imageAvailable[frame];
         submit.pWaitDstStageMask = &waitStage;
         submit.commandBufferCount = 1;
         submit.pCommandBuffers = &cmd;
         submit.signalSemaphoreCount = 1;
-        submit.pSignalSemaphores = &renderFinished;
+        submit.pSignalSemaphores = &sync.renderFinished[imageIndex];
 
-        vkQueueSubmit(graphicsQueue, 1, &submit, inFlight);
+        recordZone.End();
+        VgtTraceZone submitZone("submit");
+        vkQueueSubmit(graphicsQueue, 1, &submit, sync.inFlight[frame]);
+        submitZone.End();
 
-        VkPresentInfoKHR present{ VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
-        present.waitSemaphoreCount = 1;
-        present.pWaitSemaphores = &renderFinished;
-        present.swapchainCount = 1;
-        present.pSwapchains = &swapchain;
-        present.pImageIndices = &imageIndex;
-        vkQueuePresentKHR(presentQueue, &present);
+        VgtFrameStatsCpuEnd(frameStats);
 
-        vkQueueWaitIdle(presentQueue);
+        {
+            const VkResult res = VgtPresenterPresent(presenter, sync.renderFinished[imageIndex], imageIndex);
+            if (res != VK_SUCCESS)
+            {
+                PrintVkResult("VgtPresenterPresent", res);
+                break;
+            }
+        }
+
+        VgtAdvanceFrame(sync);
+        // --memory-stats: once everything is live (a streamed texture may still be on its way).
+        if (options.memoryStats && presenter.framesPresented == 1)
+            VgtPrintAllocatorStats("Step02_VertexColor", VgtGetAllocatorStats(allocator), "first frame");
+        VgtFrameStatsTick(frameStats);
+        VgtBenchmarkTick(bench, frameStats, gpuTimer);
+        VgtGpuTimerTick(gpuTimer);
     }
 
     vkDeviceWaitIdle(device);
-
-    vkDestroyFence(device, inFlight, nullptr);
-    vkDestroySemaphore(device, renderFinished, nullptr);
-    vkDestroySemaphore(device, imageAvailable, nullptr);
-
-    vkFreeCommandBuffers(device, cmdPool, swapImageCount, cmdBuffers.data());
+    if (options.memoryStats)
+        VgtPrintAllocatorStats("Step02_VertexColor", VgtGetAllocatorStats(allocator), "before teardown");
+    VgtFrameStatsFinish(frameStats);
+    VgtGpuTimerFinish(gpuTimer);
+    VgtBenchmarkFinish(bench, gpuTimer);
+    VgtTraceStop();
+
+    VgtDestroyFrameSync(device, sync);
+    VgtDestroyGpuTimer(gpuTimer);
+
+    vkFreeCommandBuffers(device, cmdPool, options.framesInFlight, cmdBuffers.data());
+    if (!staticCmdBuffers.empty())
+        vkFreeCommandBuffers(device, cmdPool, static_cast<uint32_t>(staticCmdBuffers.size()), staticCmdBuffers.data());
     vkDestroyCommandPool(device, cmdPool, nullptr);
 
     vkDestroyPipeline(device, pipeline, nullptr);
+    VgtDestroyPipelineCache(device, pipelineCache);
     vkDestroyShaderModule(device, fragModule, nullptr);
     vkDestroyShaderModule(device, vertModule, nullptr);
     vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
 
-    vkDestroyBuffer(device, vertexBuffer, nullptr);
-    vkFreeMemory(device, vertexMem, nullptr);
+    VgtDestroyBuffer(allocator, vertexBuffer, vertexAlloc);
+    VgtDestroyUploadContext(upload);
 
     for (auto fb : framebuffers)
         vkDestroyFramebuffer(device, fb, nullptr);
@@ -681,15 +717,16 @@ int main()
     for (auto v : swapImageViews)
         vkDestroyImageView(device, v, nullptr);
 
-    vkDestroySwapchainKHR(device, swapchain, nullptr);
+    VgtPresenterDestroySwapchain(presenter);
+    VgtDestroyAllocator(allocator);
+
     vkDestroyDevice(device, nullptr);
 
-    vkDestroySurfaceKHR(instance, surface, nullptr);
+    VgtPresenterDestroySurface(presenter);
 
     vkDestroyInstance(instance, nullptr);
 
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    VgtPresenterShutdown(presenter);
 
     if (pauseOnExit)
     {
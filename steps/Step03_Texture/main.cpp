@@ -6,15 +6,24 @@
 #include <fstream>
 #include <cstring>
 
-#include <Windows.h>
-
-#define GLFW_INCLUDE_VULKAN
-#include <GLFW/glfw3.h>
-
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+#include <vulkan/vulkan.h>
 
 #include <VgtConfig.h>
+#include <VgtAllocator.h>
+#include <VgtAssetPack.h>
+#include <VgtBenchmark.h>
+#include <VgtFrameStats.h>
+#include <VgtFrameSync.h>
+#include <VgtGpuTimer.h>
+#include <VgtOptions.h>
+#include <VgtPipelineCache.h>
+#include <VgtPlatform.h>
+#include <VgtPresenter.h>
+#include <VgtSpirv.h>
+#include <VgtTaskGraph.h>
+#include <VgtTextureStreamer.h>
+#include <VgtTrace.h>
+#include <VgtUpload.h>
 
 static void PrintVkResult(const char* what, VkResult res)
 {
@@ -25,8 +34,7 @@ static void PrintVkResult(const char* what, VkResult res)
 
 static void ShowFatal(const char* msg)
 {
-    std::fprintf(stderr, "%s\n", msg);
-    MessageBoxA(nullptr, msg, "Step03_Texture", MB_OK | MB_ICONERROR);
+    VgtShowError("Step03_Texture", msg);
 }
 
 struct Vertex
@@ -35,161 +43,40 @@ struct Vertex
     float uv[2];
 };
 
-static std::vector<uint32_t> ReadSpirvFile(const char* path)
-{
-    std::ifstream file(path, std::ios::binary | std::ios::ate);
-    if (!file)
-        return {};
-
-    const std::streamsize size = file.tellg();
-    if (size <= 0)
-        return {};
-
-    std::vector<uint32_t> data(static_cast<size_t>(size / 4));
-    file.seekg(0);
-    file.read(reinterpret_cast<char*>(data.data()), size);
-    return data;
-}
-
-static std::vector<uint32_t> ReadSpirvWithFallback(const char* relativePath)
-{
-    // Try runtime layout first (when shaders are copied next to the exe).
-    {
-        auto data = ReadSpirvFile(relativePath);
-        if (!data.empty())
-            return data;
-    }
-
-    // Fallback: locate shader outputs relative to the executable.
-    // This handles cases where the working directory is not the exe directory.
-    {
-        char exePath[MAX_PATH] = {};
-        const DWORD len = GetModuleFileNameA(nullptr, exePath, MAX_PATH);
-        if (len > 0 && len < MAX_PATH)
-        {
-            std::string exeDir(exePath);
-            const size_t lastSlash = exeDir.find_last_of("\\/");
-            if (lastSlash != std::string::npos)
-                exeDir.resize(lastSlash + 1);
-
-            std::string fromExeDir = exeDir + std::string("compiled_shaders/") + relativePath;
-            {
-                auto data = ReadSpirvFile(fromExeDir.c_str());
-                if (!data.empty())
-                    return data;
-            }
-
-            // Common MSBuild layout: <target>/Debug/.. == <target>/
-            std::string exeParentDir = exeDir;
-            if (!exeParentDir.empty())
-            {
-                // remove trailing slash
-                while (!exeParentDir.empty() && (exeParentDir.back() == '\\' || exeParentDir.back() == '/'))
-                    exeParentDir.pop_back();
-                const size_t parentSlash = exeParentDir.find_last_of("\\/");
-                if (parentSlash != std::string::npos)
-                {
-                    exeParentDir.resize(parentSlash + 1);
-                    std::string fromExeParentDir = exeParentDir + std::string("compiled_shaders/") + relativePath;
-                    {
-                        auto data = ReadSpirvFile(fromExeParentDir.c_str());
-                        if (!data.empty())
-                            return data;
-                    }
-                }
-            }
-        }
-    }
-
-    // Fallback: run from build tree.
-    // e.g. build-ninja/.../steps/Step03_Texture/compiled_shaders
-    std::string alt = std::string("compiled_shaders/") + relativePath;
-    {
-        auto data = ReadSpirvFile(alt.c_str());
-        if (!data.empty())
-            return data;
-    }
-
-    return {};
-}
-
-static stbi_uc* LoadTextureWithFallback(const char* relativePath, int* width, int* height, int* channels)
-{
-    // Try direct path first
-    stbi_uc* pixels = stbi_load(relativePath, width, height, channels, STBI_rgb_alpha);
-    if (pixels)
-        return pixels;
-
-    // Fallback: locate texture relative to the executable
-    char exePath[MAX_PATH] = {};
-    const DWORD len = GetModuleFileNameA(nullptr, exePath, MAX_PATH);
-    if (len > 0 && len < MAX_PATH)
-    {
-        std::string exeDir(exePath);
-        const size_t lastSlash = exeDir.find_last_of("\\/");
-        if (lastSlash != std::string::npos)
-            exeDir.resize(lastSlash + 1);
-
-        std::string fromExeDir = exeDir + relativePath;
-        pixels = stbi_load(fromExeDir.c_str(), width, height, channels, STBI_rgb_alpha);
-        if (pixels)
-            return pixels;
-
-        // Common MSBuild layout: <target>/Debug/.. == <target>/
-        std::string exeParentDir = exeDir;
-        if (!exeParentDir.empty())
-        {
-            // remove trailing slash
-            while (!exeParentDir.empty() && (exeParentDir.back() == '\\' || exeParentDir.back() == '/'))
-                exeParentDir.pop_back();
-            const size_t parentSlash = exeParentDir.find_last_of("\\/");
-            if (parentSlash != std::string::npos)
-            {
-                exeParentDir.resize(parentSlash + 1);
-                std::string fromExeParentDir = exeParentDir + relativePath;
-                pixels = stbi_load(fromExeParentDir.c_str(), width, height, channels, STBI_rgb_alpha);
-                if (pixels)
-                    return pixels;
-            }
-        }
-    }
-
-    return nullptr;
-}
-
-static uint32_t FindMemoryTypeIndex(VkPhysicalDevice physicalDevice, uint32_t typeBits, VkMemoryPropertyFlags properties)
+int main(int argc, char** argv)
 {
-    VkPhysicalDeviceMemoryProperties memProps{};
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProps);
-
-    for (uint32_t i = 0; i < memProps.memoryTypeCount; ++i)
+    // Time to first frame is measured from here, see the end of the first frame.
+    const double launchTime = VgtGetTimeSeconds();
+    const VgtOptions options = VgtParseOptions(argc, argv);
+    VgtTraceStart(options.tracePath.c_str(), "Step03_Texture");
+    VgtTraceZone initZone("init");
+    VgtBenchmark bench;
+    VgtBenchmarkBegin(bench, "Step03_Texture", options);
+
+    std::string pauseEnv;
+    const bool pauseOnExit = VgtGetEnv("VGT_PAUSE_ON_EXIT", pauseEnv);
+
+    // Shaders and textures come from the mapped pack when the build wrote one, else from loose files.
+    VgtAssetPack assetPack;
+    if (VgtOpenAssetPack("Step03_Texture.vgtpack", assetPack))
     {
-        if ((typeBits & (1u << i)) && (memProps.memoryTypes[i].propertyFlags & properties) == properties)
-            return i;
+        VgtMountAssetPack(&assetPack);
+        if (options.showFps || options.benchmark)
+            std::fprintf(stderr, "[Step03_Texture] asset pack: %s (%u entries)\n", assetPack.path.c_str(), assetPack.entryCount);
     }
 
-    return UINT32_MAX;
-}
-
-int main()
-{
-    bool pauseOnExit = false;
-    {
-        char* val = nullptr;
-        size_t len = 0;
-        if (_dupenv_s(&val, &len, "VGT_PAUSE_ON_EXIT") == 0 && val != nullptr)
-        {
-            pauseOnExit = true;
-            std::free(val);
-        }
-    }
-
-    if (!glfwInit())
-        return 1;
-
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-    GLFWwindow* window = glfwCreateWindow(1280, 720, "Step03_Texture", nullptr, nullptr);
-    if (!window)
+    // Window (or nothing, when rendering headless)
+    VgtPresenterCreateInfo presenterCI{};
+    presenterCI.title = "Step03_Texture";
+    presenterCI.backend = options.backend;
+    presenterCI.frameLimit = options.frameLimit;
+    presenterCI.presentMode = options.presentMode;
+    presenterCI.swapchainImages = options.swapchainImages;
+    presenterCI.framesInFlight = options.framesInFlight;
+    presenterCI.measureLatency = options.latency;
+
+    VgtPresenter presenter;
+    if (!VgtPresenterInit(presenterCI, presenter))
         return 1;
 
     // Instance
@@ -197,9 +84,8 @@ int main()
     appInfo.pApplicationName = "vulkan-glsl-tutorial";
     appInfo.apiVersion = VK_API_VERSION_1_3;
 
-    uint32_t glfwExtCount = 0;
-    const char** glfwExts = glfwGetRequiredInstanceExtensions(&glfwExtCount);
-    std::vector<const char*> instanceExts(glfwExts, glfwExts + glfwExtCount);
+    std::vector<const char*> instanceExts;
+    VgtPresenterGetInstanceExtensions(presenter, instanceExts);
 
     std::vector<const char*> layers;
 #if VGT_ENABLE_VALIDATION
@@ -216,6 +102,7 @@ int main()
 
     VkInstance instance = VK_NULL_HANDLE;
     {
+        VGT_TRACE_ZONE("instance creation");
         const VkResult res = vkCreateInstance(&instanceCI, nullptr, &instance);
         if (res != VK_SUCCESS)
         {
@@ -227,14 +114,13 @@ int main()
         }
     }
 
-    // Surface
-    VkSurfaceKHR surface = VK_NULL_HANDLE;
+    // Surface (none when rendering offscreen)
     {
-        const VkResult res = glfwCreateWindowSurface(instance, window, nullptr, &surface);
+        const VkResult res = VgtPresenterCreateSurface(presenter, instance);
         if (res != VK_SUCCESS)
         {
-            PrintVkResult("glfwCreateWindowSurface", res);
-            ShowFatal("glfwCreateWindowSurface failed");
+            PrintVkResult("VgtPresenterCreateSurface", res);
+            ShowFatal("Surface creation failed");
             if (pauseOnExit)
                 (void)std::getchar();
             return 1;
@@ -261,12 +147,13 @@ int main()
         if ((qProps[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) && graphicsQ == UINT32_MAX)
             graphicsQ = i;
 
-        VkBool32 presentSupport = VK_FALSE;
-        vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentSupport);
-        if (presentSupport && presentQ == UINT32_MAX)
+        if (VgtPresenterSupportsPresent(presenter, physicalDevice, i) && presentQ == UINT32_MAX)
             presentQ = i;
     }
 
+    // Dedicated copy queue for static uploads (see VgtUpload.h), when the device has one.
+    const uint32_t transferQ = VgtFindTransferQueueFamily(physicalDevice);
+
     float qPriority = 1.0f;
     std::vector<VkDeviceQueueCreateInfo> queueCIs;
     {
@@ -284,18 +171,37 @@ int main()
             pqci.pQueuePriorities = &qPriority;
             queueCIs.push_back(pqci);
         }
+
+        if (transferQ != UINT32_MAX && transferQ != graphicsQ && transferQ != presentQ)
+        {
+            VkDeviceQueueCreateInfo tqci{ VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
+            tqci.queueFamilyIndex = transferQ;
+            tqci.queueCount = 1;
+            tqci.pQueuePriorities = &qPriority;
+            queueCIs.push_back(tqci);
+        }
     }
 
-    const char* deviceExts[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+    std::vector<const char*> deviceExts;
+    VgtPresenterGetDeviceExtensions(presenter, deviceExts);
 
     VkDeviceCreateInfo deviceCI{ VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
     deviceCI.queueCreateInfoCount = static_cast<uint32_t>(queueCIs.size());
     deviceCI.pQueueCreateInfos = queueCIs.data();
-    deviceCI.enabledExtensionCount = 1;
-    deviceCI.ppEnabledExtensionNames = deviceExts;
+    deviceCI.enabledExtensionCount = static_cast<uint32_t>(deviceExts.size());
+    deviceCI.ppEnabledExtensionNames = deviceExts.empty() ? nullptr : deviceExts.data();
+
+    // Block-compressed textures (KTX2/DDS from tools/vgt_texconv) need these to be sampled.
+    VkPhysicalDeviceFeatures deviceFeatures{};
+    VgtEnableTextureCompressionFeatures(physicalDevice, deviceFeatures);
+    deviceCI.pEnabledFeatures = &deviceFeatures;
+
+    // --latency: present id / present wait for input-to-photon timing, when supported.
+    VgtPresenterEnableDeviceFeatures(presenter, physicalDevice, deviceExts, deviceCI);
 
     VkDevice device = VK_NULL_HANDLE;
     {
+        VGT_TRACE_ZONE("device creation");
         const VkResult res = vkCreateDevice(physicalDevice, &deviceCI, nullptr, &device);
         if (res != VK_SUCCESS)
         {
@@ -308,281 +214,72 @@ int main()
     }
 
     VkQueue graphicsQueue = VK_NULL_HANDLE;
-    VkQueue presentQueue = VK_NULL_HANDLE;
     vkGetDeviceQueue(device, graphicsQ, 0, &graphicsQueue);
-    vkGetDeviceQueue(device, presentQ, 0, &presentQueue);
 
-    // Swapchain
-    VkSurfaceCapabilitiesKHR caps{};
-    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, surface, &caps);
+    // Device memory: buffers and images are sub-allocated from large per-memory-type blocks.
+    VgtAllocatorCreateInfo allocatorCI{};
+    allocatorCI.physicalDevice = physicalDevice;
+    allocatorCI.device = device;
+
+    VgtAllocator allocator;
+    VgtCreateAllocator(allocatorCI, allocator);
 
-    uint32_t formatCount = 0;
-    vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, nullptr);
-    std::vector<VkSurfaceFormatKHR> formats(formatCount);
-    vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, formats.data());
+    // Static geometry goes to DEVICE_LOCAL memory through staging copies.
+    VgtUploadContextCreateInfo uploadCI{};
+    uploadCI.device = device;
+    uploadCI.allocator = &allocator;
+    uploadCI.graphicsQueueFamily = graphicsQ;
+    uploadCI.transferQueueFamily = transferQ;
 
-    VkSurfaceFormatKHR surfaceFormat = formats[0];
-    for (const auto& f : formats)
+    VgtUploadContext upload;
     {
-        if (f.format == VK_FORMAT_B8G8R8A8_UNORM && f.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+        const VkResult res = VgtCreateUploadContext(uploadCI, upload);
+        if (res != VK_SUCCESS)
         {
-            surfaceFormat = f;
-            break;
+            PrintVkResult("VgtCreateUploadContext", res);
+            return 1;
         }
     }
 
-    VkExtent2D extent = caps.currentExtent;
-    if (extent.width == UINT32_MAX)
+    // Textures are decoded on worker threads and uploaded in the background; a placeholder is
+    // bound until they are ready, so the window shows up without waiting for stb_image.
+    VgtTextureStreamerCreateInfo streamerCI{};
+    streamerCI.device = device;
+    streamerCI.allocator = &allocator;
+    streamerCI.graphicsQueueFamily = graphicsQ;
+    streamerCI.transferQueueFamily = transferQ;
+    streamerCI.physicalDevice = physicalDevice;
+    streamerCI.mipmaps = options.mipmaps;
+    streamerCI.shadersFromDisk = options.shadersFromDisk;
+    streamerCI.label = "Step03_Texture";
+    streamerCI.verbose = options.showFps || options.benchmark;
+
+    VgtTextureStreamer streamer;
     {
-        int w = 0, h = 0;
-        glfwGetFramebufferSize(window, &w, &h);
-        extent.width = static_cast<uint32_t>(w);
-        extent.height = static_cast<uint32_t>(h);
-    }
-
-    VkSwapchainCreateInfoKHR swapCI{ VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR };
-    swapCI.surface = surface;
-    swapCI.minImageCount = caps.minImageCount + 1;
-    swapCI.imageFormat = surfaceFormat.format;
-    swapCI.imageColorSpace = surfaceFormat.colorSpace;
-    swapCI.imageExtent = extent;
-    swapCI.imageArrayLayers = 1;
-    swapCI.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-    swapCI.preTransform = caps.currentTransform;
-    swapCI.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-    swapCI.presentMode = VK_PRESENT_MODE_FIFO_KHR;
-    swapCI.clipped = VK_TRUE;
-
-    uint32_t qIndices[] = { graphicsQ, presentQ };
-    if (graphicsQ != presentQ)
-    {
-        swapCI.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
-        swapCI.queueFamilyIndexCount = 2;
-        swapCI.pQueueFamilyIndices = qIndices;
-    }
-
-    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
-    {
-        const VkResult res = vkCreateSwapchainKHR(device, &swapCI, nullptr, &swapchain);
+        const VkResult res = VgtCreateTextureStreamer(streamerCI, streamer);
         if (res != VK_SUCCESS)
         {
-            PrintVkResult("vkCreateSwapchainKHR", res);
-            ShowFatal("vkCreateSwapchainKHR failed");
-            if (pauseOnExit)
-                (void)std::getchar();
+            PrintVkResult("VgtCreateTextureStreamer", res);
             return 1;
         }
     }
-
-    uint32_t swapImageCount = 0;
-    vkGetSwapchainImagesKHR(device, swapchain, &swapImageCount, nullptr);
-    std::vector<VkImage> swapImages(swapImageCount);
-    vkGetSwapchainImagesKHR(device, swapchain, &swapImageCount, swapImages.data());
-
-    std::vector<VkImageView> swapImageViews(swapImageCount);
-    for (uint32_t i = 0; i < swapImageCount; ++i)
-    {
-        VkImageViewCreateInfo viewCI{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
-        viewCI.image = swapImages[i];
-        viewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        viewCI.format = surfaceFormat.format;
-        viewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        viewCI.subresourceRange.levelCount = 1;
-        viewCI.subresourceRange.layerCount = 1;
-        vkCreateImageView(device, &viewCI, nullptr, &swapImageViews[i]);
-    }
-
-    // Load texture with stb_image
-    int texWidth = 0, texHeight = 0, texChannels = 0;
-    stbi_uc* pixels = LoadTextureWithFallback("assets/texture.png", &texWidth, &texHeight, &texChannels);
-    if (!pixels)
-    {
-        ShowFatal("Failed to load texture.png. Make sure assets/texture.png exists.");
-        if (pauseOnExit)
-            (void)std::getchar();
-        return 1;
-    }
-    const VkDeviceSize imageSize = static_cast<VkDeviceSize>(texWidth) * texHeight * 4;
-
-    // Staging buffer for texture upload
-    VkBufferCreateInfo stagingBufCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-    stagingBufCI.size = imageSize;
-    stagingBufCI.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    stagingBufCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-    VkBuffer stagingBuffer = VK_NULL_HANDLE;
-    vkCreateBuffer(device, &stagingBufCI, nullptr, &stagingBuffer);
-
-    VkMemoryRequirements stagingMemReq{};
-    vkGetBufferMemoryRequirements(device, stagingBuffer, &stagingMemReq);
-
-    uint32_t stagingMemType = FindMemoryTypeIndex(
-        physicalDevice,
-        stagingMemReq.memoryTypeBits,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-    VkMemoryAllocateInfo stagingAlloc{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-    stagingAlloc.allocationSize = stagingMemReq.size;
-    stagingAlloc.memoryTypeIndex = stagingMemType;
-
-    VkDeviceMemory stagingMem = VK_NULL_HANDLE;
-    vkAllocateMemory(device, &stagingAlloc, nullptr, &stagingMem);
-    vkBindBufferMemory(device, stagingBuffer, stagingMem, 0);
-
-    void* mapped = nullptr;
-    vkMapMemory(device, stagingMem, 0, imageSize, 0, &mapped);
-    std::memcpy(mapped, pixels, static_cast<size_t>(imageSize));
-    vkUnmapMemory(device, stagingMem);
-
-    stbi_image_free(pixels);
-
-    // Create texture image
-    VkImageCreateInfo imageCI{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
-    imageCI.imageType = VK_IMAGE_TYPE_2D;
-    imageCI.extent.width = static_cast<uint32_t>(texWidth);
-    imageCI.extent.height = static_cast<uint32_t>(texHeight);
-    imageCI.extent.depth = 1;
-    imageCI.mipLevels = 1;
-    imageCI.arrayLayers = 1;
-    imageCI.format = VK_FORMAT_R8G8B8A8_UNORM;
-    imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
-    imageCI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageCI.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-    imageCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
-
-    VkImage textureImage = VK_NULL_HANDLE;
-    vkCreateImage(device, &imageCI, nullptr, &textureImage);
-
-    VkMemoryRequirements imgMemReq{};
-    vkGetImageMemoryRequirements(device, textureImage, &imgMemReq);
-
-    uint32_t imgMemType = FindMemoryTypeIndex(
-        physicalDevice,
-        imgMemReq.memoryTypeBits,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-    VkMemoryAllocateInfo imgAlloc{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-    imgAlloc.allocationSize = imgMemReq.size;
-    imgAlloc.memoryTypeIndex = imgMemType;
-
-    VkDeviceMemory textureMemory = VK_NULL_HANDLE;
-    vkAllocateMemory(device, &imgAlloc, nullptr, &textureMemory);
-    vkBindImageMemory(device, textureImage, textureMemory, 0);
-
-    // Transition image layout and copy from staging buffer
-    VkCommandPoolCreateInfo transferPoolCI{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
-    transferPoolCI.queueFamilyIndex = graphicsQ;
-
-    VkCommandPool transferPool = VK_NULL_HANDLE;
-    vkCreateCommandPool(device, &transferPoolCI, nullptr, &transferPool);
-
-    VkCommandBufferAllocateInfo transferCmdAI{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
-    transferCmdAI.commandPool = transferPool;
-    transferCmdAI.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    transferCmdAI.commandBufferCount = 1;
-
-    VkCommandBuffer transferCmd = VK_NULL_HANDLE;
-    vkAllocateCommandBuffers(device, &transferCmdAI, &transferCmd);
-
-    VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-    vkBeginCommandBuffer(transferCmd, &beginInfo);
-
-    // Transition to TRANSFER_DST_OPTIMAL
-    VkImageMemoryBarrier barrier1{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
-    barrier1.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    barrier1.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier1.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier1.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier1.image = textureImage;
-    barrier1.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier1.subresourceRange.levelCount = 1;
-    barrier1.subresourceRange.layerCount = 1;
-    barrier1.srcAccessMask = 0;
-    barrier1.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-    vkCmdPipelineBarrier(transferCmd,
-        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-        0, 0, nullptr, 0, nullptr, 1, &barrier1);
-
-    // Copy buffer to image
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = { 0, 0, 0 };
-    region.imageExtent = { static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight), 1 };
-
-    vkCmdCopyBufferToImage(transferCmd, stagingBuffer, textureImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-    // Transition to SHADER_READ_ONLY_OPTIMAL
-    VkImageMemoryBarrier barrier2{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
-    barrier2.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier2.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barrier2.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier2.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier2.image = textureImage;
-    barrier2.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier2.subresourceRange.levelCount = 1;
-    barrier2.subresourceRange.layerCount = 1;
-    barrier2.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier2.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-    vkCmdPipelineBarrier(transferCmd,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-        0, 0, nullptr, 0, nullptr, 1, &barrier2);
-
-    vkEndCommandBuffer(transferCmd);
-
-    VkSubmitInfo transferSubmit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
-    transferSubmit.commandBufferCount = 1;
-    transferSubmit.pCommandBuffers = &transferCmd;
-
-    vkQueueSubmit(graphicsQueue, 1, &transferSubmit, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
-
-    vkFreeCommandBuffers(device, transferPool, 1, &transferCmd);
-    vkDestroyCommandPool(device, transferPool, nullptr);
-
-    vkDestroyBuffer(device, stagingBuffer, nullptr);
-    vkFreeMemory(device, stagingMem, nullptr);
-
-    // Create image view
-    VkImageViewCreateInfo texViewCI{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
-    texViewCI.image = textureImage;
-    texViewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    texViewCI.format = VK_FORMAT_R8G8B8A8_UNORM;
-    texViewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    texViewCI.subresourceRange.levelCount = 1;
-    texViewCI.subresourceRange.layerCount = 1;
-
-    VkImageView textureView = VK_NULL_HANDLE;
-    vkCreateImageView(device, &texViewCI, nullptr, &textureView);
-
-    // Create sampler
-    VkSamplerCreateInfo samplerCI{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
-    samplerCI.magFilter = VK_FILTER_LINEAR;
-    samplerCI.minFilter = VK_FILTER_LINEAR;
-    samplerCI.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerCI.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerCI.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerCI.anisotropyEnable = VK_FALSE;
-    samplerCI.maxAnisotropy = 1.0f;
-    samplerCI.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-    samplerCI.unnormalizedCoordinates = VK_FALSE;
-    samplerCI.compareEnable = VK_FALSE;
-    samplerCI.compareOp = VK_COMPARE_OP_ALWAYS;
-    samplerCI.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-
-    VkSampler textureSampler = VK_NULL_HANDLE;
-    vkCreateSampler(device, &samplerCI, nullptr, &textureSampler);
+    const uint32_t texture = VgtRequestTexture(streamer, options.texturePath.c_str());
+
+    // GPU timestamps (--gpu-timing): one query range per frame in flight.
+    // Pre-recorded static command buffers are not timed (their slot is not known when recording).
+    VgtGpuTimerCreateInfo gpuTimerCI{};
+    gpuTimerCI.physicalDevice = physicalDevice;
+    gpuTimerCI.device = device;
+    gpuTimerCI.queueFamily = graphicsQ;
+    gpuTimerCI.slotCount = options.framesInFlight;
+    gpuTimerCI.label = "Step03_Texture";
+    gpuTimerCI.enabled = options.gpuTiming && !options.staticCommandBuffers;
+    gpuTimerCI.csvPath = options.gpuTimingCsv.c_str();
+
+    VgtGpuTimer gpuTimer;
+    VgtCreateGpuTimer(gpuTimerCI, gpuTimer);
+    const uint32_t gpuFrameScope = VgtGpuTimerScope(gpuTimer, "frame");
+    const uint32_t gpuRenderPassScope = VgtGpuTimerScope(gpuTimer, "render_pass");
 
     // Descriptor set layout
     VkDescriptorSetLayoutBinding samplerBinding{};
@@ -598,51 +295,36 @@ int main()
     VkDescriptorSetLayout descLayout = VK_NULL_HANDLE;
     vkCreateDescriptorSetLayout(device, &descLayoutCI, nullptr, &descLayout);
 
-    // Descriptor pool
-    VkDescriptorPoolSize poolSize{};
-    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSize.descriptorCount = 1;
-
-    VkDescriptorPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
-    poolCI.poolSizeCount = 1;
-    poolCI.pPoolSizes = &poolSize;
-    poolCI.maxSets = 1;
-
-    VkDescriptorPool descPool = VK_NULL_HANDLE;
-    vkCreateDescriptorPool(device, &poolCI, nullptr, &descPool);
-
-    // Descriptor set
-    VkDescriptorSetAllocateInfo descAI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
-    descAI.descriptorPool = descPool;
-    descAI.descriptorSetCount = 1;
-    descAI.pSetLayouts = &descLayout;
-
-    VkDescriptorSet descSet = VK_NULL_HANDLE;
-    vkAllocateDescriptorSets(device, &descAI, &descSet);
-
-    VkDescriptorImageInfo imageInfo{};
-    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageInfo.imageView = textureView;
-    imageInfo.sampler = textureSampler;
+    // Pipeline layout
+    VkPipelineLayoutCreateInfo plCI{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    plCI.setLayoutCount = 1;
+    plCI.pSetLayouts = &descLayout;
 
-    VkWriteDescriptorSet descWrite{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
-    descWrite.dstSet = descSet;
-    descWrite.dstBinding = 0;
-    descWrite.dstArrayElement = 0;
-    descWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    descWrite.descriptorCount = 1;
-    descWrite.pImageInfo = &imageInfo;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    vkCreatePipelineLayout(device, &plCI, nullptr, &pipelineLayout);
 
-    vkUpdateDescriptorSets(device, 1, &descWrite, 0, nullptr);
+    // The swapchain format is known before the swapchain exists, so the render pass (and the
+    // pipeline built on it) do not have to wait for it.
+    {
+        const VkResult res = VgtPresenterChooseFormat(presenter, physicalDevice);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtPresenterChooseFormat", res);
+            ShowFatal("Swapchain creation failed");
+            if (pauseOnExit)
+                (void)std::getchar();
+            return 1;
+        }
+    }
 
     // Render pass
     VkAttachmentDescription colorAttachment{};
-    colorAttachment.format = surfaceFormat.format;
+    colorAttachment.format = presenter.format;
     colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
     colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    colorAttachment.finalLayout = presenter.presentLayout;
 
     VkAttachmentReference colorRef{};
     colorRef.attachment = 0;
@@ -662,183 +344,295 @@ int main()
     VkRenderPass renderPass = VK_NULL_HANDLE;
     vkCreateRenderPass(device, &rpCI, nullptr, &renderPass);
 
-    // Framebuffers
-    std::vector<VkFramebuffer> framebuffers(swapImageCount);
-    for (uint32_t i = 0; i < swapImageCount; ++i)
+    // Startup tasks (see VgtTaskGraph.h): read the SPIR-V and create the shader modules, load the
+    // pipeline cache, then create the pipeline. They need neither the swapchain nor the geometry,
+    // so they run on the streamer's workers (next to the texture decode requested above) while this
+    // thread creates the swapchain and uploads the quad. --serial-startup runs them right here.
+    VkShaderModule vertModule = VK_NULL_HANDLE;
+    VkShaderModule fragModule = VK_NULL_HANDLE;
+    VgtPipelineCache pipelineCache;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+
+    auto createShaderModule = [&](const char* name, VkShaderModule& module) -> VkResult
     {
-        VkImageView attachments[] = { swapImageViews[i] };
-        VkFramebufferCreateInfo fbCI{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
-        fbCI.renderPass = renderPass;
-        fbCI.attachmentCount = 1;
-        fbCI.pAttachments = attachments;
-        fbCI.width = extent.width;
-        fbCI.height = extent.height;
-        fbCI.layers = 1;
-        vkCreateFramebuffer(device, &fbCI, nullptr, &framebuffers[i]);
-    }
+        const auto spv = VgtLoadSpirv(name, options.shadersFromDisk);
+        if (spv.empty())
+            return VK_ERROR_INITIALIZATION_FAILED;
+
+        VkShaderModuleCreateInfo smCI{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+        smCI.codeSize = spv.size() * sizeof(uint32_t);
+        smCI.pCode = spv.data();
+        return vkCreateShaderModule(device, &smCI, nullptr, &module);
+    };
 
-    // Vertex buffer (quad with UV coordinates)
-    Vertex vertices[6] = {
-        { { -0.5f, -0.5f }, { 0.0f, 0.0f } },
-        { {  0.5f, -0.5f }, { 1.0f, 0.0f } },
-        { {  0.5f,  0.5f }, { 1.0f, 1.0f } },
-        { { -0.5f, -0.5f }, { 0.0f, 0.0f } },
-        { {  0.5f,  0.5f }, { 1.0f, 1.0f } },
-        { { -0.5f,  0.5f }, { 0.0f, 1.0f } },
+    auto createPipeline = [&]() -> VkResult
+    {
+        VkPipelineShaderStageCreateInfo stages[2]{};
+        stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        stages[0].module = vertModule;
+        stages[0].pName = "main";
+        stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        stages[1].module = fragModule;
+        stages[1].pName = "main";
+
+        // Vertex input
+        VkVertexInputBindingDescription binding{};
+        binding.binding = 0;
+        binding.stride = sizeof(Vertex);
+        binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+        VkVertexInputAttributeDescription attrs[2]{};
+        attrs[0].location = 0;
+        attrs[0].binding = 0;
+        attrs[0].format = VK_FORMAT_R32G32_SFLOAT;
+        attrs[0].offset = offsetof(Vertex, pos);
+
+        attrs[1].location = 1;
+        attrs[1].binding = 0;
+        attrs[1].format = VK_FORMAT_R32G32_SFLOAT;
+        attrs[1].offset = offsetof(Vertex, uv);
+
+        VkPipelineVertexInputStateCreateInfo vi{ VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
+        vi.vertexBindingDescriptionCount = 1;
+        vi.pVertexBindingDescriptions = &binding;
+        vi.vertexAttributeDescriptionCount = 2;
+        vi.pVertexAttributeDescriptions = attrs;
+
+        VkPipelineInputAssemblyStateCreateInfo ia{ VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO };
+        ia.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        // Viewport and scissor are dynamic state, so the pipeline only needs their counts (and
+        // does not depend on the swapchain extent).
+        VkPipelineViewportStateCreateInfo vp{ VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO };
+        vp.viewportCount = 1;
+        vp.scissorCount = 1;
+
+        VkPipelineRasterizationStateCreateInfo rs{ VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO };
+        rs.depthClampEnable = VK_FALSE;
+        rs.rasterizerDiscardEnable = VK_FALSE;
+        rs.polygonMode = VK_POLYGON_MODE_FILL;
+        rs.cullMode = VK_CULL_MODE_NONE;
+        rs.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        rs.depthBiasEnable = VK_FALSE;
+        rs.lineWidth = 1.0f;
+
+        VkPipelineMultisampleStateCreateInfo ms{ VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
+        ms.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkPipelineColorBlendAttachmentState cbAttach{};
+        cbAttach.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+        VkPipelineColorBlendStateCreateInfo cb{ VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
+        cb.attachmentCount = 1;
+        cb.pAttachments = &cbAttach;
+
+        VkDynamicState dynStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+        VkPipelineDynamicStateCreateInfo dyn{ VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
+        dyn.dynamicStateCount = static_cast<uint32_t>(std::size(dynStates));
+        dyn.pDynamicStates = dynStates;
+
+        VkGraphicsPipelineCreateInfo gpCI{ VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
+        gpCI.stageCount = 2;
+        gpCI.pStages = stages;
+        gpCI.pVertexInputState = &vi;
+        gpCI.pInputAssemblyState = &ia;
+        gpCI.pViewportState = &vp;
+        gpCI.pRasterizationState = &rs;
+        gpCI.pMultisampleState = &ms;
+        gpCI.pColorBlendState = &cb;
+        gpCI.pDynamicState = &dyn;
+        gpCI.layout = pipelineLayout;
+        gpCI.renderPass = renderPass;
+
+        return VgtCreateGraphicsPipelines(device, pipelineCache, 1, &gpCI, &pipeline);
     };
 
-    VkBufferCreateInfo bufCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-    bufCI.size = sizeof(vertices);
-    bufCI.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-    bufCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    // Declared after everything the tasks write to: its destructor waits for them on early returns.
+    VgtTaskGraph startup;
+    const uint32_t vertTask = VgtTaskGraphAdd(startup, "vertex shader module",
+        [&] { return createShaderModule("texture.vert.spv", vertModule); });
+    const uint32_t fragTask = VgtTaskGraphAdd(startup, "fragment shader module",
+        [&] { return createShaderModule("texture.frag.spv", fragModule); });
+    // Pipeline cache persisted next to the exe: the first run compiles (cold), later runs reuse it (warm).
+    const uint32_t cacheTask = VgtTaskGraphAdd(startup, "pipeline cache", [&] {
+        return VgtCreatePipelineCache(physicalDevice, device, "Step03_Texture", options.pipelineCache, pipelineCache);
+    });
+    VgtTaskGraphAdd(startup, "graphics pipeline", createPipeline, { vertTask, fragTask, cacheTask });
+    VgtTaskGraphRun(startup, options.serialStartup ? nullptr : streamer.decodePool.get());
+
+    // Swapchain (offscreen images when headless)
+    VgtSwapchainDesc swapDesc{};
+    swapDesc.graphicsQueueFamily = graphicsQ;
+    swapDesc.presentQueueFamily = presentQ;
+    {
+        const VkResult res = VgtPresenterCreateSwapchain(presenter, physicalDevice, device, swapDesc);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtPresenterCreateSwapchain", res);
+            ShowFatal("Swapchain creation failed");
+            if (pauseOnExit)
+                (void)std::getchar();
+            return 1;
+        }
+    }
 
-    VkBuffer vertexBuffer = VK_NULL_HANDLE;
-    vkCreateBuffer(device, &bufCI, nullptr, &vertexBuffer);
+    // References: both change when the swapchain is recreated.
+    const VkExtent2D& extent = presenter.extent;
+    const std::vector<VkImage>& swapImages = presenter.images;
+
+    // Create samplers: the placeholder has a single level; the texture's sampler is created once it is
+    // ready, with maxLod covering its mip chain.
+    VkSamplerCreateInfo samplerCI{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+    samplerCI.magFilter = VK_FILTER_LINEAR;
+    samplerCI.minFilter = VK_FILTER_LINEAR;
+    samplerCI.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerCI.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerCI.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerCI.anisotropyEnable = VK_FALSE;
+    samplerCI.maxAnisotropy = 1.0f;
+    samplerCI.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+    samplerCI.unnormalizedCoordinates = VK_FALSE;
+    samplerCI.compareEnable = VK_FALSE;
+    samplerCI.compareOp = VK_COMPARE_OP_ALWAYS;
+    samplerCI.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    samplerCI.minLod = 0.0f;
+    samplerCI.maxLod = 0.0f;
 
-    VkMemoryRequirements memReq{};
-    vkGetBufferMemoryRequirements(device, vertexBuffer, &memReq);
+    VkSampler placeholderSampler = VK_NULL_HANDLE;
+    vkCreateSampler(device, &samplerCI, nullptr, &placeholderSampler);
+    VkSampler textureSampler = VK_NULL_HANDLE;
 
-    uint32_t memType = FindMemoryTypeIndex(
-        physicalDevice,
-        memReq.memoryTypeBits,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    // Descriptor pool
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSize.descriptorCount = options.framesInFlight;
 
-    VkMemoryAllocateInfo alloc{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-    alloc.allocationSize = memReq.size;
-    alloc.memoryTypeIndex = memType;
+    VkDescriptorPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolCI.poolSizeCount = 1;
+    poolCI.pPoolSizes = &poolSize;
+    poolCI.maxSets = options.framesInFlight;
 
-    VkDeviceMemory vertexMem = VK_NULL_HANDLE;
-    vkAllocateMemory(device, &alloc, nullptr, &vertexMem);
-    vkBindBufferMemory(device, vertexBuffer, vertexMem, 0);
+    VkDescriptorPool descPool = VK_NULL_HANDLE;
+    vkCreateDescriptorPool(device, &poolCI, nullptr, &descPool);
 
-    vkMapMemory(device, vertexMem, 0, sizeof(vertices), 0, &mapped);
-    std::memcpy(mapped, vertices, sizeof(vertices));
-    vkUnmapMemory(device, vertexMem);
+    // Descriptor sets: one per frame in flight, so a slot can switch from the placeholder to the
+    // streamed texture while the other slots are still in use by the GPU.
+    std::vector<VkDescriptorSetLayout> descLayouts(options.framesInFlight, descLayout);
+    VkDescriptorSetAllocateInfo descAI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    descAI.descriptorPool = descPool;
+    descAI.descriptorSetCount = options.framesInFlight;
+    descAI.pSetLayouts = descLayouts.data();
 
-    // Pipeline layout
-    VkPipelineLayoutCreateInfo plCI{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
-    plCI.setLayoutCount = 1;
-    plCI.pSetLayouts = &descLayout;
+    std::vector<VkDescriptorSet> descSets(options.framesInFlight);
+    vkAllocateDescriptorSets(device, &descAI, descSets.data());
 
-    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
-    vkCreatePipelineLayout(device, &plCI, nullptr, &pipelineLayout);
+    // View currently written into each set.
+    std::vector<VkImageView> boundViews(options.framesInFlight, VK_NULL_HANDLE);
+    auto writeTextureDescriptor = [&](uint32_t slot, VkImageView view)
+    {
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfo.imageView = view;
+        imageInfo.sampler = view == streamer.placeholderView ? placeholderSampler : textureSampler;
+
+        VkWriteDescriptorSet descWrite{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        descWrite.dstSet = descSets[slot];
+        descWrite.dstBinding = 0;
+        descWrite.dstArrayElement = 0;
+        descWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        descWrite.descriptorCount = 1;
+        descWrite.pImageInfo = &imageInfo;
+
+        vkUpdateDescriptorSets(device, 1, &descWrite, 0, nullptr);
+        boundViews[slot] = view;
+    };
+    for (uint32_t i = 0; i < options.framesInFlight; ++i)
+        writeTextureDescriptor(i, VgtGetTextureView(streamer, texture));
 
-    // Shader modules
-    const auto vertSpv = ReadSpirvWithFallback("texture.vert.spv");
-    const auto fragSpv = ReadSpirvWithFallback("texture.frag.spv");
-    if (vertSpv.empty() || fragSpv.empty())
+    // Image views and framebuffers, one per swapchain image; rebuilt by recreateSwapchain below.
+    std::vector<VkImageView> swapImageViews;
+    std::vector<VkFramebuffer> framebuffers;
+    auto createSwapchainTargets = [&]()
     {
-        ShowFatal("Failed to load shaders. Did you build the project (which runs glslangValidator)?");
-        if (pauseOnExit)
-            (void)std::getchar();
-        return 1;
-    }
+        const uint32_t imageCount = static_cast<uint32_t>(swapImages.size());
+        swapImageViews.assign(imageCount, VK_NULL_HANDLE);
+        framebuffers.assign(imageCount, VK_NULL_HANDLE);
+        for (uint32_t i = 0; i < imageCount; ++i)
+        {
+            VkImageViewCreateInfo viewCI{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+            viewCI.image = swapImages[i];
+            viewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewCI.format = presenter.format;
+            viewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            viewCI.subresourceRange.levelCount = 1;
+            viewCI.subresourceRange.layerCount = 1;
+            vkCreateImageView(device, &viewCI, nullptr, &swapImageViews[i]);
+
+            VkImageView attachments[] = { swapImageViews[i] };
+            VkFramebufferCreateInfo fbCI{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
+            fbCI.renderPass = renderPass;
+            fbCI.attachmentCount = 1;
+            fbCI.pAttachments = attachments;
+            fbCI.width = extent.width;
+            fbCI.height = extent.height;
+            fbCI.layers = 1;
+            vkCreateFramebuffer(device, &fbCI, nullptr, &framebuffers[i]);
+        }
+    };
+    createSwapchainTargets();
 
-    VkShaderModuleCreateInfo smVertCI{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
-    smVertCI.codeSize = vertSpv.size() * sizeof(uint32_t);
-    smVertCI.pCode = vertSpv.data();
-    VkShaderModule vertModule = VK_NULL_HANDLE;
-    vkCreateShaderModule(device, &smVertCI, nullptr, &vertModule);
+    // Vertex + index buffer (quad with UV coordinates; --texture-repeat tiles the texture to minify it)
+    const float uvMax = static_cast<float>(options.textureRepeat);
+    Vertex vertices[4] = {
+        { { -0.5f, -0.5f }, { 0.0f, 0.0f } },
+        { {  0.5f, -0.5f }, { uvMax, 0.0f } },
+        { {  0.5f,  0.5f }, { uvMax, uvMax } },
+        { { -0.5f,  0.5f }, { 0.0f, uvMax } },
+    };
+    const uint16_t indices[6] = { 0, 1, 2, 0, 2, 3 };
+    const uint32_t indexCount = 6;
 
-    VkShaderModuleCreateInfo smFragCI{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
-    smFragCI.codeSize = fragSpv.size() * sizeof(uint32_t);
-    smFragCI.pCode = fragSpv.data();
-    VkShaderModule fragModule = VK_NULL_HANDLE;
-    vkCreateShaderModule(device, &smFragCI, nullptr, &fragModule);
-
-    VkPipelineShaderStageCreateInfo stages[2]{};
-    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
-    stages[0].module = vertModule;
-    stages[0].pName = "main";
-    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    stages[1].module = fragModule;
-    stages[1].pName = "main";
-
-    // Vertex input
-    VkVertexInputBindingDescription binding{};
-    binding.binding = 0;
-    binding.stride = sizeof(Vertex);
-    binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-    VkVertexInputAttributeDescription attrs[2]{};
-    attrs[0].location = 0;
-    attrs[0].binding = 0;
-    attrs[0].format = VK_FORMAT_R32G32_SFLOAT;
-    attrs[0].offset = offsetof(Vertex, pos);
-
-    attrs[1].location = 1;
-    attrs[1].binding = 0;
-    attrs[1].format = VK_FORMAT_R32G32_SFLOAT;
-    attrs[1].offset = offsetof(Vertex, uv);
-
-    VkPipelineVertexInputStateCreateInfo vi{ VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
-    vi.vertexBindingDescriptionCount = 1;
-    vi.pVertexBindingDescriptions = &binding;
-    vi.vertexAttributeDescriptionCount = 2;
-    vi.pVertexAttributeDescriptions = attrs;
-
-    VkPipelineInputAssemblyStateCreateInfo ia{ VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO };
-    ia.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = static_cast<float>(extent.width);
-    viewport.height = static_cast<float>(extent.height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    VkRect2D scissor{};
-    scissor.offset = { 0, 0 };
-    scissor.extent = extent;
-
-    VkPipelineViewportStateCreateInfo vp{ VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO };
-    vp.viewportCount = 1;
-    vp.pViewports = &viewport;
-    vp.scissorCount = 1;
-    vp.pScissors = &scissor;
-
-    VkPipelineRasterizationStateCreateInfo rs{ VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO };
-    rs.depthClampEnable = VK_FALSE;
-    rs.rasterizerDiscardEnable = VK_FALSE;
-    rs.polygonMode = VK_POLYGON_MODE_FILL;
-    rs.cullMode = VK_CULL_MODE_NONE;
-    rs.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-    rs.depthBiasEnable = VK_FALSE;
-    rs.lineWidth = 1.0f;
-
-    VkPipelineMultisampleStateCreateInfo ms{ VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
-    ms.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-    VkPipelineColorBlendAttachmentState cbAttach{};
-    cbAttach.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-
-    VkPipelineColorBlendStateCreateInfo cb{ VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
-    cb.attachmentCount = 1;
-    cb.pAttachments = &cbAttach;
-
-    VkDynamicState dynStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
-    VkPipelineDynamicStateCreateInfo dyn{ VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
-    dyn.dynamicStateCount = static_cast<uint32_t>(std::size(dynStates));
-    dyn.pDynamicStates = dynStates;
-
-    VkGraphicsPipelineCreateInfo gpCI{ VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
-    gpCI.stageCount = 2;
-    gpCI.pStages = stages;
-    gpCI.pVertexInputState = &vi;
-    gpCI.pInputAssemblyState = &ia;
-    gpCI.pViewportState = &vp;
-    gpCI.pRasterizationState = &rs;
-    gpCI.pMultisampleState = &ms;
-    gpCI.pColorBlendState = &cb;
-    gpCI.pDynamicState = &dyn;
-    gpCI.layout = pipelineLayout;
-    gpCI.renderPass = renderPass;
+    VkBuffer vertexBuffer = VK_NULL_HANDLE;
+    VgtAllocation vertexAlloc;
+    VkBuffer indexBuffer = VK_NULL_HANDLE;
+    VgtAllocation indexAlloc;
+    {
+        VkResult res = VgtUploadBuffer(upload, vertices, sizeof(vertices), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer, vertexAlloc);
+        if (res == VK_SUCCESS)
+            res = VgtUploadBuffer(upload, indices, sizeof(indices), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer, indexAlloc);
+        if (res == VK_SUCCESS)
+            res = VgtFlushUploads(upload);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("Geometry upload", res);
+            return 1;
+        }
+    }
 
-    VkPipeline pipeline = VK_NULL_HANDLE;
-    vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &gpCI, nullptr, &pipeline);
+    // Join the startup tasks: the pipeline is the last thing the frame loop needs.
+    {
+        VGT_TRACE_ZONE("startup wait");
+        const VkResult res = VgtTaskGraphWaitAll(startup);
+        if (VgtTaskGraphWait(startup, vertTask) != VK_SUCCESS || VgtTaskGraphWait(startup, fragTask) != VK_SUCCESS)
+        {
+            ShowFatal("Failed to load shaders. Did you build the project (which runs glslangValidator)?");
+            if (pauseOnExit)
+                (void)std::getchar();
+            return 1;
+        }
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("Pipeline creation", res);
+            return 1;
+        }
+    }
+    // Each task's own duration. In parallel they overlap, so they add up to more than the wait.
+    for (const VgtTask& task : startup.tasks)
+        VgtBenchmarkPhase(bench, task.name, task.ms);
+    if (options.showFps || options.benchmark)
+        VgtPrintPipelineCacheStats("Step03_Texture", pipelineCache);
 
     // Command pool / buffers
     VkCommandPoolCreateInfo cmdPoolCI{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
@@ -848,46 +642,32 @@ int main()
     VkCommandPool cmdPool = VK_NULL_HANDLE;
     vkCreateCommandPool(device, &cmdPoolCI, nullptr, &cmdPool);
 
-    std::vector<VkCommandBuffer> cmdBuffers(swapImageCount);
+    // One command buffer per frame in flight; the frame fence guards its reuse.
+    std::vector<VkCommandBuffer> cmdBuffers(options.framesInFlight);
     VkCommandBufferAllocateInfo cmdAI{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
     cmdAI.commandPool = cmdPool;
     cmdAI.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    cmdAI.commandBufferCount = swapImageCount;
+    cmdAI.commandBufferCount = options.framesInFlight;
     vkAllocateCommandBuffers(device, &cmdAI, cmdBuffers.data());
 
-    VkSemaphoreCreateInfo semCI{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
-    VkFenceCreateInfo fenceCI{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
-    fenceCI.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-    VkSemaphore imageAvailable = VK_NULL_HANDLE;
-    VkSemaphore renderFinished = VK_NULL_HANDLE;
-    VkFence inFlight = VK_NULL_HANDLE;
-    vkCreateSemaphore(device, &semCI, nullptr, &imageAvailable);
-    vkCreateSemaphore(device, &semCI, nullptr, &renderFinished);
-    vkCreateFence(device, &fenceCI, nullptr, &inFlight);
-
-    while (!glfwWindowShouldClose(window))
+    // Sync primitives: per frame in flight (fence + imageAvailable) and per swapchain image (renderFinished).
+    VgtFrameSync sync;
     {
-        glfwPollEvents();
-
-        vkWaitForFences(device, 1, &inFlight, VK_TRUE, UINT64_MAX);
-        vkResetFences(device, 1, &inFlight);
-
-        uint32_t imageIndex = 0;
+        const VkResult res = VgtCreateFrameSync(device, options.framesInFlight, static_cast<uint32_t>(swapImages.size()), sync);
+        if (res != VK_SUCCESS)
         {
-            const VkResult res = vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, imageAvailable, VK_NULL_HANDLE, &imageIndex);
-            if (res != VK_SUCCESS)
-            {
-                PrintVkResult("vkAcquireNextImageKHR", res);
-                break;
-            }
+            PrintVkResult("VgtCreateFrameSync", res);
+            return 1;
         }
+    }
 
-        VkCommandBuffer cmd = cmdBuffers[imageIndex];
-        vkResetCommandBuffer(cmd, 0);
-
+    // Records the whole frame for swapchain image `imageIndex` into `cmd`.
+    auto recordFrame = [&](VkCommandBuffer cmd, uint32_t imageIndex) -> VkResult
+    {
         VkCommandBufferBeginInfo begin{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
         vkBeginCommandBuffer(cmd, &begin);
+        VgtGpuTimerBeginFrame(gpuTimer, cmd, sync.currentFrame);
+        VgtGpuTimerBegin(gpuTimer, cmd, gpuFrameScope);
 
         VkClearValue clear{};
         clear.color.float32[0] = 0.02f;
@@ -903,6 +683,7 @@ int main()
         rpBegin.clearValueCount = 1;
         rpBegin.pClearValues = &clear;
 
+        VgtGpuTimerBegin(gpuTimer, cmd, gpuRenderPassScope);
         vkCmdBeginRenderPass(cmd, &rpBegin, VK_SUBPASS_CONTENTS_INLINE);
 
         VkViewport drawViewport{};
@@ -920,48 +701,209 @@ int main()
         vkCmdSetScissor(cmd, 0, 1, &drawScissor);
 
         vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
-        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descSet, 0, nullptr);
+        // Static buffers are recorded once with set 0; per-frame recording uses the slot's own set.
+        const uint32_t descSlot = options.staticCommandBuffers ? 0 : sync.currentFrame;
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descSets[descSlot], 0, nullptr);
 
         VkDeviceSize offset = 0;
         vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer, &offset);
-        vkCmdDraw(cmd, 6, 1, 0, 0);
+        vkCmdBindIndexBuffer(cmd, indexBuffer, 0, VK_INDEX_TYPE_UINT16);
+        vkCmdDrawIndexed(cmd, indexCount, 1, 0, 0, 0);
 
         vkCmdEndRenderPass(cmd);
-        vkEndCommandBuffer(cmd);
+        VgtGpuTimerEnd(gpuTimer, cmd, gpuRenderPassScope);
+        VgtGpuTimerEnd(gpuTimer, cmd, gpuFrameScope);
+        return vkEndCommandBuffer(cmd);
+    };
+
+    // --static-command-buffers: nothing in the frame changes, so record one command buffer per
+    // swapchain image up front and just resubmit it. Re-recorded when the swapchain is recreated.
+    std::vector<VkCommandBuffer> staticCmdBuffers;
+    auto recordStaticCommandBuffers = [&]() -> VkResult
+    {
+        const uint32_t imageCount = static_cast<uint32_t>(swapImages.size());
+        staticCmdBuffers.resize(imageCount);
+        VkCommandBufferAllocateInfo staticAI = cmdAI;
+        staticAI.commandBufferCount = imageCount;
+        VkResult res = vkAllocateCommandBuffers(device, &staticAI, staticCmdBuffers.data());
+        for (uint32_t i = 0; res == VK_SUCCESS && i < imageCount; ++i)
+            res = recordFrame(staticCmdBuffers[i], i);
+        if (res != VK_SUCCESS)
+            PrintVkResult("recordFrame (static)", res);
+        return res;
+    };
+    if (options.staticCommandBuffers && recordStaticCommandBuffers() != VK_SUCCESS)
+        return 1;
+
+    // Resize / out of date: the old swapchain and everything built on its images are retired to
+    // `sync` and destroyed as the frames in flight finish, without idling the device. The render
+    // pass, pipeline, texture and descriptor sets do not depend on the extent and are kept.
+    auto recreateSwapchain = [&]() -> VkResult
+    {
+        const VkResult res = VgtRecreateSwapchain(presenter, sync);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtRecreateSwapchain", res);
+            return res;
+        }
+
+        VgtRetire(sync, [device, views = std::move(swapImageViews), fbs = std::move(framebuffers)]() {
+            for (auto fb : fbs)
+                vkDestroyFramebuffer(device, fb, nullptr);
+            for (auto v : views)
+                vkDestroyImageView(device, v, nullptr);
+        });
+        createSwapchainTargets();
+        if (staticCmdBuffers.empty())
+            return VK_SUCCESS;
+
+        VgtRetire(sync, [device, cmdPool, cmds = std::move(staticCmdBuffers)]() {
+            vkFreeCommandBuffers(device, cmdPool, static_cast<uint32_t>(cmds.size()), cmds.data());
+        });
+        return recordStaticCommandBuffers();
+    };
+
+    VgtFrameStats frameStats;
+    VgtFrameStatsBegin(frameStats, "Step03_Texture", options.showFps);
+
+    VgtBenchmarkPhase(bench, "pipeline", pipelineCache.creationMs);
+    VgtBenchmarkPhase(bench, "upload", upload.uploadMs);
+    initZone.End();
+    VgtBenchmarkBeginFrames(bench, presenter);
+
+    while (VgtPresenterRunning(presenter))
+    {
+        VGT_TRACE_ZONE("frame");
+        // Wait until this frame slot's previous submission retired before touching its resources.
+        const uint32_t frame = sync.currentFrame;
+        VgtWaitForFrame(device, sync);
+
+        if (presenter.needsRecreate && recreateSwapchain() != VK_SUCCESS)
+            break;
+
+        // Swap the placeholder for the streamed texture once its upload fence has signaled.
+        VgtTextureStreamerUpdate(streamer);
+        const VkImageView textureView = VgtGetTextureView(streamer, texture);
+        if (textureView != streamer.placeholderView && textureSampler == VK_NULL_HANDLE)
+        {
+            samplerCI.maxLod = static_cast<float>(VgtGetTextureMipLevels(streamer, texture));
+            vkCreateSampler(device, &samplerCI, nullptr, &textureSampler);
+            VgtBenchmarkPhase(bench, "texture_ready", VgtBenchmarkElapsedMs(bench));
+        }
+        if (!options.staticCommandBuffers && boundViews[frame] != textureView)
+        {
+            writeTextureDescriptor(frame, textureView);
+        }
+        else if (options.staticCommandBuffers && boundViews[0] != textureView)
+        {
+            // Updating the set invalidates the pre-recorded buffers that bind it.
+            vkDeviceWaitIdle(device);
+            writeTextureDescriptor(0, textureView);
+            VkResult res = VK_SUCCESS;
+            for (uint32_t i = 0; res == VK_SUCCESS && i < staticCmdBuffers.size(); ++i)
+            {
+                vkResetCommandBuffer(staticCmdBuffers[i], 0);
+                res = recordFrame(staticCmdBuffers[i], i);
+            }
+            if (res != VK_SUCCESS)
+            {
+                PrintVkResult("recordFrame (static)", res);
+                break;
+            }
+        }
+
+        uint32_t imageIndex = 0;
+        {
+            const VkResult res = VgtPresenterAcquire(presenter, sync.imageAvailable[frame], imageIndex);
+            if (res == VK_ERROR_OUT_OF_DATE_KHR)
+                continue; // nothing acquired; recreated at the top of the next iteration
+            if (res != VK_SUCCESS)
+            {
+                PrintVkResult("VgtPresenterAcquire", res);
+                break;
+            }
+        }
+
+        VgtClaimImage(device, sync, imageIndex);
+
+        // Static mode resubmits the image's pre-recorded buffer; otherwise re-record this slot's buffer.
+        VgtFrameStatsCpuBegin(frameStats);
+        VgtTraceZone recordZone("record");
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        if (options.staticCommandBuffers)
+        {
+            cmd = staticCmdBuffers[imageIndex];
+        }
+        else
+        {
+            cmd = cmdBuffers[frame];
+            vkResetCommandBuffer(cmd, 0);
+            const VkResult res = recordFrame(cmd, imageIndex);
+            if (res != VK_SUCCESS)
+            {
+                PrintVkResult("recordFrame", res);
+                break;
+            }
+        }
 
         VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
         VkSubmitInfo submit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
         submit.waitSemaphoreCount = 1;
-        submit.pWaitSemaphores = &imageAvailable;
+        submit.pWaitSemaphores = &sync.imageAvailable[frame];
         submit.pWaitDstStageMask = &waitStage;
         submit.commandBufferCount = 1;
         submit.pCommandBuffers = &cmd;
         submit.signalSemaphoreCount = 1;
-        submit.pSignalSemaphores = &renderFinished;
+        submit.pSignalSemaphores = &sync.renderFinished[imageIndex];
 
-        vkQueueSubmit(graphicsQueue, 1, &submit, inFlight);
+        recordZone.End();
+        VgtTraceZone submitZone("submit");
+        vkQueueSubmit(graphicsQueue, 1, &submit, sync.inFlight[frame]);
+        submitZone.End();
 
-        VkPresentInfoKHR present{ VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
-        present.waitSemaphoreCount = 1;
-        present.pWaitSemaphores = &renderFinished;
-        present.swapchainCount = 1;
-        present.pSwapchains = &swapchain;
-        present.pImageIndices = &imageIndex;
-        vkQueuePresentKHR(presentQueue, &present);
+        VgtFrameStatsCpuEnd(frameStats);
 
-        vkQueueWaitIdle(presentQueue);
+        {
+            const VkResult res = VgtPresenterPresent(presenter, sync.renderFinished[imageIndex], imageIndex);
+            if (res != VK_SUCCESS)
+            {
+                PrintVkResult("VgtPresenterPresent", res);
+                break;
+            }
+        }
+        if (presenter.framesPresented == 1 && (options.showFps || options.benchmark))
+        {
+            std::fprintf(stderr, "[Step03_Texture] first frame after %.1f ms (%s startup)\n",
+                1000.0 * (VgtGetTimeSeconds() - launchTime), options.serialStartup ? "serial" : "parallel");
+        }
+
+        VgtAdvanceFrame(sync);
+        // --memory-stats: once everything is live (a streamed texture may still be on its way).
+        if (options.memoryStats && presenter.framesPresented == 1)
+            VgtPrintAllocatorStats("Step03_Texture", VgtGetAllocatorStats(allocator), "first frame");
+        VgtFrameStatsTick(frameStats);
+        VgtBenchmarkTick(bench, frameStats, gpuTimer);
+        VgtGpuTimerTick(gpuTimer);
     }
 
     vkDeviceWaitIdle(device);
-
-    vkDestroyFence(device, inFlight, nullptr);
-    vkDestroySemaphore(device, renderFinished, nullptr);
-    vkDestroySemaphore(device, imageAvailable, nullptr);
-
-    vkFreeCommandBuffers(device, cmdPool, swapImageCount, cmdBuffers.data());
+    if (options.memoryStats)
+        VgtPrintAllocatorStats("Step03_Texture", VgtGetAllocatorStats(allocator), "before teardown");
+    VgtFrameStatsFinish(frameStats);
+    VgtGpuTimerFinish(gpuTimer);
+    VgtBenchmarkFinish(bench, gpuTimer);
+    VgtTraceStop();
+
+    VgtDestroyFrameSync(device, sync);
+    VgtDestroyGpuTimer(gpuTimer);
+
+    vkFreeCommandBuffers(device, cmdPool, options.framesInFlight, cmdBuffers.data());
+    if (!staticCmdBuffers.empty())
+        vkFreeCommandBuffers(device, cmdPool, static_cast<uint32_t>(staticCmdBuffers.size()), staticCmdBuffers.data());
     vkDestroyCommandPool(device, cmdPool, nullptr);
 
     vkDestroyPipeline(device, pipeline, nullptr);
+    VgtDestroyPipelineCache(device, pipelineCache);
     vkDestroyShaderModule(device, fragModule, nullptr);
     vkDestroyShaderModule(device, vertModule, nullptr);
     vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
@@ -969,13 +911,14 @@ int main()
     vkDestroyDescriptorPool(device, descPool, nullptr);
     vkDestroyDescriptorSetLayout(device, descLayout, nullptr);
 
-    vkDestroySampler(device, textureSampler, nullptr);
-    vkDestroyImageView(device, textureView, nullptr);
-    vkDestroyImage(device, textureImage, nullptr);
-    vkFreeMemory(device, textureMemory, nullptr);
+    if (textureSampler)
+        vkDestroySampler(device, textureSampler, nullptr);
+    vkDestroySampler(device, placeholderSampler, nullptr);
+    VgtDestroyTextureStreamer(streamer);
 
-    vkDestroyBuffer(device, vertexBuffer, nullptr);
-    vkFreeMemory(device, vertexMem, nullptr);
+    VgtDestroyBuffer(allocator, indexBuffer, indexAlloc);
+    VgtDestroyBuffer(allocator, vertexBuffer, vertexAlloc);
+    VgtDestroyUploadContext(upload);
 
     for (auto fb : framebuffers)
         vkDestroyFramebuffer(device, fb, nullptr);
@@ -985,15 +928,19 @@ int main()
     for (auto v : swapImageViews)
         vkDestroyImageView(device, v, nullptr);
 
-    vkDestroySwapchainKHR(device, swapchain, nullptr);
+    VgtPresenterDestroySwapchain(presenter);
+    VgtDestroyAllocator(allocator);
+
     vkDestroyDevice(device, nullptr);
 
-    vkDestroySurfaceKHR(instance, surface, nullptr);
+    VgtPresenterDestroySurface(presenter);
 
     vkDestroyInstance(instance, nullptr);
 
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    VgtPresenterShutdown(presenter);
+
+    // After the streamer: pack-backed images are read until their staging copy is recorded.
+    VgtCloseAssetPack(assetPack);
 
     if (pauseOnExit)
     {
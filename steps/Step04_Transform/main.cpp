@@ -1,18 +1,33 @@
-#include <cassert>
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <vector>
 #include <string>
 #include <fstream>
 #include <cstring>
-#include <cmath>
 
-#include <Windows.h>
-
-#define GLFW_INCLUDE_VULKAN
-#include <GLFW/glfw3.h>
+#include <vulkan/vulkan.h>
 
 #include <VgtConfig.h>
+#include <VgtAllocator.h>
+#include <VgtBenchmark.h>
+#include <VgtDepth.h>
+#include <VgtFrameStats.h>
+#include <VgtFrameSync.h>
+#include <VgtGpuCull.h>
+#include <VgtGpuTimer.h>
+#include <VgtIndirectDraw.h>
+#include <VgtMath.h>
+#include <VgtOptions.h>
+#include <VgtParallelRecorder.h>
+#include <VgtPipelineCache.h>
+#include <VgtPlatform.h>
+#include <VgtPresenter.h>
+#include <VgtSpirv.h>
+#include <VgtTrace.h>
+#include <VgtUniformRing.h>
+#include <VgtUpload.h>
 
 static void PrintVkResult(const char* what, VkResult res)
 {
@@ -23,8 +38,7 @@ static void PrintVkResult(const char* what, VkResult res)
 
 static void ShowFatal(const char* msg)
 {
-    std::fprintf(stderr, "%s\n", msg);
-    MessageBoxA(nullptr, msg, "Step04_Transform", MB_OK | MB_ICONERROR);
+    VgtShowError("Step04_Transform", msg);
 }
 
 struct Vertex
@@ -35,226 +49,71 @@ struct Vertex
 
 struct UniformBufferObject
 {
-    float mvp[16];
+    VgtMat4 mvp;
 };
 
-static void Mat4Identity(float* m)
-{
-    for (int i = 0; i < 16; ++i)
-        m[i] = 0.0f;
-    m[0] = m[5] = m[10] = m[15] = 1.0f;
-}
-
-static void Mat4RotateY(float* m, float angle)
-{
-    const float c = std::cosf(angle);
-    const float s = std::sinf(angle);
-    Mat4Identity(m);
-    m[0] = c;
-    m[2] = s;
-    m[8] = -s;
-    m[10] = c;
-}
-
-static void Mat4LookAt(float* m, float eyeX, float eyeY, float eyeZ,
-                       float centerX, float centerY, float centerZ,
-                       float upX, float upY, float upZ)
+// --indirect: one UBO for all objects (transform_indirect.vert).
+struct IndirectUniforms
 {
-    float fx = centerX - eyeX;
-    float fy = centerY - eyeY;
-    float fz = centerZ - eyeZ;
-    float rlf = 1.0f / std::sqrtf(fx * fx + fy * fy + fz * fz);
-    fx *= rlf;
-    fy *= rlf;
-    fz *= rlf;
-
-    float sx = fy * upZ - fz * upY;
-    float sy = fz * upX - fx * upZ;
-    float sz = fx * upY - fy * upX;
-    float rls = 1.0f / std::sqrtf(sx * sx + sy * sy + sz * sz);
-    sx *= rls;
-    sy *= rls;
-    sz *= rls;
-
-    float ux = sy * fz - sz * fy;
-    float uy = sz * fx - sx * fz;
-    float uz = sx * fy - sy * fx;
-
-    m[0] = sx;
-    m[1] = ux;
-    m[2] = -fx;
-    m[3] = 0.0f;
-    m[4] = sy;
-    m[5] = uy;
-    m[6] = -fy;
-    m[7] = 0.0f;
-    m[8] = sz;
-    m[9] = uz;
-    m[10] = -fz;
-    m[11] = 0.0f;
-    m[12] = -(sx * eyeX + sy * eyeY + sz * eyeZ);
-    m[13] = -(ux * eyeX + uy * eyeY + uz * eyeZ);
-    m[14] = (fx * eyeX + fy * eyeY + fz * eyeZ);
-    m[15] = 1.0f;
-}
-
-static void Mat4Perspective(float* m, float fovY, float aspect, float zNear, float zFar)
-{
-    const float tanHalfFovy = std::tanf(fovY / 2.0f);
-    for (int i = 0; i < 16; ++i)
-        m[i] = 0.0f;
-    m[0] = 1.0f / (aspect * tanHalfFovy);
-    m[5] = 1.0f / tanHalfFovy;
-    m[10] = zFar / (zNear - zFar);
-    m[11] = -1.0f;
-    m[14] = -(zFar * zNear) / (zFar - zNear);
-    
-    // Vulkan clip space has inverted Y and depth [0, 1]
-    // We handle this by negating Y in the projection
-    m[5] = -m[5];
-}
-
-static void Mat4Multiply(float* out, const float* a, const float* b)
-{
-    float temp[16];
-    for (int row = 0; row < 4; ++row)
-    {
-        for (int col = 0; col < 4; ++col)
-        {
-            temp[row * 4 + col] = 0.0f;
-            for (int k = 0; k < 4; ++k)
-            {
-                temp[row * 4 + col] += a[row * 4 + k] * b[k * 4 + col];
-            }
-        }
-    }
-    std::memcpy(out, temp, sizeof(temp));
-}
-
-static void Mat4Transpose(float* out, const float* m)
-{
-    float temp[16];
-    for (int row = 0; row < 4; ++row)
-    {
-        for (int col = 0; col < 4; ++col)
-        {
-            temp[col * 4 + row] = m[row * 4 + col];
-        }
-    }
-    std::memcpy(out, temp, sizeof(temp));
-}
-
-static std::vector<uint32_t> ReadSpirvFile(const char* path)
-{
-    std::ifstream file(path, std::ios::binary | std::ios::ate);
-    if (!file)
-        return {};
-
-    const std::streamsize size = file.tellg();
-    if (size <= 0)
-        return {};
-
-    std::vector<uint32_t> data(static_cast<size_t>(size / 4));
-    file.seekg(0);
-    file.read(reinterpret_cast<char*>(data.data()), size);
-    return data;
-}
-
-static std::vector<uint32_t> ReadSpirvWithFallback(const char* relativePath)
-{
-    // Try runtime layout first (when shaders are copied next to the exe).
-    {
-        auto data = ReadSpirvFile(relativePath);
-        if (!data.empty())
-            return data;
-    }
-
-    // Fallback: locate shader outputs relative to the executable.
-    // This handles cases where the working directory is not the exe directory.
-    {
-        char exePath[MAX_PATH] = {};
-        const DWORD len = GetModuleFileNameA(nullptr, exePath, MAX_PATH);
-        if (len > 0 && len < MAX_PATH)
-        {
-            std::string exeDir(exePath);
-            const size_t lastSlash = exeDir.find_last_of("\\/");
-            if (lastSlash != std::string::npos)
-                exeDir.resize(lastSlash + 1);
-
-            std::string fromExeDir = exeDir + std::string("compiled_shaders/") + relativePath;
-            {
-                auto data = ReadSpirvFile(fromExeDir.c_str());
-                if (!data.empty())
-                    return data;
-            }
+    VgtMat4 spin;
+    VgtMat4 viewProj;
+};
 
-            // Common MSBuild layout: <target>/Debug/.. == <target>/
-            std::string exeParentDir = exeDir;
-            if (!exeParentDir.empty())
-            {
-                // remove trailing slash
-                while (!exeParentDir.empty() && (exeParentDir.back() == '\\' || exeParentDir.back() == '/'))
-                    exeParentDir.pop_back();
-                const size_t parentSlash = exeParentDir.find_last_of("\\/");
-                if (parentSlash != std::string::npos)
-                {
-                    exeParentDir.resize(parentSlash + 1);
-                    std::string fromExeParentDir = exeParentDir + std::string("compiled_shaders/") + relativePath;
-                    {
-                        auto data = ReadSpirvFile(fromExeParentDir.c_str());
-                        if (!data.empty())
-                            return data;
-                    }
-                }
-            }
-        }
-    }
+// Minimum UBO pushes per frame; each frame slice of the uniform ring holds at least this many
+// (and one per draw with --draws N).
+constexpr uint32_t kMaxUniformsPerFrame = 1024;
 
-    // Fallback: run from build tree.
-    // e.g. build-ninja/.../steps/Step04_Transform/compiled_shaders
-    std::string alt = std::string("compiled_shaders/") + relativePath;
-    {
-        auto data = ReadSpirvFile(alt.c_str());
-        if (!data.empty())
-            return data;
-    }
+// Side of the square the --draws N copies are spread over: inside the view by default, about
+// five times wider than the view with --cull so most objects end up outside the frustum.
+constexpr float kGridExtent = 1.6f;
+constexpr float kCullGridExtent = 8.0f;
 
-    return {};
-}
+// Seconds between two "culling:" lines.
+constexpr double kCullReportIntervalSec = 2.0;
 
-static uint32_t FindMemoryTypeIndex(VkPhysicalDevice physicalDevice, uint32_t typeBits, VkMemoryPropertyFlags properties)
+// Model matrix of copy `index` out of `count`. One copy is the original full-size triangle;
+// more copies shrink onto a centered `extent`-wide grid, each spinning with its own phase.
+// Row vectors (see VgtMath.h): translation in m[12..14]. The scale is uniform and the spin is
+// about the same axis as the phase, so GridModel(i, n, a) == VgtMat4RotateY(a) * GridModel(i, n, 0).
+static VgtMat4 GridModel(uint32_t index, uint32_t count, float angle, float extent)
 {
-    VkPhysicalDeviceMemoryProperties memProps{};
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProps);
-
-    for (uint32_t i = 0; i < memProps.memoryTypeCount; ++i)
-    {
-        if ((typeBits & (1u << i)) && (memProps.memoryTypes[i].propertyFlags & properties) == properties)
-            return i;
-    }
-
-    return UINT32_MAX;
+    if (count == 1)
+        return VgtMat4RotateY(angle);
+
+    const uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(count))));
+    const float cell = extent / static_cast<float>(side);
+
+    VgtMat4 model = VgtMat4RotateY(angle + 0.1f * static_cast<float>(index));
+    for (uint32_t i = 0; i < 12; ++i)
+        model.m[i] *= cell;
+    model.m[12] = -0.5f * extent + cell * (static_cast<float>(index % side) + 0.5f);
+    model.m[13] = -0.5f * extent + cell * (static_cast<float>(index / side) + 0.5f);
+    return model;
 }
 
-int main()
+int main(int argc, char** argv)
 {
-    bool pauseOnExit = false;
-    {
-        char* val = nullptr;
-        size_t len = 0;
-        if (_dupenv_s(&val, &len, "VGT_PAUSE_ON_EXIT") == 0 && val != nullptr)
-        {
-            pauseOnExit = true;
-            std::free(val);
-        }
-    }
-
-    if (!glfwInit())
-        return 1;
-
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-    GLFWwindow* window = glfwCreateWindow(1280, 720, "Step04_Transform", nullptr, nullptr);
-    if (!window)
+    const VgtOptions options = VgtParseOptions(argc, argv);
+    VgtTraceStart(options.tracePath.c_str(), "Step04_Transform");
+    VgtTraceZone initZone("init");
+    VgtBenchmark bench;
+    VgtBenchmarkBegin(bench, "Step04_Transform", options);
+
+    std::string pauseEnv;
+    const bool pauseOnExit = VgtGetEnv("VGT_PAUSE_ON_EXIT", pauseEnv);
+
+    // Window (or nothing, when rendering headless)
+    VgtPresenterCreateInfo presenterCI{};
+    presenterCI.title = "Step04_Transform";
+    presenterCI.backend = options.backend;
+    presenterCI.frameLimit = options.frameLimit;
+    presenterCI.presentMode = options.presentMode;
+    presenterCI.swapchainImages = options.swapchainImages;
+    presenterCI.framesInFlight = options.framesInFlight;
+    presenterCI.measureLatency = options.latency;
+
+    VgtPresenter presenter;
+    if (!VgtPresenterInit(presenterCI, presenter))
         return 1;
 
     // Instance
@@ -262,9 +121,8 @@ int main()
     appInfo.pApplicationName = "vulkan-glsl-tutorial";
     appInfo.apiVersion = VK_API_VERSION_1_3;
 
-    uint32_t glfwExtCount = 0;
-    const char** glfwExts = glfwGetRequiredInstanceExtensions(&glfwExtCount);
-    std::vector<const char*> instanceExts(glfwExts, glfwExts + glfwExtCount);
+    std::vector<const char*> instanceExts;
+    VgtPresenterGetInstanceExtensions(presenter, instanceExts);
 
     std::vector<const char*> layers;
 #if VGT_ENABLE_VALIDATION
@@ -281,6 +139,7 @@ int main()
 
     VkInstance instance = VK_NULL_HANDLE;
     {
+        VGT_TRACE_ZONE("instance creation");
         const VkResult res = vkCreateInstance(&instanceCI, nullptr, &instance);
         if (res != VK_SUCCESS)
         {
@@ -292,14 +151,13 @@ int main()
         }
     }
 
-    // Surface
-    VkSurfaceKHR surface = VK_NULL_HANDLE;
+    // Surface (none when rendering offscreen)
     {
-        const VkResult res = glfwCreateWindowSurface(instance, window, nullptr, &surface);
+        const VkResult res = VgtPresenterCreateSurface(presenter, instance);
         if (res != VK_SUCCESS)
         {
-            PrintVkResult("glfwCreateWindowSurface", res);
-            ShowFatal("glfwCreateWindowSurface failed");
+            PrintVkResult("VgtPresenterCreateSurface", res);
+            ShowFatal("Surface creation failed");
             if (pauseOnExit)
                 (void)std::getchar();
             return 1;
@@ -326,12 +184,13 @@ int main()
         if ((qProps[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) && graphicsQ == UINT32_MAX)
             graphicsQ = i;
 
-        VkBool32 presentSupport = VK_FALSE;
-        vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentSupport);
-        if (presentSupport && presentQ == UINT32_MAX)
+        if (VgtPresenterSupportsPresent(presenter, physicalDevice, i) && presentQ == UINT32_MAX)
             presentQ = i;
     }
 
+    // Dedicated copy queue for static uploads (see VgtUpload.h), when the device has one.
+    const uint32_t transferQ = VgtFindTransferQueueFamily(physicalDevice);
+
     float qPriority = 1.0f;
     std::vector<VkDeviceQueueCreateInfo> queueCIs;
     {
@@ -349,18 +208,44 @@ int main()
             pqci.pQueuePriorities = &qPriority;
             queueCIs.push_back(pqci);
         }
+
+        if (transferQ != UINT32_MAX && transferQ != graphicsQ && transferQ != presentQ)
+        {
+            VkDeviceQueueCreateInfo tqci{ VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
+            tqci.queueFamilyIndex = transferQ;
+            tqci.queueCount = 1;
+            tqci.pQueuePriorities = &qPriority;
+            queueCIs.push_back(tqci);
+        }
     }
 
-    const char* deviceExts[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+    std::vector<const char*> deviceExts;
+    VgtPresenterGetDeviceExtensions(presenter, deviceExts);
 
     VkDeviceCreateInfo deviceCI{ VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
     deviceCI.queueCreateInfoCount = static_cast<uint32_t>(queueCIs.size());
     deviceCI.pQueueCreateInfos = queueCIs.data();
-    deviceCI.enabledExtensionCount = 1;
-    deviceCI.ppEnabledExtensionNames = deviceExts;
+    deviceCI.enabledExtensionCount = static_cast<uint32_t>(deviceExts.size());
+    deviceCI.ppEnabledExtensionNames = deviceExts.empty() ? nullptr : deviceExts.data();
+
+    // --indirect: multi-draw indirect (with a GPU-side count when available), else one instanced draw.
+    VkPhysicalDeviceFeatures enabledFeatures{};
+    VkPhysicalDeviceVulkan12Features enabledFeatures12{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+    VgtIndirectPath indirectPath = VgtIndirectPath::Instanced;
+    if (options.indirect)
+    {
+        indirectPath = VgtEnableIndirectDrawFeatures(physicalDevice, enabledFeatures, enabledFeatures12);
+        if (indirectPath == VgtIndirectPath::Count)
+            deviceCI.pNext = &enabledFeatures12;
+    }
+    deviceCI.pEnabledFeatures = &enabledFeatures;
+
+    // --latency: present id / present wait for input-to-photon timing, when supported.
+    VgtPresenterEnableDeviceFeatures(presenter, physicalDevice, deviceExts, deviceCI);
 
     VkDevice device = VK_NULL_HANDLE;
     {
+        VGT_TRACE_ZONE("device creation");
         const VkResult res = vkCreateDevice(physicalDevice, &deviceCI, nullptr, &device);
         if (res != VK_SUCCESS)
         {
@@ -373,137 +258,99 @@ int main()
     }
 
     VkQueue graphicsQueue = VK_NULL_HANDLE;
-    VkQueue presentQueue = VK_NULL_HANDLE;
     vkGetDeviceQueue(device, graphicsQ, 0, &graphicsQueue);
-    vkGetDeviceQueue(device, presentQ, 0, &presentQueue);
 
-    // Swapchain
-    VkSurfaceCapabilitiesKHR caps{};
-    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, surface, &caps);
+    // Device memory: buffers and images are sub-allocated from large per-memory-type blocks.
+    VgtAllocatorCreateInfo allocatorCI{};
+    allocatorCI.physicalDevice = physicalDevice;
+    allocatorCI.device = device;
+
+    VgtAllocator allocator;
+    VgtCreateAllocator(allocatorCI, allocator);
 
-    uint32_t formatCount = 0;
-    vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, nullptr);
-    std::vector<VkSurfaceFormatKHR> formats(formatCount);
-    vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, formats.data());
+    // Static geometry goes to DEVICE_LOCAL memory through staging copies.
+    VgtUploadContextCreateInfo uploadCI{};
+    uploadCI.device = device;
+    uploadCI.allocator = &allocator;
+    uploadCI.graphicsQueueFamily = graphicsQ;
+    uploadCI.transferQueueFamily = transferQ;
 
-    VkSurfaceFormatKHR surfaceFormat = formats[0];
-    for (const auto& f : formats)
+    VgtUploadContext upload;
     {
-        if (f.format == VK_FORMAT_B8G8R8A8_UNORM && f.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+        const VkResult res = VgtCreateUploadContext(uploadCI, upload);
+        if (res != VK_SUCCESS)
         {
-            surfaceFormat = f;
-            break;
+            PrintVkResult("VgtCreateUploadContext", res);
+            return 1;
         }
     }
 
-    VkExtent2D extent = caps.currentExtent;
-    if (extent.width == UINT32_MAX)
+    // Swapchain (offscreen images when headless)
+    VgtSwapchainDesc swapDesc{};
+    swapDesc.graphicsQueueFamily = graphicsQ;
+    swapDesc.presentQueueFamily = presentQ;
     {
-        int w = 0, h = 0;
-        glfwGetFramebufferSize(window, &w, &h);
-        extent.width = static_cast<uint32_t>(w);
-        extent.height = static_cast<uint32_t>(h);
-    }
-
-    VkSwapchainCreateInfoKHR swapCI{ VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR };
-    swapCI.surface = surface;
-    swapCI.minImageCount = caps.minImageCount + 1;
-    swapCI.imageFormat = surfaceFormat.format;
-    swapCI.imageColorSpace = surfaceFormat.colorSpace;
-    swapCI.imageExtent = extent;
-    swapCI.imageArrayLayers = 1;
-    swapCI.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-    swapCI.preTransform = caps.currentTransform;
-    swapCI.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-    swapCI.presentMode = VK_PRESENT_MODE_FIFO_KHR;
-    swapCI.clipped = VK_TRUE;
-
-    uint32_t qIndices[] = { graphicsQ, presentQ };
-    if (graphicsQ != presentQ)
-    {
-        swapCI.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
-        swapCI.queueFamilyIndexCount = 2;
-        swapCI.pQueueFamilyIndices = qIndices;
-    }
-
-    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
-    {
-        const VkResult res = vkCreateSwapchainKHR(device, &swapCI, nullptr, &swapchain);
+        const VkResult res = VgtPresenterCreateSwapchain(presenter, physicalDevice, device, swapDesc);
         if (res != VK_SUCCESS)
         {
-            PrintVkResult("vkCreateSwapchainKHR", res);
-            ShowFatal("vkCreateSwapchainKHR failed");
+            PrintVkResult("VgtPresenterCreateSwapchain", res);
+            ShowFatal("Swapchain creation failed");
             if (pauseOnExit)
                 (void)std::getchar();
             return 1;
         }
     }
 
-    uint32_t swapImageCount = 0;
-    vkGetSwapchainImagesKHR(device, swapchain, &swapImageCount, nullptr);
-    std::vector<VkImage> swapImages(swapImageCount);
-    vkGetSwapchainImagesKHR(device, swapchain, &swapImageCount, swapImages.data());
+    // References: both change when the swapchain is recreated.
+    const VkExtent2D& extent = presenter.extent;
+    const std::vector<VkImage>& swapImages = presenter.images;
 
-    std::vector<VkImageView> swapImageViews(swapImageCount);
-    for (uint32_t i = 0; i < swapImageCount; ++i)
+    // Uniform buffer: one persistently mapped ring, sliced per frame in flight.
+    // Each frame pushes its UBO(s) into its own slice and binds them with a dynamic offset.
+    // One UBO per draw, or a single shared one when the objects come from the storage buffer (--indirect).
+    const uint32_t uniformsPerFrame = options.indirect ? 1 : options.drawCount;
+    const VkDeviceSize uboSize = options.indirect ? sizeof(IndirectUniforms) : sizeof(UniformBufferObject);
+    VgtUniformRing uniformRing;
     {
-        VkImageViewCreateInfo viewCI{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
-        viewCI.image = swapImages[i];
-        viewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        viewCI.format = surfaceFormat.format;
-        viewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        viewCI.subresourceRange.levelCount = 1;
-        viewCI.subresourceRange.layerCount = 1;
-        vkCreateImageView(device, &viewCI, nullptr, &swapImageViews[i]);
+        const VkResult res =
+            VgtCreateUniformRing(allocator, uboSize, std::max(kMaxUniformsPerFrame, uniformsPerFrame), options.framesInFlight, uniformRing);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtCreateUniformRing", res);
+            return 1;
+        }
     }
-
-    // Uniform buffer
-    VkBufferCreateInfo uniformBufCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-    uniformBufCI.size = sizeof(UniformBufferObject);
-    uniformBufCI.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-    uniformBufCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-    VkBuffer uniformBuffer = VK_NULL_HANDLE;
-    vkCreateBuffer(device, &uniformBufCI, nullptr, &uniformBuffer);
-
-    VkMemoryRequirements uniformMemReq{};
-    vkGetBufferMemoryRequirements(device, uniformBuffer, &uniformMemReq);
-
-    uint32_t uniformMemType = FindMemoryTypeIndex(
-        physicalDevice,
-        uniformMemReq.memoryTypeBits,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-    VkMemoryAllocateInfo uniformAlloc{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-    uniformAlloc.allocationSize = uniformMemReq.size;
-    uniformAlloc.memoryTypeIndex = uniformMemType;
-
-    VkDeviceMemory uniformMemory = VK_NULL_HANDLE;
-    vkAllocateMemory(device, &uniformAlloc, nullptr, &uniformMemory);
-    vkBindBufferMemory(device, uniformBuffer, uniformMemory, 0);
-
-    // Descriptor set layout
-    VkDescriptorSetLayoutBinding uboBinding{};
-    uboBinding.binding = 0;
-    uboBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    uboBinding.descriptorCount = 1;
-    uboBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    const VkDeviceSize uboStride = VgtUniformRingAlign(uniformRing, uboSize);
+
+    // Descriptor set layout (binding 1: per-object model matrices, --indirect only)
+    VkDescriptorSetLayoutBinding bindings[2]{};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    const uint32_t bindingCount = options.indirect ? 2 : 1;
 
     VkDescriptorSetLayoutCreateInfo descLayoutCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
-    descLayoutCI.bindingCount = 1;
-    descLayoutCI.pBindings = &uboBinding;
+    descLayoutCI.bindingCount = bindingCount;
+    descLayoutCI.pBindings = bindings;
 
     VkDescriptorSetLayout descLayout = VK_NULL_HANDLE;
     vkCreateDescriptorSetLayout(device, &descLayoutCI, nullptr, &descLayout);
 
     // Descriptor pool
-    VkDescriptorPoolSize poolSize{};
-    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSize.descriptorCount = 1;
+    VkDescriptorPoolSize poolSizes[2]{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSizes[0].descriptorCount = 1;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[1].descriptorCount = 1;
 
     VkDescriptorPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
-    poolCI.poolSizeCount = 1;
-    poolCI.pPoolSizes = &poolSize;
+    poolCI.poolSizeCount = bindingCount;
+    poolCI.pPoolSizes = poolSizes;
     poolCI.maxSets = 1;
 
     VkDescriptorPool descPool = VK_NULL_HANDLE;
@@ -519,61 +366,126 @@ int main()
     vkAllocateDescriptorSets(device, &descAI, &descSet);
 
     VkDescriptorBufferInfo bufferInfo{};
-    bufferInfo.buffer = uniformBuffer;
+    bufferInfo.buffer = uniformRing.buffer;
     bufferInfo.offset = 0;
-    bufferInfo.range = sizeof(UniformBufferObject);
+    bufferInfo.range = uboSize;
 
     VkWriteDescriptorSet descWrite{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
     descWrite.dstSet = descSet;
     descWrite.dstBinding = 0;
     descWrite.dstArrayElement = 0;
-    descWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    descWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     descWrite.descriptorCount = 1;
     descWrite.pBufferInfo = &bufferInfo;
 
     vkUpdateDescriptorSets(device, 1, &descWrite, 0, nullptr);
 
+    // Depth buffer: one image shared by every framebuffer (see VgtDepth.h), created with them below.
+    const VkFormat depthFormat = VgtPickDepthFormat(physicalDevice);
+
     // Render pass
-    VkAttachmentDescription colorAttachment{};
-    colorAttachment.format = surfaceFormat.format;
+    VkAttachmentDescription attachmentDescs[2]{};
+    VkAttachmentDescription& colorAttachment = attachmentDescs[0];
+    colorAttachment.format = presenter.format;
     colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
     colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    colorAttachment.finalLayout = presenter.presentLayout;
+
+    // Depth is cleared on load and never stored: nothing reads it after the pass.
+    VkAttachmentDescription& depthAttachment = attachmentDescs[1];
+    depthAttachment.format = depthFormat;
+    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
     VkAttachmentReference colorRef{};
     colorRef.attachment = 0;
     colorRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
+    VkAttachmentReference depthRef{};
+    depthRef.attachment = 1;
+    depthRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
     VkSubpassDescription subpass{};
     subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
     subpass.colorAttachmentCount = 1;
     subpass.pColorAttachments = &colorRef;
+    subpass.pDepthStencilAttachment = &depthRef;
+
+    // The depth image is shared between frames in flight: this frame's clear must wait for the
+    // previous frame's depth tests, and the color write for the acquire semaphore (which waits
+    // at COLOR_ATTACHMENT_OUTPUT).
+    VkSubpassDependency dependency{};
+    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependency.dstSubpass = 0;
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependency.dstStageMask = dependency.srcStageMask;
+    dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 
     VkRenderPassCreateInfo rpCI{ VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
-    rpCI.attachmentCount = 1;
-    rpCI.pAttachments = &colorAttachment;
+    rpCI.attachmentCount = 2;
+    rpCI.pAttachments = attachmentDescs;
     rpCI.subpassCount = 1;
     rpCI.pSubpasses = &subpass;
+    rpCI.dependencyCount = 1;
+    rpCI.pDependencies = &dependency;
 
     VkRenderPass renderPass = VK_NULL_HANDLE;
     vkCreateRenderPass(device, &rpCI, nullptr, &renderPass);
 
-    // Framebuffers
-    std::vector<VkFramebuffer> framebuffers(swapImageCount);
-    for (uint32_t i = 0; i < swapImageCount; ++i)
+    // Swapchain-sized targets: the depth buffer, plus an image view and framebuffer per swapchain
+    // image. Rebuilt by recreateSwapchain below.
+    VgtDepthBuffer depthBuffer;
+    std::vector<VkImageView> swapImageViews;
+    std::vector<VkFramebuffer> framebuffers;
+    auto createSwapchainTargets = [&]() -> VkResult
     {
-        VkImageView attachments[] = { swapImageViews[i] };
-        VkFramebufferCreateInfo fbCI{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
-        fbCI.renderPass = renderPass;
-        fbCI.attachmentCount = 1;
-        fbCI.pAttachments = attachments;
-        fbCI.width = extent.width;
-        fbCI.height = extent.height;
-        fbCI.layers = 1;
-        vkCreateFramebuffer(device, &fbCI, nullptr, &framebuffers[i]);
-    }
+        {
+            const VkResult res = VgtCreateDepthBuffer(allocator, device, depthFormat, extent, depthBuffer);
+            if (res != VK_SUCCESS)
+            {
+                PrintVkResult("VgtCreateDepthBuffer", res);
+                return res;
+            }
+        }
+
+        const uint32_t imageCount = static_cast<uint32_t>(swapImages.size());
+        swapImageViews.assign(imageCount, VK_NULL_HANDLE);
+        framebuffers.assign(imageCount, VK_NULL_HANDLE);
+        for (uint32_t i = 0; i < imageCount; ++i)
+        {
+            VkImageViewCreateInfo viewCI{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+            viewCI.image = swapImages[i];
+            viewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewCI.format = presenter.format;
+            viewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            viewCI.subresourceRange.levelCount = 1;
+            viewCI.subresourceRange.layerCount = 1;
+            vkCreateImageView(device, &viewCI, nullptr, &swapImageViews[i]);
+
+            VkImageView attachments[] = { swapImageViews[i], depthBuffer.view };
+            VkFramebufferCreateInfo fbCI{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
+            fbCI.renderPass = renderPass;
+            fbCI.attachmentCount = 2;
+            fbCI.pAttachments = attachments;
+            fbCI.width = extent.width;
+            fbCI.height = extent.height;
+            fbCI.layers = 1;
+            vkCreateFramebuffer(device, &fbCI, nullptr, &framebuffers[i]);
+        }
+        return VK_SUCCESS;
+    };
+    if (createSwapchainTargets() != VK_SUCCESS)
+        return 1;
 
     // Vertex buffer (triangle with 3D positions)
     Vertex vertices[3] = {
@@ -582,34 +494,145 @@ int main()
         { { -0.5f,  0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
     };
 
-    VkBufferCreateInfo bufCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-    bufCI.size = sizeof(vertices);
-    bufCI.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-    bufCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
     VkBuffer vertexBuffer = VK_NULL_HANDLE;
-    vkCreateBuffer(device, &bufCI, nullptr, &vertexBuffer);
-
-    VkMemoryRequirements memReq{};
-    vkGetBufferMemoryRequirements(device, vertexBuffer, &memReq);
+    VgtAllocation vertexAlloc;
+    {
+        const VkResult res = VgtUploadBuffer(upload, vertices, sizeof(vertices), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer, vertexAlloc);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("Vertex buffer upload", res);
+            return 1;
+        }
+    }
 
-    uint32_t memType = FindMemoryTypeIndex(
-        physicalDevice,
-        memReq.memoryTypeBits,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    // --cull: the compute pass runs on the graphics queue and needs one command per object.
+    bool cull = options.cull;
+    if (cull && indirectPath == VgtIndirectPath::Instanced)
+    {
+        std::fprintf(stderr, "Ignoring --cull: the device has no multiDrawIndirect / drawIndirectFirstInstance\n");
+        cull = false;
+    }
+    if (cull && !(qProps[graphicsQ].queueFlags & VK_QUEUE_COMPUTE_BIT))
+    {
+        std::fprintf(stderr, "Ignoring --cull: the graphics queue family has no compute support\n");
+        cull = false;
+    }
+    const float gridExtent = cull ? kCullGridExtent : kGridExtent;
+
+    // --indirect: everything the GPU needs to draw all objects without per-object CPU work.
+    // The model matrices are static (the spin is shared and goes into the UBO), the commands are
+    // written once, and the count buffer holds the command count for vkCmdDrawIndexedIndirectCount.
+    // With --cull the commands and the count are rewritten every frame by the cull pass, from one
+    // world-space bounding sphere per object.
+    VkBuffer indexBuffer = VK_NULL_HANDLE;
+    VgtAllocation indexAlloc;
+    VkBuffer objectBuffer = VK_NULL_HANDLE;
+    VgtAllocation objectAlloc;
+    VkBuffer indirectBuffer = VK_NULL_HANDLE;
+    VgtAllocation indirectAlloc;
+    VkBuffer countBuffer = VK_NULL_HANDLE;
+    VgtAllocation countAlloc;
+    VkBuffer boundsBuffer = VK_NULL_HANDLE;
+    VgtAllocation boundsAlloc;
+    uint32_t indirectCommandCount = 0;
+    if (options.indirect)
+    {
+        const uint16_t indices[3] = { 0, 1, 2 };
+
+        std::vector<VgtMat4> models(options.drawCount);
+        for (uint32_t i = 0; i < options.drawCount; ++i)
+            models[i] = GridModel(i, options.drawCount, 0.0f, gridExtent);
+
+        const std::vector<VkDrawIndexedIndirectCommand> commands = VgtBuildIndirectCommands(indirectPath, options.drawCount, 3);
+        indirectCommandCount = static_cast<uint32_t>(commands.size());
+
+        VkResult res = VgtUploadBuffer(upload, indices, sizeof(indices), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer, indexAlloc);
+        if (res == VK_SUCCESS)
+            res = VgtUploadBuffer(upload, models.data(), models.size() * sizeof(VgtMat4), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, objectBuffer,
+                objectAlloc);
+        if (res == VK_SUCCESS)
+            res = VgtUploadBuffer(upload, commands.data(), commands.size() * sizeof(VkDrawIndexedIndirectCommand),
+                VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, indirectBuffer, indirectAlloc);
+        if (res == VK_SUCCESS)
+            res = VgtUploadBuffer(upload, &indirectCommandCount, sizeof(indirectCommandCount),
+                VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, countBuffer,
+                countAlloc);
+        if (res == VK_SUCCESS && cull)
+        {
+            // The spin is about each object's origin, so a sphere around the origin bounds the
+            // triangle at any angle; the grid scale is uniform.
+            float radius = 0.0f;
+            for (const Vertex& v : vertices)
+                radius = std::max(radius, std::sqrt(v.pos[0] * v.pos[0] + v.pos[1] * v.pos[1] + v.pos[2] * v.pos[2]));
+
+            std::vector<VgtVec4> spheres(options.drawCount);
+            for (uint32_t i = 0; i < options.drawCount; ++i)
+            {
+                const VgtMat4& m = models[i];
+                const float scale = std::sqrt(m.m[0] * m.m[0] + m.m[1] * m.m[1] + m.m[2] * m.m[2]);
+                spheres[i] = VgtVec4{ m.m[12], m.m[13], m.m[14], radius * scale };
+            }
+            res = VgtUploadBuffer(upload, spheres.data(), spheres.size() * sizeof(VgtVec4), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, boundsBuffer,
+                boundsAlloc);
+        }
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("Indirect buffer upload", res);
+            return 1;
+        }
 
-    VkMemoryAllocateInfo alloc{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-    alloc.allocationSize = memReq.size;
-    alloc.memoryTypeIndex = memType;
+        VkDescriptorBufferInfo objectInfo{};
+        objectInfo.buffer = objectBuffer;
+        objectInfo.offset = 0;
+        objectInfo.range = VK_WHOLE_SIZE;
+
+        VkWriteDescriptorSet objectWrite{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        objectWrite.dstSet = descSet;
+        objectWrite.dstBinding = 1;
+        objectWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        objectWrite.descriptorCount = 1;
+        objectWrite.pBufferInfo = &objectInfo;
+        vkUpdateDescriptorSets(device, 1, &objectWrite, 0, nullptr);
+
+        std::fprintf(stderr, "[Step04_Transform] %u object(s) drawn with %s (%u command(s))%s\n", options.drawCount,
+            VgtIndirectPathName(indirectPath), indirectCommandCount, cull ? ", frustum-culled on the GPU" : "");
+    }
 
-    VkDeviceMemory vertexMem = VK_NULL_HANDLE;
-    vkAllocateMemory(device, &alloc, nullptr, &vertexMem);
-    vkBindBufferMemory(device, vertexBuffer, vertexMem, 0);
+    {
+        const VkResult res = VgtFlushUploads(upload);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtFlushUploads", res);
+            return 1;
+        }
+    }
 
-    void* mapped = nullptr;
-    vkMapMemory(device, vertexMem, 0, sizeof(vertices), 0, &mapped);
-    std::memcpy(mapped, vertices, sizeof(vertices));
-    vkUnmapMemory(device, vertexMem);
+    // --cull: compute pipeline writing indirectBuffer / countBuffer each frame.
+    VgtGpuCull gpuCull;
+    if (cull)
+    {
+        VgtGpuCullCreateInfo cullCI{};
+        cullCI.device = device;
+        cullCI.allocator = &allocator;
+        cullCI.path = indirectPath;
+        cullCI.objectCount = options.drawCount;
+        cullCI.indexCount = 3;
+        cullCI.boundsBuffer = boundsBuffer;
+        cullCI.commandBuffer = indirectBuffer;
+        cullCI.countBuffer = countBuffer;
+        cullCI.framesInFlight = options.framesInFlight;
+        cullCI.shadersFromDisk = options.shadersFromDisk;
+
+        const VkResult res = VgtCreateGpuCull(cullCI, gpuCull);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtCreateGpuCull", res);
+            ShowFatal("Failed to create the culling pipeline (frustum_cull.comp.spv)");
+            if (pauseOnExit)
+                (void)std::getchar();
+            return 1;
+        }
+    }
 
     // Pipeline layout
     VkPipelineLayoutCreateInfo plCI{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
@@ -620,8 +643,8 @@ int main()
     vkCreatePipelineLayout(device, &plCI, nullptr, &pipelineLayout);
 
     // Shader modules
-    const auto vertSpv = ReadSpirvWithFallback("transform.vert.spv");
-    const auto fragSpv = ReadSpirvWithFallback("transform.frag.spv");
+    const auto vertSpv = VgtLoadSpirv(options.indirect ? "transform_indirect.vert.spv" : "transform.vert.spv", options.shadersFromDisk);
+    const auto fragSpv = VgtLoadSpirv("transform.frag.spv", options.shadersFromDisk);
     if (vertSpv.empty() || fragSpv.empty())
     {
         ShowFatal("Failed to load shaders. Did you build the project (which runs glslangValidator)?");
@@ -708,6 +731,11 @@ int main()
     VkPipelineMultisampleStateCreateInfo ms{ VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
     ms.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
 
+    VkPipelineDepthStencilStateCreateInfo ds{ VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO };
+    ds.depthTestEnable = VK_TRUE;
+    ds.depthWriteEnable = VK_TRUE;
+    ds.depthCompareOp = VgtDepthCompareOp(options.reverseZ);
+
     VkPipelineColorBlendAttachmentState cbAttach{};
     cbAttach.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
 
@@ -728,13 +756,27 @@ int main()
     gpCI.pViewportState = &vp;
     gpCI.pRasterizationState = &rs;
     gpCI.pMultisampleState = &ms;
+    gpCI.pDepthStencilState = &ds;
     gpCI.pColorBlendState = &cb;
     gpCI.pDynamicState = &dyn;
     gpCI.layout = pipelineLayout;
     gpCI.renderPass = renderPass;
 
+    // Pipeline cache persisted next to the exe: the first run compiles (cold), later runs reuse it (warm).
+    VgtPipelineCache pipelineCache;
+    {
+        const VkResult res = VgtCreatePipelineCache(physicalDevice, device, "Step04_Transform", options.pipelineCache, pipelineCache);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtCreatePipelineCache", res);
+            return 1;
+        }
+    }
+
     VkPipeline pipeline = VK_NULL_HANDLE;
-    vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &gpCI, nullptr, &pipeline);
+    VgtCreateGraphicsPipelines(device, pipelineCache, 1, &gpCI, &pipeline);
+    if (options.showFps || options.benchmark)
+        VgtPrintPipelineCacheStats("Step04_Transform", pipelineCache);
 
     // Command pool / buffers
     VkCommandPoolCreateInfo cmdPoolCI{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
@@ -744,143 +786,347 @@ int main()
     VkCommandPool cmdPool = VK_NULL_HANDLE;
     vkCreateCommandPool(device, &cmdPoolCI, nullptr, &cmdPool);
 
-    std::vector<VkCommandBuffer> cmdBuffers(swapImageCount);
+    // One command buffer per frame in flight; the frame fence guards its reuse.
+    std::vector<VkCommandBuffer> cmdBuffers(options.framesInFlight);
     VkCommandBufferAllocateInfo cmdAI{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
     cmdAI.commandPool = cmdPool;
     cmdAI.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    cmdAI.commandBufferCount = swapImageCount;
+    cmdAI.commandBufferCount = options.framesInFlight;
     vkAllocateCommandBuffers(device, &cmdAI, cmdBuffers.data());
 
-    VkSemaphoreCreateInfo semCI{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
-    VkFenceCreateInfo fenceCI{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
-    fenceCI.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    // --record-threads N: the draws go into secondary command buffers recorded on N threads,
+    // each with its own command pools (see VgtParallelRecorder.h). Pointless with --indirect,
+    // which records one draw call whatever the object count.
+    const uint32_t recordThreads = options.indirect ? 0 : options.recordThreads;
+    if (options.indirect && options.recordThreads != 0)
+        std::fprintf(stderr, "Ignoring --record-threads with --indirect\n");
+
+    VgtParallelRecorder recorder;
+    if (recordThreads != 0)
+    {
+        VgtParallelRecorderCreateInfo recorderCI{};
+        recorderCI.device = device;
+        recorderCI.queueFamily = graphicsQ;
+        recorderCI.threadCount = recordThreads;
+        recorderCI.framesInFlight = options.framesInFlight;
+
+        const VkResult res = VgtCreateParallelRecorder(recorderCI, recorder);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtCreateParallelRecorder", res);
+            return 1;
+        }
+    }
+    if (!options.indirect && (recordThreads != 0 || options.drawCount > 1))
+        std::fprintf(stderr, "[Step04_Transform] %u draw(s) per frame, recorded on %u thread(s)%s\n", options.drawCount,
+            std::max(recorder.threadCount, 1u), recordThreads != 0 ? " into secondary command buffers" : "");
+
+    // Sync primitives: per frame in flight (fence + imageAvailable) and per swapchain image (renderFinished).
+    VgtFrameSync sync;
+    {
+        const VkResult res = VgtCreateFrameSync(device, options.framesInFlight, static_cast<uint32_t>(swapImages.size()), sync);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtCreateFrameSync", res);
+            return 1;
+        }
+    }
+
+    // GPU timestamps (--gpu-timing): one query range per frame in flight.
+    // Pre-recorded static command buffers are not timed (their slot is not known when recording).
+    VgtGpuTimerCreateInfo gpuTimerCI{};
+    gpuTimerCI.physicalDevice = physicalDevice;
+    gpuTimerCI.device = device;
+    gpuTimerCI.queueFamily = graphicsQ;
+    gpuTimerCI.slotCount = options.framesInFlight;
+    gpuTimerCI.label = "Step04_Transform";
+    gpuTimerCI.enabled = options.gpuTiming && !options.staticCommandBuffers;
+    gpuTimerCI.csvPath = options.gpuTimingCsv.c_str();
+
+    VgtGpuTimer gpuTimer;
+    VgtCreateGpuTimer(gpuTimerCI, gpuTimer);
+    const uint32_t gpuFrameScope = VgtGpuTimerScope(gpuTimer, "frame");
+    const uint32_t gpuCullScope = cull ? VgtGpuTimerScope(gpuTimer, "cull") : kVgtGpuTimerNoScope;
+    const uint32_t gpuRenderPassScope = VgtGpuTimerScope(gpuTimer, "render_pass");
+
+    VgtFrameStats frameStats;
+    VgtFrameStatsBegin(frameStats, "Step04_Transform", options.showFps);
+
+    // --cull counters. With the count buffer only the visible commands are walked; with a fixed
+    // count every command is submitted and the culled ones draw zero instances.
+    auto printCullStats = [&](uint32_t visible) {
+        const uint32_t submitted = indirectPath == VgtIndirectPath::Count ? visible : indirectCommandCount;
+        std::fprintf(stderr, "[Step04_Transform] culling: %u / %u objects visible, %u draw command(s) submitted\n", visible,
+            options.drawCount, submitted);
+    };
+
+    // Resize / out of date: the old swapchain, its views and framebuffers and the depth buffer are
+    // retired to `sync` and destroyed as the frames in flight finish, without idling the device.
+    // Pipelines and buffers do not depend on the extent (the projection is rebuilt every frame).
+    auto recreateSwapchain = [&]() -> VkResult
+    {
+        const VkResult res = VgtRecreateSwapchain(presenter, sync);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtRecreateSwapchain", res);
+            return res;
+        }
+
+        VgtRetire(sync, [device, &allocator, depth = depthBuffer, views = std::move(swapImageViews), fbs = std::move(framebuffers)]() mutable {
+            for (auto fb : fbs)
+                vkDestroyFramebuffer(device, fb, nullptr);
+            for (auto v : views)
+                vkDestroyImageView(device, v, nullptr);
+            VgtDestroyDepthBuffer(allocator, device, depth);
+        });
+        return createSwapchainTargets();
+    };
 
-    VkSemaphore imageAvailable = VK_NULL_HANDLE;
-    VkSemaphore renderFinished = VK_NULL_HANDLE;
-    VkFence inFlight = VK_NULL_HANDLE;
-    vkCreateSemaphore(device, &semCI, nullptr, &imageAvailable);
-    vkCreateSemaphore(device, &semCI, nullptr, &renderFinished);
-    vkCreateFence(device, &fenceCI, nullptr, &inFlight);
+    double startTime = VgtGetTimeSeconds();
+    double cullReportTime = startTime;
 
-    double startTime = glfwGetTime();
+    VgtBenchmarkPhase(bench, "pipeline", pipelineCache.creationMs);
+    VgtBenchmarkPhase(bench, "upload", upload.uploadMs);
+    initZone.End();
+    VgtBenchmarkBeginFrames(bench, presenter);
 
-    while (!glfwWindowShouldClose(window))
+    while (VgtPresenterRunning(presenter))
     {
-        glfwPollEvents();
-
-        double currentTime = glfwGetTime();
-        float time = static_cast<float>(currentTime - startTime);
-
-        // Update uniform buffer - TEST: NO transpose
-        UniformBufferObject ubo{};
-        
-        float model[16], view[16], proj[16], temp[16];
-        Mat4RotateY(model, time);
-        Mat4LookAt(view, 0.0f, 0.0f, 2.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f);
-        Mat4Perspective(proj, 0.785398f, static_cast<float>(extent.width) / extent.height, 0.1f, 10.0f);
-        
-        // MVP = proj * view * model
-        Mat4Multiply(temp, view, model);
-        Mat4Multiply(ubo.mvp, proj, temp);
-        
-        // NO TRANSPOSE - try sending directly
-
-        vkMapMemory(device, uniformMemory, 0, sizeof(ubo), 0, &mapped);
-        std::memcpy(mapped, &ubo, sizeof(ubo));
-        vkUnmapMemory(device, uniformMemory);
-
-        vkWaitForFences(device, 1, &inFlight, VK_TRUE, UINT64_MAX);
-        vkResetFences(device, 1, &inFlight);
+        VGT_TRACE_ZONE("frame");
+        // Wait until this frame slot's previous submission retired before touching its resources.
+        const uint32_t frame = sync.currentFrame;
+        VgtWaitForFrame(device, sync);
+        VgtUniformRingBeginFrame(uniformRing, frame);
+
+        if (presenter.needsRecreate && recreateSwapchain() != VK_SUCCESS)
+            break;
+
+        double currentTime = VgtGetTimeSeconds();
+        // Fixed timestep under --benchmark, so every run animates the same frames.
+        float time = static_cast<float>(VgtBenchmarkTime(bench, currentTime - startTime));
+
+        if (cull && currentTime - cullReportTime >= kCullReportIntervalSec)
+        {
+            // This slot's previous cull has retired with the fence wait above.
+            printCullStats(VgtGpuCullVisibleCount(gpuCull, frame));
+            cullReportTime = currentTime;
+        }
+
+        // Row-major matrices and row vectors, see VgtMath.h. Step04 spins the other way than Step05.
+        const VgtMat4 view = VgtMat4LookAt(0.0f, 0.0f, 2.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f);
+        const float aspect = static_cast<float>(extent.width) / extent.height;
+        const VgtMat4 proj = options.reverseZ ? VgtMat4PerspectiveReverseZ(0.785398f, aspect, 0.1f, 10.0f)
+                                              : VgtMat4Perspective(0.785398f, aspect, 0.1f, 10.0f);
+        const VgtMat4 viewProj = VgtMat4Mul(view, proj);
+
+        // One UBO per draw, reserved in one go; the recording code fills its own range of it, so
+        // those writes are traced as part of "record". With --indirect there is a single UBO:
+        // the shared spin and the view-projection.
+        VgtTraceZone uboZone("ubo update");
+        uint32_t uboBase = 0;
+        uint8_t* uboData = static_cast<uint8_t*>(VgtUniformRingAllocate(uniformRing, uboStride * uniformsPerFrame, uboBase));
+        if (uboData == nullptr)
+        {
+            std::fprintf(stderr, "[Step04_Transform] Uniform ring too small for %u UBO(s) per frame\n", uniformsPerFrame);
+            break;
+        }
+        if (options.indirect)
+        {
+            // GridModel(i, n, -time) == RotateY(-time) * GridModel(i, n, 0), see GridModel.
+            IndirectUniforms ubo{};
+            ubo.spin = VgtMat4RotateY(-time);
+            ubo.viewProj = viewProj;
+            std::memcpy(uboData, &ubo, sizeof(ubo));
+        }
+        uboZone.End();
 
         uint32_t imageIndex = 0;
         {
-            const VkResult res = vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, imageAvailable, VK_NULL_HANDLE, &imageIndex);
+            const VkResult res = VgtPresenterAcquire(presenter, sync.imageAvailable[frame], imageIndex);
+            if (res == VK_ERROR_OUT_OF_DATE_KHR)
+                continue; // nothing acquired; recreated at the top of the next iteration
             if (res != VK_SUCCESS)
             {
-                PrintVkResult("vkAcquireNextImageKHR", res);
+                PrintVkResult("VgtPresenterAcquire", res);
                 break;
             }
         }
 
-        VkCommandBuffer cmd = cmdBuffers[imageIndex];
+        VgtClaimImage(device, sync, imageIndex);
+
+        // Records all objects with one indirect draw; the CPU cost does not depend on the object count.
+        auto recordIndirect = [&](VkCommandBuffer drawCmd) {
+            VkViewport drawViewport{};
+            drawViewport.x = 0.0f;
+            drawViewport.y = 0.0f;
+            drawViewport.width = static_cast<float>(extent.width);
+            drawViewport.height = static_cast<float>(extent.height);
+            drawViewport.minDepth = 0.0f;
+            drawViewport.maxDepth = 1.0f;
+            vkCmdSetViewport(drawCmd, 0, 1, &drawViewport);
+
+            VkRect2D drawScissor{};
+            drawScissor.offset = { 0, 0 };
+            drawScissor.extent = extent;
+            vkCmdSetScissor(drawCmd, 0, 1, &drawScissor);
+
+            vkCmdBindPipeline(drawCmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+            vkCmdBindDescriptorSets(drawCmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descSet, 1, &uboBase);
+
+            VkDeviceSize offset = 0;
+            vkCmdBindVertexBuffers(drawCmd, 0, 1, &vertexBuffer, &offset);
+            vkCmdBindIndexBuffer(drawCmd, indexBuffer, 0, VK_INDEX_TYPE_UINT16);
+            VgtCmdDrawIndexedIndirectObjects(drawCmd, indirectPath, indirectBuffer, countBuffer, indirectCommandCount);
+        };
+
+        // Records draws [first, first + count). Also runs on the recording threads, so every call
+        // sets the state a secondary buffer does not inherit and writes only its own UBOs.
+        auto recordDraws = [&](VkCommandBuffer drawCmd, uint32_t first, uint32_t count) {
+            VkViewport drawViewport{};
+            drawViewport.x = 0.0f;
+            drawViewport.y = 0.0f;
+            drawViewport.width = static_cast<float>(extent.width);
+            drawViewport.height = static_cast<float>(extent.height);
+            drawViewport.minDepth = 0.0f;
+            drawViewport.maxDepth = 1.0f;
+            vkCmdSetViewport(drawCmd, 0, 1, &drawViewport);
+
+            VkRect2D drawScissor{};
+            drawScissor.offset = { 0, 0 };
+            drawScissor.extent = extent;
+            vkCmdSetScissor(drawCmd, 0, 1, &drawScissor);
+
+            vkCmdBindPipeline(drawCmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+            VkDeviceSize offset = 0;
+            vkCmdBindVertexBuffers(drawCmd, 0, 1, &vertexBuffer, &offset);
+
+            for (uint32_t i = first; i < first + count; ++i)
+            {
+                UniformBufferObject ubo{};
+                ubo.mvp = VgtMat4Mul(GridModel(i, options.drawCount, -time, gridExtent), viewProj);
+                std::memcpy(uboData + i * uboStride, &ubo, sizeof(ubo));
+
+                const uint32_t uboOffset = uboBase + static_cast<uint32_t>(i * uboStride);
+                vkCmdBindDescriptorSets(drawCmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descSet, 1, &uboOffset);
+                vkCmdDraw(drawCmd, 3, 1, 0, 0);
+            }
+        };
+
+        VgtFrameStatsCpuBegin(frameStats);
+        VgtTraceZone recordZone("record");
+        VkCommandBuffer cmd = cmdBuffers[frame];
         vkResetCommandBuffer(cmd, 0);
 
         VkCommandBufferBeginInfo begin{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
         vkBeginCommandBuffer(cmd, &begin);
+        VgtGpuTimerBeginFrame(gpuTimer, cmd, frame);
+        VgtGpuTimerBegin(gpuTimer, cmd, gpuFrameScope);
 
-        VkClearValue clear{};
-        clear.color.float32[0] = 0.02f;
-        clear.color.float32[1] = 0.02f;
-        clear.color.float32[2] = 0.05f;
-        clear.color.float32[3] = 1.0f;
+        // Rewrites the indirect commands and the count for this frame's draw. The objects are
+        // static, so the bounds stay in world space and only the planes change.
+        if (cull)
+        {
+            VgtGpuTimerBegin(gpuTimer, cmd, gpuCullScope);
+            VgtCmdGpuCull(cmd, gpuCull, frame, viewProj);
+            VgtGpuTimerEnd(gpuTimer, cmd, gpuCullScope);
+        }
+
+        VkClearValue clears[2]{};
+        clears[0].color.float32[0] = 0.02f;
+        clears[0].color.float32[1] = 0.02f;
+        clears[0].color.float32[2] = 0.05f;
+        clears[0].color.float32[3] = 1.0f;
+        clears[1].depthStencil.depth = VgtDepthClearValue(options.reverseZ);
 
         VkRenderPassBeginInfo rpBegin{ VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
         rpBegin.renderPass = renderPass;
         rpBegin.framebuffer = framebuffers[imageIndex];
         rpBegin.renderArea.offset = { 0, 0 };
         rpBegin.renderArea.extent = extent;
-        rpBegin.clearValueCount = 1;
-        rpBegin.pClearValues = &clear;
-
-        vkCmdBeginRenderPass(cmd, &rpBegin, VK_SUBPASS_CONTENTS_INLINE);
-
-        VkViewport drawViewport{};
-        drawViewport.x = 0.0f;
-        drawViewport.y = 0.0f;
-        drawViewport.width = static_cast<float>(extent.width);
-        drawViewport.height = static_cast<float>(extent.height);
-        drawViewport.minDepth = 0.0f;
-        drawViewport.maxDepth = 1.0f;
-        vkCmdSetViewport(cmd, 0, 1, &drawViewport);
-
-        VkRect2D drawScissor{};
-        drawScissor.offset = { 0, 0 };
-        drawScissor.extent = extent;
-        vkCmdSetScissor(cmd, 0, 1, &drawScissor);
-
-        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
-        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descSet, 0, nullptr);
+        rpBegin.clearValueCount = 2;
+        rpBegin.pClearValues = clears;
 
-        VkDeviceSize offset = 0;
-        vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer, &offset);
-        vkCmdDraw(cmd, 3, 1, 0, 0);
+        VgtGpuTimerBegin(gpuTimer, cmd, gpuRenderPassScope);
+        if (recordThreads != 0)
+        {
+            vkCmdBeginRenderPass(cmd, &rpBegin, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+            const VkResult res =
+                VgtRecordParallel(recorder, frame, cmd, renderPass, framebuffers[imageIndex], options.drawCount, recordDraws);
+            if (res != VK_SUCCESS)
+            {
+                PrintVkResult("VgtRecordParallel", res);
+                break;
+            }
+        }
+        else
+        {
+            vkCmdBeginRenderPass(cmd, &rpBegin, VK_SUBPASS_CONTENTS_INLINE);
+            if (options.indirect)
+                recordIndirect(cmd);
+            else
+                recordDraws(cmd, 0, options.drawCount);
+        }
 
         vkCmdEndRenderPass(cmd);
+        VgtGpuTimerEnd(gpuTimer, cmd, gpuRenderPassScope);
+        VgtGpuTimerEnd(gpuTimer, cmd, gpuFrameScope);
         vkEndCommandBuffer(cmd);
 
         VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
         VkSubmitInfo submit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
         submit.waitSemaphoreCount = 1;
-        submit.pWaitSemaphores = &imageAvailable;
+        submit.pWaitSemaphores = &sync.imageAvailable[frame];
         submit.pWaitDstStageMask = &waitStage;
         submit.commandBufferCount = 1;
         submit.pCommandBuffers = &cmd;
         submit.signalSemaphoreCount = 1;
-        submit.pSignalSemaphores = &renderFinished;
+        submit.pSignalSemaphores = &sync.renderFinished[imageIndex];
 
-        vkQueueSubmit(graphicsQueue, 1, &submit, inFlight);
+        recordZone.End();
+        VgtTraceZone submitZone("submit");
+        vkQueueSubmit(graphicsQueue, 1, &submit, sync.inFlight[frame]);
+        submitZone.End();
+        VgtFrameStatsCpuEnd(frameStats);
 
-        VkPresentInfoKHR present{ VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
-        present.waitSemaphoreCount = 1;
-        present.pWaitSemaphores = &renderFinished;
-        present.swapchainCount = 1;
-        present.pSwapchains = &swapchain;
-        present.pImageIndices = &imageIndex;
-        vkQueuePresentKHR(presentQueue, &present);
+        {
+            const VkResult res = VgtPresenterPresent(presenter, sync.renderFinished[imageIndex], imageIndex);
+            if (res != VK_SUCCESS)
+            {
+                PrintVkResult("VgtPresenterPresent", res);
+                break;
+            }
+        }
 
-        vkQueueWaitIdle(presentQueue);
+        VgtAdvanceFrame(sync);
+        // --memory-stats: once everything is live (a streamed texture may still be on its way).
+        if (options.memoryStats && presenter.framesPresented == 1)
+            VgtPrintAllocatorStats("Step04_Transform", VgtGetAllocatorStats(allocator), "first frame");
+        VgtFrameStatsTick(frameStats);
+        VgtBenchmarkTick(bench, frameStats, gpuTimer);
+        VgtGpuTimerTick(gpuTimer);
     }
 
     vkDeviceWaitIdle(device);
-
-    vkDestroyFence(device, inFlight, nullptr);
-    vkDestroySemaphore(device, renderFinished, nullptr);
-    vkDestroySemaphore(device, imageAvailable, nullptr);
-
-    vkFreeCommandBuffers(device, cmdPool, swapImageCount, cmdBuffers.data());
+    if (options.memoryStats)
+        VgtPrintAllocatorStats("Step04_Transform", VgtGetAllocatorStats(allocator), "before teardown");
+    VgtFrameStatsFinish(frameStats);
+    VgtGpuTimerFinish(gpuTimer);
+    VgtBenchmarkFinish(bench, gpuTimer);
+    VgtTraceStop();
+    if (cull)
+        printCullStats(VgtGpuCullVisibleCount(gpuCull, (sync.currentFrame + options.framesInFlight - 1) % options.framesInFlight));
+
+    VgtDestroyFrameSync(device, sync);
+    VgtDestroyGpuTimer(gpuTimer);
+    VgtDestroyParallelRecorder(recorder);
+    VgtDestroyGpuCull(gpuCull);
+
+    vkFreeCommandBuffers(device, cmdPool, options.framesInFlight, cmdBuffers.data());
     vkDestroyCommandPool(device, cmdPool, nullptr);
 
     vkDestroyPipeline(device, pipeline, nullptr);
+    VgtDestroyPipelineCache(device, pipelineCache);
     vkDestroyShaderModule(device, fragModule, nullptr);
     vkDestroyShaderModule(device, vertModule, nullptr);
     vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
@@ -888,29 +1134,39 @@ int main()
     vkDestroyDescriptorPool(device, descPool, nullptr);
     vkDestroyDescriptorSetLayout(device, descLayout, nullptr);
 
-    vkDestroyBuffer(device, uniformBuffer, nullptr);
-    vkFreeMemory(device, uniformMemory, nullptr);
+    VgtDestroyUniformRing(allocator, uniformRing);
 
-    vkDestroyBuffer(device, vertexBuffer, nullptr);
-    vkFreeMemory(device, vertexMem, nullptr);
+    VgtDestroyBuffer(allocator, vertexBuffer, vertexAlloc);
+    if (options.indirect)
+    {
+        VgtDestroyBuffer(allocator, countBuffer, countAlloc);
+        VgtDestroyBuffer(allocator, indirectBuffer, indirectAlloc);
+        VgtDestroyBuffer(allocator, objectBuffer, objectAlloc);
+        VgtDestroyBuffer(allocator, indexBuffer, indexAlloc);
+        if (cull)
+            VgtDestroyBuffer(allocator, boundsBuffer, boundsAlloc);
+    }
+    VgtDestroyUploadContext(upload);
 
     for (auto fb : framebuffers)
         vkDestroyFramebuffer(device, fb, nullptr);
 
     vkDestroyRenderPass(device, renderPass, nullptr);
+    VgtDestroyDepthBuffer(allocator, device, depthBuffer);
 
     for (auto v : swapImageViews)
         vkDestroyImageView(device, v, nullptr);
 
-    vkDestroySwapchainKHR(device, swapchain, nullptr);
+    VgtPresenterDestroySwapchain(presenter);
+    VgtDestroyAllocator(allocator);
+
     vkDestroyDevice(device, nullptr);
 
-    vkDestroySurfaceKHR(instance, surface, nullptr);
+    VgtPresenterDestroySurface(presenter);
 
     vkDestroyInstance(instance, nullptr);
 
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    VgtPresenterShutdown(presenter);
 
     if (pauseOnExit)
     {
@@ -7,11 +7,12 @@ layout(location = 0) out vec3 vColor;
 
 layout(set = 0, binding = 0) uniform UBO
 {
-    layout(row_major) mat4 uMvp;  // C++ uses row-major format
+    layout(row_major) mat4 uMvp;  // C++ uses row-major format: model * view * proj
 } ubo;
 
 void main()
 {
-    gl_Position = ubo.uMvp * vec4(iPos, 1.0);
+    // Row vector times matrix, like VgtMat4MulVec4 (see VgtMath.h).
+    gl_Position = vec4(iPos, 1.0) * ubo.uMvp;
     vColor = iColor;
 }
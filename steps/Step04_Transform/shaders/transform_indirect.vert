@@ -0,0 +1,27 @@
+#version 450
+
+layout(location = 0) in vec3 iPos;
+layout(location = 1) in vec3 iColor;
+
+layout(location = 0) out vec3 vColor;
+
+// Spin and view * proj, shared by every object
+layout(set = 0, binding = 0) uniform UBO
+{
+    layout(row_major) mat4 uSpin;      // C++ uses row-major format
+    layout(row_major) mat4 uViewProj;
+} ubo;
+
+// One model matrix per object, indexed by the indirect command's firstInstance (or the
+// instance number when everything is a single instanced draw).
+layout(std430, set = 0, binding = 1) readonly buffer Objects
+{
+    layout(row_major) mat4 uModel[];
+} objects;
+
+void main()
+{
+    // Row vectors (see VgtMath.h): each object spins about its own origin before its model matrix.
+    gl_Position = vec4(iPos, 1.0) * ubo.uSpin * objects.uModel[gl_InstanceIndex] * ubo.uViewProj;
+    vColor = iColor;
+}
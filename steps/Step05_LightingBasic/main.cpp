@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
@@ -5,14 +6,26 @@
 #include <string>
 #include <fstream>
 #include <cstring>
-#include <cmath>
 
-#include <Windows.h>
-
-#define GLFW_INCLUDE_VULKAN
-#include <GLFW/glfw3.h>
+#include <vulkan/vulkan.h>
 
 #include <VgtConfig.h>
+#include <VgtAllocator.h>
+#include <VgtBenchmark.h>
+#include <VgtClusteredLights.h>
+#include <VgtDepth.h>
+#include <VgtFrameStats.h>
+#include <VgtFrameSync.h>
+#include <VgtGpuTimer.h>
+#include <VgtMath.h>
+#include <VgtOptions.h>
+#include <VgtPipelineCache.h>
+#include <VgtPlatform.h>
+#include <VgtPresenter.h>
+#include <VgtSpirv.h>
+#include <VgtTrace.h>
+#include <VgtUniformRing.h>
+#include <VgtUpload.h>
 
 static void PrintVkResult(const char* what, VkResult res)
 {
@@ -23,8 +36,7 @@ static void PrintVkResult(const char* what, VkResult res)
 
 static void ShowFatal(const char* msg)
 {
-    std::fprintf(stderr, "%s\n", msg);
-    MessageBoxA(nullptr, msg, "Step05_LightingBasic", MB_OK | MB_ICONERROR);
+    VgtShowError("Step05_LightingBasic", msg);
 }
 
 struct Vertex
@@ -35,250 +47,53 @@ struct Vertex
 
 struct UniformBufferObject
 {
-    float mvp[16];
-    float modelView[16];
-    float normalMatrix[16];
+    VgtMat4 mvp;
+    VgtMat4 modelView;
+    VgtMat4 normalMatrix;
     float lightDir[4];  // w component unused, padding for alignment
 };
 
-static void Mat4Identity(float* m)
-{
-    for (int i = 0; i < 16; ++i)
-        m[i] = 0.0f;
-    m[0] = m[5] = m[10] = m[15] = 1.0f;
-}
-
-static void Mat4RotateY(float* m, float angle)
-{
-    const float c = std::cosf(angle);
-    const float s = std::sinf(angle);
-    Mat4Identity(m);
-    // Column-major format (GLSL standard)
-    m[0] = c;   // m[0][0]
-    m[2] = -s;  // m[0][2]
-    m[8] = s;   // m[2][0]
-    m[10] = c;  // m[2][2]
-}
-
-static void Mat4LookAt(float* m, float eyeX, float eyeY, float eyeZ,
-                       float centerX, float centerY, float centerZ,
-                       float upX, float upY, float upZ)
-{
-    // Forward vector (normalized)
-    float fx = centerX - eyeX;
-    float fy = centerY - eyeY;
-    float fz = centerZ - eyeZ;
-    float rlf = 1.0f / std::sqrtf(fx * fx + fy * fy + fz * fz);
-    fx *= rlf;
-    fy *= rlf;
-    fz *= rlf;
-
-    // Right vector (normalized)
-    float sx = fy * upZ - fz * upY;
-    float sy = fz * upX - fx * upZ;
-    float sz = fx * upY - fy * upX;
-    float rls = 1.0f / std::sqrtf(sx * sx + sy * sy + sz * sz);
-    sx *= rls;
-    sy *= rls;
-    sz *= rls;
-
-    // Up vector
-    float ux = sy * fz - sz * fy;
-    float uy = sz * fx - sx * fz;
-    float uz = sx * fy - sy * fx;
-
-    // Column-major format (GLSL standard)
-    m[0] = sx;  // Right.x
-    m[1] = sy;  // Right.y
-    m[2] = sz;  // Right.z
-    m[3] = 0.0f;
-    m[4] = ux;  // Up.x
-    m[5] = uy;  // Up.y
-    m[6] = uz;  // Up.z
-    m[7] = 0.0f;
-    m[8] = -fx; // -Forward.x
-    m[9] = -fy; // -Forward.y
-    m[10] = -fz; // -Forward.z
-    m[11] = 0.0f;
-    m[12] = -(sx * eyeX + sy * eyeY + sz * eyeZ);  // -dot(Right, Eye)
-    m[13] = -(ux * eyeX + uy * eyeY + uz * eyeZ);  // -dot(Up, Eye)
-    m[14] = (fx * eyeX + fy * eyeY + fz * eyeZ);   // dot(Forward, Eye)
-    m[15] = 1.0f;
-}
-
-static void Mat4Perspective(float* m, float fovY, float aspect, float zNear, float zFar)
-{
-    const float tanHalfFovy = std::tanf(fovY / 2.0f);
-    for (int i = 0; i < 16; ++i)
-        m[i] = 0.0f;
-    m[0] = 1.0f / (aspect * tanHalfFovy);
-    m[5] = 1.0f / tanHalfFovy;
-    m[10] = zFar / (zNear - zFar);
-    m[11] = -1.0f;
-    m[14] = -(zFar * zNear) / (zFar - zNear);
-    
-    // Vulkan clip space has inverted Y and depth [0, 1]
-    // We handle this by negating Y in the projection
-    m[5] = -m[5];
-}
+// Upper bound of UBO pushes per frame; each frame slice of the uniform ring holds this many.
+constexpr uint32_t kMaxUniformsPerFrame = 1024;
 
-static void Mat4Multiply(float* out, const float* a, const float* b)
-{
-    float temp[16];
-    for (int row = 0; row < 4; ++row)
-    {
-        for (int col = 0; col < 4; ++col)
-        {
-            temp[row * 4 + col] = 0.0f;
-            for (int k = 0; k < 4; ++k)
-            {
-                temp[row * 4 + col] += a[row * 4 + k] * b[k * 4 + col];
-            }
-        }
-    }
-    std::memcpy(out, temp, sizeof(temp));
-}
+// Camera projection; the light clusters (--lights) are built for the same frustum.
+constexpr float kFovY = 0.785398f;
+constexpr float kZNear = 0.1f;
+constexpr float kZFar = 10.0f;
 
-static void Mat4Transpose(float* out, const float* m)
+// Model matrix of overdraw layer `layer` of `count` (--overdraw): the layers are stacked along z,
+// layer 0 farthest from the camera, each spinning about its own center.
+static VgtMat4 LayerModel(uint32_t layer, uint32_t count, float angle)
 {
-    float temp[16];
-    for (int row = 0; row < 4; ++row)
-    {
-        for (int col = 0; col < 4; ++col)
-        {
-            temp[col * 4 + row] = m[row * 4 + col];
-        }
-    }
-    std::memcpy(out, temp, sizeof(temp));
+    VgtMat4 model = VgtMat4RotateY(angle);
+    if (count > 1)
+        model.m[14] = -1.5f + 2.0f * static_cast<float>(layer) / static_cast<float>(count - 1);
+    return model;
 }
 
-static void Mat3FromMat4(float* out, const float* m)
+int main(int argc, char** argv)
 {
-    out[0] = m[0]; out[1] = m[1]; out[2] = m[2];
-    out[3] = m[4]; out[4] = m[5]; out[5] = m[6];
-    out[6] = m[8]; out[7] = m[9]; out[8] = m[10];
-}
-
-static void Mat3Transpose(float* out, const float* m)
-{
-    float temp[9];
-    temp[0] = m[0]; temp[1] = m[3]; temp[2] = m[6];
-    temp[3] = m[1]; temp[4] = m[4]; temp[5] = m[7];
-    temp[6] = m[2]; temp[7] = m[5]; temp[8] = m[8];
-    std::memcpy(out, temp, sizeof(temp));
-}
-
-static std::vector<uint32_t> ReadSpirvFile(const char* path)
-{
-    std::ifstream file(path, std::ios::binary | std::ios::ate);
-    if (!file)
-        return {};
-
-    const std::streamsize size = file.tellg();
-    if (size <= 0)
-        return {};
-
-    std::vector<uint32_t> data(static_cast<size_t>(size / 4));
-    file.seekg(0);
-    file.read(reinterpret_cast<char*>(data.data()), size);
-    return data;
-}
-
-static std::vector<uint32_t> ReadSpirvWithFallback(const char* relativePath)
-{
-    // Try runtime layout first (when shaders are copied next to the exe).
-    {
-        auto data = ReadSpirvFile(relativePath);
-        if (!data.empty())
-            return data;
-    }
-
-    // Fallback: locate shader outputs relative to the executable.
-    // This handles cases where the working directory is not the exe directory.
-    {
-        char exePath[MAX_PATH] = {};
-        const DWORD len = GetModuleFileNameA(nullptr, exePath, MAX_PATH);
-        if (len > 0 && len < MAX_PATH)
-        {
-            std::string exeDir(exePath);
-            const size_t lastSlash = exeDir.find_last_of("\\/");
-            if (lastSlash != std::string::npos)
-                exeDir.resize(lastSlash + 1);
-
-            std::string fromExeDir = exeDir + std::string("compiled_shaders/") + relativePath;
-            {
-                auto data = ReadSpirvFile(fromExeDir.c_str());
-                if (!data.empty())
-                    return data;
-            }
-
-            // Common MSBuild layout: <target>/Debug/.. == <target>/
-            std::string exeParentDir = exeDir;
-            if (!exeParentDir.empty())
-            {
-                // remove trailing slash
-                while (!exeParentDir.empty() && (exeParentDir.back() == '\\' || exeParentDir.back() == '/'))
-                    exeParentDir.pop_back();
-                const size_t parentSlash = exeParentDir.find_last_of("\\/");
-                if (parentSlash != std::string::npos)
-                {
-                    exeParentDir.resize(parentSlash + 1);
-                    std::string fromExeParentDir = exeParentDir + std::string("compiled_shaders/") + relativePath;
-                    {
-                        auto data = ReadSpirvFile(fromExeParentDir.c_str());
-                        if (!data.empty())
-                            return data;
-                    }
-                }
-            }
-        }
-    }
-
-    // Fallback: run from build tree.
-    // e.g. build-ninja/.../steps/Step05_LightingBasic/compiled_shaders
-    std::string alt = std::string("compiled_shaders/") + relativePath;
-    {
-        auto data = ReadSpirvFile(alt.c_str());
-        if (!data.empty())
-            return data;
-    }
-
-    return {};
-}
-
-static uint32_t FindMemoryTypeIndex(VkPhysicalDevice physicalDevice, uint32_t typeBits, VkMemoryPropertyFlags properties)
-{
-    VkPhysicalDeviceMemoryProperties memProps{};
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProps);
-
-    for (uint32_t i = 0; i < memProps.memoryTypeCount; ++i)
-    {
-        if ((typeBits & (1u << i)) && (memProps.memoryTypes[i].propertyFlags & properties) == properties)
-            return i;
-    }
-
-    return UINT32_MAX;
-}
-
-int main()
-{
-    bool pauseOnExit = false;
-    {
-        char* val = nullptr;
-        size_t len = 0;
-        if (_dupenv_s(&val, &len, "VGT_PAUSE_ON_EXIT") == 0 && val != nullptr)
-        {
-            pauseOnExit = true;
-            std::free(val);
-        }
-    }
-
-    if (!glfwInit())
-        return 1;
-
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-    GLFWwindow* window = glfwCreateWindow(1280, 720, "Step05_LightingBasic", nullptr, nullptr);
-    if (!window)
+    const VgtOptions options = VgtParseOptions(argc, argv);
+    VgtTraceStart(options.tracePath.c_str(), "Step05_LightingBasic");
+    VgtTraceZone initZone("init");
+    VgtBenchmark bench;
+    VgtBenchmarkBegin(bench, "Step05_LightingBasic", options);
+
+    std::string pauseEnv;
+    const bool pauseOnExit = VgtGetEnv("VGT_PAUSE_ON_EXIT", pauseEnv);
+
+    // Window (or nothing, when rendering headless)
+    VgtPresenterCreateInfo presenterCI{};
+    presenterCI.title = "Step05_LightingBasic";
+    presenterCI.backend = options.backend;
+    presenterCI.frameLimit = options.frameLimit;
+    presenterCI.presentMode = options.presentMode;
+    presenterCI.swapchainImages = options.swapchainImages;
+    presenterCI.framesInFlight = options.framesInFlight;
+    presenterCI.measureLatency = options.latency;
+
+    VgtPresenter presenter;
+    if (!VgtPresenterInit(presenterCI, presenter))
         return 1;
 
     // Instance
@@ -286,9 +101,8 @@ int main()
     appInfo.pApplicationName = "vulkan-glsl-tutorial";
     appInfo.apiVersion = VK_API_VERSION_1_3;
 
-    uint32_t glfwExtCount = 0;
-    const char** glfwExts = glfwGetRequiredInstanceExtensions(&glfwExtCount);
-    std::vector<const char*> instanceExts(glfwExts, glfwExts + glfwExtCount);
+    std::vector<const char*> instanceExts;
+    VgtPresenterGetInstanceExtensions(presenter, instanceExts);
 
     std::vector<const char*> layers;
 #if VGT_ENABLE_VALIDATION
@@ -305,6 +119,7 @@ int main()
 
     VkInstance instance = VK_NULL_HANDLE;
     {
+        VGT_TRACE_ZONE("instance creation");
         const VkResult res = vkCreateInstance(&instanceCI, nullptr, &instance);
         if (res != VK_SUCCESS)
         {
@@ -316,14 +131,13 @@ int main()
         }
     }
 
-    // Surface
-    VkSurfaceKHR surface = VK_NULL_HANDLE;
+    // Surface (none when rendering offscreen)
     {
-        const VkResult res = glfwCreateWindowSurface(instance, window, nullptr, &surface);
+        const VkResult res = VgtPresenterCreateSurface(presenter, instance);
         if (res != VK_SUCCESS)
         {
-            PrintVkResult("glfwCreateWindowSurface", res);
-            ShowFatal("glfwCreateWindowSurface failed");
+            PrintVkResult("VgtPresenterCreateSurface", res);
+            ShowFatal("Surface creation failed");
             if (pauseOnExit)
                 (void)std::getchar();
             return 1;
@@ -350,12 +164,13 @@ int main()
         if ((qProps[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) && graphicsQ == UINT32_MAX)
             graphicsQ = i;
 
-        VkBool32 presentSupport = VK_FALSE;
-        vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentSupport);
-        if (presentSupport && presentQ == UINT32_MAX)
+        if (VgtPresenterSupportsPresent(presenter, physicalDevice, i) && presentQ == UINT32_MAX)
             presentQ = i;
     }
 
+    // Dedicated copy queue for static uploads (see VgtUpload.h), when the device has one.
+    const uint32_t transferQ = VgtFindTransferQueueFamily(physicalDevice);
+
     float qPriority = 1.0f;
     std::vector<VkDeviceQueueCreateInfo> queueCIs;
     {
@@ -373,18 +188,32 @@ int main()
             pqci.pQueuePriorities = &qPriority;
             queueCIs.push_back(pqci);
         }
+
+        if (transferQ != UINT32_MAX && transferQ != graphicsQ && transferQ != presentQ)
+        {
+            VkDeviceQueueCreateInfo tqci{ VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
+            tqci.queueFamilyIndex = transferQ;
+            tqci.queueCount = 1;
+            tqci.pQueuePriorities = &qPriority;
+            queueCIs.push_back(tqci);
+        }
     }
 
-    const char* deviceExts[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+    std::vector<const char*> deviceExts;
+    VgtPresenterGetDeviceExtensions(presenter, deviceExts);
 
     VkDeviceCreateInfo deviceCI{ VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
     deviceCI.queueCreateInfoCount = static_cast<uint32_t>(queueCIs.size());
     deviceCI.pQueueCreateInfos = queueCIs.data();
-    deviceCI.enabledExtensionCount = 1;
-    deviceCI.ppEnabledExtensionNames = deviceExts;
+    deviceCI.enabledExtensionCount = static_cast<uint32_t>(deviceExts.size());
+    deviceCI.ppEnabledExtensionNames = deviceExts.empty() ? nullptr : deviceExts.data();
+
+    // --latency: present id / present wait for input-to-photon timing, when supported.
+    VgtPresenterEnableDeviceFeatures(presenter, physicalDevice, deviceExts, deviceCI);
 
     VkDevice device = VK_NULL_HANDLE;
     {
+        VGT_TRACE_ZONE("device creation");
         const VkResult res = vkCreateDevice(physicalDevice, &deviceCI, nullptr, &device);
         if (res != VK_SUCCESS)
         {
@@ -397,119 +226,70 @@ int main()
     }
 
     VkQueue graphicsQueue = VK_NULL_HANDLE;
-    VkQueue presentQueue = VK_NULL_HANDLE;
     vkGetDeviceQueue(device, graphicsQ, 0, &graphicsQueue);
-    vkGetDeviceQueue(device, presentQ, 0, &presentQueue);
 
-    // Swapchain
-    VkSurfaceCapabilitiesKHR caps{};
-    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, surface, &caps);
+    // Device memory: buffers and images are sub-allocated from large per-memory-type blocks.
+    VgtAllocatorCreateInfo allocatorCI{};
+    allocatorCI.physicalDevice = physicalDevice;
+    allocatorCI.device = device;
+
+    VgtAllocator allocator;
+    VgtCreateAllocator(allocatorCI, allocator);
 
-    uint32_t formatCount = 0;
-    vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, nullptr);
-    std::vector<VkSurfaceFormatKHR> formats(formatCount);
-    vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, formats.data());
+    // Static geometry goes to DEVICE_LOCAL memory through staging copies.
+    VgtUploadContextCreateInfo uploadCI{};
+    uploadCI.device = device;
+    uploadCI.allocator = &allocator;
+    uploadCI.graphicsQueueFamily = graphicsQ;
+    uploadCI.transferQueueFamily = transferQ;
 
-    VkSurfaceFormatKHR surfaceFormat = formats[0];
-    for (const auto& f : formats)
+    VgtUploadContext upload;
     {
-        if (f.format == VK_FORMAT_B8G8R8A8_UNORM && f.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+        const VkResult res = VgtCreateUploadContext(uploadCI, upload);
+        if (res != VK_SUCCESS)
         {
-            surfaceFormat = f;
-            break;
+            PrintVkResult("VgtCreateUploadContext", res);
+            return 1;
         }
     }
 
-    VkExtent2D extent = caps.currentExtent;
-    if (extent.width == UINT32_MAX)
-    {
-        int w = 0, h = 0;
-        glfwGetFramebufferSize(window, &w, &h);
-        extent.width = static_cast<uint32_t>(w);
-        extent.height = static_cast<uint32_t>(h);
-    }
-
-    VkSwapchainCreateInfoKHR swapCI{ VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR };
-    swapCI.surface = surface;
-    swapCI.minImageCount = caps.minImageCount + 1;
-    swapCI.imageFormat = surfaceFormat.format;
-    swapCI.imageColorSpace = surfaceFormat.colorSpace;
-    swapCI.imageExtent = extent;
-    swapCI.imageArrayLayers = 1;
-    swapCI.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-    swapCI.preTransform = caps.currentTransform;
-    swapCI.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-    swapCI.presentMode = VK_PRESENT_MODE_FIFO_KHR;
-    swapCI.clipped = VK_TRUE;
-
-    uint32_t qIndices[] = { graphicsQ, presentQ };
-    if (graphicsQ != presentQ)
-    {
-        swapCI.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
-        swapCI.queueFamilyIndexCount = 2;
-        swapCI.pQueueFamilyIndices = qIndices;
-    }
-
-    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+    // Swapchain (offscreen images when headless)
+    VgtSwapchainDesc swapDesc{};
+    swapDesc.graphicsQueueFamily = graphicsQ;
+    swapDesc.presentQueueFamily = presentQ;
     {
-        const VkResult res = vkCreateSwapchainKHR(device, &swapCI, nullptr, &swapchain);
+        const VkResult res = VgtPresenterCreateSwapchain(presenter, physicalDevice, device, swapDesc);
         if (res != VK_SUCCESS)
         {
-            PrintVkResult("vkCreateSwapchainKHR", res);
-            ShowFatal("vkCreateSwapchainKHR failed");
+            PrintVkResult("VgtPresenterCreateSwapchain", res);
+            ShowFatal("Swapchain creation failed");
             if (pauseOnExit)
                 (void)std::getchar();
             return 1;
         }
     }
 
-    uint32_t swapImageCount = 0;
-    vkGetSwapchainImagesKHR(device, swapchain, &swapImageCount, nullptr);
-    std::vector<VkImage> swapImages(swapImageCount);
-    vkGetSwapchainImagesKHR(device, swapchain, &swapImageCount, swapImages.data());
+    // References: both change when the swapchain is recreated.
+    const VkExtent2D& extent = presenter.extent;
+    const std::vector<VkImage>& swapImages = presenter.images;
 
-    std::vector<VkImageView> swapImageViews(swapImageCount);
-    for (uint32_t i = 0; i < swapImageCount; ++i)
+    // Uniform buffer: one persistently mapped ring, sliced per frame in flight.
+    // Each frame pushes its UBO(s) into its own slice and binds them with a dynamic offset.
+    VgtUniformRing uniformRing;
     {
-        VkImageViewCreateInfo viewCI{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
-        viewCI.image = swapImages[i];
-        viewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        viewCI.format = surfaceFormat.format;
-        viewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        viewCI.subresourceRange.levelCount = 1;
-        viewCI.subresourceRange.layerCount = 1;
-        vkCreateImageView(device, &viewCI, nullptr, &swapImageViews[i]);
+        const VkResult res = VgtCreateUniformRing(allocator, sizeof(UniformBufferObject), std::max(kMaxUniformsPerFrame, options.overdraw),
+            options.framesInFlight, uniformRing);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtCreateUniformRing", res);
+            return 1;
+        }
     }
 
-    // Uniform buffer
-    VkBufferCreateInfo uniformBufCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-    uniformBufCI.size = sizeof(UniformBufferObject);
-    uniformBufCI.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-    uniformBufCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-    VkBuffer uniformBuffer = VK_NULL_HANDLE;
-    vkCreateBuffer(device, &uniformBufCI, nullptr, &uniformBuffer);
-
-    VkMemoryRequirements uniformMemReq{};
-    vkGetBufferMemoryRequirements(device, uniformBuffer, &uniformMemReq);
-
-    uint32_t uniformMemType = FindMemoryTypeIndex(
-        physicalDevice,
-        uniformMemReq.memoryTypeBits,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-    VkMemoryAllocateInfo uniformAlloc{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-    uniformAlloc.allocationSize = uniformMemReq.size;
-    uniformAlloc.memoryTypeIndex = uniformMemType;
-
-    VkDeviceMemory uniformMemory = VK_NULL_HANDLE;
-    vkAllocateMemory(device, &uniformAlloc, nullptr, &uniformMemory);
-    vkBindBufferMemory(device, uniformBuffer, uniformMemory, 0);
-
     // Descriptor set layout
     VkDescriptorSetLayoutBinding uboBinding{};
     uboBinding.binding = 0;
-    uboBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    uboBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     uboBinding.descriptorCount = 1;
     uboBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
@@ -522,7 +302,7 @@ int main()
 
     // Descriptor pool
     VkDescriptorPoolSize poolSize{};
-    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     poolSize.descriptorCount = 1;
 
     VkDescriptorPoolCreateInfo poolCI{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
@@ -543,7 +323,7 @@ int main()
     vkAllocateDescriptorSets(device, &descAI, &descSet);
 
     VkDescriptorBufferInfo bufferInfo{};
-    bufferInfo.buffer = uniformBuffer;
+    bufferInfo.buffer = uniformRing.buffer;
     bufferInfo.offset = 0;
     bufferInfo.range = sizeof(UniformBufferObject);
 
@@ -551,53 +331,118 @@ int main()
     descWrite.dstSet = descSet;
     descWrite.dstBinding = 0;
     descWrite.dstArrayElement = 0;
-    descWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    descWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     descWrite.descriptorCount = 1;
     descWrite.pBufferInfo = &bufferInfo;
 
     vkUpdateDescriptorSets(device, 1, &descWrite, 0, nullptr);
 
+    // Depth buffer: one image shared by every framebuffer (see VgtDepth.h), created with them below.
+    const VkFormat depthFormat = VgtPickDepthFormat(physicalDevice);
+
     // Render pass
-    VkAttachmentDescription colorAttachment{};
-    colorAttachment.format = surfaceFormat.format;
+    VkAttachmentDescription attachmentDescs[2]{};
+    VkAttachmentDescription& colorAttachment = attachmentDescs[0];
+    colorAttachment.format = presenter.format;
     colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
     colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    colorAttachment.finalLayout = presenter.presentLayout;
+
+    // Depth is cleared on load and never stored: nothing reads it after the pass.
+    VkAttachmentDescription& depthAttachment = attachmentDescs[1];
+    depthAttachment.format = depthFormat;
+    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
     VkAttachmentReference colorRef{};
     colorRef.attachment = 0;
     colorRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
+    VkAttachmentReference depthRef{};
+    depthRef.attachment = 1;
+    depthRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
     VkSubpassDescription subpass{};
     subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
     subpass.colorAttachmentCount = 1;
     subpass.pColorAttachments = &colorRef;
+    subpass.pDepthStencilAttachment = &depthRef;
+
+    // The depth image is shared between frames in flight: this frame's clear must wait for the
+    // previous frame's depth tests, and the color write for the acquire semaphore (which waits
+    // at COLOR_ATTACHMENT_OUTPUT).
+    VkSubpassDependency dependency{};
+    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependency.dstSubpass = 0;
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependency.dstStageMask = dependency.srcStageMask;
+    dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 
     VkRenderPassCreateInfo rpCI{ VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
-    rpCI.attachmentCount = 1;
-    rpCI.pAttachments = &colorAttachment;
+    rpCI.attachmentCount = 2;
+    rpCI.pAttachments = attachmentDescs;
     rpCI.subpassCount = 1;
     rpCI.pSubpasses = &subpass;
+    rpCI.dependencyCount = 1;
+    rpCI.pDependencies = &dependency;
 
     VkRenderPass renderPass = VK_NULL_HANDLE;
     vkCreateRenderPass(device, &rpCI, nullptr, &renderPass);
 
-    // Framebuffers
-    std::vector<VkFramebuffer> framebuffers(swapImageCount);
-    for (uint32_t i = 0; i < swapImageCount; ++i)
+    // Swapchain-sized targets: the depth buffer, plus an image view and framebuffer per swapchain
+    // image. Rebuilt by recreateSwapchain below.
+    VgtDepthBuffer depthBuffer;
+    std::vector<VkImageView> swapImageViews;
+    std::vector<VkFramebuffer> framebuffers;
+    auto createSwapchainTargets = [&]() -> VkResult
     {
-        VkImageView attachments[] = { swapImageViews[i] };
-        VkFramebufferCreateInfo fbCI{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
-        fbCI.renderPass = renderPass;
-        fbCI.attachmentCount = 1;
-        fbCI.pAttachments = attachments;
-        fbCI.width = extent.width;
-        fbCI.height = extent.height;
-        fbCI.layers = 1;
-        vkCreateFramebuffer(device, &fbCI, nullptr, &framebuffers[i]);
-    }
+        {
+            const VkResult res = VgtCreateDepthBuffer(allocator, device, depthFormat, extent, depthBuffer);
+            if (res != VK_SUCCESS)
+            {
+                PrintVkResult("VgtCreateDepthBuffer", res);
+                return res;
+            }
+        }
+
+        const uint32_t imageCount = static_cast<uint32_t>(swapImages.size());
+        swapImageViews.assign(imageCount, VK_NULL_HANDLE);
+        framebuffers.assign(imageCount, VK_NULL_HANDLE);
+        for (uint32_t i = 0; i < imageCount; ++i)
+        {
+            VkImageViewCreateInfo viewCI{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+            viewCI.image = swapImages[i];
+            viewCI.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewCI.format = presenter.format;
+            viewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            viewCI.subresourceRange.levelCount = 1;
+            viewCI.subresourceRange.layerCount = 1;
+            vkCreateImageView(device, &viewCI, nullptr, &swapImageViews[i]);
+
+            VkImageView attachments[] = { swapImageViews[i], depthBuffer.view };
+            VkFramebufferCreateInfo fbCI{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
+            fbCI.renderPass = renderPass;
+            fbCI.attachmentCount = 2;
+            fbCI.pAttachments = attachments;
+            fbCI.width = extent.width;
+            fbCI.height = extent.height;
+            fbCI.layers = 1;
+            vkCreateFramebuffer(device, &fbCI, nullptr, &framebuffers[i]);
+        }
+        return VK_SUCCESS;
+    };
+    if (createSwapchainTargets() != VK_SUCCESS)
+        return 1;
 
     // Vertex buffer (triangle with 3D positions and normals)
     Vertex vertices[3] = {
@@ -606,46 +451,78 @@ int main()
         { { -0.5f,  0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
     };
 
-    VkBufferCreateInfo bufCI{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-    bufCI.size = sizeof(vertices);
-    bufCI.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-    bufCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
     VkBuffer vertexBuffer = VK_NULL_HANDLE;
-    vkCreateBuffer(device, &bufCI, nullptr, &vertexBuffer);
-
-    VkMemoryRequirements memReq{};
-    vkGetBufferMemoryRequirements(device, vertexBuffer, &memReq);
+    VgtAllocation vertexAlloc;
+    {
+        VkResult res = VgtUploadBuffer(upload, vertices, sizeof(vertices), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer, vertexAlloc);
+        if (res == VK_SUCCESS)
+            res = VgtFlushUploads(upload);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("Vertex buffer upload", res);
+            return 1;
+        }
+    }
 
-    uint32_t memType = FindMemoryTypeIndex(
-        physicalDevice,
-        memReq.memoryTypeBits,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    // --lights: point/spot lights scattered around the layers, binned into view-space clusters
+    // by a compute pass on the graphics queue every frame (see VgtClusteredLights.h).
+    uint32_t lightCount = options.lights;
+    if (lightCount > 0 && !(qProps[graphicsQ].queueFlags & VK_QUEUE_COMPUTE_BIT))
+    {
+        std::fprintf(stderr, "Ignoring --lights: the graphics queue family has no compute support\n");
+        lightCount = 0;
+    }
 
-    VkMemoryAllocateInfo alloc{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-    alloc.allocationSize = memReq.size;
-    alloc.memoryTypeIndex = memType;
+    VkBuffer lightBuffer = VK_NULL_HANDLE;
+    VgtAllocation lightAlloc;
+    VgtClusteredLights clusters;
+    if (lightCount > 0)
+    {
+        const float boundsMin[3] = { -1.5f, -1.5f, -2.0f };
+        const float boundsMax[3] = { 1.5f, 1.5f, 1.0f };
+        const float target[3] = { 0.0f, 0.0f, 0.0f };
+        const std::vector<VgtLight> lights = VgtScatterLights(lightCount, boundsMin, boundsMax, 0.4f, target);
+
+        VkResult res = VgtUploadBuffer(upload, lights.data(), lights.size() * sizeof(VgtLight), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            lightBuffer, lightAlloc);
+        if (res == VK_SUCCESS)
+            res = VgtFlushUploads(upload);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("Light buffer upload", res);
+            return 1;
+        }
 
-    VkDeviceMemory vertexMem = VK_NULL_HANDLE;
-    vkAllocateMemory(device, &alloc, nullptr, &vertexMem);
-    vkBindBufferMemory(device, vertexBuffer, vertexMem, 0);
+        VgtClusteredLightsCreateInfo clustersCI{};
+        clustersCI.device = device;
+        clustersCI.allocator = &allocator;
+        clustersCI.lightBuffer = lightBuffer;
+        clustersCI.lightCount = lightCount;
+        clustersCI.shadersFromDisk = options.shadersFromDisk;
 
-    void* mapped = nullptr;
-    vkMapMemory(device, vertexMem, 0, sizeof(vertices), 0, &mapped);
-    std::memcpy(mapped, vertices, sizeof(vertices));
-    vkUnmapMemory(device, vertexMem);
+        res = VgtCreateClusteredLights(clustersCI, clusters);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtCreateClusteredLights", res);
+            ShowFatal("Failed to create the light clustering pipeline (cluster_lights.comp.spv)");
+            if (pauseOnExit)
+                (void)std::getchar();
+            return 1;
+        }
+    }
 
-    // Pipeline layout
+    // Pipeline layout: set 0 is the per-draw UBO, set 1 the light clusters (--lights only).
+    const VkDescriptorSetLayout setLayouts[2] = { descLayout, clusters.setLayout };
     VkPipelineLayoutCreateInfo plCI{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
-    plCI.setLayoutCount = 1;
-    plCI.pSetLayouts = &descLayout;
+    plCI.setLayoutCount = lightCount > 0 ? 2 : 1;
+    plCI.pSetLayouts = setLayouts;
 
     VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
     vkCreatePipelineLayout(device, &plCI, nullptr, &pipelineLayout);
 
     // Shader modules
-    const auto vertSpv = ReadSpirvWithFallback("lighting.vert.spv");
-    const auto fragSpv = ReadSpirvWithFallback("lighting.frag.spv");
+    const auto vertSpv = VgtLoadSpirv(lightCount > 0 ? "lighting_clustered.vert.spv" : "lighting.vert.spv", options.shadersFromDisk);
+    const auto fragSpv = VgtLoadSpirv(lightCount > 0 ? "lighting_clustered.frag.spv" : "lighting.frag.spv", options.shadersFromDisk);
     if (vertSpv.empty() || fragSpv.empty())
     {
         ShowFatal("Failed to load shaders. Did you build the project (which runs glslangValidator)?");
@@ -732,6 +609,12 @@ int main()
     VkPipelineMultisampleStateCreateInfo ms{ VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
     ms.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
 
+    // With --depth-prepass the depth is final before shading: test EQUAL and leave it alone.
+    VkPipelineDepthStencilStateCreateInfo ds{ VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO };
+    ds.depthTestEnable = VK_TRUE;
+    ds.depthWriteEnable = options.depthPrepass ? VK_FALSE : VK_TRUE;
+    ds.depthCompareOp = options.depthPrepass ? VK_COMPARE_OP_EQUAL : VgtDepthCompareOp(options.reverseZ);
+
     VkPipelineColorBlendAttachmentState cbAttach{};
     cbAttach.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
 
@@ -752,13 +635,52 @@ int main()
     gpCI.pViewportState = &vp;
     gpCI.pRasterizationState = &rs;
     gpCI.pMultisampleState = &ms;
+    gpCI.pDepthStencilState = &ds;
     gpCI.pColorBlendState = &cb;
     gpCI.pDynamicState = &dyn;
     gpCI.layout = pipelineLayout;
     gpCI.renderPass = renderPass;
 
-    VkPipeline pipeline = VK_NULL_HANDLE;
-    vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &gpCI, nullptr, &pipeline);
+    // Pipeline cache persisted next to the exe: the first run compiles (cold), later runs reuse it (warm).
+    VgtPipelineCache pipelineCache;
+    {
+        const VkResult res = VgtCreatePipelineCache(physicalDevice, device, "Step05_LightingBasic", options.pipelineCache, pipelineCache);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtCreatePipelineCache", res);
+            return 1;
+        }
+    }
+
+    // Depth pre-pass pipeline: the same vertex shader (gl_Position is invariant, so both passes
+    // produce bit-identical depth), no fragment shader and no color writes.
+    VkPipelineDepthStencilStateCreateInfo prepassDs = ds;
+    prepassDs.depthWriteEnable = VK_TRUE;
+    prepassDs.depthCompareOp = VgtDepthCompareOp(options.reverseZ);
+
+    VkPipelineColorBlendAttachmentState prepassCbAttach{};
+    VkPipelineColorBlendStateCreateInfo prepassCb = cb;
+    prepassCb.pAttachments = &prepassCbAttach;
+
+    VkGraphicsPipelineCreateInfo prepassCI = gpCI;
+    prepassCI.stageCount = 1;
+    prepassCI.pDepthStencilState = &prepassDs;
+    prepassCI.pColorBlendState = &prepassCb;
+
+    const VkGraphicsPipelineCreateInfo pipelineCIs[2] = { gpCI, prepassCI };
+    VkPipeline pipelines[2] = {};
+    VgtCreateGraphicsPipelines(device, pipelineCache, options.depthPrepass ? 2 : 1, pipelineCIs, pipelines);
+    if (options.showFps || options.benchmark)
+        VgtPrintPipelineCacheStats("Step05_LightingBasic", pipelineCache);
+    const VkPipeline pipeline = pipelines[0];
+    const VkPipeline prepassPipeline = pipelines[1];
+
+    if (options.overdraw > 1 || options.depthPrepass)
+        std::fprintf(stderr, "[Step05_LightingBasic] %u layer(s) back to front, %s, depth %s\n", options.overdraw,
+            options.depthPrepass ? "depth pre-pass + EQUAL shading pass" : "single pass", options.reverseZ ? "reversed" : "standard");
+    if (lightCount > 0)
+        std::fprintf(stderr, "[Step05_LightingBasic] clustered lighting: %u lights, %ux%ux%u clusters, up to %u per cluster\n", lightCount,
+            clusters.tilesX, clusters.tilesY, clusters.slices, clusters.maxLightsPerCluster);
 
     // Command pool / buffers
     VkCommandPoolCreateInfo cmdPoolCI{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
@@ -768,112 +690,175 @@ int main()
     VkCommandPool cmdPool = VK_NULL_HANDLE;
     vkCreateCommandPool(device, &cmdPoolCI, nullptr, &cmdPool);
 
-    std::vector<VkCommandBuffer> cmdBuffers(swapImageCount);
+    // One command buffer per frame in flight; the frame fence guards its reuse.
+    std::vector<VkCommandBuffer> cmdBuffers(options.framesInFlight);
     VkCommandBufferAllocateInfo cmdAI{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
     cmdAI.commandPool = cmdPool;
     cmdAI.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    cmdAI.commandBufferCount = swapImageCount;
+    cmdAI.commandBufferCount = options.framesInFlight;
     vkAllocateCommandBuffers(device, &cmdAI, cmdBuffers.data());
 
-    VkSemaphoreCreateInfo semCI{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
-    VkFenceCreateInfo fenceCI{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
-    fenceCI.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    // Sync primitives: per frame in flight (fence + imageAvailable) and per swapchain image (renderFinished).
+    VgtFrameSync sync;
+    {
+        const VkResult res = VgtCreateFrameSync(device, options.framesInFlight, static_cast<uint32_t>(swapImages.size()), sync);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtCreateFrameSync", res);
+            return 1;
+        }
+    }
+
+    // GPU timestamps (--gpu-timing): one query range per frame in flight.
+    // Pre-recorded static command buffers are not timed (their slot is not known when recording).
+    VgtGpuTimerCreateInfo gpuTimerCI{};
+    gpuTimerCI.physicalDevice = physicalDevice;
+    gpuTimerCI.device = device;
+    gpuTimerCI.queueFamily = graphicsQ;
+    gpuTimerCI.slotCount = options.framesInFlight;
+    gpuTimerCI.label = "Step05_LightingBasic";
+    gpuTimerCI.enabled = options.gpuTiming && !options.staticCommandBuffers;
+    gpuTimerCI.csvPath = options.gpuTimingCsv.c_str();
+
+    VgtGpuTimer gpuTimer;
+    VgtCreateGpuTimer(gpuTimerCI, gpuTimer);
+    const uint32_t gpuFrameScope = VgtGpuTimerScope(gpuTimer, "frame");
+    const uint32_t gpuClusterScope = lightCount > 0 ? VgtGpuTimerScope(gpuTimer, "light_cluster") : kVgtGpuTimerNoScope;
+    const uint32_t gpuRenderPassScope = VgtGpuTimerScope(gpuTimer, "render_pass");
+
+    VgtFrameStats frameStats;
+    VgtFrameStatsBegin(frameStats, "Step05_LightingBasic", options.showFps);
+
+    // Resize / out of date: the old swapchain, its views and framebuffers and the depth buffer are
+    // retired to `sync` and destroyed as the frames in flight finish, without idling the device.
+    // Pipelines and the light clusters do not depend on the extent (the binning takes it per frame).
+    auto recreateSwapchain = [&]() -> VkResult
+    {
+        const VkResult res = VgtRecreateSwapchain(presenter, sync);
+        if (res != VK_SUCCESS)
+        {
+            PrintVkResult("VgtRecreateSwapchain", res);
+            return res;
+        }
 
-    VkSemaphore imageAvailable = VK_NULL_HANDLE;
-    VkSemaphore renderFinished = VK_NULL_HANDLE;
-    VkFence inFlight = VK_NULL_HANDLE;
-    vkCreateSemaphore(device, &semCI, nullptr, &imageAvailable);
-    vkCreateSemaphore(device, &semCI, nullptr, &renderFinished);
-    vkCreateFence(device, &fenceCI, nullptr, &inFlight);
+        VgtRetire(sync, [device, &allocator, depth = depthBuffer, views = std::move(swapImageViews), fbs = std::move(framebuffers)]() mutable {
+            for (auto fb : fbs)
+                vkDestroyFramebuffer(device, fb, nullptr);
+            for (auto v : views)
+                vkDestroyImageView(device, v, nullptr);
+            VgtDestroyDepthBuffer(allocator, device, depth);
+        });
+        return createSwapchainTargets();
+    };
+
+    double startTime = VgtGetTimeSeconds();
+    std::vector<uint32_t> uboOffsets;
 
-    double startTime = glfwGetTime();
+    VgtBenchmarkPhase(bench, "pipeline", pipelineCache.creationMs);
+    VgtBenchmarkPhase(bench, "upload", upload.uploadMs);
+    initZone.End();
+    VgtBenchmarkBeginFrames(bench, presenter);
 
-    while (!glfwWindowShouldClose(window))
+    while (VgtPresenterRunning(presenter))
     {
-        glfwPollEvents();
-
-        double currentTime = glfwGetTime();
-        float time = static_cast<float>(currentTime - startTime);
-
-        // Update uniform buffer
-        UniformBufferObject ubo{};
-        
-        float model[16], view[16], proj[16], modelView[16];
-        Mat4RotateY(model, time);
-        Mat4LookAt(view, 0.0f, 0.0f, 2.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f);
-        Mat4Perspective(proj, 0.785398f, static_cast<float>(extent.width) / extent.height, 0.1f, 10.0f);
-        
-        // ModelView = view * model
-        Mat4Multiply(modelView, view, model);
-        
-        // MVP = proj * modelView
-        Mat4Multiply(ubo.mvp, proj, modelView);
-        
-        // Copy modelView (no transpose)
-        std::memcpy(ubo.modelView, modelView, sizeof(modelView));
-        
-        // Normal matrix = transpose(inverse(mat3(modelView)))
-        // For simple rotations, transpose(mat3(modelView)) is sufficient
-        float mv3[9];
-        Mat3FromMat4(mv3, modelView);
-        float normalMat3[9];
-        Mat3Transpose(normalMat3, mv3);
-        
-        // Expand to mat4 (padding with identity for the 4th row/column)
-        Mat4Identity(ubo.normalMatrix);
-        ubo.normalMatrix[0] = normalMat3[0];
-        ubo.normalMatrix[1] = normalMat3[1];
-        ubo.normalMatrix[2] = normalMat3[2];
-        ubo.normalMatrix[4] = normalMat3[3];
-        ubo.normalMatrix[5] = normalMat3[4];
-        ubo.normalMatrix[6] = normalMat3[5];
-        ubo.normalMatrix[8] = normalMat3[6];
-        ubo.normalMatrix[9] = normalMat3[7];
-        ubo.normalMatrix[10] = normalMat3[8];
-        
-        // Light direction in view space (pointing down and to the right)
-        ubo.lightDir[0] = 0.5f;
-        ubo.lightDir[1] = -0.5f;
-        ubo.lightDir[2] = -1.0f;
-        ubo.lightDir[3] = 0.0f;
-
-        vkMapMemory(device, uniformMemory, 0, sizeof(ubo), 0, &mapped);
-        std::memcpy(mapped, &ubo, sizeof(ubo));
-        vkUnmapMemory(device, uniformMemory);
-
-        vkWaitForFences(device, 1, &inFlight, VK_TRUE, UINT64_MAX);
-        vkResetFences(device, 1, &inFlight);
+        VGT_TRACE_ZONE("frame");
+        // Wait until this frame slot's previous submission retired before touching its resources.
+        const uint32_t frame = sync.currentFrame;
+        VgtWaitForFrame(device, sync);
+        VgtUniformRingBeginFrame(uniformRing, frame);
+
+        if (presenter.needsRecreate && recreateSwapchain() != VK_SUCCESS)
+            break;
+
+        double currentTime = VgtGetTimeSeconds();
+        // Fixed timestep under --benchmark, so every run animates the same frames.
+        float time = static_cast<float>(VgtBenchmarkTime(bench, currentTime - startTime));
+
+        // Update uniform buffers (row-major matrices and row vectors, see VgtMath.h): one per layer.
+        const VgtMat4 view = VgtMat4LookAt(0.0f, 0.0f, 2.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f);
+        const float aspect = static_cast<float>(extent.width) / extent.height;
+        const VgtMat4 proj = options.reverseZ ? VgtMat4PerspectiveReverseZ(kFovY, aspect, kZNear, kZFar)
+                                              : VgtMat4Perspective(kFovY, aspect, kZNear, kZFar);
+
+        VgtTraceZone uboZone("ubo update");
+        uboOffsets.resize(options.overdraw);
+        bool uboFull = false;
+        for (uint32_t layer = 0; layer < options.overdraw && !uboFull; ++layer)
+        {
+            UniformBufferObject ubo{};
+
+            const VgtMat4 model = LayerModel(layer, options.overdraw, time);
+            ubo.modelView = VgtMat4Mul(model, view);
+            ubo.mvp = VgtMat4Mul(ubo.modelView, proj);
+
+            // Normal matrix = transpose(inverse(mat3(modelView)))
+            // For simple rotations, transpose(mat3(modelView)) is sufficient
+            ubo.normalMatrix = VgtMat4NormalMatrix(ubo.modelView);
+
+            // Light direction in view space (pointing down and to the right)
+            ubo.lightDir[0] = 0.5f;
+            ubo.lightDir[1] = -0.5f;
+            ubo.lightDir[2] = -1.0f;
+            ubo.lightDir[3] = 0.0f;
+
+            uboOffsets[layer] = VgtUniformRingPush(uniformRing, &ubo, sizeof(ubo));
+            uboFull = uboOffsets[layer] == UINT32_MAX;
+        }
+        uboZone.End();
+        if (uboFull)
+        {
+            std::fprintf(stderr, "[Step05_LightingBasic] Uniform ring too small for %u UBO(s) per frame\n", options.overdraw);
+            break;
+        }
 
         uint32_t imageIndex = 0;
         {
-            const VkResult res = vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, imageAvailable, VK_NULL_HANDLE, &imageIndex);
+            const VkResult res = VgtPresenterAcquire(presenter, sync.imageAvailable[frame], imageIndex);
+            if (res == VK_ERROR_OUT_OF_DATE_KHR)
+                continue; // nothing acquired; recreated at the top of the next iteration
             if (res != VK_SUCCESS)
             {
-                PrintVkResult("vkAcquireNextImageKHR", res);
+                PrintVkResult("VgtPresenterAcquire", res);
                 break;
             }
         }
 
-        VkCommandBuffer cmd = cmdBuffers[imageIndex];
+        VgtClaimImage(device, sync, imageIndex);
+
+        VgtFrameStatsCpuBegin(frameStats);
+        VgtTraceZone recordZone("record");
+        VkCommandBuffer cmd = cmdBuffers[frame];
         vkResetCommandBuffer(cmd, 0);
 
         VkCommandBufferBeginInfo begin{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
         vkBeginCommandBuffer(cmd, &begin);
+        VgtGpuTimerBeginFrame(gpuTimer, cmd, frame);
+        VgtGpuTimerBegin(gpuTimer, cmd, gpuFrameScope);
 
-        VkClearValue clear{};
-        clear.color.float32[0] = 0.02f;
-        clear.color.float32[1] = 0.02f;
-        clear.color.float32[2] = 0.05f;
-        clear.color.float32[3] = 1.0f;
+        // Bins the lights for this frame's view; the shading pass below reads the cluster lists.
+        if (lightCount > 0)
+        {
+            VgtGpuTimerBegin(gpuTimer, cmd, gpuClusterScope);
+            VgtCmdClusterLights(cmd, clusters, view, kFovY, aspect, kZNear, kZFar, extent);
+            VgtGpuTimerEnd(gpuTimer, cmd, gpuClusterScope);
+        }
+
+        VkClearValue clears[2]{};
+        clears[0].color.float32[0] = 0.02f;
+        clears[0].color.float32[1] = 0.02f;
+        clears[0].color.float32[2] = 0.05f;
+        clears[0].color.float32[3] = 1.0f;
+        clears[1].depthStencil.depth = VgtDepthClearValue(options.reverseZ);
 
         VkRenderPassBeginInfo rpBegin{ VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
         rpBegin.renderPass = renderPass;
         rpBegin.framebuffer = framebuffers[imageIndex];
         rpBegin.renderArea.offset = { 0, 0 };
         rpBegin.renderArea.extent = extent;
-        rpBegin.clearValueCount = 1;
-        rpBegin.pClearValues = &clear;
+        rpBegin.clearValueCount = 2;
+        rpBegin.pClearValues = clears;
 
+        VgtGpuTimerBegin(gpuTimer, cmd, gpuRenderPassScope);
         vkCmdBeginRenderPass(cmd, &rpBegin, VK_SUBPASS_CONTENTS_INLINE);
 
         VkViewport drawViewport{};
@@ -890,49 +875,87 @@ int main()
         drawScissor.extent = extent;
         vkCmdSetScissor(cmd, 0, 1, &drawScissor);
 
-        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
-        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descSet, 0, nullptr);
-
         VkDeviceSize offset = 0;
         vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer, &offset);
-        vkCmdDraw(cmd, 3, 1, 0, 0);
+        if (lightCount > 0)
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1, &clusters.descSet, 0, nullptr);
+
+        // Layers go back to front, so without the pre-pass each one passes the depth test and
+        // is shaded over the previous one. The pre-pass draws the same layers depth-only first.
+        if (options.depthPrepass)
+        {
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, prepassPipeline);
+            for (uint32_t layer = 0; layer < options.overdraw; ++layer)
+            {
+                vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descSet, 1, &uboOffsets[layer]);
+                vkCmdDraw(cmd, 3, 1, 0, 0);
+            }
+        }
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        for (uint32_t layer = 0; layer < options.overdraw; ++layer)
+        {
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descSet, 1, &uboOffsets[layer]);
+            vkCmdDraw(cmd, 3, 1, 0, 0);
+        }
 
         vkCmdEndRenderPass(cmd);
+        VgtGpuTimerEnd(gpuTimer, cmd, gpuRenderPassScope);
+        VgtGpuTimerEnd(gpuTimer, cmd, gpuFrameScope);
         vkEndCommandBuffer(cmd);
 
         VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
         VkSubmitInfo submit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
         submit.waitSemaphoreCount = 1;
-        submit.pWaitSemaphores = &imageAvailable;
+        submit.pWaitSemaphores = &sync.imageAvailable[frame];
         submit.pWaitDstStageMask = &waitStage;
         submit.commandBufferCount = 1;
         submit.pCommandBuffers = &cmd;
         submit.signalSemaphoreCount = 1;
-        submit.pSignalSemaphores = &renderFinished;
+        submit.pSignalSemaphores = &sync.renderFinished[imageIndex];
 
-        vkQueueSubmit(graphicsQueue, 1, &submit, inFlight);
+        recordZone.End();
+        VgtTraceZone submitZone("submit");
+        vkQueueSubmit(graphicsQueue, 1, &submit, sync.inFlight[frame]);
+        submitZone.End();
+        VgtFrameStatsCpuEnd(frameStats);
 
-        VkPresentInfoKHR present{ VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
-        present.waitSemaphoreCount = 1;
-        present.pWaitSemaphores = &renderFinished;
-        present.swapchainCount = 1;
-        present.pSwapchains = &swapchain;
-        present.pImageIndices = &imageIndex;
-        vkQueuePresentKHR(presentQueue, &present);
+        {
+            const VkResult res = VgtPresenterPresent(presenter, sync.renderFinished[imageIndex], imageIndex);
+            if (res != VK_SUCCESS)
+            {
+                PrintVkResult("VgtPresenterPresent", res);
+                break;
+            }
+        }
 
-        vkQueueWaitIdle(presentQueue);
+        VgtAdvanceFrame(sync);
+        // --memory-stats: once everything is live (a streamed texture may still be on its way).
+        if (options.memoryStats && presenter.framesPresented == 1)
+            VgtPrintAllocatorStats("Step05_LightingBasic", VgtGetAllocatorStats(allocator), "first frame");
+        VgtFrameStatsTick(frameStats);
+        VgtBenchmarkTick(bench, frameStats, gpuTimer);
+        VgtGpuTimerTick(gpuTimer);
     }
 
     vkDeviceWaitIdle(device);
+    if (options.memoryStats)
+        VgtPrintAllocatorStats("Step05_LightingBasic", VgtGetAllocatorStats(allocator), "before teardown");
+    VgtFrameStatsFinish(frameStats);
+    VgtGpuTimerFinish(gpuTimer);
+    VgtBenchmarkFinish(bench, gpuTimer);
+    VgtTraceStop();
 
-    vkDestroyFence(device, inFlight, nullptr);
-    vkDestroySemaphore(device, renderFinished, nullptr);
-    vkDestroySemaphore(device, imageAvailable, nullptr);
+    VgtDestroyFrameSync(device, sync);
+    VgtDestroyGpuTimer(gpuTimer);
 
-    vkFreeCommandBuffers(device, cmdPool, swapImageCount, cmdBuffers.data());
+    vkFreeCommandBuffers(device, cmdPool, options.framesInFlight, cmdBuffers.data());
     vkDestroyCommandPool(device, cmdPool, nullptr);
 
     vkDestroyPipeline(device, pipeline, nullptr);
+    if (prepassPipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(device, prepassPipeline, nullptr);
+    VgtDestroyPipelineCache(device, pipelineCache);
     vkDestroyShaderModule(device, fragModule, nullptr);
     vkDestroyShaderModule(device, vertModule, nullptr);
     vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
@@ -940,29 +963,35 @@ int main()
     vkDestroyDescriptorPool(device, descPool, nullptr);
     vkDestroyDescriptorSetLayout(device, descLayout, nullptr);
 
-    vkDestroyBuffer(device, uniformBuffer, nullptr);
-    vkFreeMemory(device, uniformMemory, nullptr);
+    VgtDestroyUniformRing(allocator, uniformRing);
 
-    vkDestroyBuffer(device, vertexBuffer, nullptr);
-    vkFreeMemory(device, vertexMem, nullptr);
+    VgtDestroyBuffer(allocator, vertexBuffer, vertexAlloc);
+    if (lightCount > 0)
+    {
+        VgtDestroyClusteredLights(clusters);
+        VgtDestroyBuffer(allocator, lightBuffer, lightAlloc);
+    }
+    VgtDestroyUploadContext(upload);
 
     for (auto fb : framebuffers)
         vkDestroyFramebuffer(device, fb, nullptr);
 
     vkDestroyRenderPass(device, renderPass, nullptr);
+    VgtDestroyDepthBuffer(allocator, device, depthBuffer);
 
     for (auto v : swapImageViews)
         vkDestroyImageView(device, v, nullptr);
 
-    vkDestroySwapchainKHR(device, swapchain, nullptr);
+    VgtPresenterDestroySwapchain(presenter);
+    VgtDestroyAllocator(allocator);
+
     vkDestroyDevice(device, nullptr);
 
-    vkDestroySurfaceKHR(instance, surface, nullptr);
+    VgtPresenterDestroySurface(presenter);
 
     vkDestroyInstance(instance, nullptr);
 
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    VgtPresenterShutdown(presenter);
 
     if (pauseOnExit)
     {
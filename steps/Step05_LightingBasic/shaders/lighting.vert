@@ -5,6 +5,10 @@ layout(location = 1) in vec3 iNormal;
 
 layout(location = 0) out vec3 vNormal;
 
+// The depth pre-pass pipeline (--depth-prepass) runs this shader too; its depth must match the
+// shading pass exactly for the EQUAL test.
+invariant gl_Position;
+
 layout(set = 0, binding = 0) uniform UBO
 {
     layout(row_major) mat4 uMvp;
@@ -15,6 +19,6 @@ layout(set = 0, binding = 0) uniform UBO
 
 void main()
 {
-    gl_Position = ubo.uMvp * vec4(iPos, 1.0);
+    gl_Position = vec4(iPos, 1.0) * ubo.uMvp;
     vNormal = mat3(ubo.uNormalMatrix) * iNormal;
 }
@@ -0,0 +1,105 @@
+#version 450
+
+// lighting.frag plus point and spot lights from the clustered light lists (--lights N).
+// The cluster of a fragment is its screen tile and the exponential depth slice of its view-space
+// depth; only the lights binned into that cluster by cluster_lights.comp are evaluated.
+
+layout(location = 0) in vec3 vNormal;
+layout(location = 1) in vec3 vViewPos;
+layout(location = 0) out vec4 oColor;
+
+// Evaluate every light instead of the cluster's list (the brute-force baseline of ClusterBench).
+layout(constant_id = 0) const bool kAllLights = false;
+
+layout(set = 0, binding = 0) uniform UBO
+{
+    mat4 uMvp;
+    mat4 uModelView;
+    mat4 uNormalMatrix;
+    vec4 uLightDir;
+} ubo;
+
+// Same layout as VgtLight (std430, 64 bytes); positions and directions in view space.
+struct Light
+{
+    vec4 positionRange;
+    vec4 colorIntensity;
+    vec4 directionSpotScale;
+    vec4 spotOffset;
+};
+
+layout(std140, set = 1, binding = 0) uniform Params
+{
+    layout(row_major) mat4 uView;
+    vec4 uProjection; // tanHalfFovX, tanHalfFovY, zNear, zFar
+    vec4 uScreen;     // width, height, tile width, tile height (px)
+    vec4 uSlicing;    // slice scale, slice bias
+    uvec4 uGrid;      // tilesX, tilesY, slices, maxLightsPerCluster
+    uvec4 uLights;    // x: light count
+} params;
+
+layout(std430, set = 1, binding = 2) readonly buffer ViewLights
+{
+    Light uLights[];
+} viewLights;
+
+layout(std430, set = 1, binding = 3) readonly buffer ClusterCounts
+{
+    uint uCounts[];
+} clusterCounts;
+
+layout(std430, set = 1, binding = 4) readonly buffer ClusterIndices
+{
+    uint uIndices[];
+} clusterIndices;
+
+vec3 PointLight(Light light, vec3 N, vec3 baseColor)
+{
+    const vec3 toLight = light.positionRange.xyz - vViewPos;
+    const float dist2 = dot(toLight, toLight);
+    const float range = light.positionRange.w;
+    if (dist2 >= range * range)
+        return vec3(0.0);
+
+    const vec3 L = toLight * inversesqrt(max(dist2, 1e-8));
+    // Inverse-square falloff, windowed to reach exactly zero at the light's range.
+    const float window = clamp(1.0 - (dist2 * dist2) / (range * range * range * range), 0.0, 1.0);
+    const float attenuation = window * window / (dist2 + 0.01);
+    float spot = clamp(dot(-L, light.directionSpotScale.xyz) * light.directionSpotScale.w + light.spotOffset.x, 0.0, 1.0);
+    spot *= spot;
+
+    const float ndotl = max(dot(N, L), 0.0);
+    return baseColor * light.colorIntensity.rgb * (light.colorIntensity.a * ndotl * attenuation * spot);
+}
+
+void main()
+{
+    vec3 N = normalize(vNormal);
+    vec3 L = normalize(-ubo.uLightDir.xyz);
+    float ndotl = max(dot(N, L), 0.0);
+
+    vec3 baseColor = vec3(0.8, 0.6, 0.4);
+    vec3 ambient = baseColor * 0.2;
+    vec3 diffuse = baseColor * ndotl * 0.8;
+    vec3 color = ambient + diffuse;
+
+    if (kAllLights)
+    {
+        for (uint i = 0u; i < params.uLights.x; ++i)
+            color += PointLight(viewLights.uLights[i], N, baseColor);
+    }
+    else
+    {
+        const uvec2 tile = min(uvec2(gl_FragCoord.xy / params.uScreen.zw), params.uGrid.xy - 1u);
+        const float depth = max(-vViewPos.z, params.uProjection.z);
+        const uint slice = min(uint(max(log(depth) * params.uSlicing.x + params.uSlicing.y, 0.0)), params.uGrid.z - 1u);
+        const uint cluster = tile.x + params.uGrid.x * (tile.y + params.uGrid.y * slice);
+
+        // The stored count is unclamped; only maxLightsPerCluster indices exist.
+        const uint count = min(clusterCounts.uCounts[cluster], params.uGrid.w);
+        for (uint i = 0u; i < count; ++i)
+            color += PointLight(viewLights.uLights[clusterIndices.uIndices[cluster * params.uGrid.w + i]], N, baseColor);
+    }
+
+    oColor = vec4(color, 1.0);
+}
@@ -0,0 +1,27 @@
+#version 450
+
+// lighting.vert plus the view-space position, for the clustered light lookup (--lights N).
+
+layout(location = 0) in vec3 iPos;
+layout(location = 1) in vec3 iNormal;
+
+layout(location = 0) out vec3 vNormal;
+layout(location = 1) out vec3 vViewPos;
+
+// Must match lighting.vert exactly: the depth pre-pass may run either shader before the EQUAL test.
+invariant gl_Position;
+
+layout(set = 0, binding = 0) uniform UBO
+{
+    layout(row_major) mat4 uMvp;
+    layout(row_major) mat4 uModelView;
+    layout(row_major) mat4 uNormalMatrix;
+    vec4 uLightDir;
+} ubo;
+
+void main()
+{
+    gl_Position = vec4(iPos, 1.0) * ubo.uMvp;
+    vNormal = mat3(ubo.uNormalMatrix) * iNormal;
+    vViewPos = (vec4(iPos, 1.0) * ubo.uModelView).xyz;
+}
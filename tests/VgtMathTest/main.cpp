@@ -0,0 +1,257 @@
+// Checks that VgtMath reproduces the scalar Mat4* helpers the steps used before, for whichever
+// kernel (AVX2 / SSE2 / NEON / scalar) this build picked.
+//
+// Usage: VgtMathTest [--count N]
+//
+// Exit code 1 on any mismatch. Registered with CTest (`ctest -L vgt_unit`) and needs no GPU.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <VgtMath.h>
+
+// --- former per-step helpers (Step05_LightingBasic), kept verbatim as the reference ---------
+
+static void Mat4Identity(float* m)
+{
+    for (int i = 0; i < 16; ++i)
+        m[i] = 0.0f;
+    m[0] = m[5] = m[10] = m[15] = 1.0f;
+}
+
+static void Mat4RotateY(float* m, float angle)
+{
+    const float c = std::cos(angle);
+    const float s = std::sin(angle);
+    Mat4Identity(m);
+    m[0] = c;
+    m[2] = -s;
+    m[8] = s;
+    m[10] = c;
+}
+
+static void Mat4LookAt(float* m, float eyeX, float eyeY, float eyeZ,
+                       float centerX, float centerY, float centerZ,
+                       float upX, float upY, float upZ)
+{
+    float fx = centerX - eyeX;
+    float fy = centerY - eyeY;
+    float fz = centerZ - eyeZ;
+    float rlf = 1.0f / std::sqrt(fx * fx + fy * fy + fz * fz);
+    fx *= rlf;
+    fy *= rlf;
+    fz *= rlf;
+
+    float sx = fy * upZ - fz * upY;
+    float sy = fz * upX - fx * upZ;
+    float sz = fx * upY - fy * upX;
+    float rls = 1.0f / std::sqrt(sx * sx + sy * sy + sz * sz);
+    sx *= rls;
+    sy *= rls;
+    sz *= rls;
+
+    float ux = sy * fz - sz * fy;
+    float uy = sz * fx - sx * fz;
+    float uz = sx * fy - sy * fx;
+
+    m[0] = sx;
+    m[1] = sy;
+    m[2] = sz;
+    m[3] = 0.0f;
+    m[4] = ux;
+    m[5] = uy;
+    m[6] = uz;
+    m[7] = 0.0f;
+    m[8] = -fx;
+    m[9] = -fy;
+    m[10] = -fz;
+    m[11] = 0.0f;
+    m[12] = -(sx * eyeX + sy * eyeY + sz * eyeZ);
+    m[13] = -(ux * eyeX + uy * eyeY + uz * eyeZ);
+    m[14] = (fx * eyeX + fy * eyeY + fz * eyeZ);
+    m[15] = 1.0f;
+}
+
+static void Mat4Perspective(float* m, float fovY, float aspect, float zNear, float zFar)
+{
+    const float tanHalfFovy = std::tan(fovY / 2.0f);
+    for (int i = 0; i < 16; ++i)
+        m[i] = 0.0f;
+    m[0] = 1.0f / (aspect * tanHalfFovy);
+    m[5] = 1.0f / tanHalfFovy;
+    m[10] = zFar / (zNear - zFar);
+    m[11] = -1.0f;
+    m[14] = -(zFar * zNear) / (zFar - zNear);
+    m[5] = -m[5];
+}
+
+static void Mat4Multiply(float* out, const float* a, const float* b)
+{
+    float temp[16];
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int col = 0; col < 4; ++col)
+        {
+            temp[row * 4 + col] = 0.0f;
+            for (int k = 0; k < 4; ++k)
+            {
+                temp[row * 4 + col] += a[row * 4 + k] * b[k * 4 + col];
+            }
+        }
+    }
+    std::memcpy(out, temp, sizeof(temp));
+}
+
+static void Mat4Transpose(float* out, const float* m)
+{
+    float temp[16];
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int col = 0; col < 4; ++col)
+        {
+            temp[col * 4 + row] = m[row * 4 + col];
+        }
+    }
+    std::memcpy(out, temp, sizeof(temp));
+}
+
+static void NormalMatrix(float* out, const float* modelView)
+{
+    // Mat3FromMat4 + Mat3Transpose + expand to mat4, as Step05 did it.
+    float mv3[9] = {
+        modelView[0], modelView[1], modelView[2],
+        modelView[4], modelView[5], modelView[6],
+        modelView[8], modelView[9], modelView[10],
+    };
+    float n3[9] = { mv3[0], mv3[3], mv3[6], mv3[1], mv3[4], mv3[7], mv3[2], mv3[5], mv3[8] };
+    Mat4Identity(out);
+    out[0] = n3[0]; out[1] = n3[1]; out[2] = n3[2];
+    out[4] = n3[3]; out[5] = n3[4]; out[6] = n3[5];
+    out[8] = n3[6]; out[9] = n3[7]; out[10] = n3[8];
+}
+
+// --- equivalence -------------------------------------------------------------------------
+
+struct Checker
+{
+    double maxError = 0.0;
+    int failures = 0;
+
+    void Compare(const char* what, const float* expected, const float* actual, int n = 16)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            const double err = std::fabs(double(expected[i]) - double(actual[i]));
+            const double tolerance = 1e-5 * std::max(1.0, std::fabs(double(expected[i])));
+            maxError = std::max(maxError, err);
+            if (err > tolerance)
+            {
+                if (failures < 10)
+                    std::fprintf(stderr, "MISMATCH %s[%d]: expected %.9g got %.9g\n", what, i, expected[i], actual[i]);
+                ++failures;
+            }
+        }
+    }
+};
+
+static bool CheckEquivalence(const std::vector<VgtMat4>& a, const std::vector<VgtMat4>& b, std::mt19937& rng)
+{
+    Checker check;
+    std::uniform_real_distribution<float> angle(-6.3f, 6.3f);
+    std::uniform_real_distribution<float> coord(-10.0f, 10.0f);
+
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        float ref[16];
+        Mat4Multiply(ref, a[i].m, b[i].m);
+        check.Compare("VgtMat4Mul", ref, VgtMat4Mul(a[i], b[i]).m);
+
+        Mat4Transpose(ref, a[i].m);
+        check.Compare("VgtMat4Transpose", ref, VgtMat4Transpose(a[i]).m);
+    }
+
+    // In place (`out` aliasing `a`), over an odd count so the single-matrix tail runs too.
+    std::vector<VgtMat4> batch = a;
+    const size_t batchCount = a.size() % 2 == 0 ? a.size() - 1 : a.size();
+    VgtMat4MulBatch(batch.data(), batch.data(), b[0], batchCount);
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        float ref[16];
+        if (i < batchCount)
+        {
+            Mat4Multiply(ref, a[i].m, b[0].m);
+            check.Compare("VgtMat4MulBatch", ref, batch[i].m);
+            if (std::memcmp(batch[i].m, VgtMat4Mul(a[i], b[0]).m, sizeof(VgtMat4)) != 0)
+            {
+                if (check.failures < 10)
+                    std::fprintf(stderr, "MISMATCH VgtMat4MulBatch: matrix %zu differs from VgtMat4Mul\n", i);
+                ++check.failures;
+            }
+        }
+
+        const VgtVec4 v{ coord(rng), coord(rng), coord(rng), 1.0f };
+        float row[16] = { v.x, v.y, v.z, v.w };
+        Mat4Multiply(ref, row, a[i].m);
+        const VgtVec4 r = VgtMat4MulVec4(v, a[i]);
+        check.Compare("VgtMat4MulVec4", ref, &r.x, 4);
+    }
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        float ref[16];
+        const float t = angle(rng);
+        Mat4RotateY(ref, t);
+        check.Compare("VgtMat4RotateY", ref, VgtMat4RotateY(t).m);
+
+        const float e[3] = { coord(rng), coord(rng), coord(rng) };
+        Mat4LookAt(ref, e[0], e[1], e[2], 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f);
+        check.Compare("VgtMat4LookAt", ref, VgtMat4LookAt(e[0], e[1], e[2], 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f).m);
+
+        const float aspect = 0.5f + std::fabs(angle(rng));
+        Mat4Perspective(ref, 0.785398f, aspect, 0.1f, 10.0f);
+        check.Compare("VgtMat4Perspective", ref, VgtMat4Perspective(0.785398f, aspect, 0.1f, 10.0f).m);
+
+        NormalMatrix(ref, a[i % a.size()].m);
+        check.Compare("VgtMat4NormalMatrix", ref, VgtMat4NormalMatrix(a[i % a.size()]).m);
+    }
+
+    std::printf("equivalence: %s (max abs error %.3g)\n", check.failures == 0 ? "OK" : "FAILED", check.maxError);
+    return check.failures == 0;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t count = 4096;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+            count = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--count N]\n", argv[0]);
+            return 1;
+        }
+    }
+    count = std::max(count, 1u);
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+    std::vector<VgtMat4> a(count), b(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        for (int k = 0; k < 16; ++k)
+        {
+            a[i].m[k] = value(rng);
+            b[i].m[k] = value(rng);
+        }
+    }
+
+    std::printf("kernel: %s\n", VGT_MATH_KERNEL);
+    std::printf("matrices: %u\n", count);
+    return CheckEquivalence(a, b, rng) ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+// Writes a VgtAssetPack archive (see common/VgtAssetPack.h).
+//
+// Usage: vgt_pack -o OUTPUT NAME=PATH [NAME=PATH ...]
+//
+// NAME is what the runtime looks up (e.g. "texture.vert.spv", "assets/texture.ktx2"), PATH the
+// file to store. Entries are sorted by name and aligned to kVgtPackAlignment.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <VgtAssetPack.h>
+
+struct Input
+{
+    std::string name;
+    std::string path;
+    std::vector<uint8_t> bytes;
+};
+
+static bool ReadBytes(const std::string& path, std::vector<uint8_t>& bytes)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !file.bad();
+}
+
+static size_t AlignUp(size_t v, size_t alignment)
+{
+    return (v + alignment - 1) / alignment * alignment;
+}
+
+int main(int argc, char** argv)
+{
+    std::string output;
+    std::vector<Input> inputs;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+            continue;
+        }
+
+        const char* eq = std::strchr(argv[i], '=');
+        if (!eq || eq == argv[i])
+        {
+            std::fprintf(stderr, "Usage: vgt_pack -o OUTPUT NAME=PATH [NAME=PATH ...]\n");
+            return 1;
+        }
+        Input input;
+        input.name.assign(argv[i], static_cast<size_t>(eq - argv[i]));
+        input.path = eq + 1;
+        if (input.name.size() > kVgtPackMaxNameLength)
+        {
+            std::fprintf(stderr, "Asset name too long (max %zu): %s\n", kVgtPackMaxNameLength, input.name.c_str());
+            return 1;
+        }
+        inputs.push_back(std::move(input));
+    }
+    if (output.empty())
+    {
+        std::fprintf(stderr, "Usage: vgt_pack -o OUTPUT NAME=PATH [NAME=PATH ...]\n");
+        return 1;
+    }
+
+    std::sort(inputs.begin(), inputs.end(), [](const Input& a, const Input& b) { return std::strcmp(a.name.c_str(), b.name.c_str()) < 0; });
+    for (size_t i = 1; i < inputs.size(); ++i)
+    {
+        if (inputs[i].name == inputs[i - 1].name)
+        {
+            std::fprintf(stderr, "Duplicate asset name: %s\n", inputs[i].name.c_str());
+            return 1;
+        }
+    }
+
+    size_t offset = AlignUp(sizeof(VgtPackHeader) + inputs.size() * sizeof(VgtPackEntry), kVgtPackAlignment);
+    const size_t dataStart = offset;
+    std::vector<VgtPackEntry> entries(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        if (!ReadBytes(inputs[i].path, inputs[i].bytes))
+        {
+            std::fprintf(stderr, "Cannot read %s\n", inputs[i].path.c_str());
+            return 1;
+        }
+        VgtPackEntry& entry = entries[i];
+        std::memset(&entry, 0, sizeof(entry));
+        std::memcpy(entry.name, inputs[i].name.c_str(), inputs[i].name.size());
+        entry.offset = offset;
+        entry.size = inputs[i].bytes.size();
+        offset = AlignUp(offset + inputs[i].bytes.size(), kVgtPackAlignment);
+    }
+
+    VgtPackHeader header{};
+    std::memcpy(header.magic, kVgtPackMagic, sizeof(kVgtPackMagic));
+    header.version = kVgtPackVersion;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.dataSize = offset - dataStart;
+
+    std::vector<uint8_t> pack(offset, 0);
+    std::memcpy(pack.data(), &header, sizeof(header));
+    if (!entries.empty())
+        std::memcpy(pack.data() + sizeof(header), entries.data(), entries.size() * sizeof(VgtPackEntry));
+    for (size_t i = 0; i < inputs.size(); ++i)
+        std::copy(inputs[i].bytes.begin(), inputs[i].bytes.end(), pack.begin() + static_cast<std::ptrdiff_t>(entries[i].offset));
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!out || !out.write(reinterpret_cast<const char*>(pack.data()), static_cast<std::streamsize>(pack.size())))
+    {
+        std::fprintf(stderr, "Failed to write %s\n", output.c_str());
+        return 1;
+    }
+    std::printf("%s: %zu assets, %zu KiB\n", output.c_str(), entries.size(), pack.size() / 1024);
+    return 0;
+}
@@ -0,0 +1,326 @@
+#include "BlockCompress.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include <VgtImageFile.h>
+
+// Fits a segment through the block along the principal axis of its first `channels` channels.
+// e0/e1 are the extreme projections, in 0..255.
+static void FitEndpoints(const uint8_t* rgba, uint32_t channels, float e0[4], float e1[4])
+{
+    float mean[4] = {};
+    for (uint32_t i = 0; i < 16; ++i)
+        for (uint32_t c = 0; c < channels; ++c)
+            mean[c] += rgba[i * 4 + c];
+    for (uint32_t c = 0; c < channels; ++c)
+        mean[c] /= 16.0f;
+
+    float cov[4][4] = {};
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        float d[4] = {};
+        for (uint32_t c = 0; c < channels; ++c)
+            d[c] = rgba[i * 4 + c] - mean[c];
+        for (uint32_t a = 0; a < channels; ++a)
+            for (uint32_t b = 0; b < channels; ++b)
+                cov[a][b] += d[a] * d[b];
+    }
+
+    // Power iteration, started from the row of the channel with the largest variance
+    // (a fixed start vector can be orthogonal to the axis, e.g. for a red/blue checker).
+    uint32_t widest = 0;
+    for (uint32_t c = 1; c < channels; ++c)
+        if (cov[c][c] > cov[widest][widest])
+            widest = c;
+
+    float axis[4] = {};
+    for (uint32_t c = 0; c < channels; ++c)
+        axis[c] = cov[widest][c];
+
+    for (uint32_t iter = 0; iter < 8; ++iter)
+    {
+        float next[4] = {};
+        float len = 0.0f;
+        for (uint32_t a = 0; a < channels; ++a)
+        {
+            for (uint32_t b = 0; b < channels; ++b)
+                next[a] += cov[a][b] * axis[b];
+            len += next[a] * next[a];
+        }
+        len = std::sqrt(len);
+        if (len < 1e-6f)
+            break;
+        for (uint32_t c = 0; c < channels; ++c)
+            axis[c] = next[c] / len;
+    }
+
+    float tMin = 0.0f, tMax = 0.0f;
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        float t = 0.0f;
+        for (uint32_t c = 0; c < channels; ++c)
+            t += (rgba[i * 4 + c] - mean[c]) * axis[c];
+        tMin = std::min(tMin, t);
+        tMax = std::max(tMax, t);
+    }
+
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        e0[c] = c < channels ? std::clamp(mean[c] + axis[c] * tMin, 0.0f, 255.0f) : 255.0f;
+        e1[c] = c < channels ? std::clamp(mean[c] + axis[c] * tMax, 0.0f, 255.0f) : 255.0f;
+    }
+}
+
+// Index of the palette entry closest to each texel (squared distance over `channels`).
+static void NearestIndices(const uint8_t* rgba, uint32_t channels, const int (*palette)[4], uint32_t paletteSize, uint32_t indices[16])
+{
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        int bestErr = 0x7FFFFFFF;
+        for (uint32_t p = 0; p < paletteSize; ++p)
+        {
+            int err = 0;
+            for (uint32_t c = 0; c < channels; ++c)
+            {
+                const int d = rgba[i * 4 + c] - palette[p][c];
+                err += d * d;
+            }
+            if (err < bestErr)
+            {
+                bestErr = err;
+                indices[i] = p;
+            }
+        }
+    }
+}
+
+static uint16_t To565(const float c[4])
+{
+    const uint32_t r = static_cast<uint32_t>(std::lround(c[0] * 31.0f / 255.0f));
+    const uint32_t g = static_cast<uint32_t>(std::lround(c[1] * 63.0f / 255.0f));
+    const uint32_t b = static_cast<uint32_t>(std::lround(c[2] * 31.0f / 255.0f));
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+static void From565(uint16_t v, int out[4])
+{
+    const int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+    out[3] = 255;
+}
+
+void EncodeBC1Block(const uint8_t* rgba, uint8_t* out)
+{
+    float e0[4], e1[4];
+    FitEndpoints(rgba, 3, e0, e1);
+    uint16_t c0 = To565(e1);
+    uint16_t c1 = To565(e0);
+    // color0 > color1 selects the 4-color mode; equal endpoints decode every index 0 to color0.
+    if (c0 < c1)
+        std::swap(c0, c1);
+
+    uint32_t indices[16] = {};
+    if (c0 != c1)
+    {
+        int palette[4][4];
+        From565(c0, palette[0]);
+        From565(c1, palette[1]);
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        NearestIndices(rgba, 3, palette, 4, indices);
+    }
+
+    uint32_t bits = 0;
+    for (uint32_t i = 0; i < 16; ++i)
+        bits |= indices[i] << (2 * i);
+    out[0] = static_cast<uint8_t>(c0);
+    out[1] = static_cast<uint8_t>(c0 >> 8);
+    out[2] = static_cast<uint8_t>(c1);
+    out[3] = static_cast<uint8_t>(c1 >> 8);
+    std::memcpy(out + 4, &bits, 4);
+}
+
+void EncodeBC4Block(const uint8_t* values, uint32_t stride, uint8_t* out)
+{
+    int lo = 255, hi = 0;
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        lo = std::min<int>(lo, values[i * stride]);
+        hi = std::max<int>(hi, values[i * stride]);
+    }
+
+    // value0 > value1 selects the 8-value mode: value0, value1 and six steps in between.
+    int palette[8];
+    palette[0] = hi;
+    palette[1] = lo;
+    for (int k = 2; k < 8; ++k)
+        palette[k] = ((8 - k) * hi + (k - 1) * lo + 3) / 7;
+
+    uint64_t bits = 0;
+    if (hi != lo)
+    {
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            const int v = values[i * stride];
+            uint64_t best = 0;
+            for (uint64_t k = 1; k < 8; ++k)
+                if (std::abs(v - palette[k]) < std::abs(v - palette[best]))
+                    best = k;
+            bits |= best << (3 * i);
+        }
+    }
+
+    out[0] = static_cast<uint8_t>(hi);
+    out[1] = static_cast<uint8_t>(lo);
+    for (uint32_t b = 0; b < 6; ++b)
+        out[2 + b] = static_cast<uint8_t>(bits >> (8 * b));
+}
+
+void EncodeBC3Block(const uint8_t* rgba, uint8_t* out)
+{
+    EncodeBC4Block(rgba + 3, 4, out);
+    EncodeBC1Block(rgba, out + 8);
+}
+
+void EncodeBC5Block(const uint8_t* rgba, uint8_t* out)
+{
+    EncodeBC4Block(rgba + 0, 4, out);
+    EncodeBC4Block(rgba + 1, 4, out + 8);
+}
+
+namespace
+{
+struct BitWriter
+{
+    uint8_t* out;
+    uint32_t pos = 0;
+
+    void put(uint32_t value, uint32_t bits)
+    {
+        for (uint32_t b = 0; b < bits; ++b, ++pos)
+        {
+            if ((value >> b) & 1u)
+                out[pos >> 3] |= static_cast<uint8_t>(1u << (pos & 7));
+        }
+    }
+};
+} // namespace
+
+// 7-bit endpoint plus the shared p-bit that fits `e` best (endpoint = q << 1 | p).
+static void QuantizeBC7Mode6(const float e[4], uint32_t q[4], uint32_t& pbit)
+{
+    float bestErr = 0.0f;
+    for (uint32_t p = 0; p < 2; ++p)
+    {
+        uint32_t cand[4];
+        float err = 0.0f;
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            cand[c] = static_cast<uint32_t>(std::clamp(std::lround((e[c] - p) / 2.0f), 0L, 127L));
+            const float d = static_cast<float>(cand[c] * 2 + p) - e[c];
+            err += d * d;
+        }
+        if (p == 0 || err < bestErr)
+        {
+            bestErr = err;
+            pbit = p;
+            std::memcpy(q, cand, sizeof(cand));
+        }
+    }
+}
+
+void EncodeBC7Block(const uint8_t* rgba, uint8_t* out)
+{
+    static const int kWeights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    float e[2][4];
+    FitEndpoints(rgba, 4, e[0], e[1]);
+
+    uint32_t q[2][4], p[2];
+    QuantizeBC7Mode6(e[0], q[0], p[0]);
+    QuantizeBC7Mode6(e[1], q[1], p[1]);
+
+    int palette[16][4];
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            const int a = static_cast<int>(q[0][c] * 2 + p[0]);
+            const int b = static_cast<int>(q[1][c] * 2 + p[1]);
+            palette[i][c] = ((64 - kWeights[i]) * a + kWeights[i] * b + 32) >> 6;
+        }
+    }
+
+    uint32_t indices[16] = {};
+    NearestIndices(rgba, 4, palette, 16, indices);
+
+    // The anchor (texel 0) index has an implicit leading 0 bit: swap the endpoints if it is >= 8.
+    if (indices[0] & 8u)
+    {
+        std::swap(q[0], q[1]);
+        std::swap(p[0], p[1]);
+        for (uint32_t& index : indices)
+            index = 15 - index;
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter w{ out };
+    w.put(1u << 6, 7); // mode 6
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        w.put(q[0][c], 7);
+        w.put(q[1][c], 7);
+    }
+    w.put(p[0], 1);
+    w.put(p[1], 1);
+    w.put(indices[0], 3);
+    for (uint32_t i = 1; i < 16; ++i)
+        w.put(indices[i], 4);
+}
+
+std::vector<uint8_t> CompressLevel(VkFormat format, const uint8_t* rgba, uint32_t width, uint32_t height)
+{
+    if (format == VK_FORMAT_R8G8B8A8_UNORM)
+        return std::vector<uint8_t>(rgba, rgba + static_cast<size_t>(width) * height * 4);
+
+    uint32_t blockW = 4, blockH = 4, blockBytes = 16;
+    VgtGetFormatBlockInfo(format, blockW, blockH, blockBytes);
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    std::vector<uint8_t> out(static_cast<size_t>(blocksX) * blocksY * blockBytes);
+
+    uint8_t block[64];
+    for (uint32_t by = 0; by < blocksY; ++by)
+    {
+        for (uint32_t bx = 0; bx < blocksX; ++bx)
+        {
+            for (uint32_t y = 0; y < 4; ++y)
+            {
+                const uint32_t sy = std::min(by * 4 + y, height - 1);
+                for (uint32_t x = 0; x < 4; ++x)
+                {
+                    const uint32_t sx = std::min(bx * 4 + x, width - 1);
+                    std::memcpy(&block[(y * 4 + x) * 4], &rgba[(static_cast<size_t>(sy) * width + sx) * 4], 4);
+                }
+            }
+
+            uint8_t* dst = &out[(static_cast<size_t>(by) * blocksX + bx) * blockBytes];
+            switch (format)
+            {
+            case VK_FORMAT_BC1_RGBA_UNORM_BLOCK: EncodeBC1Block(block, dst); break;
+            case VK_FORMAT_BC3_UNORM_BLOCK: EncodeBC3Block(block, dst); break;
+            case VK_FORMAT_BC5_UNORM_BLOCK: EncodeBC5Block(block, dst); break;
+            default: EncodeBC7Block(block, dst); break;
+            }
+        }
+    }
+    return out;
+}
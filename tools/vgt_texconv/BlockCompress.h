@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+// CPU block encoders for vgt_texconv. They aim for "obviously correct and fast enough for
+// the tutorial assets", not for the quality of a production encoder:
+// endpoints come from the principal axis of each 4x4 block, indices are the nearest palette entry.
+//
+// Each block encoder takes 16 RGBA8 texels in row-major order (64 bytes).
+
+void EncodeBC1Block(const uint8_t* rgba, uint8_t* out);  // 8 bytes, 4-color mode (opaque)
+void EncodeBC3Block(const uint8_t* rgba, uint8_t* out);  // 16 bytes: BC4 alpha + BC1 color
+void EncodeBC4Block(const uint8_t* values, uint32_t stride, uint8_t* out); // 8 bytes, one channel
+void EncodeBC5Block(const uint8_t* rgba, uint8_t* out);  // 16 bytes: BC4 red + BC4 green
+void EncodeBC7Block(const uint8_t* rgba, uint8_t* out);  // 16 bytes, mode 6 only
+
+// Encodes a whole `width` x `height` RGBA8 level into `format` (RGBA8 or the UNORM variants of
+// BC1_RGBA, BC3, BC5 and BC7). Partial blocks on the right and bottom edges repeat the last
+// column / row.
+std::vector<uint8_t> CompressLevel(VkFormat format, const uint8_t* rgba, uint32_t width, uint32_t height);
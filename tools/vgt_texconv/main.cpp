@@ -0,0 +1,395 @@
+// Offline texture converter: PNG/JPEG (or the Step03 checkerboard) -> KTX2 / DDS / PNG.
+//
+// Usage: vgt_texconv [--format bc1|bc3|bc5|bc7|rgba8] [--no-mips] (INPUT | --checkerboard) -o OUTPUT
+//
+// The container follows the extension of OUTPUT (.ktx2, .dds or .png). KTX2 and DDS files get a
+// full mip chain (2x2 box filter, the same as common/shaders/mipgen.comp) unless --no-mips is
+// given; PNG output is always a single RGBA8 level. The default format is bc7.
+//
+// Encoding covers BC1/BC3/BC5/BC7 and RGBA8. ETC2/ASTC files can be loaded by VgtImageFile but
+// have to come from an external encoder.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+#include <VgtImageFile.h>
+
+#include "BlockCompress.h"
+
+struct Level
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> rgba;
+    std::vector<uint8_t> encoded;
+};
+
+// The texture tools/generate_texture.py used to write: 256x256, 32 px squares.
+static Level MakeCheckerboard()
+{
+    Level level;
+    level.width = 256;
+    level.height = 256;
+    level.rgba.resize(256 * 256 * 4);
+    for (uint32_t y = 0; y < 256; ++y)
+    {
+        for (uint32_t x = 0; x < 256; ++x)
+        {
+            const bool red = ((x / 32 + y / 32) % 2) == 0;
+            uint8_t* p = &level.rgba[(y * 256 + x) * 4];
+            p[0] = red ? 255 : 100;
+            p[1] = 100;
+            p[2] = red ? 100 : 255;
+            p[3] = 255;
+        }
+    }
+    return level;
+}
+
+// Next level with a 2x2 box filter; reads are clamped so odd sizes work.
+static Level Downsample(const Level& src)
+{
+    Level dst;
+    dst.width = std::max(src.width / 2, 1u);
+    dst.height = std::max(src.height / 2, 1u);
+    dst.rgba.resize(static_cast<size_t>(dst.width) * dst.height * 4);
+    for (uint32_t y = 0; y < dst.height; ++y)
+    {
+        for (uint32_t x = 0; x < dst.width; ++x)
+        {
+            const uint32_t x0 = std::min(x * 2, src.width - 1), x1 = std::min(x * 2 + 1, src.width - 1);
+            const uint32_t y0 = std::min(y * 2, src.height - 1), y1 = std::min(y * 2 + 1, src.height - 1);
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                const uint32_t sum = src.rgba[(static_cast<size_t>(y0) * src.width + x0) * 4 + c] +
+                    src.rgba[(static_cast<size_t>(y0) * src.width + x1) * 4 + c] +
+                    src.rgba[(static_cast<size_t>(y1) * src.width + x0) * 4 + c] +
+                    src.rgba[(static_cast<size_t>(y1) * src.width + x1) * 4 + c];
+                dst.rgba[(static_cast<size_t>(y) * dst.width + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+    return dst;
+}
+
+static void PutU32(std::vector<uint8_t>& out, uint32_t v)
+{
+    for (uint32_t b = 0; b < 4; ++b)
+        out.push_back(static_cast<uint8_t>(v >> (8 * b)));
+}
+
+static void PutU64(std::vector<uint8_t>& out, uint64_t v)
+{
+    for (uint32_t b = 0; b < 8; ++b)
+        out.push_back(static_cast<uint8_t>(v >> (8 * b)));
+}
+
+static void SetU32(std::vector<uint8_t>& out, size_t offset, uint32_t v)
+{
+    for (uint32_t b = 0; b < 4; ++b)
+        out[offset + b] = static_cast<uint8_t>(v >> (8 * b));
+}
+
+static void SetU64(std::vector<uint8_t>& out, size_t offset, uint64_t v)
+{
+    for (uint32_t b = 0; b < 8; ++b)
+        out[offset + b] = static_cast<uint8_t>(v >> (8 * b));
+}
+
+// Basic data format descriptor (Khronos Data Format spec, section 5) for the formats we encode.
+static std::vector<uint8_t> MakeDfd(VkFormat format)
+{
+    struct Sample
+    {
+        uint32_t bitOffset;
+        uint32_t bitLength;
+        uint32_t channel;
+        uint32_t upper;
+    };
+    uint32_t colorModel = 1; // KHR_DF_MODEL_RGBSDA
+    uint32_t blockDim = 0;   // texelBlockDimension0..3, each stored minus one
+    uint32_t blockBytes = 4;
+    std::vector<Sample> samples;
+    switch (format)
+    {
+    case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        colorModel = 128; // KHR_DF_MODEL_BC1A
+        blockDim = 0x0303;
+        blockBytes = 8;
+        samples = { { 0, 63, 1, 0xFFFFFFFFu } }; // KHR_DF_CHANNEL_BC1A_ALPHAPRESENT
+        break;
+    case VK_FORMAT_BC3_UNORM_BLOCK:
+        colorModel = 130; // KHR_DF_MODEL_BC3
+        blockDim = 0x0303;
+        blockBytes = 16;
+        samples = { { 0, 63, 15, 0xFFFFFFFFu }, { 64, 63, 0, 0xFFFFFFFFu } }; // alpha, color
+        break;
+    case VK_FORMAT_BC5_UNORM_BLOCK:
+        colorModel = 132; // KHR_DF_MODEL_BC5
+        blockDim = 0x0303;
+        blockBytes = 16;
+        samples = { { 0, 63, 0, 0xFFFFFFFFu }, { 64, 63, 1, 0xFFFFFFFFu } }; // red, green
+        break;
+    case VK_FORMAT_BC7_UNORM_BLOCK:
+        colorModel = 134; // KHR_DF_MODEL_BC7
+        blockDim = 0x0303;
+        blockBytes = 16;
+        samples = { { 0, 127, 0, 0xFFFFFFFFu } };
+        break;
+    default: // RGBA8
+        samples = { { 0, 7, 0, 255 }, { 8, 7, 1, 255 }, { 16, 7, 2, 255 }, { 24, 7, 15, 255 } };
+        break;
+    }
+
+    const uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+    std::vector<uint8_t> dfd;
+    PutU32(dfd, 4 + blockSize);          // dfdTotalSize
+    PutU32(dfd, 0);                      // vendorId = Khronos, descriptorType = basic
+    PutU32(dfd, 2 | (blockSize << 16));  // versionNumber 1.3, descriptorBlockSize
+    PutU32(dfd, colorModel | (1u << 8) | (1u << 16)); // BT709 primaries, linear transfer, straight alpha
+    PutU32(dfd, blockDim);
+    PutU32(dfd, blockBytes);             // bytesPlane0..3
+    PutU32(dfd, 0);                      // bytesPlane4..7
+    for (const Sample& s : samples)
+    {
+        PutU32(dfd, s.bitOffset | (s.bitLength << 16) | (s.channel << 24));
+        PutU32(dfd, 0); // samplePosition
+        PutU32(dfd, 0); // sampleLower
+        PutU32(dfd, s.upper);
+    }
+    return dfd;
+}
+
+static size_t AlignUp(size_t v, size_t alignment)
+{
+    return (v + alignment - 1) / alignment * alignment;
+}
+
+// KTX2: header, level index (level 0 first), DFD, then the level data smallest first so a
+// reader can stream in the low mips before the large ones.
+static std::vector<uint8_t> WriteKtx2(VkFormat format, const std::vector<Level>& levels)
+{
+    uint32_t blockW = 1, blockH = 1, blockBytes = 4;
+    VgtGetFormatBlockInfo(format, blockW, blockH, blockBytes);
+    const size_t levelAlignment = std::lcm(static_cast<size_t>(blockBytes), size_t{ 4 });
+
+    const std::vector<uint8_t> dfd = MakeDfd(format);
+    const size_t levelIndexOffset = kVgtKtx2HeaderSize;
+    const size_t dfdOffset = levelIndexOffset + levels.size() * kVgtKtx2LevelIndexEntry;
+
+    std::vector<uint8_t> out(kVgtKtx2Identifier, kVgtKtx2Identifier + sizeof(kVgtKtx2Identifier));
+    PutU32(out, static_cast<uint32_t>(format));
+    PutU32(out, 1); // typeSize
+    PutU32(out, levels[0].width);
+    PutU32(out, levels[0].height);
+    PutU32(out, 0); // pixelDepth
+    PutU32(out, 0); // layerCount
+    PutU32(out, 1); // faceCount
+    PutU32(out, static_cast<uint32_t>(levels.size()));
+    PutU32(out, 0); // supercompressionScheme
+    PutU32(out, static_cast<uint32_t>(dfdOffset));
+    PutU32(out, static_cast<uint32_t>(dfd.size()));
+    PutU32(out, 0); // kvdByteOffset
+    PutU32(out, 0); // kvdByteLength
+    PutU64(out, 0); // sgdByteOffset
+    PutU64(out, 0); // sgdByteLength
+
+    out.resize(dfdOffset);
+    out.insert(out.end(), dfd.begin(), dfd.end());
+
+    for (size_t i = levels.size(); i-- > 0;)
+    {
+        out.resize(AlignUp(out.size(), levelAlignment));
+        const size_t entry = levelIndexOffset + i * kVgtKtx2LevelIndexEntry;
+        SetU64(out, entry + 0, out.size());
+        SetU64(out, entry + 8, levels[i].encoded.size());
+        SetU64(out, entry + 16, levels[i].encoded.size());
+        out.insert(out.end(), levels[i].encoded.begin(), levels[i].encoded.end());
+    }
+    return out;
+}
+
+// DDS with the DX10 extension header, levels largest first.
+static std::vector<uint8_t> WriteDds(VkFormat format, const std::vector<Level>& levels)
+{
+    constexpr uint32_t kFlags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000; // CAPS|HEIGHT|WIDTH|PIXELFORMAT|MIPMAPCOUNT|LINEARSIZE
+    constexpr uint32_t kCapsTexture = 0x1000, kCapsComplex = 0x8, kCapsMipmap = 0x400000;
+
+    std::vector<uint8_t> out;
+    PutU32(out, kVgtDdsMagic);
+    const size_t header = out.size();
+    out.resize(header + kVgtDdsHeaderSize, 0);
+    SetU32(out, header + 0, static_cast<uint32_t>(kVgtDdsHeaderSize));
+    SetU32(out, header + 4, kFlags);
+    SetU32(out, header + 8, levels[0].height);
+    SetU32(out, header + 12, levels[0].width);
+    SetU32(out, header + 16, static_cast<uint32_t>(levels[0].encoded.size()));
+    SetU32(out, header + 24, static_cast<uint32_t>(levels.size()));
+    SetU32(out, header + 72, 32);  // DDS_PIXELFORMAT::dwSize
+    SetU32(out, header + 76, 0x4); // DDPF_FOURCC
+    SetU32(out, header + 80, 'D' | ('X' << 8) | ('1' << 16) | ('0' << 24));
+    SetU32(out, header + 104, kCapsTexture | (levels.size() > 1 ? kCapsComplex | kCapsMipmap : 0));
+
+    PutU32(out, VgtDxgiFromVkFormat(format));
+    PutU32(out, 3); // D3D10_RESOURCE_DIMENSION_TEXTURE2D
+    PutU32(out, 0); // miscFlag
+    PutU32(out, 1); // arraySize
+    PutU32(out, 0); // miscFlags2
+
+    for (const Level& level : levels)
+        out.insert(out.end(), level.encoded.begin(), level.encoded.end());
+    return out;
+}
+
+static bool EndsWith(const std::string& s, const char* suffix)
+{
+    const size_t n = std::strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+static bool ParseFormat(const char* text, VkFormat& format)
+{
+    static const struct
+    {
+        const char* name;
+        VkFormat format;
+    } kNames[] = {
+        { "bc1", VK_FORMAT_BC1_RGBA_UNORM_BLOCK },
+        { "bc3", VK_FORMAT_BC3_UNORM_BLOCK },
+        { "bc5", VK_FORMAT_BC5_UNORM_BLOCK },
+        { "bc7", VK_FORMAT_BC7_UNORM_BLOCK },
+        { "rgba8", VK_FORMAT_R8G8B8A8_UNORM },
+    };
+    for (const auto& entry : kNames)
+    {
+        if (std::strcmp(text, entry.name) == 0)
+        {
+            format = entry.format;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void PrintUsage()
+{
+    std::fprintf(stderr,
+        "Usage: vgt_texconv [--format bc1|bc3|bc5|bc7|rgba8] [--no-mips] (INPUT | --checkerboard) -o OUTPUT\n"
+        "  OUTPUT extension selects the container: .ktx2, .dds or .png (RGBA8, level 0 only)\n");
+}
+
+int main(int argc, char** argv)
+{
+    VkFormat format = VK_FORMAT_BC7_UNORM_BLOCK;
+    bool mips = true;
+    bool checkerboard = false;
+    std::string input;
+    std::string output;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+        {
+            if (!ParseFormat(argv[++i], format))
+            {
+                std::fprintf(stderr, "Unknown format: %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--no-mips") == 0)
+            mips = false;
+        else if (std::strcmp(argv[i], "--checkerboard") == 0)
+            checkerboard = true;
+        else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else if (argv[i][0] != '-' && input.empty())
+            input = argv[i];
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (output.empty() || checkerboard == !input.empty())
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    std::vector<Level> levels(1);
+    if (checkerboard)
+    {
+        levels[0] = MakeCheckerboard();
+    }
+    else
+    {
+        VgtImageData image;
+        if (!VgtLoadImageFile(input.c_str(), image))
+        {
+            std::fprintf(stderr, "Failed to load %s\n", input.c_str());
+            return 1;
+        }
+        if (image.format != VK_FORMAT_R8G8B8A8_UNORM)
+        {
+            std::fprintf(stderr, "%s is already %s; only uncompressed images can be converted\n",
+                input.c_str(), VgtGetFormatName(image.format));
+            VgtFreeImageData(image);
+            return 1;
+        }
+        levels[0].width = image.width;
+        levels[0].height = image.height;
+        levels[0].rgba.assign(image.pixels, image.pixels + image.levels[0].size);
+        VgtFreeImageData(image);
+    }
+
+    if (EndsWith(output, ".png"))
+    {
+        const Level& level = levels[0];
+        if (!stbi_write_png(output.c_str(), static_cast<int>(level.width), static_cast<int>(level.height), 4,
+                level.rgba.data(), static_cast<int>(level.width * 4)))
+        {
+            std::fprintf(stderr, "Failed to write %s\n", output.c_str());
+            return 1;
+        }
+        std::printf("%s: %ux%u RGBA8\n", output.c_str(), level.width, level.height);
+        return 0;
+    }
+
+    const bool ktx2 = EndsWith(output, ".ktx2");
+    if (!ktx2 && !EndsWith(output, ".dds"))
+    {
+        std::fprintf(stderr, "Unknown output container: %s (expected .ktx2, .dds or .png)\n", output.c_str());
+        return 1;
+    }
+
+    while (mips && (levels.back().width > 1 || levels.back().height > 1))
+        levels.push_back(Downsample(levels.back()));
+
+    size_t rawBytes = 0, encodedBytes = 0;
+    for (Level& level : levels)
+    {
+        level.encoded = CompressLevel(format, level.rgba.data(), level.width, level.height);
+        rawBytes += level.rgba.size();
+        encodedBytes += level.encoded.size();
+    }
+
+    const std::vector<uint8_t> file = ktx2 ? WriteKtx2(format, levels) : WriteDds(format, levels);
+    std::ofstream out(output, std::ios::binary);
+    if (!out || !out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size())))
+    {
+        std::fprintf(stderr, "Failed to write %s\n", output.c_str());
+        return 1;
+    }
+
+    std::printf("%s: %ux%u %s, %zu levels, %zu KiB (RGBA8: %zu KiB)\n", output.c_str(), levels[0].width,
+        levels[0].height, VgtGetFormatName(format), levels.size(), encodedBytes / 1024, rawBytes / 1024);
+    return 0;
+}